@@ -32,10 +32,10 @@ doi:10.1007/s11554-016-0590-2.
 
 ***************************************/
 
-module LinkRunCCA(clk,rst,datavalid,pix_in,datavalid_out,box_out);
+module LinkRunCCA(clk,rst,datavalid,pix_in,datavalid_out,box_out,x_last,y_last);
 
-parameter imwidth=1280;
-parameter imheight=800;
+parameter imwidth=1280; //maximum image width
+parameter imheight=800; //maximum image height
 parameter x_bit=$clog2(imwidth); 
 parameter y_bit=$clog2(imheight);
 parameter address_bit=x_bit-1;
@@ -43,6 +43,8 @@ parameter data_bit=2*(x_bit+y_bit);
 parameter latency=3; //latency is 3 with holes_filler
 
 input clk,rst,datavalid,pix_in;
+input [x_bit-1:0]x_last; //runtime image width - 1, only change between frames (together with rst)
+input [y_bit-1:0]y_last; //runtime image height - 1, only change between frames (together with rst)
 output reg datavalid_out;
 output reg [data_bit-1:0]box_out;
 
@@ -59,6 +61,7 @@ wire A,B,C,D,r1,r2,fp,fn,O,HCN,DAC,DMG,CLR,EOC;
 wire [address_bit-1:0]p,hp,tp,np;
 wire [data_bit-1:0]d,dp;
 wire left,hr1,hf_out;
+wire [x_bit-1:0]row_len=x_last-1'b1; //row buffers hold imwidth-2 pixels, the window holds the remaining two
 
 
 //tables
@@ -73,13 +76,13 @@ table_ram#(data_bit,address_bit)
 
 //holes filler
 holes_filler HF(clk,datavalid,pix_in,hr1,left,hf_out);
-row_buf#(imwidth-2) RBHF(clk,datavalid,left,hr1);
+row_buf#(.length(imwidth-2),.len_bit(x_bit)) RBHF(clk,datavalid,left,hr1,,row_len);
 
 
 
 //window & row buffer
 window WIN(clk,datavalid,hf_out,r1,A,B,C,D);
-row_buf#(imwidth-2) RB(clk,datavalid,C,r1,r2);
+row_buf#(.length(imwidth-2),.len_bit(x_bit)) RB(clk,datavalid,C,r1,r2,row_len);
 
 //table reader
 table_reader#(address_bit,data_bit) TR(
@@ -112,7 +115,7 @@ feature_accumulator#(
 	.latency(latency)
 	)
 	FA(
-	clk,rst,datavalid,DAC,DMG,CLR,dp,d
+	clk,rst,datavalid,DAC,DMG,CLR,dp,d,x_last,y_last
 );
 
 
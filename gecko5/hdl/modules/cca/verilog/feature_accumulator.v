@@ -32,7 +32,7 @@ doi:10.1007/s11554-016-0590-2.
 ***************************************/
 
 module feature_accumulator(
-	clk,rst,datavalid,DAC,DMG,CLR,dp,d
+	clk,rst,datavalid,DAC,DMG,CLR,dp,d,x_last,y_last
 );
 
 parameter imwidth=512;
@@ -42,24 +42,28 @@ parameter y_bit=9;
 parameter address_bit=8;
 parameter data_bit=38;
 parameter latency=3; //latency to offset counter x, 3 if holes filling, else 1
-parameter rstx=imwidth-latency;
-parameter rsty=imheight-1;
-parameter compx=imwidth-1;
 input clk,rst,datavalid,DAC,DMG,CLR;
 input [data_bit-1:0]dp;
 output reg[data_bit-1:0]d;
+input [x_bit-1:0]x_last; //runtime image width - 1, must not exceed imwidth - 1
+input [y_bit-1:0]y_last; //runtime image height - 1, must not exceed imheight - 1
+
+//counter limits follow the runtime geometry instead of imwidth/imheight
+wire [x_bit-1:0]rstx=x_last+1'b1-latency[x_bit-1:0];
+wire [y_bit-1:0]rsty=y_last;
+wire [x_bit-1:0]compx=x_last;
 
 ////coordinate counter
 reg [x_bit-1:0]x;
 reg [y_bit-1:0]y;
 always@(posedge clk or posedge rst)
 	if(rst)begin 
-		x<=rstx[x_bit-1:0];y<=rsty[y_bit-1:0];
+		x<=rstx;y<=rsty;
 	end
 	else if(datavalid)begin
-		if(x==compx[x_bit-1:0])begin
+		if(x==compx)begin
 			x<=0;
-			if(y==rsty[y_bit-1:0])
+			if(y==rsty)
 				y<=0;
 			else y<=y+1;
 		end
@@ -30,10 +30,12 @@ doi:10.1007/s11554-016-0590-2.
 
 ***************************************/
 
-module row_buf(clk,datavalid,pix_in,pix_out1,pix_out2);
-parameter length=640;
+module row_buf(clk,datavalid,pix_in,pix_out1,pix_out2,len);
+parameter length=640; //maximum length
+parameter len_bit=$clog2(length+1);
 
 input clk,datavalid,pix_in;
+input [len_bit-1:0]len; //runtime length, 2<=len<=length
 output pix_out1,pix_out2;
 
 reg [length-1:0] R;
@@ -45,7 +47,8 @@ always@(posedge clk)begin
 		R[0]<=pix_in;
 	end
 end
-assign pix_out1=R[length-1];
-assign pix_out2=R[length-2];
+//tap the shift register at the runtime length, bits above len-1 are don't care
+assign pix_out1=R[len-1];
+assign pix_out2=R[len-2];
 	
 endmodule
@@ -8,6 +8,7 @@ module tb_featureTransferSpi;
   reg featureValid = 0;
   reg [FEATURE_WIDTH-1:0] featureVecCamDomain = 0;
   reg vSync = 0;
+  reg [7:0] sensorMode = 0;
   // sys domain
   reg sysClock = 0;
   // spi
@@ -15,9 +16,18 @@ module tb_featureTransferSpi;
   wire spiMosi;
   wire spiMiso;
   wire spiTransferDone;
+  // ci
+  reg ciStart = 0;
+  reg ciCke = 0;
+  reg [7:0] ciN = 0;
+  reg [31:0] ciValueA = 0;
+  reg [31:0] ciValueB = 0;
+  wire [31:0] ciResult;
+  wire ciDone;
 
   assign spiMiso = spiMosi;
   featureTransferSpi #(
+      .CUSTOM_INSTRUCTION_ID('d2),
       .NUM_BITS_X(NUM_BITS_X),
       .NUM_BITS_Y(NUM_BITS_Y)
   ) ft (
@@ -26,12 +36,21 @@ module tb_featureTransferSpi;
       .featureValid(featureValid),
       .featureVector(featureVecCamDomain),
       .cameraVsync(vSync),
+      .sensorMode(sensorMode),
       .systemClock(sysClock),
       // spi
       .spiSck(spiSck),
       .spiMosi(spiMosi),
       .spiMiso(spiMiso),
-      .spiTransferDone(spiTransferDone)
+      .spiTransferDone(spiTransferDone),
+      // ci
+      .ciStart(ciStart),
+      .ciCke(ciCke),
+      .ciN(ciN),
+      .ciValueA(ciValueA),
+      .ciValueB(ciValueB),
+      .ciResult(ciResult),
+      .ciDone(ciDone)
   );
 
   always #1 sysClock = ~sysClock;
@@ -52,6 +71,18 @@ module tb_featureTransferSpi;
     end
   endtask
 
+  task setStreaming(input enable);
+    begin
+      @(posedge sysClock) #0 ciN = 'd2;
+      ciValueA = 'd1;
+      ciValueB = enable;
+      ciStart = 1;
+      ciCke = 1;
+      @(posedge sysClock) #0 ciStart = 0;
+      ciCke = 0;
+    end
+  endtask
+
   task waitForTransfer;
     begin
       @(posedge spiTransferDone);
@@ -84,7 +115,9 @@ module tb_featureTransferSpi;
     waitForTransfer();
     #10 sync();
 
-    #80 featureVecCamDomain = 'h0156;
+    // mode of the frame being collected, reported in the header of this frame
+    #80 sensorMode = 'd2;
+    featureVecCamDomain = 'h0156;
     writeFeature();
     #10 featureVecCamDomain = 'hAC5E;
     writeFeature();
@@ -106,6 +139,43 @@ module tb_featureTransferSpi;
 
     // write no features
     waitForTransfer();
+
+    // streaming, applied from the next frame on: the frame in progress is still sent in one packet
+    setStreaming(1);
+    #80 featureVecCamDomain = 'h1357;
+    writeFeature();
+    #10 sync();
+    waitForTransfer();
+
+    // every feature is sent in a chunk of its own, the last chunk of the frame is empty
+    #80 featureVecCamDomain = 'h2222;
+    writeFeature();
+    waitForTransfer();
+    #80 featureVecCamDomain = 'h3333;
+    writeFeature();
+    waitForTransfer();
+    #10 sync();
+    waitForTransfer();
+
+    // features queued during a transfer share the next chunk, the end of frame marker closes it
+    featureVecCamDomain = 'h4444;
+    writeFeature();
+    featureVecCamDomain = 'h5555;
+    writeFeature();
+    sync();
+    waitForTransfer();
+
+    // back to one packet per frame, the frame in progress is still streamed
+    setStreaming(0);
+    #80 featureVecCamDomain = 'h6666;
+    writeFeature();
+    waitForTransfer();
+    #10 sync();
+    waitForTransfer();
+    #80 featureVecCamDomain = 'h7777;
+    writeFeature();
+    #10 sync();
+    waitForTransfer();
     #200 // To allow spi rx
 
     $finish;
@@ -0,0 +1,101 @@
+// dual clock fifo, gray coded pointers crossing with two flops
+module featureFifo #(
+    parameter DATA_WIDTH = 10,
+    parameter ADDRESS_WIDTH = 7  // FIFO depth = 2^ADDRESS_WIDTH
+) (
+    input wire reset,  // async
+    // producer
+    input wire writeClock,
+    input wire writeEnable,  // ignored if full
+    input wire [DATA_WIDTH-1:0] dataIn,
+    output wire full,  // synched with writeClock, pessimistic: a read is seen by the producer two writeClock cycles late
+    output wire oneWriteLeft,  // synched with writeClock, true while exactly one write is left
+    // consumer
+    input wire readClock,
+    input wire readEnable,  // pops the element at dataOut, ignored if empty
+    output wire empty,  // synched with readClock, pessimistic: a write is seen by the consumer two readClock cycles late
+    output wire [DATA_WIDTH-1:0] dataOut  // element at the head, valid on the rising readClock edge after the pop
+);
+
+  localparam integer unsigned Depth = 2 ** ADDRESS_WIDTH;
+
+  function automatic [ADDRESS_WIDTH:0] binaryToGray(input [ADDRESS_WIDTH:0] binary);
+    binaryToGray = binary ^ (binary >> 1);
+  endfunction
+
+  function automatic [ADDRESS_WIDTH:0] grayToBinary(input [ADDRESS_WIDTH:0] gray);
+    integer i;
+    begin
+      grayToBinary[ADDRESS_WIDTH] = gray[ADDRESS_WIDTH];
+      for (i = ADDRESS_WIDTH - 1; i >= 0; i = i - 1) begin
+        grayToBinary[i] = grayToBinary[i+1] ^ gray[i];
+      end
+    end
+  endfunction
+
+  // one more bit than the address to tell full from empty
+  reg [ADDRESS_WIDTH:0] writePointer;
+  reg [ADDRESS_WIDTH:0] writePointerGray;
+  reg [ADDRESS_WIDTH:0] readPointer;
+  reg [ADDRESS_WIDTH:0] readPointerGray;
+
+  // producer clock domain
+  reg [ADDRESS_WIDTH:0] readPointerGraySync0;
+  reg [ADDRESS_WIDTH:0] readPointerGraySync1;
+  wire [ADDRESS_WIDTH:0] used = writePointer - grayToBinary(readPointerGraySync1);
+  wire doWrite = writeEnable && !full;
+
+  assign full = (used == Depth);
+  assign oneWriteLeft = (used == (Depth - 1));
+
+  always @(posedge writeClock or posedge reset) begin
+    if (reset) begin
+      writePointer <= 'd0;
+      writePointerGray <= 'd0;
+      readPointerGraySync0 <= 'd0;
+      readPointerGraySync1 <= 'd0;
+    end else begin
+      writePointer <= (doWrite == 'b1) ? (writePointer + 'd1) : writePointer;
+      writePointerGray <= (doWrite == 'b1) ? binaryToGray(writePointer + 'd1) : writePointerGray;
+      readPointerGraySync0 <= readPointerGray;
+      readPointerGraySync1 <= readPointerGraySync0;
+    end
+  end
+
+  // consumer clock domain
+  reg [ADDRESS_WIDTH:0] writePointerGraySync0;
+  reg [ADDRESS_WIDTH:0] writePointerGraySync1;
+  wire doRead = readEnable && !empty;
+
+  // the memory is written on the edge the write pointer moves, the data is stable once the pointer is seen here
+  assign empty = (readPointerGray == writePointerGraySync1);
+
+  always @(posedge readClock or posedge reset) begin
+    if (reset) begin
+      readPointer <= 'd0;
+      readPointerGray <= 'd0;
+      writePointerGraySync0 <= 'd0;
+      writePointerGraySync1 <= 'd0;
+    end else begin
+      readPointer <= (doRead == 'b1) ? (readPointer + 'd1) : readPointer;
+      readPointerGray <= (doRead == 'b1) ? binaryToGray(readPointer + 'd1) : readPointerGray;
+      writePointerGraySync0 <= writePointerGray;
+      writePointerGraySync1 <= writePointerGraySync0;
+    end
+  end
+
+  // write on the rising edge, read on the falling edge
+  sramDp #(
+      .DATA_WIDTH(DATA_WIDTH),
+      .ADDRESS_WIDTH(ADDRESS_WIDTH)
+  ) memory (
+      .clockA(writeClock),
+      .writeEnableA(doWrite),
+      .addressA(writePointer[ADDRESS_WIDTH-1:0]),
+      .dataInA(dataIn),
+      .clockB(readClock),
+      .addressB(readPointer[ADDRESS_WIDTH-1:0]),
+      .dataOutB(dataOut)
+  );
+
+endmodule
@@ -1,4 +1,5 @@
 module featureTransferSpi #(
+    parameter [7:0] CUSTOM_INSTRUCTION_ID = 'd0,
     // default for 640x480 resolution
     parameter integer unsigned NUM_BITS_X = 10,  // must be less or equal to 16
     parameter integer unsigned NUM_BITS_Y = 9  // must be less or equal to 16
@@ -9,15 +10,62 @@ module featureTransferSpi #(
     input wire featureValid,
     input wire [((NUM_BITS_X + NUM_BITS_Y) * 2) - 1:0] featureVector,
     input wire cameraVsync,  // low active!
+    input wire [7:0] sensorMode,  // geometry tag of the current frame, must only change on the falling edge of cameraVsync
     // consumer
     input wire systemClock,
     // here the spi master interface is defined
     output wire spiSck,
     output wire spiMosi,
     input wire spiMiso,
-    output reg spiTransferDone
+    output reg spiTransferDone,
+    // custom instruction interface
+    input wire ciStart,
+    input wire ciCke,
+    input wire [7:0] ciN,
+    input wire [31:0] ciValueA,
+    input wire [31:0] ciValueB,
+    output wire [31:0] ciResult,
+    output wire ciDone
 );
 
+  /*
+   *
+   * CUSTOM INSTRUCTION
+   *
+   * different ci commands:
+   * ciValueA:    Description:
+   *     0        Read transfer mode (ciResult[0])
+   *     1        Write transfer mode (ciValueB[0]), 0: one packet per frame, 1: streaming
+   *
+   * The mode is applied from the next frame on, see featureTransferPacket.md for the packets of both modes.
+   *
+   */
+  localparam CI_A_READ_MODE = 0;
+  localparam CI_A_WRITE_MODE = 1;
+
+  wire isMyCi = (ciN == CUSTOM_INSTRUCTION_ID) ? ciStart & ciCke : 'b0;
+  reg streamingRequested;
+
+  always @(posedge systemClock, posedge reset) begin
+    if (reset) begin
+      streamingRequested <= 'b0;
+    end else if (isMyCi == 'b1 && (ciValueA[0] == CI_A_WRITE_MODE)) begin
+      streamingRequested <= ciValueB[0];
+    end
+  end
+
+  reg [31:0] selectedResult = 'd0; // intentionally set to 0 since process does not define a reset value
+
+  assign ciDone   = isMyCi;
+  assign ciResult = (isMyCi == 'b0) ? 'd0 : selectedResult;
+
+  always @(*) begin
+    case (ciValueA)
+      CI_A_READ_MODE: selectedResult <= {31'b0, streamingRequested};
+      default: selectedResult <= 'd0;
+    endcase
+  end
+
   /*
    *
    * FEATURE BUFFER
@@ -71,10 +119,107 @@ module featureTransferSpi #(
       .dataOut(featureVectorSystemDomain)
   );
 
+  /*
+   *
+   * STREAM BUFFER
+   *
+   * In streaming mode every feature is queued as soon as the cca completed it, together with the frame count and
+   * sensor mode of its frame. The buffer switch queues an end of frame marker instead of a feature.
+   * The double buffer is still written but its packet is skipped for streamed frames.
+   *
+   */
+  localparam integer unsigned StreamFeaturesMax = (2 ** DoubleBufferAddressWidth) - 2; // per frame, as the double buffer
+  localparam integer unsigned StreamFifoAddressWidth = DoubleBufferAddressWidth; // a full frame and its marker
+  localparam integer unsigned StreamEntryWidth = 1 + 8 + 8 + FeatureWidth; // end of frame, frame count, sensor mode, feature
+
+  // the requested mode is quasi static, it is sampled on the buffer switch only
+  reg [1:0] streamingPixelDomain;
+  reg streamFrame; // the frame in progress is streamed
+  reg frameStreamed; // the frame just completed was streamed, stable until the next buffer switch
+  reg [7:0] streamFrameCount; // frame count the frame in progress is sent with, the double buffer counts the same
+  reg [DoubleBufferAddressWidth-1:0] streamFeatureCount;
+
+  wire streamFull;
+  wire streamOneWriteLeft;
+  // one element is always kept free for the end of frame marker
+  wire streamFeature = featureValid && streamFrame && !switchBuffer && (streamFeatureCount < StreamFeaturesMax) && !(streamFull || streamOneWriteLeft);
+  wire streamEndOfFrame = switchBuffer && streamFrame;
+  wire [StreamEntryWidth-1:0] streamEntry = {streamEndOfFrame, streamFrameCount, sensorMode, (streamEndOfFrame == 'b1) ? {FeatureWidth{1'b0}} : featureVector};
+
+  always @(posedge pixelClock, posedge reset) begin
+    if (reset) begin
+      streamingPixelDomain <= 'd0;
+      streamFrame <= 'b0;
+      frameStreamed <= 'b0;
+      streamFrameCount <= 'd1;
+      streamFeatureCount <= 'd0;
+    end else begin
+      streamingPixelDomain <= {streamingPixelDomain[0], streamingRequested};
+      if (switchBuffer == 'b1) begin
+        streamFrame <= streamingPixelDomain[1];
+        frameStreamed <= streamFrame;
+        streamFrameCount <= streamFrameCount + 'd1;
+        streamFeatureCount <= 'd0;
+      end else if (streamFeature == 'b1) begin
+        streamFeatureCount <= streamFeatureCount + 'd1;
+      end
+    end
+  end
+
+  wire streamEmpty;
+  wire streamPop;
+  wire [StreamEntryWidth-1:0] streamHead;
+
+  featureFifo #(
+      .DATA_WIDTH(StreamEntryWidth),
+      .ADDRESS_WIDTH(StreamFifoAddressWidth)
+  ) streamBuffer (
+      .reset(reset),
+      // producer
+      .writeClock(pixelClock),
+      .writeEnable(streamFeature || streamEndOfFrame),
+      .dataIn(streamEntry),
+      .full(streamFull),
+      .oneWriteLeft(streamOneWriteLeft),
+      // consumer
+      .readClock(systemClock),
+      .readEnable(streamPop),
+      .empty(streamEmpty),
+      .dataOut(streamHead)
+  );
+
+  wire headEndOfFrame = streamHead[StreamEntryWidth-1];
+  wire [7:0] headFrameCount = streamHead[StreamEntryWidth-2:StreamEntryWidth-9];
+  wire [7:0] headSensorMode = streamHead[StreamEntryWidth-10:FeatureWidth];
+  wire [FeatureWidth-1:0] headFeature = streamHead[FeatureWidth-1:0];
+
+  /*
+   *
+   * CHUNK
+   *
+   * The queued features of one frame are collected into a chunk until the queue is empty, the chunk is full or the
+   * end of frame marker is reached. A chunk is sent as a packet of its own, the last one of a frame is flagged and
+   * may be empty. Features found in a burst share a chunk, single features leave the fpga right away.
+   *
+   */
+  localparam integer unsigned ChunkFeaturesMax = 8;
+  localparam integer unsigned ChunkIndexWidth = $clog2(ChunkFeaturesMax);
+  // packet format in the upper nibble of the sensor mode byte, refer to BlobPacketFormat of the vision add-on
+  localparam [3:0] FormatChunk = 4'h3;
+  localparam [3:0] FormatChunkLast = 4'h4;
+
+  reg [FeatureWidth-1:0] chunkFeatures [0:ChunkFeaturesMax-1];
+  reg [ChunkIndexWidth:0] chunkLength;
+  reg [7:0] chunkFrameCount;
+  reg [7:0] chunkSensorMode;
+  reg chunkLast;
+  reg chunkActive; // the packet in flight is a chunk
+
   wire [BitsPaddedFeatureVector-1:0] paddedFeatureVector;
   localparam integer unsigned BitsPadding = BitsPaddedFeatureVector - FeatureWidth;
   wire [1:0] Padding = 'b0;
-  assign paddedFeatureVector = {Padding, featureVectorSystemDomain};
+  wire [FeatureWidth-1:0] featureToSend = (chunkActive == 'b1) ? chunkFeatures[bufferReadAddress[ChunkIndexWidth-1:0]] : featureVectorSystemDomain;
+  assign paddedFeatureVector = {Padding, featureToSend};
 
 
 
@@ -116,6 +261,16 @@ module featureTransferSpi #(
       .Q(switchBufferSysDom)
   );
 
+  // the mode is captured together with the buffer switch, it belongs to the features of the frame just completed
+  reg [7:0] frameSensorMode;
+  always @(posedge pixelClock, posedge reset) begin
+    if (reset) begin
+      frameSensorMode <= 'd0;
+    end else if (switchBuffer == 'd1) begin
+      frameSensorMode <= sensorMode;
+    end
+  end
+
   reg [7:0] frameCount;
   always @(posedge systemClock, posedge reset) begin
     if (reset) begin
@@ -135,14 +290,22 @@ module featureTransferSpi #(
   localparam integer unsigned StateSendFrameCountPulseValid = 2;
   localparam integer unsigned StateSendLengthWaitReady = 3;
   localparam integer unsigned StateSendLengthPulseValid = 4;
-  localparam integer unsigned StateSendByteWaitReady = 5;
-  localparam integer unsigned StateSendBytePulseValid = 6;
-  localparam integer unsigned StateCheckBytesRemaining = 7;
-  localparam integer unsigned StateIncrementAddress = 8;
-  localparam integer unsigned StateCheckFeaturesRemaining = 9;
-  localparam integer unsigned StateTransferDone = 10;
-  localparam integer unsigned StateError = 11;
-  localparam integer unsigned NumberOfStates = 12;
+  localparam integer unsigned StateSendModeWaitReady = 5;
+  localparam integer unsigned StateSendModePulseValid = 6;
+  localparam integer unsigned StateSendByteWaitReady = 7;
+  localparam integer unsigned StateSendBytePulseValid = 8;
+  localparam integer unsigned StateCheckBytesRemaining = 9;
+  localparam integer unsigned StateIncrementAddress = 10;
+  localparam integer unsigned StateCheckFeaturesRemaining = 11;
+  localparam integer unsigned StateSendCrcHighWaitReady = 12;
+  localparam integer unsigned StateSendCrcHighPulseValid = 13;
+  localparam integer unsigned StateSendCrcLowWaitReady = 14;
+  localparam integer unsigned StateSendCrcLowPulseValid = 15;
+  localparam integer unsigned StateWaitLastByteSent = 16;
+  localparam integer unsigned StateTransferDone = 17;
+  localparam integer unsigned StateCollectChunk = 18;
+  localparam integer unsigned StateError = 19;
+  localparam integer unsigned NumberOfStates = 20;
 
   reg [$clog2(NumberOfStates)-1:0] fsmState;
   reg [$clog2(NumberOfStates)-1:0] fsmStateNext;
@@ -164,66 +327,114 @@ module featureTransferSpi #(
     end
   end
 
+  // a buffer switch of a streamed frame only ends its chunks, the double buffer packet is skipped
+  wire packetDue = newData && !frameStreamed;
+  wire chunkFull = (chunkLength == ChunkFeaturesMax);
+  wire chunkClosed = chunkLast || chunkFull || ((chunkLength != 'd0) && (headFrameCount != chunkFrameCount));
+
   // NSL
-  wire featuresRemaining = bufferReadAddress < dataLength;
+  wire featuresRemaining = bufferReadAddress < ((chunkActive == 'b1) ? chunkLength : dataLength);
   wire bytesRemaining =  txByteCount < BytesPaddedFeatureVector;
   always_comb begin
     case (fsmState)
       StateIdle: begin
-        fsmStateNext = (newData == 'b1) ? StateSendFrameCountWaitReady : StateIdle;
+        fsmStateNext = (packetDue == 'b1) ? StateSendFrameCountWaitReady : (streamEmpty == 'b0) ? StateCollectChunk : StateIdle;
         txByteCountNext = 'd0;
         bufferReadAddressNext = 'd0;
       end
       StateSendFrameCountWaitReady: begin
-        fsmStateNext = (newData == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendFrameCountPulseValid : StateSendFrameCountWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendFrameCountPulseValid : StateSendFrameCountWaitReady;
         txByteCountNext = 'd0;
         bufferReadAddressNext = 'd0;
       end
       StateSendFrameCountPulseValid: begin
-        fsmStateNext = (newData == 'b1) ? StateError : StateSendLengthWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateSendLengthWaitReady;
         txByteCountNext = 'd0;
         bufferReadAddressNext = 'd0;
       end
       StateSendLengthWaitReady: begin
-        fsmStateNext = (newData == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendLengthPulseValid : StateSendLengthWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendLengthPulseValid : StateSendLengthWaitReady;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress;
       end
       StateSendLengthPulseValid: begin
-        fsmStateNext = (newData == 'b1) ? StateError : ~featuresRemaining ? StateTransferDone : StateSendByteWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateSendModeWaitReady;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateSendModeWaitReady: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendModePulseValid : StateSendModeWaitReady;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateSendModePulseValid: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : ~featuresRemaining ? StateSendCrcHighWaitReady : StateSendByteWaitReady;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress;
       end
       StateSendByteWaitReady: begin
-        fsmStateNext = (newData == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendBytePulseValid : StateSendByteWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendBytePulseValid : StateSendByteWaitReady;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress;
       end
       StateSendBytePulseValid: begin
-        fsmStateNext = (newData == 'b1) ? StateError : StateCheckBytesRemaining;
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateCheckBytesRemaining;
         txByteCountNext = txByteCount + 'd1;
         bufferReadAddressNext = bufferReadAddress;
       end
       StateCheckBytesRemaining: begin
-        fsmStateNext = (newData == 'b1) ? StateError : ~bytesRemaining ? StateIncrementAddress : StateSendByteWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : ~bytesRemaining ? StateIncrementAddress : StateSendByteWaitReady;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress;
       end
       StateIncrementAddress: begin
-        fsmStateNext = (newData == 'b1) ? StateError : StateCheckFeaturesRemaining;
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateCheckFeaturesRemaining;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress + 'd1;
       end
       StateCheckFeaturesRemaining: begin
-        fsmStateNext = (newData == 'b1) ? StateError : ~featuresRemaining ? StateTransferDone : StateSendByteWaitReady;
+        fsmStateNext = (packetDue == 'b1) ? StateError : ~featuresRemaining ? StateSendCrcHighWaitReady : StateSendByteWaitReady;
         txByteCountNext = 'd0;
         bufferReadAddressNext = bufferReadAddress;
       end
+      StateSendCrcHighWaitReady: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendCrcHighPulseValid : StateSendCrcHighWaitReady;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateSendCrcHighPulseValid: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateSendCrcLowWaitReady;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateSendCrcLowWaitReady: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateSendCrcLowPulseValid : StateSendCrcLowWaitReady;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateSendCrcLowPulseValid: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateWaitLastByteSent;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
+      StateWaitLastByteSent: begin
+        // the receiver reads its dma counter on transfer done, the last byte must be on the wire by then
+        fsmStateNext = (packetDue == 'b1) ? StateError : (spiTxReady == 'b1) ? StateTransferDone : StateWaitLastByteSent;
+        txByteCountNext = txByteCount;
+        bufferReadAddressNext = bufferReadAddress;
+      end
       StateTransferDone: begin
-        fsmStateNext = (newData == 'b1) ? StateError : StateIdle;
+        fsmStateNext = (packetDue == 'b1) ? StateError : StateIdle;
         txByteCountNext = txByteCount;
         bufferReadAddressNext = bufferReadAddress;
       end
+      StateCollectChunk: begin
+        fsmStateNext = (packetDue == 'b1) ? StateError :
+                       ((streamEmpty == 'b0) && (chunkClosed == 'b0)) ? StateCollectChunk :
+                       ((chunkLength != 'd0) || (chunkLast == 'b1)) ? StateSendFrameCountWaitReady : StateIdle;
+        txByteCountNext = 'd0;
+        bufferReadAddressNext = 'd0;
+      end
       StateError: begin
         fsmStateNext = StateIdle;
         txByteCountNext = 'd0;
@@ -237,13 +448,85 @@ module featureTransferSpi #(
     endcase
   end
 
+  // one element per cycle, the next head is valid on the following rising edge
+  assign streamPop = (fsmState == StateCollectChunk) && (streamEmpty == 'b0) && (chunkClosed == 'b0);
+
+  always @(posedge systemClock, posedge reset) begin
+    if (reset) begin
+      chunkLength <= 'd0;
+      chunkFrameCount <= 'd0;
+      chunkSensorMode <= 'd0;
+      chunkLast <= 'b0;
+      chunkActive <= 'b0;
+    end else if (fsmState == StateIdle) begin
+      chunkLength <= 'd0;
+      chunkLast <= 'b0;
+      chunkActive <= 'b0;
+    end else if (fsmState == StateCollectChunk) begin
+      chunkActive <= 'b1;
+      if (streamPop == 'b1) begin
+        if (chunkLength == 'd0) begin
+          chunkFrameCount <= headFrameCount;
+          chunkSensorMode <= headSensorMode;
+        end
+        if (headEndOfFrame == 'b1) begin
+          chunkLast <= 'b1;
+        end else begin
+          chunkLength <= chunkLength + 'd1;
+        end
+      end
+    end
+  end
+
+  always @(posedge systemClock) begin
+    if ((streamPop == 'b1) && (headEndOfFrame == 'b0)) begin
+      chunkFeatures[chunkLength[ChunkIndexWidth-1:0]] <= headFeature;
+    end
+  end
+
+  /*
+   *
+   * PACKET CRC
+   *
+   * CRC-16/CCITT-FALSE (polynomial 0x1021, init 0xFFFF, no reflection, no final xor) over header and features,
+   * appended most significant byte first. The crc over the whole packet including the appended crc is 0.
+   *
+   */
+  function automatic [15:0] crc16Update(input [15:0] crc, input [7:0] data);
+    integer i;
+    reg [15:0] c;
+    begin
+      c = crc ^ {data, 8'h00};
+      for (i = 0; i < 8; i = i + 1) begin
+        c = (c[15] == 'b1) ? ((c << 1) ^ 16'h1021) : (c << 1);
+      end
+      crc16Update = c;
+    end
+  endfunction
+
+  wire payloadByteValid = (fsmState == StateSendFrameCountPulseValid) || (fsmState == StateSendLengthPulseValid) || (fsmState == StateSendModePulseValid) || (fsmState == StateSendBytePulseValid);
+  reg [15:0] crc;
+  always @(posedge systemClock, posedge reset) begin
+    if (reset) begin
+      crc <= 16'hFFFF;
+    end else if (fsmState == StateIdle) begin
+      crc <= 16'hFFFF;
+    end else if (payloadByteValid == 'b1) begin
+      crc <= crc16Update(crc, spiTxData);
+    end
+  end
+
   reg [7:0] dbg;
   // OL
   always_comb begin
-    spiTxDataValid = ((fsmState == StateSendFrameCountPulseValid) || (fsmState == StateSendLengthPulseValid) || (fsmState == StateSendBytePulseValid)) ? 'b1 : 'b0;
-    spiTxData = (fsmState == StateSendFrameCountPulseValid) ? (frameCount) :
-                (fsmState == StateSendLengthPulseValid) ? (dataLength) : // number of features
+    spiTxDataValid = (payloadByteValid || (fsmState == StateSendCrcHighPulseValid) || (fsmState == StateSendCrcLowPulseValid)) ? 'b1 : 'b0;
+    spiTxData = (fsmState == StateSendFrameCountPulseValid) ? ((chunkActive == 'b1) ? chunkFrameCount : frameCount) :
+                (fsmState == StateSendLengthPulseValid) ? ((chunkActive == 'b1) ? chunkLength : dataLength) : // number of features
+                (fsmState == StateSendModePulseValid) ? ((chunkActive == 'b1) ? {((chunkLast == 'b1) ? FormatChunkLast : FormatChunk), chunkSensorMode[3:0]} :
+                                                        frameSensorMode) : // quasi static, stable until the next buffer switch
                 (fsmState == StateSendBytePulseValid) ? (paddedFeatureVector >> (txByteCount * 8)) & 8'hFF :
+                (fsmState == StateSendCrcHighPulseValid) ? crc[15:8] :
+                (fsmState == StateSendCrcLowPulseValid) ? crc[7:0] :
                 'd0;
     spiTransferDone = (fsmState == StateTransferDone) ? 'b1 : 'b0;
   end
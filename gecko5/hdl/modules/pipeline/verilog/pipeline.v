@@ -1,5 +1,7 @@
 module pipeline #(
     parameter [7:0] BINARIZE_CUSTOM_INSTRUCTION_ID = 8'd0,
+    parameter [7:0] GEOMETRY_CUSTOM_INSTRUCTION_ID = 8'd1,
+    parameter [7:0] TRANSFER_CUSTOM_INSTRUCTION_ID = 8'd2,
 ) (
     input wire reset,
     // camera domain
@@ -64,6 +66,7 @@ module pipeline #(
   assign vsyncBinOut = vsyncBin;
   assign camDataBinOut = camDataBin;
 
+  // maximum geometry, the active one is set at runtime by the geometry ci
   localparam IMAGE_WIDTH = 1280;
   localparam NUM_BITS_X = $clog2(IMAGE_WIDTH);
   localparam IMAGE_HEIGHT = 800;
@@ -81,20 +84,58 @@ module pipeline #(
       .neg(vsyncBinEdge)
   );
 
+  wire [31:0] ciResultGeometry;
+  wire ciDoneGeometry;
+  wire [NUM_BITS_X-1:0] xLast;
+  wire [NUM_BITS_Y-1:0] yLast;
+  wire [7:0] sensorMode;
+
+  sensorGeometry #(
+      .CUSTOM_INSTRUCTION_ID(GEOMETRY_CUSTOM_INSTRUCTION_ID),
+      .MAX_WIDTH(IMAGE_WIDTH),
+      .MAX_HEIGHT(IMAGE_HEIGHT),
+      .NUM_BITS_X(NUM_BITS_X),
+      .NUM_BITS_Y(NUM_BITS_Y)
+  ) geometry (
+      .reset(reset),
+      .pixelClock(pixelClock),
+      .frameStart(vsyncBinEdge),
+      .xLast(xLast),
+      .yLast(yLast),
+      .mode(sensorMode),
+      // ci
+      .systemClock(systemClock),
+      .ciStart(ciStart),
+      .ciCke(ciCke),
+      .ciN(ciN),
+      .ciValueA(ciValueA),
+      .ciValueB(ciValueB),
+      .ciResult(ciResultGeometry),
+      .ciDone(ciDoneGeometry)
+  );
+
   wire binValid;
   assign binValid = hrefBin & vsyncBin;
-  LinkRunCCA cca (
+  LinkRunCCA #(
+      .imwidth(IMAGE_WIDTH),
+      .imheight(IMAGE_HEIGHT)
+  ) cca (
       .clk(pixelClock),
       .rst(vsyncBinEdge),
       .datavalid(binValid),
       .pix_in(camDataBin[0]),
       .datavalid_out(featureValidCamDomain),
-      .box_out(featureVectorCamDomain)
+      .box_out(featureVectorCamDomain),
+      .x_last(xLast),
+      .y_last(yLast)
   );
 
   wire [31:0] numberOfFeatures;
+  wire [31:0] ciResultTransfer;
+  wire ciDoneTransfer;
 
   featureTransferSpi #(
+      .CUSTOM_INSTRUCTION_ID(TRANSFER_CUSTOM_INSTRUCTION_ID),
       .NUM_BITS_X(NUM_BITS_X),
       .NUM_BITS_Y(NUM_BITS_Y)
   ) ft (
@@ -104,16 +145,25 @@ module pipeline #(
       .featureValid(featureValidCamDomain),
       .featureVector(featureVectorCamDomain),
       .cameraVsync(vsyncBin),  // low active!
+      .sensorMode(sensorMode),
       // sys domain
       .systemClock(systemClock),
       // spi
       .spiSck(spiSck),
       .spiMosi(spiMosi),
       .spiMiso(spiMiso),
-      .spiTransferDone(spiTransferDone)
+      .spiTransferDone(spiTransferDone),
+      // ci
+      .ciStart(ciStart),
+      .ciCke(ciCke),
+      .ciN(ciN),
+      .ciValueA(ciValueA),
+      .ciValueB(ciValueB),
+      .ciResult(ciResultTransfer),
+      .ciDone(ciDoneTransfer)
   );
 
-  assign ciResult = ciResultBinarize;
-  assign ciDone = ciDoneBinarize;
+  assign ciResult = ciResultBinarize | ciResultGeometry | ciResultTransfer;
+  assign ciDone = ciDoneBinarize | ciDoneGeometry | ciDoneTransfer;
 
 endmodule
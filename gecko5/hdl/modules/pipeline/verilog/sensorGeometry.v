@@ -0,0 +1,113 @@
+module sensorGeometry #(
+    parameter [7:0] CUSTOM_INSTRUCTION_ID = 'd0,
+    parameter integer unsigned MAX_WIDTH = 1280,
+    parameter integer unsigned MAX_HEIGHT = 800,
+    parameter integer unsigned NUM_BITS_X = $clog2(MAX_WIDTH),
+    parameter integer unsigned NUM_BITS_Y = $clog2(MAX_HEIGHT),
+    parameter [7:0] DEFAULT_MODE = 'd1  // 1280x800 72 fps, mode selected by the vision add-on on boot
+) (
+    input wire reset,
+    // camera domain
+    input wire pixelClock,
+    input wire frameStart,  // geometry is applied on this pulse only
+    output reg [NUM_BITS_X-1:0] xLast,  // width - 1
+    output reg [NUM_BITS_Y-1:0] yLast,  // height - 1
+    output reg [7:0] mode,
+    // system domain
+    input wire systemClock,
+    // ci
+    input wire ciStart,
+    input wire ciCke,
+    input wire [7:0] ciN,
+    input wire [31:0] ciValueA,
+    input wire [31:0] ciValueB,
+    output wire [31:0] ciResult,
+    output wire ciDone
+);
+  /*
+   * CUSTOM INSTRUCTION
+   *
+   * different ci commands:
+   * ciValueA:    Description:
+   *     0        Read requested geometry (ciResult, same layout as write)
+   *     1        Write geometry (ciValueB[11:0] width, ciValueB[23:12] height, ciValueB[31:24] sensor mode)
+   *
+   * The sensor mode is not interpreted, it is forwarded to the feature packet header so the receiver knows the
+   * active geometry. A write is applied at the next frame start, writes exceeding MAX_WIDTH / MAX_HEIGHT or
+   * smaller than MIN_WIDTH / MIN_HEIGHT are ignored.
+   *
+   */
+  localparam CI_A_READ_GEOMETRY = 0;
+  localparam CI_A_WRITE_GEOMETRY = 1;
+
+  localparam integer unsigned MIN_WIDTH = 4;  // the cca window and row buffers need at least 4 columns
+  localparam integer unsigned MIN_HEIGHT = 2;
+
+  wire isMyCi = (ciN == CUSTOM_INSTRUCTION_ID) ? ciStart & ciCke : 'b0;
+
+  wire [11:0] ciWidth = ciValueB[11:0];
+  wire [11:0] ciHeight = ciValueB[23:12];
+  wire [7:0] ciMode = ciValueB[31:24];
+  wire ciGeometryValid = (ciWidth >= MIN_WIDTH) && (ciWidth <= MAX_WIDTH) && (ciHeight >= MIN_HEIGHT) && (ciHeight <= MAX_HEIGHT);
+  wire isWrite = (isMyCi == 'b1) && (ciValueA[0] == CI_A_WRITE_GEOMETRY) && ciGeometryValid;
+
+  reg [11:0] requestedWidth;
+  reg [11:0] requestedHeight;
+  reg [7:0] requestedMode;
+
+  always @(posedge systemClock) begin
+    if (reset) begin
+      requestedWidth <= MAX_WIDTH;
+      requestedHeight <= MAX_HEIGHT;
+      requestedMode <= DEFAULT_MODE;
+    end else if (isWrite) begin
+      requestedWidth <= ciWidth;
+      requestedHeight <= ciHeight;
+      requestedMode <= ciMode;
+    end
+  end
+
+  reg [31:0] selectedResult = 'd0; // intentionally set to 0 since process does not define a reset value
+
+  assign ciDone   = isMyCi;
+  assign ciResult = (isMyCi == 'b0) ? 'd0 : selectedResult;
+
+  always @(*) begin
+    case (ciValueA)
+      CI_A_READ_GEOMETRY: selectedResult <= {requestedMode, requestedHeight, requestedWidth};
+      default: selectedResult <= 'd0;
+    endcase
+  end
+
+  // crossing from system clock to pixel clock domain
+  // the requested registers are quasi static, they are stable long before the pending flag is seen in the camera domain
+  wire updatePixelDomain;
+  synchroFlop updateCrossing (
+      .clockIn(systemClock),
+      .clockOut(pixelClock),
+      .reset(reset),
+      .D(isWrite),
+      .Q(updatePixelDomain)
+  );
+
+  reg pending;
+  always @(posedge pixelClock, posedge reset) begin
+    if (reset) begin
+      pending <= 'b0;
+      xLast <= MAX_WIDTH - 1;
+      yLast <= MAX_HEIGHT - 1;
+      mode <= DEFAULT_MODE;
+    end else if (frameStart) begin
+      // a write arriving in the same cycle as the frame start is applied one frame later
+      pending <= updatePixelDomain;
+      if (pending) begin
+        xLast <= requestedWidth[NUM_BITS_X-1:0] - 'd1;
+        yLast <= requestedHeight[NUM_BITS_Y-1:0] - 'd1;
+        mode <= requestedMode;
+      end
+    end else if (updatePixelDomain) begin
+      pending <= 'b1;
+    end
+  end
+
+endmodule
@@ -0,0 +1,18 @@
+#ifndef FEATURETRANSFER_H_INCLUDED
+#define FEATURETRANSFER_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void featureTransferSetStreaming(bool enable);
+bool featureTransferGetStreaming();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEATURETRANSFER_H_INCLUDED */
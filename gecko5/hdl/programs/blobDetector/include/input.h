@@ -12,6 +12,8 @@ static const int INPUT_OPTION_OUTPUT_ERROR = -2;
 static const int INPUT_OPTION_THRESHOLD_ERROR = -3;
 static const int INPUT_OPTION_FRAME_TRANSFER_ERROR = -4;
 static const int INPUT_OPTION_STROBE_CONTROL_ERROR = -5;
+static const int INPUT_OPTION_GEOMETRY_ERROR = -6;
+static const int INPUT_OPTION_FEATURE_TRANSFER_ERROR = -7;
 static const int INPUT_OPTION_UNKNOWN = -255;
 
 int handle_input(char *uartBase);
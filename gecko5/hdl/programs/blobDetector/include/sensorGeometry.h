@@ -0,0 +1,20 @@
+#ifndef SENSORGEOMETRY_H_INCLUDED
+#define SENSORGEOMETRY_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool sensorGeometrySet(uint32_t width, uint32_t height, uint32_t mode);
+uint32_t sensorGeometryGetWidth();
+uint32_t sensorGeometryGetHeight();
+uint32_t sensorGeometryGetMode();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSORGEOMETRY_H_INCLUDED */
@@ -0,0 +1,15 @@
+#include "featureTransfer.h"
+
+// feature transfer ci, refer to featureTransferSpi.v
+static const int CI_TRANSFER_A_READ_MODE = 0;
+static const int CI_TRANSFER_A_WRITE_MODE = 1;
+
+void featureTransferSetStreaming(bool enable){
+  asm volatile ("l.nios_rrr r0,%[ra],%[rb],0xF"::[ra]"r"(CI_TRANSFER_A_WRITE_MODE),[rb]"r"(enable));
+}
+
+bool featureTransferGetStreaming(){
+  uint32_t mode;
+  asm volatile ("l.nios_rrr %[res],%[ra],r0,0xF":[res]"=r"(mode):[ra]"r"(CI_TRANSFER_A_READ_MODE));
+  return (mode & 1) != 0;
+}
@@ -7,6 +7,8 @@
 #include "input.h"
 #include "binarize.h"
 #include "cameraSelector.h"
+#include "featureTransfer.h"
+#include "sensorGeometry.h"
 #include "strobeControl.h"
 #include "myLib.h"
 
@@ -46,6 +48,22 @@ bool parse_bool(char b, bool* parsed){
   return false;
 }
 
+// terminates str at the first separator, returns the remainder or NULL if there is no separator before ASCII_LF or ASCII_NUL
+char* split(char *str, char separator)
+{
+  const char ASCII_NUL = 0; // '\0'
+  const char ASCII_LF = 10;
+  for (int i = 0; (str[i] != ASCII_LF) && (str[i] != ASCII_NUL); ++i)
+  {
+    if (str[i] == separator)
+    {
+      str[i] = ASCII_NUL;
+      return &str[i + 1];
+    }
+  }
+  return NULL;
+}
+
 const char HELP_TEXT_HELP[] =
     "help text - 'h'\n"
     "  h - print help text\n";
@@ -71,6 +89,15 @@ const char HELP_TEXT_STROBE_CONTROL[] =
     "  sc<enable> - enable/disable constant output\n"
     "  <enable>: [0-1], 0=disable, 1=enable\n"
     "  <value>: [0-2^32-1]\n";
+const char HELP_TEXT_GEOMETRY[] =
+    "pipeline geometry - 'g'\n"
+    "  g<width>,<height>,<mode> - process <width>x<height> px per frame, applied on the next frame\n"
+    "  <width>: [4-1280], <height>: [2-800]\n"
+    "  <mode>: [0-255], sensor mode reported in the feature packet header\n";
+const char HELP_TEXT_FEATURE_TRANSFER[] =
+    "feature transfer - 'f'\n"
+    "  f<enable> - stream the features in chunks while the frame is processed, applied on the next frame\n"
+    "  <enable>: [0-1], 0=one packet per frame, 1=streaming\n";
 
 int handle_input(char* uartBase)
 {
@@ -203,6 +230,38 @@ int handle_input(char* uartBase)
     }
     break;
   }
+  case 'g':
+  {
+    int width = 0;
+    int height = 0;
+    int mode = 0;
+    char *heightString = split(&inputString[1], ',');
+    char *modeString = (heightString != NULL) ? split(heightString, ',') : NULL;
+    if ((modeString == NULL) || !myAtoi(&inputString[1], &width) || !myAtoi(heightString, &height) || !myAtoi(modeString, &mode)
+        || (width < 0) || (height < 0) || (mode < 0) || !sensorGeometrySet(width, height, mode))
+    {
+      uart_rx_flush(uartBase);
+      printf("invalid geometry\n");
+      printf(HELP_TEXT_GEOMETRY);
+      return INPUT_OPTION_GEOMETRY_ERROR;
+    }
+    printf("geometry set to : %dx%d, mode %d\n", sensorGeometryGetWidth(), sensorGeometryGetHeight(), sensorGeometryGetMode());
+  }
+  break;
+  case 'f':
+  {
+    bool streaming = false;
+    if (!parse_bool(inputString[1], &streaming))
+    {
+      uart_rx_flush(uartBase);
+      printf("unknown argument\n");
+      printf(HELP_TEXT_FEATURE_TRANSFER);
+      return INPUT_OPTION_FEATURE_TRANSFER_ERROR;
+    }
+    featureTransferSetStreaming(streaming);
+    printf("streaming set to : %d\n", featureTransferGetStreaming());
+  }
+  break;
   case 'h':
   {
     printf(HELP_TEXT_HELP);
@@ -210,6 +269,8 @@ int handle_input(char* uartBase)
     printf(HELP_TEXT_OUTPUT);
     printf(HELP_TEXT_BIN_THRESHOLD);
     printf(HELP_TEXT_STROBE_CONTROL);
+    printf(HELP_TEXT_GEOMETRY);
+    printf(HELP_TEXT_FEATURE_TRANSFER);
   }
   break;
   default:
@@ -0,0 +1,44 @@
+#include "sensorGeometry.h"
+
+// sensor geometry ci
+static const int CI_GEOMETRY_A_READ = 0;
+static const int CI_GEOMETRY_A_WRITE = 1;
+
+// refer to sensorGeometry.v
+static const uint32_t WIDTH_MIN = 4;
+static const uint32_t WIDTH_MAX = 1280;
+static const uint32_t HEIGHT_MIN = 2;
+static const uint32_t HEIGHT_MAX = 800;
+static const uint32_t MODE_MAX = 0xff;
+static const uint32_t OFFSET_WIDTH = 0;
+static const uint32_t OFFSET_HEIGHT = 12;
+static const uint32_t OFFSET_MODE = 24;
+static const uint32_t MASK_SIZE = 0xfff;
+static const uint32_t MASK_MODE = 0xff;
+
+bool sensorGeometrySet(uint32_t width, uint32_t height, uint32_t mode){
+  if ((width < WIDTH_MIN) || (width > WIDTH_MAX) || (height < HEIGHT_MIN) || (height > HEIGHT_MAX) || (mode > MODE_MAX)) {
+    return false;
+  }
+  uint32_t geometry = (width << OFFSET_WIDTH) | (height << OFFSET_HEIGHT) | (mode << OFFSET_MODE);
+  asm volatile ("l.nios_rrr r0,%[ra],%[rb],0xD"::[ra]"r"(CI_GEOMETRY_A_WRITE),[rb]"r"(geometry));
+  return true;
+}
+
+static uint32_t sensorGeometryGet(){
+  uint32_t geometry;
+  asm volatile ("l.nios_rrr %[res],%[ra],r0,0xD":[res]"=r"(geometry):[ra]"r"(CI_GEOMETRY_A_READ));
+  return geometry;
+}
+
+uint32_t sensorGeometryGetWidth(){
+  return (sensorGeometryGet() >> OFFSET_WIDTH) & MASK_SIZE;
+}
+
+uint32_t sensorGeometryGetHeight(){
+  return (sensorGeometryGet() >> OFFSET_HEIGHT) & MASK_SIZE;
+}
+
+uint32_t sensorGeometryGetMode(){
+  return (sensorGeometryGet() >> OFFSET_MODE) & MASK_MODE;
+}
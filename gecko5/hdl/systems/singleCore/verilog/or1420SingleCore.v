@@ -418,6 +418,8 @@ module or1420SingleCore (
 
   pipeline #(
       .BINARIZE_CUSTOM_INSTRUCTION_ID(8'd11),
+      .GEOMETRY_CUSTOM_INSTRUCTION_ID(8'd13),
+      .TRANSFER_CUSTOM_INSTRUCTION_ID(8'd15),
   ) blobDetector (
       .reset(s_reset),
       .pixelClock(camPclk),
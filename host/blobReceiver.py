@@ -4,6 +4,7 @@ import logging
 import math
 import queue
 import socket
+import struct
 import threading
 import time
 import typing
@@ -12,6 +13,8 @@ from pathlib import Path
 
 import click
 
+import deltaDecoder
+
 logging.basicConfig(
     level=logging.INFO, style="{", format="[{threadName} ({thread})] {message}"
 )
@@ -41,6 +44,33 @@ class BlobReceiver(asyncio.DatagramProtocol):
             FEATURE_WIDTH / 8.0
         )
         self._ip_to_previous_frame_count: typing.Dict[IPv4Address, int] = {}
+        # tracked packets only: (track id, velocity x, velocity y, confidence) per coordinate of the latest packet,
+        # velocity in 1/4 px of the sensor mode per frame, see trackedFeaturePacket.md in the vision add-on firmware
+        self.tracks: typing.Dict[IPv4Address, typing.List[typing.Tuple[int, int, int, int]]] = {}
+        self._PACKET_FORMAT_RAW: typing.Final[int] = 0x0
+        self._PACKET_FORMAT_TRACKED: typing.Final[int] = 0x1
+        # streamed frames arrive as raw chunks, the coordinates are collected until the last chunk of the frame
+        self._PACKET_FORMAT_CHUNK: typing.Final[int] = 0x3
+        self._PACKET_FORMAT_CHUNK_LAST: typing.Final[int] = 0x4
+        self._ip_to_chunked_frame: typing.Dict[IPv4Address, typing.Tuple[int, typing.List[typing.Tuple[int, int, int, int]]]] = {}
+        self._BYTES_TRACK: typing.Final[int] = 5  # track id U16, velocity x I8, velocity y I8, confidence U8
+        # tracked packets with blink decoding only: coordinate index -> marker id (index into the code book)
+        self.markers: typing.Dict[IPv4Address, typing.Dict[int, int]] = {}
+        self._BYTES_MARKER: typing.Final[int] = 2  # feature index U8, marker id U8
+        # packets with time trailer only: synchronised receive time of the latest packet in us, see network_time_sync_set_config
+        self.times: typing.Dict[IPv4Address, int] = {}
+        self._TIME_TRAILER_FLAG: typing.Final[int] = 0x80  # in the sensor mode byte
+        self._BYTES_TIME: typing.Final[int] = 8  # U64
+        # delta packets reference the previous packet of the same device
+        self._ip_to_delta_decoder: typing.Dict[IPv4Address, deltaDecoder.DeltaDecoder] = {}
+        # sensor mode -> (binning, offset x, offset y), must match SENSOR_MODES in the vision add-on firmware
+        self._SENSOR_MODES: typing.Final[typing.Dict[int, typing.Tuple[int, int, int]]] = {
+            0: (1, 0, 0),  # 1280x800 13 fps
+            1: (1, 0, 0),  # 1280x800 72 fps
+            2: (2, 0, 0),  # 640x400 144 fps, binned
+            3: (1, 320, 200),  # 640x400 144 fps, center window
+            4: (1, 320, 300),  # 640x200 240 fps, center window
+        }
 
         if record_to is not None:
             self._file_queue: queue.Queue = queue.Queue(maxsize=1000)
@@ -57,31 +87,102 @@ class BlobReceiver(asyncio.DatagramProtocol):
 
     def _get_coords(
         self, ip: IPv4Address, data: bytes
-    ) -> typing.List[typing.Tuple[int, int, int, int]]:
+    ) -> typing.Optional[typing.List[typing.Tuple[int, int, int, int]]]:
+        """coordinates of the packet, None for a chunk which is not the last of its frame"""
         OFFSET_FRAME_COUNT: typing.Final[int] = 0
         SIZE_FRAME_COUNT: typing.Final[int] = 1
         OFFSET_LENGTH: typing.Final[int] = OFFSET_FRAME_COUNT + SIZE_FRAME_COUNT
         SIZE_LENGTH: typing.Final[int] = 1
-        OFFSET_FEATURES: typing.Final[int] = OFFSET_LENGTH + SIZE_LENGTH
+        OFFSET_SENSOR_MODE: typing.Final[int] = OFFSET_LENGTH + SIZE_LENGTH
+        SIZE_SENSOR_MODE: typing.Final[int] = 1
+        OFFSET_FEATURES: typing.Final[int] = OFFSET_SENSOR_MODE + SIZE_SENSOR_MODE
+
+        if len(data) > OFFSET_SENSOR_MODE and data[OFFSET_SENSOR_MODE] & self._TIME_TRAILER_FLAG:
+            # time trailer, appended after everything else, stripped together with its flag
+            if len(data) < OFFSET_FEATURES + self._BYTES_TIME:
+                raise ValueError
+            (self.times[ip],) = struct.unpack_from("<Q", data, len(data) - self._BYTES_TIME)
+            mode_format_unstamped = data[OFFSET_SENSOR_MODE] & ~self._TIME_TRAILER_FLAG
+            data = data[:OFFSET_SENSOR_MODE] + bytes([mode_format_unstamped]) + data[OFFSET_FEATURES : -self._BYTES_TIME]
+        else:
+            self.times.pop(ip, None)
 
         frame_count: typing.Final[int] = int.from_bytes(
             data[OFFSET_FRAME_COUNT : OFFSET_FRAME_COUNT + SIZE_FRAME_COUNT], "little"
         )
-        if ip not in self._ip_to_previous_frame_count:
-            self._ip_to_previous_frame_count[ip] = frame_count
-            logging.info(f"new device found: {ip}")
-        elif abs(frame_count - self._ip_to_previous_frame_count[ip]) not in (1, 255):
-            logging.error(
-                f"missed at least one frame! (from {self._ip_to_previous_frame_count[ip]} to {frame_count})"
-            )
+        chunk_format: typing.Final[typing.Optional[int]] = (
+            data[OFFSET_SENSOR_MODE] >> 4
+            if len(data) > OFFSET_SENSOR_MODE
+            and data[OFFSET_SENSOR_MODE] >> 4 in (self._PACKET_FORMAT_CHUNK, self._PACKET_FORMAT_CHUNK_LAST)
+            else None
+        )
+        chunked_frame = self._ip_to_chunked_frame.get(ip)
+        if chunked_frame is not None and (chunk_format is None or chunked_frame[0] != frame_count):
+            logging.warning(f"last chunk of frame {chunked_frame[0]} lost, dropping the frame")
+            del self._ip_to_chunked_frame[ip]
+            chunked_frame = None
+        if chunk_format is not None:
+            # parsed as a raw packet
+            data = data[:OFFSET_SENSOR_MODE] + bytes([data[OFFSET_SENSOR_MODE] & 0x0F]) + data[OFFSET_FEATURES:]
+        if chunked_frame is None:  # the following chunks of a frame carry the same frame count
+            if ip not in self._ip_to_previous_frame_count:
+                self._ip_to_previous_frame_count[ip] = frame_count
+                logging.info(f"new device found: {ip}")
+            elif abs(frame_count - self._ip_to_previous_frame_count[ip]) not in (1, 255):
+                logging.error(
+                    f"missed at least one frame! (from {self._ip_to_previous_frame_count[ip]} to {frame_count})"
+                )
         self._ip_to_previous_frame_count[ip] = frame_count
 
+        if (
+            len(data) > OFFSET_SENSOR_MODE
+            and data[OFFSET_SENSOR_MODE] >> 4 == deltaDecoder.PACKET_FORMAT_DELTA
+        ):
+            # decoded into the equivalent tracked packet, dropped while waiting for a keyframe
+            decoded = self._ip_to_delta_decoder.setdefault(ip, deltaDecoder.DeltaDecoder()).decode(
+                data
+            )
+            if decoded is None:
+                raise ValueError
+            data = decoded
+
         number_of_features: typing.Final[int] = int.from_bytes(
             data[OFFSET_LENGTH : OFFSET_LENGTH + SIZE_LENGTH], "little"
         )
 
-        if number_of_features != ((len(data) - SIZE_FRAME_COUNT - SIZE_LENGTH) / self._BYTES_PADDED_FEATURE_VECTOR):
+        mode_format: typing.Final[int] = int.from_bytes(
+            data[OFFSET_SENSOR_MODE : OFFSET_SENSOR_MODE + SIZE_SENSOR_MODE], "little"
+        )
+        # the packet format is carried in the upper nibble of the sensor mode byte
+        packet_format: typing.Final[int] = mode_format >> 4
+        sensor_mode: typing.Final[int] = mode_format & 0x0F
+        if packet_format == self._PACKET_FORMAT_RAW:
+            feature_size = self._BYTES_PADDED_FEATURE_VECTOR
+        elif packet_format == self._PACKET_FORMAT_TRACKED:
+            feature_size = self._BYTES_PADDED_FEATURE_VECTOR + self._BYTES_TRACK
+        else:
+            raise ValueError
+
+        offset_trailer: typing.Final[int] = OFFSET_FEATURES + number_of_features * feature_size
+        markers: typing.Dict[int, int] = {}
+        if packet_format == self._PACKET_FORMAT_TRACKED and len(data) > offset_trailer:
+            # marker trailer appended by the blink decoder: count followed by (feature index, marker id)
+            number_of_markers = data[offset_trailer]
+            if len(data) != offset_trailer + 1 + number_of_markers * self._BYTES_MARKER:
+                raise ValueError
+            for i in range(number_of_markers):
+                feature_index, marker_id = struct.unpack_from(
+                    "<BB", data, offset_trailer + 1 + i * self._BYTES_MARKER
+                )
+                if feature_index >= number_of_features:
+                    raise ValueError
+                markers[feature_index] = marker_id
+        elif len(data) != offset_trailer:
+            raise ValueError
+
+        if sensor_mode not in self._SENSOR_MODES:
             raise ValueError
+        binning, offset_x, offset_y = self._SENSOR_MODES[sensor_mode]
 
         OFFSET_Y_MAX: typing.Final[int] = 0
         OFFSET_Y_MIN: typing.Final[int] = OFFSET_Y_MAX + self._BITS_Y
@@ -92,26 +193,47 @@ class BlobReceiver(asyncio.DatagramProtocol):
         MASK_Y: typing.Final[int] = (1 << self._BITS_Y) - 1
 
         vecs_int = []
+        tracks = []
         for i in range(0, number_of_features):
-            offset_current_feature_vector = (
-                OFFSET_FEATURES + i * self._BYTES_PADDED_FEATURE_VECTOR
-            )
+            offset_current_feature_vector = OFFSET_FEATURES + i * feature_size
             padded_feature_vector = int.from_bytes(
                 data[
                     offset_current_feature_vector : offset_current_feature_vector
                     + self._BYTES_PADDED_FEATURE_VECTOR
-                    + 1
                 ],
                 "little",
             )
+            if packet_format == self._PACKET_FORMAT_TRACKED:
+                offset_track = (
+                    offset_current_feature_vector + self._BYTES_PADDED_FEATURE_VECTOR
+                )
+                tracks.append(struct.unpack_from("<HbbB", data, offset_track))
             x_min = (padded_feature_vector >> OFFSET_X_MIN) & MASK_X
             x_max = (padded_feature_vector >> OFFSET_X_MAX) & MASK_X
             y_min = (padded_feature_vector >> OFFSET_Y_MIN) & MASK_Y
             y_max = (padded_feature_vector >> OFFSET_Y_MAX) & MASK_Y
+            # convert to full resolution px, a binned px covers binning x binning full resolution px
+            x_min = x_min * binning + offset_x
+            x_max = x_max * binning + binning - 1 + offset_x
+            y_min = y_min * binning + offset_y
+            y_max = y_max * binning + binning - 1 + offset_y
             logging.debug(
                 f"x_min: {x_min}, x_max: {x_max}, y_min: {y_min}, y_max: {y_max}"
             )
             vecs_int.append((x_min, x_max, y_min, y_max))
+        if packet_format == self._PACKET_FORMAT_TRACKED:
+            self.tracks[ip] = tracks
+            self.markers[ip] = markers
+        else:
+            self.tracks.pop(ip, None)
+            self.markers.pop(ip, None)
+        if chunk_format is not None:
+            _, vecs_frame = self._ip_to_chunked_frame.setdefault(ip, (frame_count, []))
+            vecs_frame.extend(vecs_int)
+            if chunk_format != self._PACKET_FORMAT_CHUNK_LAST:
+                return None
+            del self._ip_to_chunked_frame[ip]
+            return vecs_frame
         return vecs_int
 
     def connection_made(  # type: ignore[override]
@@ -152,6 +274,8 @@ class BlobReceiver(asyncio.DatagramProtocol):
         except ValueError:
             logging.warning("Invalid data format, dropping message")
             return
+        if coords is None:
+            return
 
         try:
             self._coordinates_queue.put_nowait((ip, coords))
@@ -0,0 +1,49 @@
+import logging
+import time
+
+import click
+
+from commandSender import BootPhase, CommandSender, SdramRegion
+
+
+# Prints when each boot phase was reached, time to first blob included, and the result of the background SDRAM test.
+# With --sdram-test the pattern test is run on a region first, disable the frame history or the recorder beforehand.
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option(
+    "--sdram-test",
+    type=click.Choice([region.name.lower() for region in SdramRegion]),
+    default=None,
+    help="run the sdram pattern test on a region",
+)
+def main(ip, sdram_test) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    if sdram_test is not None:
+        assert command_sender.sdram_test_start(SdramRegion[sdram_test.upper()]), "sdram test refused"
+        time.sleep(0.1)
+
+    timeline = command_sender.boot_timeline_get()
+    assert timeline is not None, "boot timeline failed"
+    previous = 0
+    for phase in BootPhase:
+        ms = timeline.ms.get(phase)
+        if ms is None:
+            click.echo(f"{phase.name.lower():<16} not reached")
+            continue
+        click.echo(f"{phase.name.lower():<16} {ms:>7} ms  (+{ms - previous} ms)")
+        previous = max(previous, ms)
+
+    state = command_sender.sdram_test_get_state()
+    while state is not None and state.running:
+        time.sleep(0.2)
+        state = command_sender.sdram_test_get_state()
+    assert state is not None, "sdram test state failed"
+    click.echo(
+        f"sdram test {state.region.name.lower()}: {state.bytes_verified} bytes verified in {state.duration_ms} ms,"
+        f" {state.errors} errors" + (f", first @ {state.first_error_address:#010x}" if state.errors > 0 else "")
+    )
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
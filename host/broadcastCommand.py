@@ -0,0 +1,106 @@
+import logging
+import socket
+import struct
+from dataclasses import dataclass
+from typing import Dict, Optional
+
+import click
+
+from commandPacket import CommandPacket
+from commandSender import BroadcastTiming, CommandIds, CompletionStatus
+
+PORT_COMMAND_BROADCAST = 1061
+SCHEDULE_FORMAT = "<BB"  # timing, frame count
+ACK_FORMAT = "<BB"  # timing, frame count
+ACK_SIZE = struct.calcsize(ACK_FORMAT)
+
+
+@dataclass
+class BroadcastReply:
+    timing: BroadcastTiming
+    frame_count: int  # of the last feature packet when the command was applied
+    success: bool
+    data: bytes
+
+
+class BroadcastCommandSender:
+    """One command datagram to every vision add-on on the subnet, see "broadcast commands" in App/command/commands.md
+
+    The frame counts of the devices only line up if their frame counters do, e.g. with a common trigger.
+    """
+
+    def __init__(self, broadcast_ip: str = "10.0.0.255"):
+        self._broadcast_ip = broadcast_ip
+        self._logger = logging.getLogger("BroadcastCommandSender")
+
+    def send(
+        self,
+        command: CommandPacket,
+        frame_count: Optional[int] = None,
+        devices: Optional[int] = None,
+        timeout_s: float = 2.0,
+    ) -> Dict[str, BroadcastReply]:
+        """send a command, applied on reception or after the feature packet of frame_count
+
+        Args:
+            frame_count (int): 8 bit frame count of the feature packets, at most 127 frames ahead, None applies on reception
+            devices (int): stop waiting for replies after this many, None waits for the timeout
+        Returns:
+            replies by device ip
+        """
+        timing = BroadcastTiming.IMMEDIATE if frame_count is None else BroadcastTiming.ON_FRAME
+        datagram = struct.pack(SCHEDULE_FORMAT, timing.value, frame_count or 0) + command.serialize()
+        replies = {}
+        with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_BROADCAST, 1)
+            sock.settimeout(timeout_s)
+            sock.sendto(datagram, (self._broadcast_ip, PORT_COMMAND_BROADCAST))
+            while devices is None or len(replies) < devices:
+                try:
+                    data, (ip, _) = sock.recvfrom(1024)
+                except socket.timeout:
+                    break
+                ack_timing, ack_frame_count = struct.unpack_from(ACK_FORMAT, data)
+                response = CommandPacket()
+                response.deserialize(data[ACK_SIZE:])
+                if response.command_id != command.command_id:
+                    self._logger.warning(f"{ip}: reply to command {response.command_id} ignored")
+                    continue
+                replies[ip] = BroadcastReply(
+                    BroadcastTiming(ack_timing),
+                    ack_frame_count,
+                    response.completion_status == CompletionStatus.COMPLETION_SUCCESS.value,
+                    response.data,
+                )
+        if devices is not None and len(replies) < devices:
+            self._logger.warning(f"{len(replies)} of {devices} devices replied")
+        return replies
+
+
+# Sets the binarization threshold of every device on the subnet in the same frame.
+# The target frame is --frames-ahead frames after the frame count reported by the first device.
+@click.command()
+@click.option("--broadcast-ip", default="10.0.0.255", help="broadcast address of the rig subnet")
+@click.option("--threshold", type=click.IntRange(0, 255), required=True, help="binarization threshold")
+@click.option("--frames-ahead", type=click.IntRange(1, 127), default=16, help="frames until the threshold applies")
+@click.option("--devices", type=int, default=None, help="number of devices in the rig")
+def main(broadcast_ip, threshold, frames_ahead, devices) -> None:
+    sender = BroadcastCommandSender(broadcast_ip)
+    probe = sender.send(CommandPacket(request_id=1, command_id=CommandIds.BOOT_TIMELINE_GET.value), devices=devices)
+    assert len(probe) > 0, "no device replied"
+    frame_count = (next(iter(probe.values())).frame_count + frames_ahead) % 256
+    command = CommandPacket(
+        request_id=2,
+        command_id=CommandIds.PIPELINE_SET_BINARIZATION_THRESHOLD.value,
+        data=bytearray(struct.pack("<B", threshold)),
+    )
+    replies = sender.send(command, frame_count=frame_count, devices=devices)
+    for ip, reply in sorted(replies.items()):
+        click.echo(
+            f"{ip:<15} {'ok' if reply.success else 'FAILED':<6} {reply.timing.name.lower():<9} frame {reply.frame_count}"
+        )
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
@@ -2,8 +2,9 @@ import ipaddress
 import logging
 import socket
 import struct
+from dataclasses import dataclass
 from enum import Enum
-from typing import Optional, Tuple
+from typing import ClassVar, List, Optional, Tuple
 
 import numpy as np
 
@@ -18,15 +19,34 @@ class CommandIds(Enum):
     NACK = 0x00
     ACK = 0x01
     LOG_SET_LEVEL = 0x10
+    INTERRUPT_GET_STATS = 0x11
+    METRICS_GET = 0x12
+    TASK_PROFILE_GET = 0x13
+    MEMORY_BENCHMARK_RUN = 0x14
+    IMAGE_KERNEL_BENCHMARK_RUN = 0x15
+    BOOT_TIMELINE_GET = 0x16
+    SDRAM_TEST_START = 0x17
+    SDRAM_TEST_GET_STATE = 0x18
     CAMERA_REQUEST_CAPTURE = 0x20
     CAMERA_REQUEST_TRANSFER = 0x21
     CAMERA_SET_WHITE_BALANCE = 0x22
     CAMERA_SET_EXPOSURE = 0x23
     CAMERA_SET_GAIN = 0x24
     CAMERA_SET_FPS = 0x25
+    CAMERA_SET_MODE = 0x26
+    CAMERA_GET_MODE = 0x27
+    CAMERA_SET_PREVIEW = 0x28
+    CAMERA_GET_PREVIEW = 0x29
     NETWORK_GET_CONFIG = 0x30
     NETWORK_SET_CONFIG = 0x31
     NETWORK_PERSIST_CONFIG = 0x32
+    NETWORK_BENCHMARK_START = 0x33
+    NETWORK_BENCHMARK_GET_RESULT = 0x34
+    NETWORK_SUBSCRIBE = 0x35
+    NETWORK_UNSUBSCRIBE = 0x36
+    NETWORK_GET_SUBSCRIBERS = 0x37
+    NETWORK_TIME_SYNC_SET_CONFIG = 0x38
+    NETWORK_TIME_SYNC_GET_STATE = 0x39
     CALIBRATION_LOAD_CAMERA_MATRIX = 0x40
     CALIBRATION_STORE_CAMERA_MATRIX = 0x41
     CALIBRATION_LOAD_DISTORTION_COEFFICIENTS = 0x42
@@ -35,13 +55,34 @@ class CommandIds(Enum):
     CALIBRATION_STORE_ROTATION_MATRIX = 0x45
     CALIBRATION_LOAD_TRANSLATION_VECTOR = 0x46
     CALIBRATION_STORE_TRANSLATION_VECTOR = 0x47
+    CALIBRATION_GET_STATUS = 0x48
     PIPELINE_SET_INPUT = 0x50
     PIPELINE_SET_OUTPUT = 0x51
     PIPELINE_SET_BINARIZATION_THRESHOLD = 0x52
+    PIPELINE_GET_STREAM_STATS = 0x53
+    PIPELINE_SET_TRANSPORT = 0x54
+    PIPELINE_SET_TRACKING = 0x55
+    PIPELINE_GET_TRACKING = 0x56
+    PIPELINE_SET_BLINK_CODES = 0x57
+    PIPELINE_GET_BLINK_CODES = 0x58
+    PIPELINE_SET_DELTA_ENCODING = 0x59
+    PIPELINE_GET_DELTA_ENCODING = 0x5A
+    PIPELINE_SET_STREAMING = 0x5B
     STROBE_ENABLE_PULSE = 0x60
     STROBE_SET_ON_DELAY = 0x61
     STROBE_SET_HOLD_TIME = 0x62
     STROBE_ENABLE_CONSTANT = 0x63
+    AUTO_EXPOSURE_ENABLE = 0x70
+    AUTO_EXPOSURE_SET_CONFIG = 0x71
+    AUTO_EXPOSURE_GET_CONFIG = 0x72
+    AUTO_EXPOSURE_GET_STATE = 0x73
+    RECORDER_SET_CONFIG = 0x80
+    RECORDER_GET_STATE = 0x81
+    RECORDER_FETCH = 0x82
+    FRAME_HISTORY_SET_CONFIG = 0x90
+    FRAME_HISTORY_GET_STATE = 0x91
+    FRAME_HISTORY_TRIGGER = 0x92
+    FRAME_HISTORY_TRANSFER = 0x93
     UNDEFINED = 0xFF
 
 
@@ -59,6 +100,78 @@ class LogLevel(Enum):
     ERROR = 4
 
 
+class InterruptSource(Enum):
+    EXTI = 0
+    UART_RX = 1
+
+
+class MetricId(Enum):
+    LINK_XMIT = 0
+    LINK_RECV = 1
+    LINK_DROP = 2
+    LINK_ERR = 3
+    UDP_XMIT = 4
+    UDP_RECV = 5
+    UDP_DROP = 6
+    TCP_XMIT = 7
+    TCP_RECV = 8
+    TCP_DROP = 9
+    MEM_USED = 10
+    MEM_USED_MAX = 11
+    MEM_ERRORS = 12
+    PBUF_POOL_USED = 13
+    PBUF_POOL_USED_MAX = 14
+    PBUF_POOL_ERRORS = 15
+    BLOB_POOL_USED_MAX = 16
+    BLOB_POOL_ERRORS = 17
+    BLOB_PACKETS_RECEIVED = 18
+    BLOB_PACKETS_CORRUPT = 19
+    BLOB_PACKETS_SENT = 20
+    BLOB_SEND_FAILURES = 21
+    BLOB_OVERRUNS = 22
+    EXTI_INTERRUPTS = 23
+    UART_RX_INTERRUPTS = 24
+    SPI_RX_QUEUE_DEPTH = 25
+    FRAME_STATISTICS_QUEUE_DEPTH = 26
+
+
+class MetricsPeripheral(Enum):
+    SPI = 0
+    DCMI = 1
+    UART = 2
+
+
+class MetricsTask(Enum):
+    NETWORK = 0
+    BLOB_DETECTOR = 1
+    CONTROL = 2
+    STATS = 3
+    TCPIP = 4
+    ETHERNET_INPUT = 5
+    ETHERNET_LINK = 6
+    IDLE = 7
+    TIMER = 8
+    PROFILER = 9
+
+
+class BenchmarkProtocol(Enum):
+    UDP = 0
+    TCP = 1
+
+
+class SubscriberStream(Enum):
+    BLOBS = 0
+    LOG = 1
+    FRAMES = 2
+    PREVIEW = 3
+
+
+class BlobTransport(Enum):
+    TCP_SOCKET = 0
+    UDP_SOCKET = 1
+    UDP_RAW = 2
+
+
 class PipelineInput(Enum):
     CAMERA = 0
     FAKE_STATIC = 1
@@ -75,6 +188,782 @@ class Fps(Enum):
     _72 = 1
 
 
+class SensorMode(Enum):
+    MODE_1280X800_13FPS = 0
+    MODE_1280X800_72FPS = 1
+    MODE_640X400_BINNED_144FPS = 2
+    MODE_640X400_WINDOW_144FPS = 3
+    MODE_640X200_WINDOW_240FPS = 4
+
+
+@dataclass
+class SensorModeInfo:
+    mode: SensorMode
+    width: int
+    height: int
+    offset_x: int
+    offset_y: int
+    binning: int
+    fps: int
+    frame_length: int
+
+    FORMAT: ClassVar[str] = "<BHHHHBHH"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "SensorModeInfo":
+        fields = list(struct.unpack(cls.FORMAT, data))
+        fields[0] = SensorMode(fields[0])
+        return cls(*fields)
+
+
+class AutoExposureAction(Enum):
+    NONE = 0x00
+    BRIGHTEN_EXPOSURE = 0x01
+    BRIGHTEN_GAIN = 0x02
+    BRIGHTEN_THRESHOLD = 0x03
+    DARKEN_EXPOSURE = 0x04
+    DARKEN_GAIN = 0x05
+    DARKEN_THRESHOLD = 0x06
+    LIMIT_REACHED = 0x07
+    FAILED = 0x08
+
+
+class RecorderRangeType(Enum):
+    FRAMES = 0x00
+    TIME_MS = 0x01
+
+
+class HistoryStatus(Enum):
+    OFF = 0x00
+    RECORDING = 0x01
+    TRIGGERED = 0x02
+    FROZEN = 0x03
+
+
+class HistoryTrigger(Enum):
+    NONE = 0x00
+    HOST = 0x01
+    BLOB_COUNT = 0x02
+    MARKER_LOST = 0x03
+
+
+class PreviewFilter(Enum):
+    DECIMATE = 0x00
+    BOX = 0x01
+
+
+class BootPhase(Enum):
+    PERIPHERALS = 0x00
+    SDRAM = 0x01
+    SCHEDULER = 0x02
+    NETWORK = 0x03
+    NETWORK_CONFIG = 0x04
+    COMMAND_HANDLER = 0x05
+    CAMERA = 0x06
+    FIRST_BLOB = 0x07
+    SDRAM_TEST = 0x08
+
+
+class SdramRegion(Enum):
+    FRAME_HISTORY = 0x00
+    RECORDER = 0x01
+
+
+class BroadcastTiming(Enum):
+    IMMEDIATE = 0x00  # applied on reception
+    ON_FRAME = 0x01  # applied right after the feature packet of the scheduled frame
+    LATE = 0x02  # scheduled frame already passed or its packet was lost, applied on reception or the next packet
+    TIMEOUT = 0x03  # scheduled frame not reached, applied on the timeout
+
+
+@dataclass
+class BlobTrackerConfig:
+    enabled: bool = False
+    gate_px: int = 16
+    coast_frames: int = 3
+
+    FORMAT: ClassVar[str] = "<?HB"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(self.FORMAT, self.enabled, self.gate_px, self.coast_frames)
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "BlobTrackerConfig":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class BlobTrackerState:
+    config: BlobTrackerConfig
+    active_tracks: int
+    tracks_created: int
+    cycles_last: int
+    cycles_max: int
+
+    FORMAT: ClassVar[str] = "<BLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "BlobTrackerState":
+        config_size = struct.calcsize(BlobTrackerConfig.FORMAT)
+        config = BlobTrackerConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class BlinkDecoderConfig:
+    CODES_MAX: ClassVar[int] = 16
+
+    enabled: bool = False
+    code_length: int = 8
+    confirm_frames: int = 2
+    codes: Tuple[int, ...] = ()  # bit 0 first, the marker id is the index
+
+    FORMAT: ClassVar[str] = "<?BBB16H"
+
+    def serialize(self) -> bytearray:
+        codes = list(self.codes) + [0] * (self.CODES_MAX - len(self.codes))
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.enabled,
+                self.code_length,
+                self.confirm_frames,
+                len(self.codes),
+                *codes,
+            )
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "BlinkDecoderConfig":
+        enabled, code_length, confirm_frames, code_count, *codes = struct.unpack(
+            cls.FORMAT, data
+        )
+        return cls(enabled, code_length, confirm_frames, tuple(codes[:code_count]))
+
+
+@dataclass
+class BlinkDecoderState:
+    config: BlinkDecoderConfig
+    watched_tracks: int
+    identified_tracks: int
+    cycles_last: int
+    cycles_max: int
+
+    FORMAT: ClassVar[str] = "<BBLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "BlinkDecoderState":
+        config_size = struct.calcsize(BlinkDecoderConfig.FORMAT)
+        config = BlinkDecoderConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class DeltaEncoderConfig:
+    enabled: bool = False
+    keyframe_interval: int = 30
+
+    FORMAT: ClassVar[str] = "<?B"
+
+    def serialize(self) -> bytearray:
+        return bytearray(struct.pack(self.FORMAT, self.enabled, self.keyframe_interval))
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "DeltaEncoderConfig":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class DeltaEncoderState:
+    config: DeltaEncoderConfig
+    keyframes: int
+    delta_frames: int
+    raw_bytes: int
+    encoded_bytes: int
+    cycles_last: int
+    cycles_max: int
+
+    FORMAT: ClassVar[str] = "<LLLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "DeltaEncoderState":
+        config_size = struct.calcsize(DeltaEncoderConfig.FORMAT)
+        config = DeltaEncoderConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class AutoExposureConfig:
+    blob_count_min: int = 2
+    blob_count_max: int = 8
+    blob_area_max: int = 400
+    exposure_min: int = 16
+    exposure_max: int = 880
+    gain_min: int = 0
+    gain_max: int = 16
+    threshold_min: int = 64
+    threshold_max: int = 240
+    settle_frames: int = 8
+
+    FORMAT: ClassVar[str] = "<BBHHHBBBBB"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.blob_count_min,
+                self.blob_count_max,
+                self.blob_area_max,
+                self.exposure_min,
+                self.exposure_max,
+                self.gain_min,
+                self.gain_max,
+                self.threshold_min,
+                self.threshold_max,
+                self.settle_frames,
+            )
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "AutoExposureConfig":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class AutoExposureState:
+    active: bool
+    last_action: AutoExposureAction
+    last_frame_count: int
+    mean_blob_count: int
+    mean_blob_area: int
+    exposure: int
+    gain: int
+    threshold: int
+    frames_processed: int
+    adjustments: int
+
+    FORMAT: ClassVar[str] = "<?BBBHHBBLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "AutoExposureState":
+        fields = list(struct.unpack(cls.FORMAT, data))
+        fields[1] = AutoExposureAction(fields[1])
+        return cls(*fields)
+
+
+@dataclass
+class RecorderConfig:
+    enabled: bool = True
+
+    FORMAT: ClassVar[str] = "<?"
+
+    def serialize(self) -> bytearray:
+        return bytearray(struct.pack(self.FORMAT, self.enabled))
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "RecorderConfig":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class RecorderState:
+    config: RecorderConfig
+    records: int
+    records_overwritten: int
+    oldest_frame: int
+    newest_frame: int
+    oldest_time_ms: int
+    newest_time_ms: int
+    bytes_used: int
+    bytes_capacity: int
+    append_cycles_max: int
+
+    FORMAT: ClassVar[str] = "<LLLLLLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "RecorderState":
+        config_size = struct.calcsize(RecorderConfig.FORMAT)
+        config = RecorderConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class RecorderRange:
+    type: RecorderRangeType = RecorderRangeType.FRAMES
+    first: int = 0
+    last: int = 0xFFFFFFFF
+
+    FORMAT: ClassVar[str] = "<BLL"
+
+    def serialize(self) -> bytearray:
+        return bytearray(struct.pack(self.FORMAT, self.type.value, self.first, self.last))
+
+
+@dataclass
+class RecorderFetchResult:
+    records: int
+    bytes: int
+    records_lost: int
+
+    FORMAT: ClassVar[str] = "<LLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "RecorderFetchResult":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class FrameHistoryConfig:
+    enabled: bool = False
+    slots: int = 8
+    post_trigger_frames: int = 4
+    blob_count_jump: int = 0  # 0 disables the blob count trigger
+    marker_lost: bool = False
+
+    FORMAT: ClassVar[str] = "<?BBB?"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.enabled,
+                self.slots,
+                self.post_trigger_frames,
+                self.blob_count_jump,
+                self.marker_lost,
+            )
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "FrameHistoryConfig":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class FrameHistoryState:
+    config: FrameHistoryConfig
+    status: HistoryStatus
+    trigger: HistoryTrigger
+    slots_max: int
+    frames: int
+    frames_after_trigger: int
+    trigger_time_ms: int
+    frames_captured: int
+    capture_failures: int
+
+    FORMAT: ClassVar[str] = "<BBBBBLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "FrameHistoryState":
+        config_size = struct.calcsize(FrameHistoryConfig.FORMAT)
+        config = FrameHistoryConfig.deserialize(data[:config_size])
+        fields = list(struct.unpack(cls.FORMAT, data[config_size:]))
+        fields[0] = HistoryStatus(fields[0])
+        fields[1] = HistoryTrigger(fields[1])
+        return cls(config, *fields)
+
+
+@dataclass
+class PreviewConfig:
+    factor: int = 8  # 4 (320x200) or 8 (160x100)
+    filter: PreviewFilter = PreviewFilter.BOX
+    fps_max: int = 10
+
+    FORMAT: ClassVar[str] = "<BBB"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(self.FORMAT, self.factor, self.filter.value, self.fps_max)
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "PreviewConfig":
+        factor, preview_filter, fps_max = struct.unpack(cls.FORMAT, data)
+        return cls(factor, PreviewFilter(preview_filter), fps_max)
+
+
+@dataclass
+class PreviewState:
+    config: PreviewConfig
+    frames_sent: int
+    datagrams_failed: int
+    capture_failures: int
+    filter_cycles_last: int
+    filter_cycles_max: int
+
+    FORMAT: ClassVar[str] = "<LLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "PreviewState":
+        config_size = struct.calcsize(PreviewConfig.FORMAT)
+        config = PreviewConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class NetworkBenchmarkConfig:
+    protocol: BenchmarkProtocol = BenchmarkProtocol.UDP
+    payload_size: int = 1024
+    packet_rate: int = 0  # packets per second, 0 sends as fast as possible
+    duration_s: int = 10
+
+    FORMAT: ClassVar[str] = "<BHLH"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.protocol.value,
+                self.payload_size,
+                self.packet_rate,
+                self.duration_s,
+            )
+        )
+
+
+@dataclass
+class NetworkBenchmarkResult:
+    running: bool
+    protocol: BenchmarkProtocol
+    payload_size: int
+    packets_sent: int
+    send_failures: int
+    bytes_sent: int
+    elapsed_ms: int
+    throughput_kbps: int
+    send_cycles_mean: int
+    send_cycles_max: int
+    mem_used_max: int
+    mem_errors: int
+    pbuf_pool_used_max: int
+    pbuf_pool_errors: int
+
+    FORMAT: ClassVar[str] = "<?BHLLLLLLLLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "NetworkBenchmarkResult":
+        fields = list(struct.unpack(cls.FORMAT, data))
+        fields[1] = BenchmarkProtocol(fields[1])
+        return cls(*fields)
+
+
+@dataclass
+class Subscriber:
+    address: ipaddress.IPv4Address  # unicast, broadcast or multicast, frames unicast only
+    port: int
+    stream: SubscriberStream
+    decimation: int = 1  # every n-th packet, log line or frame is sent
+
+    FORMAT: ClassVar[str] = "<4sHBB"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.address.packed,
+                self.port,
+                self.stream.value,
+                self.decimation,
+            )
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "Subscriber":
+        address, port, stream, decimation = struct.unpack(cls.FORMAT, data)
+        return cls(
+            ipaddress.IPv4Address(address), port, SubscriberStream(stream), decimation
+        )
+
+
+@dataclass
+class TimeSyncConfig:
+    enabled: bool = True
+    master: ipaddress.IPv4Address = ipaddress.IPv4Address("0.0.0.0")  # 0.0.0.0 is the host (10.0.0.2)
+    port: int = 0  # 0 is 1062
+    period_ms: int = 1000  # 100 to 10000
+    stamp_packets: bool = False  # append the synchronised receive time to the feature packets
+
+    FORMAT: ClassVar[str] = "<?4sHH?"
+
+    def serialize(self) -> bytearray:
+        return bytearray(
+            struct.pack(
+                self.FORMAT,
+                self.enabled,
+                self.master.packed,
+                self.port,
+                self.period_ms,
+                self.stamp_packets,
+            )
+        )
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "TimeSyncConfig":
+        enabled, master, port, period_ms, stamp_packets = struct.unpack(cls.FORMAT, data)
+        return cls(enabled, ipaddress.IPv4Address(master), port, period_ms, stamp_packets)
+
+
+@dataclass
+class TimeSyncState:
+    config: TimeSyncConfig
+    synchronized: bool
+    offset_us: int  # master minus device time of the last round, before its correction
+    jitter_us: int
+    delay_us: int  # round trip of the last round
+    drift_ppb: int
+    rounds: int
+    failed_rounds: int
+    steps: int
+    time_us: int  # synchronised time the state was taken at
+
+    FORMAT: ClassVar[str] = "<?lLLlLLLQ"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "TimeSyncState":
+        config_size = struct.calcsize(TimeSyncConfig.FORMAT)
+        config = TimeSyncConfig.deserialize(data[:config_size])
+        return cls(config, *struct.unpack(cls.FORMAT, data[config_size:]))
+
+
+@dataclass
+class FeatureStreamStats:
+    packets_received: int
+    packets_corrupt: int
+    packets_sent: int
+    send_failures: int
+    overruns: int
+    resyncs: int
+    messages_dropped: int
+    bytes_discarded: int
+    send_cycles_mean: int
+    send_cycles_max: int
+
+    FORMAT: ClassVar[str] = "<LLLLLLLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "FeatureStreamStats":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class InterruptStats:
+    count: int
+    dispatch_cycles_last: int
+    dispatch_cycles_max: int
+    handler_cycles_last: int
+    handler_cycles_max: int
+
+    FORMAT: ClassVar[str] = "<LLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "InterruptStats":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class PeripheralErrorMetrics:
+    flags: int
+    count: int
+
+    FORMAT: ClassVar[str] = "<LL"
+
+
+@dataclass
+class TaskMetrics:
+    stack_free_min: int  # bytes, 0xffff if the task does not exist
+    cpu_permille: int
+
+    FORMAT: ClassVar[str] = "<HH"
+    STACK_UNKNOWN: ClassVar[int] = 0xFFFF
+
+
+@dataclass
+class TaskProfile:
+    period_ms: int
+    busy_permille: int
+    busy_permille_max: int
+    task_count: int
+    index: int
+    name: str
+    priority: int
+    state: int
+    stack_free_min: int  # bytes
+    cpu_permille: int
+    cpu_permille_max: int
+
+    FORMAT: ClassVar[str] = "<HHHBB16sBBHHH"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "TaskProfile":
+        fields = list(struct.unpack(cls.FORMAT, data))
+        fields[5] = fields[5].split(b"\0", 1)[0].decode("ascii")
+        return cls(*fields)
+
+
+@dataclass
+class MemoryBenchmarkPass:
+    scan_cycles: int
+    copy_cycles: int
+    scan_kbps: int
+    copy_kbps: int
+
+    FORMAT: ClassVar[str] = "<LLLL"
+    SIZE: ClassVar[int] = struct.calcsize(FORMAT)
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "MemoryBenchmarkPass":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+@dataclass
+class MemoryBenchmarkResult:
+    data_cache_enabled: bool  # setting outside of the benchmark
+    frame_size: int  # bytes
+    invalidate_cycles: int
+    cached: MemoryBenchmarkPass
+    uncached: MemoryBenchmarkPass
+
+    FORMAT: ClassVar[str] = "<?LL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "MemoryBenchmarkResult":
+        head = struct.calcsize(cls.FORMAT)
+        cached = MemoryBenchmarkPass.deserialize(data[head : head + MemoryBenchmarkPass.SIZE])
+        uncached = MemoryBenchmarkPass.deserialize(data[head + MemoryBenchmarkPass.SIZE :])
+        return cls(*struct.unpack_from(cls.FORMAT, data), cached, uncached)
+
+
+@dataclass
+class ImageKernelTiming:
+    cycles: int
+    reference_cycles: int
+    kbps: int
+    match: bool
+
+    FORMAT: ClassVar[str] = "<LLL?"
+    SIZE: ClassVar[int] = struct.calcsize(FORMAT)
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "ImageKernelTiming":
+        return cls(*struct.unpack(cls.FORMAT, data))
+
+
+# kernel order of ImageKernelBenchmarkResult.kernels, see App/command/commands.md
+IMAGE_KERNELS = ["threshold", "pack bits", "histogram", "box down", "crop", "run lengths"]
+
+
+@dataclass
+class ImageKernelBenchmarkResult:
+    pixels: int
+    threshold: int
+    kernels: List[ImageKernelTiming]
+
+    FORMAT: ClassVar[str] = "<LB"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "ImageKernelBenchmarkResult":
+        pixels, threshold = struct.unpack_from(cls.FORMAT, data)
+        offset = struct.calcsize(cls.FORMAT)
+        kernels = [
+            ImageKernelTiming.deserialize(
+                data[offset + (i * ImageKernelTiming.SIZE) : offset + ((i + 1) * ImageKernelTiming.SIZE)]
+            )
+            for i in range(len(IMAGE_KERNELS))
+        ]
+        return cls(pixels, threshold, kernels)
+
+
+@dataclass
+class BootTimeline:
+    ms: dict  # BootPhase -> ms since reset, None if not reached (yet)
+
+    NOT_REACHED: ClassVar[int] = 0xFFFFFFFF
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "BootTimeline":
+        values = struct.unpack(f"<{len(data) // 4}L", data)
+        return cls(
+            {
+                phase: (None if values[phase.value] == cls.NOT_REACHED else values[phase.value])
+                for phase in BootPhase
+                if phase.value < len(values)
+            }
+        )
+
+
+@dataclass
+class SdramTestState:
+    running: bool  # pending or in progress
+    region: SdramRegion
+    bytes_verified: int  # every pattern counts, twice the region size when done
+    errors: int
+    first_error_address: int
+    duration_ms: int
+    runs: int  # completed since boot, including the boot test
+
+    FORMAT: ClassVar[str] = "<?BLLLLL"
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "SdramTestState":
+        fields = list(struct.unpack(cls.FORMAT, data))
+        fields[1] = SdramRegion(fields[1])
+        return cls(*fields)
+
+
+@dataclass
+class RuntimeMetrics:
+    version: int
+    uptime_ms: int
+    values: dict  # MetricId or raw index (newer firmware) -> value
+    peripheral_errors: dict  # MetricsPeripheral or raw index -> PeripheralErrorMetrics
+    tasks: dict  # MetricsTask or raw index -> TaskMetrics
+
+    HEADER_FORMAT: ClassVar[str] = "<BBBBL"
+
+    @staticmethod
+    def _key(enum, index: int):
+        try:
+            return enum(index)
+        except ValueError:
+            return index
+
+    @classmethod
+    def deserialize(cls, data: bytes) -> "RuntimeMetrics":
+        version, value_count, peripheral_count, task_count, uptime_ms = (
+            struct.unpack_from(cls.HEADER_FORMAT, data)
+        )
+        offset = struct.calcsize(cls.HEADER_FORMAT)
+        values = {}
+        for i, (value,) in enumerate(
+            struct.iter_unpack("<L", data[offset : offset + 4 * value_count])
+        ):
+            values[cls._key(MetricId, i)] = value
+        offset += 4 * value_count
+        size = struct.calcsize(PeripheralErrorMetrics.FORMAT)
+        peripheral_errors = {}
+        for i, fields in enumerate(
+            struct.iter_unpack(
+                PeripheralErrorMetrics.FORMAT,
+                data[offset : offset + size * peripheral_count],
+            )
+        ):
+            peripheral_errors[cls._key(MetricsPeripheral, i)] = PeripheralErrorMetrics(
+                *fields
+            )
+        offset += size * peripheral_count
+        size = struct.calcsize(TaskMetrics.FORMAT)
+        tasks = {}
+        for i, fields in enumerate(
+            struct.iter_unpack(
+                TaskMetrics.FORMAT, data[offset : offset + size * task_count]
+            )
+        ):
+            tasks[cls._key(MetricsTask, i)] = TaskMetrics(*fields)
+        return cls(version, uptime_ms, values, peripheral_errors, tasks)
+
+
 class CommandSender:
     def __init__(
         self,
@@ -154,6 +1043,113 @@ class CommandSender:
         )
         return self._send(c, blocking, timeout_s) is not None
 
+    def interrupt_get_stats(
+        self,
+        source: InterruptSource,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[InterruptStats]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.INTERRUPT_GET_STATS.value,
+            data=bytearray([source.value]),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return InterruptStats.deserialize(data)
+
+    def metrics_get(
+        self, request_id: int = 1, blocking: bool = True, timeout_s: int = 1
+    ) -> Optional[RuntimeMetrics]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.METRICS_GET.value,
+            data=bytearray(),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return RuntimeMetrics.deserialize(data)
+
+    def task_profile_get(
+        self,
+        index: int,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[TaskProfile]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.TASK_PROFILE_GET.value,
+            data=bytearray([index]),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return TaskProfile.deserialize(data)
+
+    def memory_benchmark_run(
+        self, request_id: int = 1, blocking: bool = True, timeout_s: int = 5
+    ) -> Optional[MemoryBenchmarkResult]:
+        c = CommandPacket(
+            request_id=request_id, command_id=CommandIds.MEMORY_BENCHMARK_RUN.value
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return MemoryBenchmarkResult.deserialize(data)
+
+    def image_kernel_benchmark_run(
+        self, threshold: int, request_id: int = 1, blocking: bool = True, timeout_s: int = 5
+    ) -> Optional[ImageKernelBenchmarkResult]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.IMAGE_KERNEL_BENCHMARK_RUN.value,
+            data=bytearray([threshold]),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return ImageKernelBenchmarkResult.deserialize(data)
+
+    def boot_timeline_get(
+        self, request_id: int = 1, blocking: bool = True, timeout_s: int = 1
+    ) -> Optional[BootTimeline]:
+        c = CommandPacket(
+            request_id=request_id, command_id=CommandIds.BOOT_TIMELINE_GET.value
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return BootTimeline.deserialize(data)
+
+    def sdram_test_start(
+        self,
+        region: SdramRegion,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.SDRAM_TEST_START.value,
+            data=bytearray([region.value]),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def sdram_test_get_state(
+        self, request_id: int = 1, blocking: bool = True, timeout_s: int = 1
+    ) -> Optional[SdramTestState]:
+        c = CommandPacket(
+            request_id=request_id, command_id=CommandIds.SDRAM_TEST_GET_STATE.value
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return SdramTestState.deserialize(data)
+
     def capture(
         self, request_id: int = 1, blocking: bool = True, timeout_s: int = 1
     ) -> bool:
@@ -234,6 +1230,64 @@ class CommandSender:
         )
         return self._send(c, blocking, timeout_s) is not None
 
+    def camera_set_mode(
+        self,
+        mode: SensorMode,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.CAMERA_SET_MODE.value,
+            data=bytearray(struct.pack("<B", mode.value)),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def camera_get_mode(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[SensorModeInfo]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.CAMERA_GET_MODE.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return SensorModeInfo.deserialize(data)
+
+    def camera_set_preview(
+        self,
+        config: PreviewConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.CAMERA_SET_PREVIEW.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def camera_get_preview(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[PreviewState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.CAMERA_GET_PREVIEW.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return PreviewState.deserialize(data)
+
     def network_get_config(
         self,
         request_id: int = 1,
@@ -270,50 +1324,155 @@ class CommandSender:
             f"{gateway[0]}.{gateway[1]}.{gateway[2]}.{gateway[3]}",
         )
 
-    def network_set_config(
+    def network_set_config(
+        self,
+        mac: str,
+        ip: str,
+        netmask: str,
+        gateway: str,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        self._logger.info(f"mac {mac}, ip {ip}, netmask {netmask}, gateway {gateway}")
+        mac_octets = list(map(lambda x: int(x, base=16), mac.split(":")))
+        ip_octets = list(map(lambda x: int(x, base=10), ip.split(".")))
+        netmask_octets = list(map(lambda x: int(x, base=10), netmask.split(".")))
+        gateway_octets = list(map(lambda x: int(x, base=10), gateway.split(".")))
+        if (
+            (len(mac_octets) != 6)
+            or (len(ip_octets) != 4)
+            or (len(netmask_octets) != 4)
+            or (len(gateway_octets) != 4)
+        ):
+            self._logger.warning("invalid arguments")
+            return False
+
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_SET_CONFIG.value,
+            data=bytearray(mac_octets)
+            + bytearray(ip_octets)
+            + bytearray(netmask_octets)
+            + bytearray(gateway_octets),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def network_persist_config(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id, command_id=CommandIds.NETWORK_PERSIST_CONFIG.value
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def network_benchmark_start(
+        self,
+        config: NetworkBenchmarkConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_BENCHMARK_START.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def network_benchmark_get_result(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[NetworkBenchmarkResult]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_BENCHMARK_GET_RESULT.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return NetworkBenchmarkResult.deserialize(data)
+
+    def network_subscribe(
+        self,
+        subscriber: Subscriber,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_SUBSCRIBE.value,
+            data=subscriber.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def network_unsubscribe(
+        self,
+        subscriber: Subscriber,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_UNSUBSCRIBE.value,
+            data=subscriber.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def network_get_subscribers(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[List[Subscriber]]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_GET_SUBSCRIBERS.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        size = struct.calcsize(Subscriber.FORMAT)
+        return [
+            Subscriber.deserialize(data[1 + i * size : 1 + (i + 1) * size])
+            for i in range(data[0])
+        ]
+
+    def network_time_sync_set_config(
         self,
-        mac: str,
-        ip: str,
-        netmask: str,
-        gateway: str,
+        config: TimeSyncConfig,
         request_id: int = 1,
         blocking: bool = True,
         timeout_s: int = 1,
     ) -> bool:
-        self._logger.info(f"mac {mac}, ip {ip}, netmask {netmask}, gateway {gateway}")
-        mac_octets = list(map(lambda x: int(x, base=16), mac.split(":")))
-        ip_octets = list(map(lambda x: int(x, base=10), ip.split(".")))
-        netmask_octets = list(map(lambda x: int(x, base=10), netmask.split(".")))
-        gateway_octets = list(map(lambda x: int(x, base=10), gateway.split(".")))
-        if (
-            (len(mac_octets) != 6)
-            or (len(ip_octets) != 4)
-            or (len(netmask_octets) != 4)
-            or (len(gateway_octets) != 4)
-        ):
-            self._logger.warning("invalid arguments")
-            return False
-
         c = CommandPacket(
             request_id=request_id,
-            command_id=CommandIds.NETWORK_SET_CONFIG.value,
-            data=bytearray(mac_octets)
-            + bytearray(ip_octets)
-            + bytearray(netmask_octets)
-            + bytearray(gateway_octets),
+            command_id=CommandIds.NETWORK_TIME_SYNC_SET_CONFIG.value,
+            data=config.serialize(),
         )
         return self._send(c, blocking, timeout_s) is not None
 
-    def network_persist_config(
+    def network_time_sync_get_state(
         self,
         request_id: int = 1,
         blocking: bool = True,
         timeout_s: int = 1,
-    ) -> bool:
+    ) -> Optional[TimeSyncState]:
         c = CommandPacket(
-            request_id=request_id, command_id=CommandIds.NETWORK_PERSIST_CONFIG.value
+            request_id=request_id,
+            command_id=CommandIds.NETWORK_TIME_SYNC_GET_STATE.value,
         )
-        return self._send(c, blocking, timeout_s) is not None
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return TimeSyncState.deserialize(data)
 
     def calibration_load_camera_matrix(
         self,
@@ -445,6 +1604,22 @@ class CommandSender:
         )
         return self._send(c, blocking, timeout_s) is not None
 
+    def calibration_get_status(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[int]:
+        """stored calibration parts, bit 0 camera matrix, bit 1 distortion coefficients, bit 2 rotation matrix, bit 3 translation vector"""
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.CALIBRATION_GET_STATUS.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return data[0]
+
     def pipeline_input(
         self,
         input: PipelineInput,
@@ -487,6 +1662,136 @@ class CommandSender:
         )
         return self._send(c, blocking, timeout_s) is not None
 
+    def pipeline_get_stream_stats(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[FeatureStreamStats]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_GET_STREAM_STATS.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return FeatureStreamStats.deserialize(data)
+
+    def pipeline_set_transport(
+        self,
+        transport: BlobTransport,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_SET_TRANSPORT.value,
+            data=bytearray([transport.value]),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def pipeline_set_tracking(
+        self,
+        config: BlobTrackerConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_SET_TRACKING.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def pipeline_get_tracking(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[BlobTrackerState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_GET_TRACKING.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return BlobTrackerState.deserialize(data)
+
+    def pipeline_set_blink_codes(
+        self,
+        config: BlinkDecoderConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_SET_BLINK_CODES.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def pipeline_get_blink_codes(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[BlinkDecoderState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_GET_BLINK_CODES.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return BlinkDecoderState.deserialize(data)
+
+    def pipeline_set_delta_encoding(
+        self,
+        config: DeltaEncoderConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_SET_DELTA_ENCODING.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def pipeline_get_delta_encoding(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[DeltaEncoderState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_GET_DELTA_ENCODING.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return DeltaEncoderState.deserialize(data)
+
+    def pipeline_set_streaming(
+        self,
+        enable: bool,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.PIPELINE_SET_STREAMING.value,
+            data=bytearray(struct.pack("<?", enable)),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
     def strobe_enable_pulse(
         self,
         enable: bool,
@@ -542,3 +1847,171 @@ class CommandSender:
             data=bytearray(struct.pack("<?", enable)),
         )
         return self._send(c, blocking, timeout_s) is not None
+
+    def auto_exposure_enable(
+        self,
+        enable: bool,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.AUTO_EXPOSURE_ENABLE.value,
+            data=bytearray(struct.pack("<?", enable)),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def auto_exposure_set_config(
+        self,
+        config: AutoExposureConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.AUTO_EXPOSURE_SET_CONFIG.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def auto_exposure_get_config(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[AutoExposureConfig]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.AUTO_EXPOSURE_GET_CONFIG.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return AutoExposureConfig.deserialize(data)
+
+    def auto_exposure_get_state(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[AutoExposureState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.AUTO_EXPOSURE_GET_STATE.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return AutoExposureState.deserialize(data)
+
+    def recorder_set_config(
+        self,
+        config: RecorderConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.RECORDER_SET_CONFIG.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def recorder_get_state(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[RecorderState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.RECORDER_GET_STATE.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return RecorderState.deserialize(data)
+
+    def recorder_fetch(
+        self,
+        range: RecorderRange,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 60,
+    ) -> Optional[RecorderFetchResult]:
+        """the records are sent to port 1059 of this host, listen before sending the command"""
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.RECORDER_FETCH.value,
+            data=range.serialize(),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return RecorderFetchResult.deserialize(data)
+
+    def frame_history_set_config(
+        self,
+        config: FrameHistoryConfig,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.FRAME_HISTORY_SET_CONFIG.value,
+            data=config.serialize(),
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def frame_history_get_state(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> Optional[FrameHistoryState]:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.FRAME_HISTORY_GET_STATE.value,
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return FrameHistoryState.deserialize(data)
+
+    def frame_history_trigger(
+        self,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 1,
+    ) -> bool:
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.FRAME_HISTORY_TRIGGER.value,
+        )
+        return self._send(c, blocking, timeout_s) is not None
+
+    def frame_history_transfer(
+        self,
+        index: int,
+        request_id: int = 1,
+        blocking: bool = True,
+        timeout_s: int = 10,
+    ) -> Optional[int]:
+        """the frame is sent to port 1055 of this host, listen before sending the command
+
+        Returns:
+            Optional[int]: capture time of the frame in ms since boot
+        """
+        c = CommandPacket(
+            request_id=request_id,
+            command_id=CommandIds.FRAME_HISTORY_TRANSFER.value,
+            data=bytearray(struct.pack("<B", index)),
+        )
+        data = self._send(c, blocking, timeout_s)
+        if data is None:
+            return None
+        return struct.unpack("<L", data)[0]
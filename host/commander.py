@@ -295,6 +295,20 @@ class Commander:
                     callback=_set_vao_fps,
                 )
 
+                def _set_vao_sensor_mode(sender, app_data):
+                    self._command_sender.camera_set_mode(
+                        mode=commandSender.SensorMode[app_data]
+                    )
+
+                dpg.add_combo(
+                    label="Sensor mode",
+                    tag="set_camera_sensor_mode",
+                    items=[m.name for m in commandSender.SensorMode],
+                    default_value=commandSender.SensorMode.MODE_1280X800_72FPS.name,
+                    width=100,
+                    callback=_set_vao_sensor_mode,
+                )
+
                 def _set_vao_exposure(sender, app_data):
                     self._command_sender.exposure(level=app_data)
 
@@ -401,6 +415,16 @@ class Commander:
                     callback=_set_pipeline_output,
                 )
 
+                def _pipeline_set_streaming(sender, app_data):
+                    self._command_sender.pipeline_set_streaming(enable=app_data)
+
+                dpg.add_checkbox(
+                    tag="pipeline_set_streaming",
+                    label="Stream features",
+                    default_value=False,
+                    callback=_pipeline_set_streaming,
+                )
+
                 dpg.add_spacer(height=15)
 
                 def _strobe_enable_pulse(sender, app_data):
@@ -4,7 +4,7 @@ from pathlib import Path
 
 import click
 
-from commandSender import CommandSender, Fps
+from commandSender import AutoExposureConfig, CommandSender, Fps, SensorMode
 
 
 def apply_config_file(config_file: Path) -> bool:
@@ -27,6 +27,15 @@ def apply_config_file(config_file: Path) -> bool:
                             logging.error(f"fps {value} not supported")
                             return False
                     assert command_sender.fps(fps=fps) is True, "fps failed"
+                case "sensor_mode":
+                    try:
+                        mode = SensorMode[value]
+                    except KeyError:
+                        logging.error(f"sensor mode {value} not supported")
+                        return False
+                    assert command_sender.camera_set_mode(mode=mode) is True, (
+                        "sensor mode failed"
+                    )
                 case "exposure":
                     assert command_sender.exposure(level=value) is True, (
                         "exposure failed"
@@ -44,6 +53,18 @@ def apply_config_file(config_file: Path) -> bool:
                     assert (
                         command_sender.strobe_enable_constant(enable=value) is True
                     ), "light failed"
+                case "auto_exposure_config":
+                    assert (
+                        command_sender.auto_exposure_set_config(
+                            config=AutoExposureConfig(**value)
+                        )
+                        is True
+                    ), "auto exposure config failed"
+                case "auto_exposure":
+                    # must follow exposure and gain, manual values are rejected while active
+                    assert command_sender.auto_exposure_enable(enable=value) is True, (
+                        "auto exposure failed"
+                    )
                 case _:
                     logging.error(f"setting {setting} not supported")
                     return False
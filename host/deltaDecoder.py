@@ -0,0 +1,220 @@
+#!/usr/bin/env python
+"""Reference decoder of the delta feature packets of the vision add-on.
+
+see visionAddOn/firmware/App/blob/deltaFeaturePacket.md
+"""
+import logging
+import struct
+import typing
+from dataclasses import dataclass, replace
+
+OFFSET_FRAME_COUNT: typing.Final[int] = 0
+OFFSET_FEATURE_COUNT: typing.Final[int] = 1
+OFFSET_MODE_FORMAT: typing.Final[int] = 2
+OFFSET_SEQUENCE: typing.Final[int] = 3
+OFFSET_FLAGS: typing.Final[int] = 4
+HEADER_SIZE: typing.Final[int] = 5
+FLAG_KEYFRAME: typing.Final[int] = 0x01
+PACKET_FORMAT_TRACKED: typing.Final[int] = 0x1
+PACKET_FORMAT_DELTA: typing.Final[int] = 0x2
+ENTRY_FORMAT: typing.Final[str] = "<H6s"  # track id, bounding box
+ENTRY_SIZE: typing.Final[int] = struct.calcsize(ENTRY_FORMAT)
+BOUNDING_BOX_SIZE: typing.Final[int] = 6
+MODE_ABSENT: typing.Final[int] = 0x0
+MODE_POSITION: typing.Final[int] = 0x1
+MODE_POSITION_SIZE: typing.Final[int] = 0x2
+MODE_VARINT: typing.Final[int] = 0x3
+BITS_X: typing.Final[int] = 11
+BITS_Y: typing.Final[int] = 10
+MAX_REFERENCE: typing.Final[int] = 128  # absent features are dropped first
+REFERENCE_HOLD: typing.Final[int] = 4  # packets an absent feature stays in the reference
+
+
+@dataclass
+class Feature:
+    track_id: int
+    center_x2: int  # x_min + x_max
+    center_y2: int  # y_min + y_max
+    width: int  # x_max - x_min
+    height: int  # y_max - y_min
+    motion_x2: int = 0  # center_x2 change since the previous packet
+    motion_y2: int = 0
+    missed: int = 0  # packets since the feature was present
+
+    @classmethod
+    def from_bounding_box(cls, track_id: int, box: bytes) -> "Feature":
+        raw = int.from_bytes(box, "little")
+        y_max = raw & ((1 << BITS_Y) - 1)
+        y_min = (raw >> BITS_Y) & ((1 << BITS_Y) - 1)
+        x_max = (raw >> (2 * BITS_Y)) & ((1 << BITS_X) - 1)
+        x_min = (raw >> (2 * BITS_Y + BITS_X)) & ((1 << BITS_X) - 1)
+        return cls(track_id, x_min + x_max, y_min + y_max, x_max - x_min, y_max - y_min)
+
+    def bounding_box(self) -> bytes:
+        x_min = (self.center_x2 - self.width) // 2
+        x_max = (self.center_x2 + self.width) // 2
+        y_min = (self.center_y2 - self.height) // 2
+        y_max = (self.center_y2 + self.height) // 2
+        raw = (
+            (x_min << (2 * BITS_Y + BITS_X))
+            | (x_max << (2 * BITS_Y))
+            | (y_min << BITS_Y)
+            | y_max
+        )
+        return raw.to_bytes(BOUNDING_BOX_SIZE, "little")
+
+
+def _predict(center2: int, motion2: int, packets: int, bits: int) -> int:
+    return max(0, min(2 * ((1 << bits) - 1), center2 + motion2 * packets))
+
+
+def _nibble(value: int) -> int:
+    return value - 16 if value & 0x8 else value
+
+
+def _varint(data: bytes, offset: int) -> typing.Tuple[int, int]:
+    code = 0
+    shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[offset]
+        offset += 1
+        code |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return (code >> 1) ^ -(code & 1), offset
+
+
+class DeltaDecoder:
+    """Decodes the delta packets of one camera into tracked packets.
+
+    Delta frames reference the previous packet, after a lost packet the decoder waits for the next keyframe.
+    Use pipeline_set_delta_encoding to request a keyframe instead of waiting for the keyframe interval.
+    The tracked packets carry the bounding boxes bit-exact, velocity is the motion since the previous packet
+    in 1/4 px and confidence is not transmitted (0).
+    """
+
+    def __init__(self) -> None:
+        self._reference: typing.Optional[typing.List[Feature]] = None
+        self._sequence: typing.Optional[int] = None
+        self.keyframes_missed = 0  # delta frames dropped while waiting for a keyframe
+
+    def decode(self, data: bytes) -> typing.Optional[bytes]:
+        """Decode a delta packet.
+
+        Args:
+            data (bytes): delta packet
+
+        Raises:
+            ValueError: malformed packet, the reference is dropped
+
+        Returns:
+            typing.Optional[bytes]: tracked packet including the marker trailer, None while waiting for a keyframe
+        """
+        try:
+            return self._decode(data)
+        except (ValueError, IndexError, struct.error) as e:
+            self._reference = None
+            raise ValueError(e)
+
+    def _decode(self, data: bytes) -> typing.Optional[bytes]:
+        if len(data) < HEADER_SIZE or data[OFFSET_MODE_FORMAT] >> 4 != PACKET_FORMAT_DELTA:
+            raise ValueError("not a delta packet")
+        sequence = data[OFFSET_SEQUENCE]
+        keyframe = bool(data[OFFSET_FLAGS] & FLAG_KEYFRAME)
+        in_sequence = self._sequence is not None and sequence == (self._sequence + 1) & 0xFF
+        self._sequence = sequence
+        if not keyframe and (self._reference is None or not in_sequence):
+            self._reference = None
+            self.keyframes_missed += 1
+            logging.debug(f"delta frame {sequence} without reference, waiting for a keyframe")
+            return None
+
+        number_of_features = data[OFFSET_FEATURE_COUNT]
+        offset = HEADER_SIZE
+        features: typing.List[Feature] = []
+        # reference of the next packet: the previous reference in order (present or held), then the new features
+        reference_next: typing.List[Feature] = []
+        if keyframe:
+            for _ in range(number_of_features):
+                track_id, box = struct.unpack_from(ENTRY_FORMAT, data, offset)
+                offset += ENTRY_SIZE
+                features.append(Feature.from_bounding_box(track_id, box))
+                reference_next.append(features[-1])
+        else:
+            assert self._reference is not None
+            offset_payload = offset + (len(self._reference) + 3) // 4
+            if offset_payload > len(data):
+                raise ValueError("truncated modes")
+            for r, reference in enumerate(self._reference):
+                mode = (data[offset + r // 4] >> (2 * (r % 4))) & 0x3
+                if mode == MODE_ABSENT:
+                    if reference.missed < REFERENCE_HOLD:
+                        reference_next.append(
+                            replace(reference, missed=reference.missed + 1)
+                        )
+                    continue
+                if mode == MODE_VARINT:
+                    residual_x, offset_payload = _varint(data, offset_payload)
+                    residual_y, offset_payload = _varint(data, offset_payload)
+                    change_width, offset_payload = _varint(data, offset_payload)
+                    change_height, offset_payload = _varint(data, offset_payload)
+                else:
+                    residual_x = _nibble(data[offset_payload] & 0x0F)
+                    residual_y = _nibble(data[offset_payload] >> 4)
+                    offset_payload += 1
+                    change_width = change_height = 0
+                    if mode == MODE_POSITION_SIZE:
+                        change_width = _nibble(data[offset_payload] & 0x0F)
+                        change_height = _nibble(data[offset_payload] >> 4)
+                        offset_payload += 1
+                packets = reference.missed + 1
+                center_x2 = residual_x + _predict(
+                    reference.center_x2, reference.motion_x2, packets, BITS_X
+                )
+                center_y2 = residual_y + _predict(
+                    reference.center_y2, reference.motion_y2, packets, BITS_Y
+                )
+                # the motion is only measured between consecutive packets
+                if reference.missed == 0:
+                    motion_x2 = center_x2 - reference.center_x2
+                    motion_y2 = center_y2 - reference.center_y2
+                else:
+                    motion_x2 = reference.motion_x2
+                    motion_y2 = reference.motion_y2
+                features.append(
+                    Feature(
+                        reference.track_id,
+                        center_x2,
+                        center_y2,
+                        reference.width + change_width,
+                        reference.height + change_height,
+                        motion_x2,
+                        motion_y2,
+                    )
+                )
+                reference_next.append(features[-1])
+            offset = offset_payload
+            if len(features) > number_of_features:
+                raise ValueError("more features than announced")
+            for _ in range(number_of_features - len(features)):
+                track_id, box = struct.unpack_from(ENTRY_FORMAT, data, offset)
+                offset += ENTRY_SIZE
+                features.append(Feature.from_bounding_box(track_id, box))
+                reference_next.append(features[-1])
+
+        # untracked features can not be referenced, features beyond the reference size are sent as new ones again
+        self._reference = [f for f in reference_next if f.track_id != 0][:MAX_REFERENCE]
+
+        tracked = bytearray(data[OFFSET_FRAME_COUNT : OFFSET_MODE_FORMAT])
+        tracked.append((data[OFFSET_MODE_FORMAT] & 0x0F) | (PACKET_FORMAT_TRACKED << 4))
+        for feature in features:
+            # velocity in 1/4 px per frame: the doubled centroid motion times 2
+            velocity_x = max(-128, min(127, feature.motion_x2 * 2))
+            velocity_y = max(-128, min(127, feature.motion_y2 * 2))
+            tracked += feature.bounding_box()
+            tracked += struct.pack("<HbbB", feature.track_id, velocity_x, velocity_y, 0)
+        tracked += data[offset:]  # marker trailer, already in the decoded order
+        return bytes(tracked)
@@ -3,11 +3,11 @@ import logging
 import socket
 import struct
 from pathlib import Path
-from typing import Optional
+from typing import List, Optional
 
 from PIL import Image
 
-from commandSender import CommandSender
+from commandSender import CommandSender, HistoryStatus
 
 IMAGE_WIDTH = 1280
 IMAGE_HEIGHT = 800
@@ -92,6 +92,43 @@ class FrameReceiver:
         logging.info(f"image saved to {image_file}")
         return image_file
 
+    async def receiveHistory(
+        self, label: str, dir: Path = Path("/tmp/frameReceiver/history/")
+    ) -> List[Path]:
+        """Receive all frames of the frozen frame history, oldest first.
+
+        The images are named <label>_<index>_<capture time in ms>.png
+        """
+        state = self._command_sender.frame_history_get_state()
+        if state is None or state.status != HistoryStatus.FROZEN:
+            self._logger.warning(f"frame history not frozen, state: {state}")
+            return []
+        self._logger.info(
+            f"{state.frames} frames, {state.frames_after_trigger} after trigger {state.trigger.name} at {state.trigger_time_ms} ms"
+        )
+        image_files = []
+        for index in range(state.frames):
+            rx_socket_ready = asyncio.Event()
+            receive_task = asyncio.create_task(
+                self._start_rx_server(
+                    rx_socket_ready=rx_socket_ready, dir=dir, label=f"{label}_{index}"
+                )
+            )
+            await rx_socket_ready.wait()
+            time_ms = await asyncio.to_thread(
+                self._command_sender.frame_history_transfer, index
+            )
+            if time_ms is None:
+                receive_task.cancel()
+                self._logger.warning(f"transfer of frame {index} failed")
+                break
+            binary_file = await receive_task
+            named_file = binary_file.with_name(f"{label}_{index}_{time_ms}.bin")
+            binary_file.rename(named_file)
+            image_files.append(self._convert_gray(file=named_file, label=label))
+            named_file.unlink()
+        return image_files
+
     @staticmethod
     def _rgb565_to_rgb888(pixel):
         # Extract red, green, and blue components
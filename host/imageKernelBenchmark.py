@@ -0,0 +1,29 @@
+import logging
+
+import click
+
+from commandSender import IMAGE_KERNELS, CommandSender
+
+
+# Runs the image kernel benchmark of the firmware on the last captured frame, SIMD kernels against their byte loop
+# references. Capture a frame with markers in view first, the threshold only matters for the run length kernel.
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option("--threshold", default=128, type=click.IntRange(0, 255))
+def main(ip, threshold) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    result = command_sender.image_kernel_benchmark_run(threshold=threshold)
+    assert result is not None, "image kernel benchmark failed"
+    click.echo(f"{result.pixels} px, threshold {result.threshold}")
+    click.echo(f"{'kernel':<12} {'cycles':>10} {'reference':>10} {'speedup':>8} {'MB/s':>8} result")
+    for name, timing in zip(IMAGE_KERNELS, result.kernels):
+        speedup = timing.reference_cycles / timing.cycles if timing.cycles > 0 else 0.0
+        click.echo(
+            f"{name:<12} {timing.cycles:>10} {timing.reference_cycles:>10} {speedup:>7.1f}x"
+            f" {timing.kbps / 1000:>8.1f} {'match' if timing.match else 'MISMATCH'}"
+        )
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
@@ -0,0 +1,33 @@
+import logging
+
+import click
+
+from commandSender import CommandSender, MemoryBenchmarkPass
+
+
+# Runs the memory benchmark of the firmware, scan and copy of a frame in the external SDRAM with the data cache on and off.
+# The cached pass starts cold (frame invalidated as after a capture), the invalidate cost is printed separately.
+def print_pass(name: str, benchmark_pass: MemoryBenchmarkPass) -> None:
+    click.echo(
+        f"{name:<9} scan {benchmark_pass.scan_kbps / 1000:8.1f} MB/s ({benchmark_pass.scan_cycles} cycles),"
+        f" copy {benchmark_pass.copy_kbps / 1000:8.1f} MB/s ({benchmark_pass.copy_cycles} cycles)"
+    )
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+def main(ip) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    result = command_sender.memory_benchmark_run()
+    assert result is not None, "memory benchmark failed"
+    click.echo(
+        f"frame {result.frame_size} bytes, data cache {'on' if result.data_cache_enabled else 'off'},"
+        f" invalidate {result.invalidate_cycles} cycles"
+    )
+    print_pass("cached", result.cached)
+    print_pass("uncached", result.uncached)
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
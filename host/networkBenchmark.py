@@ -0,0 +1,156 @@
+import logging
+import socket
+import struct
+import time
+
+import click
+
+from commandSender import (
+    BenchmarkProtocol,
+    CommandSender,
+    NetworkBenchmarkConfig,
+    NetworkBenchmarkResult,
+)
+
+PORT_NETWORK_BENCHMARK = 1058
+HEADER_FORMAT = "<LL"  # sequence number, send time in us
+RECEIVE_BUFFER_SIZE = 4 * 1024 * 1024
+DRAIN_TIMEOUT_S = 1.0
+ACCEPT_TIMEOUT_S = 5.0
+
+
+class UdpStatistics:
+    def __init__(self):
+        self.received = 0
+        self.duplicates = 0
+        self.reordered = 0
+        self.jitter_us = 0.0  # interarrival jitter, RFC 3550 section 6.4.1
+        self._sequences = set()
+        self._highest_sequence = -1
+        self._last_transit_us = None
+
+    def add(self, payload: bytes, arrival_us: float) -> None:
+        sequence, send_us = struct.unpack_from(HEADER_FORMAT, payload)
+        self.received += 1
+        if sequence in self._sequences:
+            self.duplicates += 1
+            return
+        self._sequences.add(sequence)
+        if sequence < self._highest_sequence:
+            self.reordered += 1
+        self._highest_sequence = max(self._highest_sequence, sequence)
+        transit_us = arrival_us - send_us
+        if self._last_transit_us is not None:
+            d = abs(transit_us - self._last_transit_us)
+            self.jitter_us += (d - self.jitter_us) / 16.0
+        self._last_transit_us = transit_us
+
+    @property
+    def unique(self) -> int:
+        return len(self._sequences)
+
+
+def receive_udp(duration_s: int, start) -> UdpStatistics:
+    stats = UdpStatistics()
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, RECEIVE_BUFFER_SIZE)
+        s.bind(("0.0.0.0", PORT_NETWORK_BENCHMARK))
+        s.settimeout(DRAIN_TIMEOUT_S)
+        start()
+        end = time.monotonic() + duration_s + DRAIN_TIMEOUT_S
+        while time.monotonic() < end:
+            try:
+                payload = s.recv(2048)
+            except socket.timeout:
+                if stats.received > 0:
+                    break
+                continue
+            stats.add(payload, time.monotonic_ns() / 1000.0)
+    return stats
+
+
+def receive_tcp(duration_s: int, start) -> int:
+    received = 0
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as server:
+        server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        server.bind(("0.0.0.0", PORT_NETWORK_BENCHMARK))
+        server.listen(1)
+        server.settimeout(ACCEPT_TIMEOUT_S)
+        start()
+        connection, _ = server.accept()
+        with connection:
+            connection.settimeout(duration_s + DRAIN_TIMEOUT_S)
+            while True:
+                data = connection.recv(65536)
+                if not data:
+                    break
+                received += len(data)
+    return received
+
+
+def wait_for_result(command_sender: CommandSender) -> NetworkBenchmarkResult:
+    while True:
+        result = command_sender.network_benchmark_get_result()
+        assert result is not None, "get result failed"
+        if not result.running:
+            return result
+        time.sleep(0.2)
+
+
+def print_result(result: NetworkBenchmarkResult) -> None:
+    click.echo(
+        f"device: {result.packets_sent} packets, {result.send_failures} send failures, "
+        f"{result.throughput_kbps / 1000.0:.2f} Mbit/s over {result.elapsed_ms} ms"
+    )
+    click.echo(
+        f"device: {result.send_cycles_mean} cycles/send mean, {result.send_cycles_max} max"
+    )
+    click.echo(
+        f"device: lwip heap max {result.mem_used_max} bytes ({result.mem_errors} errors), "
+        f"pbuf pool max {result.pbuf_pool_used_max} ({result.pbuf_pool_errors} errors)"
+    )
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option(
+    "--protocol",
+    type=click.Choice([p.name for p in BenchmarkProtocol]),
+    default=BenchmarkProtocol.UDP.name,
+)
+@click.option("--size", default=1024, help="payload size in bytes, 8 to 1472")
+@click.option("--rate", default=0, help="packets per second, 0 sends as fast as possible")
+@click.option("--duration", default=10, help="duration in s, at most 60")
+def main(ip, protocol, size, rate, duration) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    config = NetworkBenchmarkConfig(
+        protocol=BenchmarkProtocol[protocol],
+        payload_size=size,
+        packet_rate=rate,
+        duration_s=duration,
+    )
+
+    def start():
+        assert command_sender.network_benchmark_start(config=config) is True, (
+            "start failed"
+        )
+
+    if config.protocol == BenchmarkProtocol.UDP:
+        stats = receive_udp(duration, start)
+        result = wait_for_result(command_sender)
+        lost = max(result.packets_sent - stats.unique, 0)
+        loss = lost / result.packets_sent if result.packets_sent > 0 else 0.0
+        click.echo(
+            f"host: {stats.unique} packets, {lost} lost ({loss:.3%}), {stats.duplicates} duplicates, "
+            f"{stats.reordered} reordered, jitter {stats.jitter_us:.1f} us"
+        )
+    else:
+        received = receive_tcp(duration, start)
+        result = wait_for_result(command_sender)
+        click.echo(f"host: {received} bytes received")
+    print_result(result)
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
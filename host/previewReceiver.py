@@ -0,0 +1,92 @@
+import ipaddress
+import logging
+import socket
+import struct
+from pathlib import Path
+
+import click
+from PIL import Image
+
+from commandSender import (
+    CommandSender,
+    PreviewConfig,
+    PreviewFilter,
+    Subscriber,
+    SubscriberStream,
+)
+
+PORT_PREVIEW = 1060
+HEADER_FORMAT = "<HHHHBB"  # sequence, width, height, first row, rows, factor
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+RECEIVE_TIMEOUT_S = 5.0
+
+
+def parse_datagram(data: bytes):
+    """returns (sequence, width, height, first row, rows, px), see App/camera/previewPacket.md"""
+    sequence, width, height, first_row, rows, _ = struct.unpack_from(HEADER_FORMAT, data)
+    px = data[HEADER_SIZE:]
+    if len(px) != rows * width:
+        raise ValueError(f"datagram of sequence {sequence} has {len(px)} px, expected {rows * width}")
+    return sequence, width, height, first_row, rows, px
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option("--host-ip", required=True, help="ip of this host, the preview destination")
+@click.option("--port", default=PORT_PREVIEW)
+@click.option("--factor", type=click.Choice(["4", "8"]), default="8")
+@click.option(
+    "--filter",
+    "preview_filter",
+    type=click.Choice([f.name for f in PreviewFilter]),
+    default=PreviewFilter.BOX.name,
+)
+@click.option("--fps-max", default=10)
+@click.option("--frames", default=50, help="frames to receive")
+@click.option("--output", type=click.Path(file_okay=False), help="writes every received frame as png")
+def main(ip, host_ip, port, factor, preview_filter, fps_max, frames, output) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    config = PreviewConfig(factor=int(factor), filter=PreviewFilter[preview_filter], fps_max=fps_max)
+    assert command_sender.camera_set_preview(config), "set preview failed"
+    subscriber = Subscriber(
+        address=ipaddress.IPv4Address(host_ip), port=port, stream=SubscriberStream.PREVIEW
+    )
+
+    if output is not None:
+        Path(output).mkdir(parents=True, exist_ok=True)
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as server:
+        server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        server.bind(("0.0.0.0", port))
+        server.settimeout(RECEIVE_TIMEOUT_S)
+        assert command_sender.network_subscribe(subscriber), "subscribe failed"
+        try:
+            image = None
+            sequence_shown = None
+            received = 0
+            while received < frames:
+                data, _ = server.recvfrom(2048)
+                sequence, width, height, first_row, rows, px = parse_datagram(data)
+                if image is None or image.size != (width, height):
+                    image = Image.new("L", (width, height))
+                # rows of a new sequence are drawn over the previous frame
+                if sequence_shown is not None and sequence != sequence_shown:
+                    if output is not None:
+                        image.save(Path(output) / f"preview_{received:05d}.png")
+                    received += 1
+                sequence_shown = sequence
+                image.paste(Image.frombytes("L", (width, rows), px), (0, first_row))
+        finally:
+            command_sender.network_unsubscribe(subscriber)
+
+    state = command_sender.camera_get_preview()
+    if state is not None:
+        click.echo(
+            f"device: {state.frames_sent} frames sent, {state.datagrams_failed} datagrams failed, "
+            f"{state.capture_failures} capture failures, filter cycles {state.filter_cycles_last} "
+            f"(max {state.filter_cycles_max})"
+        )
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
@@ -0,0 +1,109 @@
+import logging
+import socket
+import struct
+import threading
+import typing
+
+import click
+
+from commandSender import (
+    CommandSender,
+    RecorderFetchResult,
+    RecorderRange,
+    RecorderRangeType,
+)
+
+PORT_RECORDER = 1059
+RECORD_HEADER_FORMAT = "<LLH"  # frame number, time in ms, packet size
+RECORD_HEADER_SIZE = struct.calcsize(RECORD_HEADER_FORMAT)
+ACCEPT_TIMEOUT_S = 5.0
+RECEIVE_TIMEOUT_S = 10.0
+
+
+def parse_records(data: bytes):
+    """yields (frame number, time in ms, raw feature packet) per record, see App/blob/flightRecorder.md"""
+    offset = 0
+    while offset + RECORD_HEADER_SIZE <= len(data):
+        frame, time_ms, size = struct.unpack_from(RECORD_HEADER_FORMAT, data, offset)
+        offset += RECORD_HEADER_SIZE
+        if offset + size > len(data):
+            raise ValueError(f"truncated record of frame {frame}")
+        yield frame, time_ms, data[offset : offset + size]
+        offset += size
+    if offset != len(data):
+        raise ValueError("truncated record header")
+
+
+def receive(start) -> bytes:
+    received = bytearray()
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as server:
+        server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        server.bind(("0.0.0.0", PORT_RECORDER))
+        server.listen(1)
+        server.settimeout(ACCEPT_TIMEOUT_S)
+        start()
+        connection, _ = server.accept()
+        with connection:
+            connection.settimeout(RECEIVE_TIMEOUT_S)
+            while True:
+                data = connection.recv(65536)
+                if not data:
+                    break
+                received += data
+    return bytes(received)
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option(
+    "--range-type",
+    type=click.Choice([t.name for t in RecorderRangeType]),
+    default=RecorderRangeType.FRAMES.name,
+)
+@click.option("--first", default=0, help="first frame number or time in ms")
+@click.option("--last", default=0xFFFFFFFF, help="last frame number or time in ms, inclusive")
+@click.option("--output", type=click.Path(), help="writes the fetched records as received")
+def main(ip, range_type, first, last, output) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    state = command_sender.recorder_get_state()
+    assert state is not None, "get state failed"
+    click.echo(
+        f"device: {state.records} records, frames {state.oldest_frame} to {state.newest_frame}, "
+        f"{state.oldest_time_ms} to {state.newest_time_ms} ms, {state.bytes_used} of {state.bytes_capacity} bytes"
+    )
+
+    recorder_range = RecorderRange(type=RecorderRangeType[range_type], first=first, last=last)
+    results: typing.List[RecorderFetchResult] = []
+
+    def fetch():
+        result = command_sender.recorder_fetch(range=recorder_range)
+        if result is not None:
+            results.append(result)
+
+    # the command completes after the transfer, send it while receiving
+    thread = threading.Thread(target=fetch)
+    data = receive(thread.start)
+    thread.join()
+    assert len(results) == 1, "fetch failed"
+    result = results[0]
+
+    records = list(parse_records(data))
+    click.echo(
+        f"host: {len(records)} records, {len(data)} bytes, device: {result.records} records, "
+        f"{result.bytes} bytes, {result.records_lost} lost while fetching"
+    )
+    if records:
+        frames = [frame for frame, _, _ in records]
+        missing = (frames[-1] - frames[0] + 1) - len(set(frames))
+        click.echo(
+            f"frames {frames[0]} to {frames[-1]}, {missing} missing, "
+            f"{records[0][1]} to {records[-1][1]} ms"
+        )
+    if output is not None:
+        with open(output, "wb") as f:
+            f.write(data)
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
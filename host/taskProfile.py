@@ -0,0 +1,50 @@
+import logging
+import time
+
+import click
+
+from commandSender import CommandSender
+
+STATES = ["running", "ready", "blocked", "suspended", "deleted"]
+
+
+# Prints the latest task profiler sample of the firmware, one line per task.
+# The firmware samples once per second, cpu shares are in percent of that period, maxima since boot.
+# Stack free is the least free stack since task start, use it to right-size the task stacks (freertos.c).
+def print_profile(command_sender: CommandSender) -> None:
+    first = command_sender.task_profile_get(index=0)
+    assert first is not None, "get task profile failed"
+    click.echo(
+        f"period {first.period_ms} ms, busy {first.busy_permille / 10:5.1f}%"
+        f" (max {first.busy_permille_max / 10:5.1f}%)"
+    )
+    click.echo(
+        f"{'task':<16} {'prio':>4} {'state':<9} {'cpu %':>6} {'max %':>6}"
+        f" {'stack free':>10}"
+    )
+    for index in range(first.task_count):
+        task = first if index == 0 else command_sender.task_profile_get(index=index)
+        assert task is not None, f"get task profile {index} failed"
+        state = STATES[task.state] if task.state < len(STATES) else str(task.state)
+        click.echo(
+            f"{task.name:<16} {task.priority:>4} {state:<9} {task.cpu_permille / 10:>6.1f}"
+            f" {task.cpu_permille_max / 10:>6.1f} {task.stack_free_min:>10}"
+        )
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option("--interval", default=0.0, help="repeat every interval s, 0 prints once")
+def main(ip, interval) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    while True:
+        print_profile(command_sender)
+        if interval <= 0:
+            break
+        time.sleep(interval)
+        click.echo()
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
@@ -0,0 +1,82 @@
+import ipaddress
+import logging
+import socket
+import struct
+import threading
+import time
+
+import click
+
+from commandSender import CommandSender, TimeSyncConfig
+
+PORT_TIME_SYNC = 1062
+REQUEST_FORMAT = "<BBHQ"  # type, sequence, reserved, t1
+REPLY_FORMAT = "<BBHQQQ"  # type, sequence, reserved, t1 (echoed), t2, t3
+TYPE_REQUEST = 1
+TYPE_REPLY = 2
+
+
+def now_us() -> int:
+    return time.time_ns() // 1000
+
+
+def serve(port: int) -> None:
+    """answer time sync requests with the host clock, us since the unix epoch
+
+    The devices follow this clock, keep the host itself on ntp / ptp if the absolute time matters.
+    """
+    logger = logging.getLogger("TimeSyncMaster")
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.bind(("0.0.0.0", port))
+        logger.info(f"serving on port {port}")
+        while True:
+            data, address = sock.recvfrom(64)
+            t2 = now_us()
+            if len(data) != struct.calcsize(REQUEST_FORMAT):
+                logger.warning(f"{address[0]}: request of {len(data)} bytes ignored")
+                continue
+            request_type, sequence, _, t1 = struct.unpack(REQUEST_FORMAT, data)
+            if request_type != TYPE_REQUEST:
+                continue
+            sock.sendto(struct.pack(REPLY_FORMAT, TYPE_REPLY, sequence, 0, t1, t2, now_us()), address)
+
+
+# Time sync master (see network_time_sync_set_config in App/command/commands.md), also the local stand-in for a rig
+# master. With --ip the sync is enabled on these devices and their state is printed every --interval seconds.
+@click.command()
+@click.option("--port", type=int, default=PORT_TIME_SYNC, help="udp port to serve on")
+@click.option("--ip", multiple=True, help="vision add-on ip to enable the sync on, repeatable")
+@click.option("--master", default="0.0.0.0", help="master address the devices use, 0.0.0.0 is the default host")
+@click.option("--period-ms", type=int, default=1000, help="time between sync rounds")
+@click.option("--stamp-packets", is_flag=True, help="append the synchronised time to the feature packets")
+@click.option("--interval", type=float, default=5.0, help="seconds between state reports")
+def main(port, ip, master, period_ms, stamp_packets, interval) -> None:
+    threading.Thread(target=serve, args=(port,), daemon=True, name="master").start()
+    senders = {device: CommandSender(target_ip=device) for device in ip}
+    config = TimeSyncConfig(
+        enabled=True,
+        master=ipaddress.IPv4Address(master),
+        port=port if port != PORT_TIME_SYNC else 0,
+        period_ms=period_ms,
+        stamp_packets=stamp_packets,
+    )
+    for device, sender in senders.items():
+        assert sender.network_time_sync_set_config(config), f"{device}: time sync config refused"
+    while True:
+        time.sleep(interval)
+        for device, sender in senders.items():
+            state = sender.network_time_sync_get_state()
+            if state is None:
+                click.echo(f"{device:<15} no response")
+                continue
+            click.echo(
+                f"{device:<15} {'synced' if state.synchronized else 'unsynced':<8} offset {state.offset_us:>6} us"
+                f"  jitter {state.jitter_us:>5} us  delay {state.delay_us:>5} us  drift {state.drift_ppb / 1000:>8.3f} ppm"
+                f"  rounds {state.rounds} ({state.failed_rounds} failed, {state.steps} steps)"
+                f"  device - host {state.time_us - now_us():>7} us"
+            )
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
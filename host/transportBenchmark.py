@@ -0,0 +1,51 @@
+import logging
+import time
+
+import click
+
+from commandSender import BlobTransport, CommandSender
+
+
+# Compares the cost of handing feature packets to lwip for every blob transport.
+# The firmware measures the cycles spent in the send call of each packet, the counters are reset on every
+# transport change. Rebuild the firmware with LWIP_TCPIP_CORE_LOCKING 0 / 1 (lwipopts.h) and rerun to compare
+# the tcpip_callback and core locking variants of the raw api path.
+# The blob stream must be running (camera or fake input) and a receiver must listen for the tcp transport.
+def benchmark(command_sender: CommandSender, transport: BlobTransport, duration_s: float) -> None:
+    assert command_sender.pipeline_set_transport(transport=transport) is True, (
+        "set transport failed"
+    )
+    start = command_sender.pipeline_get_stream_stats()
+    assert start is not None, "get stream stats failed"
+    time.sleep(duration_s)
+    end = command_sender.pipeline_get_stream_stats()
+    assert end is not None, "get stream stats failed"
+
+    sent = end.packets_sent - start.packets_sent
+    failed = end.send_failures - start.send_failures
+    click.echo(
+        f"{transport.name:<12} packets {sent:>8} ({sent / duration_s:8.1f}/s)  failures {failed:>6}"
+        f"  cycles/packet mean {end.send_cycles_mean:>8}  max {end.send_cycles_max:>8}"
+    )
+
+
+@click.command()
+@click.option("--ip", default="10.0.0.1", help="vision add-on ip")
+@click.option("--duration", default=10.0, help="measurement duration per transport in s")
+@click.option(
+    "--transport",
+    "transports",
+    multiple=True,
+    type=click.Choice([t.name for t in BlobTransport]),
+    default=[t.name for t in BlobTransport],
+)
+def main(ip, duration, transports) -> None:
+    command_sender = CommandSender(target_ip=ip)
+    for name in transports:
+        benchmark(command_sender, BlobTransport[name], duration)
+    command_sender.pipeline_set_transport(transport=BlobTransport.UDP_RAW)
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    main()
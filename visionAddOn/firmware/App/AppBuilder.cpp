@@ -1,52 +1,91 @@
 #include "AppBuilder.h"
 #include "command/CommandTypes.h"
+#include "metrics/BootTimeline.h"
 #include "network/NetworkTypes.h"
 #include "utils/assert.h"
+#include "utils/constants.h"
 #include "utils/Log.h"
 
 #include <stdio.h>
 
 extern "C" {
 #include "dcmi.h"
+#include "dma.h"
 #include "usart.h"
 #include "i2c.h"
 #include "spi.h"
 }
 
-static constexpr bool BLOB_RECEIVER_USE_UDP {true};
+static constexpr BlobTransport BLOB_RECEIVER_TRANSPORT {BlobTransport::TRANSPORT_UDP_RAW};
 struct netif* AppBuilder::_networkInterface {nullptr};
 
 AppBuilder::AppBuilder():
 _camera{std::make_unique<Ov9281>(&hi2c1, 0xC0, &hdcmi)},
-_bufferPoolMutex{std::make_unique<Mutex>()},
 _spiRxToBlobReceiverQ{osMessageQueueNew(10, sizeof(ExternalIsrToBlobReceiverQMessage), NULL)},
 _spiRxInterruptHandler{std::make_unique<ExternalInterruptHandler>(&hspi1, _spiRxToBlobReceiverQ)},
-_blobReceiver{std::make_unique<BlobReceiver>(_spiRxToBlobReceiverQ, BLOB_RECEIVER_USE_UDP)},
-_frameTransfer{std::make_unique<FrameTransfer>()},
+_frameStatisticsQ{osMessageQueueNew(4, sizeof(FrameStatistics), NULL)},
+_subscriptions{std::make_unique<Subscriptions>()},
+_blobReceiver{std::make_unique<BlobReceiver>(_spiRxToBlobReceiverQ, *_subscriptions, BLOB_RECEIVER_TRANSPORT, _frameStatisticsQ)},
+_frameTransfer{std::make_unique<FrameTransfer>(*_subscriptions)},
+_frameHistory{std::make_unique<FrameHistory>(*_camera, reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_FRAME_HISTORY_ADDRESS), EXTERNAL_SDRAM_FRAME_HISTORY_SIZE_BYTES)},
+_previewStream{std::make_unique<PreviewStream>(*_camera, *_frameHistory, *_subscriptions, reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_PREVIEW_ADDRESS))},
 _eeprom{std::make_unique<At24c02d>(&hi2c4, 0b10101111, 0b10101110)},
 _networkManager{std::make_unique<NetworkManager>(_networkInterface,  *_eeprom, NetworkManager::GpioPin{GPIOC, GPIO_PIN_13})},
-_networkStats{std::make_unique<NetworkStats>()},
-_fpgaCommander{std::make_unique<FpgaCommander>(&huart2)}
+_calibrationManager{std::make_unique<CalibrationManager>(*_eeprom)},
+_networkBenchmark{std::make_unique<NetworkBenchmark>()},
+_timeSync{std::make_unique<TimeSync>()},
+_fpgaCommander{std::make_unique<FpgaCommander>(&huart2)},
+_autoExposure{std::make_unique<AutoExposure>(_frameStatisticsQ, *_camera, *_fpgaCommander)},
+_taskProfiler{std::make_unique<TaskProfiler>()},
+_memoryBenchmark{std::make_unique<MemoryBenchmark>(reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS), reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_SCRATCH_ADDRESS), FrameHistory::FRAME_SIZE)},
+_imageKernelBenchmark{std::make_unique<ImageKernelBenchmark>(reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS), reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_SCRATCH_ADDRESS))},
+_sdramTest{std::make_unique<SdramTest>(&hdma_memtomem_dma2_stream2)},
+_metrics{std::make_unique<Metrics>(*_blobReceiver, *_taskProfiler, _spiRxToBlobReceiverQ, _frameStatisticsQ)}
 {
+    CycleCounter::init();
+    Log::registerSubscriptions(*_subscriptions);
+    _blobReceiver->observe([this](uint8_t blobCount, uint8_t identifiedMarkers) {
+        _frameHistory->observe(blobCount, identifiedMarkers);
+    });
     ExternalInterruptHandler::registerHandler(EXTI10_SPI_NEW_DATA_Pin, *_spiRxInterruptHandler);
+    if(!_spiRxInterruptHandler->start()) {
+        Log::error("[AppBuilder] spi receive start failed");
+    }
 
     CommandHandler::CameraRequestCapture cameraRequestCapture = [this]() -> bool {
-        return _camera->capture();
+        return _frameHistory->capture();
     };
     CommandHandler::CameraRequestFrameTransfer cameraRequestFrameTransfer = [this](uint32_t address, uint32_t port) -> bool {
-        return _frameTransfer->sendFrame(static_cast<in_addr_t>(address), port);
+        return _frameTransfer->publishFrame(static_cast<in_addr_t>(address), port);
     };
     CommandHandler::CameraSetWhitebalance cameraSetWhitebalance = [this](uint16_t red, uint16_t green, uint16_t blue) -> bool {
         return _camera->whitebalance(red, green, blue);
     };
     CommandHandler::CameraSetExposure cameraSetExposure = [this](uint16_t levelInteger, uint8_t levelFraction) -> bool {
-        return _camera->exposure(levelInteger, levelFraction);
+        return _autoExposure->exposure(levelInteger, levelFraction);
     };
     CommandHandler::CameraSetGain cameraSetGain = [this](uint8_t level, uint8_t band) -> bool {
-        return _camera->gain(level, band);
+        return _autoExposure->gain(level, band);
+    };
+    CommandHandler::CameraSetMode cameraSetMode = [this](SensorMode mode) -> bool {
+        if(!_camera->init(mode)) {
+            return false;
+        }
+        const SensorModeInfo info {sensorModeInfo(mode)};
+        _autoExposure->syncSensorMode(info);
+        return _fpgaCommander->pipelineGeometry(info);
+    };
+    CommandHandler::CameraSetFps cameraSetFps = [cameraSetMode](Fps fps) -> bool {
+        return cameraSetMode(sensorModeFromFps(fps));
+    };
+    CommandHandler::CameraGetMode cameraGetMode = [this](void) -> SensorModeInfo {
+        return sensorModeInfo(_camera->mode());
     };
-    CommandHandler::CameraSetFps cameraSetFps = [this](Fps fps) -> bool {
-        return _camera->init(fps);
+    CommandHandler::CameraSetPreview cameraSetPreview = [this](const PreviewConfig& config) -> bool {
+        return _previewStream->config(config);
+    };
+    CommandHandler::CameraGetPreview cameraGetPreview = [this]() -> PreviewState {
+        return _previewStream->state();
     };
     CommandHandler::NetworkGetMac networkGetMac = [this](void) -> MacAddress {
         return _networkManager->mac();
@@ -75,6 +114,21 @@ _fpgaCommander{std::make_unique<FpgaCommander>(&huart2)}
     CommandHandler::NetworkPersistConfig networkPersistConfig = [this](void) -> void {
         _networkManager->persistToStorage();
     };
+    CommandHandler::NetworkBenchmarkStart networkBenchmarkStart = [this](const NetworkBenchmarkConfig& config) -> bool {
+        return _networkBenchmark->start(config);
+    };
+    CommandHandler::NetworkBenchmarkGetResult networkBenchmarkGetResult = [this](void) -> NetworkBenchmarkResult {
+        return _networkBenchmark->result();
+    };
+    CommandHandler::NetworkSubscribe networkSubscribe = [this](const Subscriber& subscriber) -> bool {
+        return _subscriptions->subscribe(subscriber);
+    };
+    CommandHandler::NetworkUnsubscribe networkUnsubscribe = [this](const Subscriber& subscriber) -> bool {
+        return _subscriptions->unsubscribe(subscriber);
+    };
+    CommandHandler::NetworkGetSubscribers networkGetSubscribers = [this](std::array<Subscriber, Subscriptions::MAX_SUBSCRIBERS>& subscribers) -> size_t {
+        return _subscriptions->subscribers(subscribers);
+    };
     CommandHandler::PipelineSetInput pipelineSetInput = [this](PipelineInput input) -> bool {
         return _fpgaCommander->pipelineInput(input);
     };
@@ -82,7 +136,55 @@ _fpgaCommander{std::make_unique<FpgaCommander>(&huart2)}
         return _fpgaCommander->pipelineOutput(output);
     };
     CommandHandler::PipelineSetBinarizationThreshold pipelineSetBinarizationThreshold = [this](uint8_t threshold) -> bool {
-        return _fpgaCommander->pipelineBinarizationThreshold(threshold);
+        return _autoExposure->threshold(threshold);
+    };
+    CommandHandler::PipelineGetStreamStats pipelineGetStreamStats = [this](void) -> FeatureStreamStats {
+        return _blobReceiver->stats();
+    };
+    CommandHandler::PipelineSetTransport pipelineSetTransport = [this](BlobTransport transport) -> bool {
+        return _blobReceiver->transport(transport);
+    };
+    CommandHandler::PipelineSetTracking pipelineSetTracking = [this](const BlobTrackerConfig& config) -> bool {
+        if(config.enabled && _pipelineStreaming) {
+            Log::warning("[AppBuilder] tracking refused, streamed frames are forwarded raw");
+            return false;
+        }
+        return _blobReceiver->tracker().config(config);
+    };
+    CommandHandler::PipelineGetTracking pipelineGetTracking = [this](void) -> BlobTrackerState {
+        return _blobReceiver->tracker().state();
+    };
+    CommandHandler::PipelineSetBlinkCodes pipelineSetBlinkCodes = [this](const BlinkDecoderConfig& config) -> bool {
+        if(config.enabled && _pipelineStreaming) {
+            Log::warning("[AppBuilder] blink decoding refused, streamed frames are forwarded raw");
+            return false;
+        }
+        return _blobReceiver->blinkDecoder().config(config);
+    };
+    CommandHandler::PipelineGetBlinkCodes pipelineGetBlinkCodes = [this](void) -> BlinkDecoderState {
+        return _blobReceiver->blinkDecoder().state();
+    };
+    CommandHandler::PipelineSetDeltaEncoding pipelineSetDeltaEncoding = [this](const DeltaEncoderConfig& config) -> bool {
+        if(config.enabled && _pipelineStreaming) {
+            Log::warning("[AppBuilder] delta encoding refused, streamed frames are forwarded raw");
+            return false;
+        }
+        return _blobReceiver->deltaEncoder().config(config);
+    };
+    CommandHandler::PipelineGetDeltaEncoding pipelineGetDeltaEncoding = [this](void) -> DeltaEncoderState {
+        return _blobReceiver->deltaEncoder().state();
+    };
+    CommandHandler::PipelineSetStreaming pipelineSetStreaming = [this](bool enable) -> bool {
+        if(enable && (_blobReceiver->tracker().state().config.enabled || _blobReceiver->blinkDecoder().state().config.enabled
+            || _blobReceiver->deltaEncoder().state().config.enabled)) {
+            Log::warning("[AppBuilder] streaming refused, disable tracking, blink decoding and delta encoding first");
+            return false;
+        }
+        if(!_fpgaCommander->pipelineStreaming(enable)) {
+            return false;
+        }
+        _pipelineStreaming = enable;
+        return true;
     };
     CommandHandler::StrobeEnablePulse strobeEnablePulse = [this](bool enable) -> bool {
         return _fpgaCommander->strobeEnablePulse(enable);
@@ -96,15 +198,131 @@ _fpgaCommander{std::make_unique<FpgaCommander>(&huart2)}
     CommandHandler::StrobeEnableConstant strobeEnableConstant = [this](bool enable) -> bool {
         return _fpgaCommander->strobeEnableConstant(enable);
     };
+    CommandHandler::AutoExposureEnable autoExposureEnable = [this](bool enable) -> void {
+        if(enable) {
+            _autoExposure->activate();
+        } else {
+            _autoExposure->deactivate();
+        }
+    };
+    CommandHandler::AutoExposureSetConfig autoExposureSetConfig = [this](const AutoExposureConfig& config) -> bool {
+        return _autoExposure->config(config);
+    };
+    CommandHandler::AutoExposureGetConfig autoExposureGetConfig = [this](void) -> AutoExposureConfig {
+        return _autoExposure->config();
+    };
+    CommandHandler::AutoExposureGetState autoExposureGetState = [this](void) -> AutoExposureState {
+        return _autoExposure->state();
+    };
+    CommandHandler::RecorderSetConfig recorderSetConfig = [this](const RecorderConfig& config) -> void {
+        if(config.enabled && _sdramTest->busy(SdramRegion::SDRAM_REGION_RECORDER)) {
+            Log::warning("[AppBuilder] recorder stays disabled, sdram test in progress");
+            return;
+        }
+        _blobReceiver->recorder().config(config);
+    };
+    CommandHandler::RecorderGetState recorderGetState = [this](void) -> RecorderState {
+        return _blobReceiver->recorder().state();
+    };
+    CommandHandler::RecorderFetch recorderFetch = [this](const RecorderRange& range, uint32_t address, RecorderFetchResult& result) -> bool {
+        return _blobReceiver->recorder().fetch(range, static_cast<in_addr_t>(address), PORT_RECORDER, result);
+    };
+    CommandHandler::FrameHistorySetConfig frameHistorySetConfig = [this](const FrameHistoryConfig& config) -> bool {
+        if(config.enabled && _sdramTest->busy(SdramRegion::SDRAM_REGION_FRAME_HISTORY)) {
+            Log::warning("[AppBuilder] frame history refused, sdram test in progress");
+            return false;
+        }
+        return _frameHistory->config(config);
+    };
+    CommandHandler::FrameHistoryGetState frameHistoryGetState = [this]() -> FrameHistoryState {
+        return _frameHistory->state();
+    };
+    CommandHandler::FrameHistoryTrigger frameHistoryTrigger = [this]() -> bool {
+        return _frameHistory->trigger(HistoryTrigger::TRIGGER_HOST);
+    };
+    CommandHandler::FrameHistoryTransfer frameHistoryTransfer = [this](uint8_t index, uint32_t address, uint32_t port, uint32_t& timeMs) -> bool {
+        const uint8_t* frame = _frameHistory->frame(index, timeMs);
+        if(frame == nullptr) {
+            Log::warning("[AppBuilder] frame history frame %u not available, the history must be frozen", index);
+            return false;
+        }
+        return _frameTransfer->sendFrame(static_cast<in_addr_t>(address), port, frame);
+    };
+    CommandHandler::MetricsGet metricsGet = [this](void) -> RuntimeMetrics {
+        return _metrics->collect();
+    };
+    CommandHandler::TaskProfileGet taskProfileGet = [this](void) -> TaskProfile {
+        return _taskProfiler->profile();
+    };
+    CommandHandler::MemoryBenchmarkRun memoryBenchmarkRun = [this](void) -> MemoryBenchmarkResult {
+        return _memoryBenchmark->measure();
+    };
+    CommandHandler::ImageKernelBenchmarkRun imageKernelBenchmarkRun = [this](uint8_t threshold) -> ImageKernelBenchmarkResult {
+        return _imageKernelBenchmark->measure(threshold);
+    };
+    CommandHandler::SdramTestStart sdramTestStart = [this](SdramRegion region) -> bool {
+        // the users of the region are not stopped on behalf of the host
+        if((region == SdramRegion::SDRAM_REGION_FRAME_HISTORY) && _frameHistory->state().config.enabled) {
+            Log::warning("[AppBuilder] sdram test refused, the frame history must be disabled");
+            return false;
+        }
+        if((region == SdramRegion::SDRAM_REGION_RECORDER) && _blobReceiver->recorder().state().config.enabled) {
+            Log::warning("[AppBuilder] sdram test refused, the recorder must be disabled");
+            return false;
+        }
+        if(!_sdramTest->start(region)) {
+            return false;
+        }
+        if(region == SdramRegion::SDRAM_REGION_RECORDER) {
+            _blobReceiver->recorder().clear(); // the records are overwritten by the test
+        }
+        return true;
+    };
+    CommandHandler::SdramTestGetState sdramTestGetState = [this](void) -> SdramTestState {
+        return _sdramTest->state();
+    };
+    CommandHandler::BroadcastAwait broadcastAwait = [this](const BroadcastSchedule& schedule) -> BroadcastAck {
+        FrameClock& clock = _blobReceiver->frameClock();
+        BroadcastAck ack {};
+        ack.timing = BroadcastTiming::BROADCAST_IMMEDIATE;
+        if(schedule.timing == BroadcastTiming::BROADCAST_ON_FRAME) {
+            // the frames ahead at the current frame rate and a margin for the packet latency
+            static constexpr uint32_t MARGIN_MS {100U};
+            const uint8_t framesAhead = static_cast<uint8_t>(schedule.frameCount - clock.frameCount());
+            const uint16_t fps = std::max<uint16_t>(sensorModeInfo(_camera->mode()).fps, 1U);
+            const uint32_t timeoutMs = ((framesAhead * MILLISECONDS_PER_SECOND) / fps) + MARGIN_MS;
+            switch(clock.waitFor(schedule.frameCount, timeoutMs)) {
+                case FrameClock::Wait::REACHED: ack.timing = BroadcastTiming::BROADCAST_ON_FRAME; break;
+                case FrameClock::Wait::PASSED: ack.timing = BroadcastTiming::BROADCAST_LATE; break;
+                default: ack.timing = BroadcastTiming::BROADCAST_TIMEOUT; break;
+            }
+        }
+        ack.frameCount = clock.frameCount();
+        return ack;
+    };
+    CommandHandler::NetworkTimeSyncSetConfig networkTimeSyncSetConfig = [this](const TimeSyncConfig& config) -> bool {
+        if(!_timeSync->config(config)) {
+            return false;
+        }
+        _blobReceiver->stampPackets(config.stampPackets);
+        return true;
+    };
+    CommandHandler::NetworkTimeSyncGetState networkTimeSyncGetState = [this](void) -> TimeSyncState {
+        return _timeSync->state();
+    };
 
     _commandHandler = std::make_unique<CommandHandler>(
-        *_eeprom,
+        *_calibrationManager,
         cameraRequestCapture,
         cameraRequestFrameTransfer,
         cameraSetWhitebalance,
         cameraSetExposure,
         cameraSetGain,
         cameraSetFps,
+        cameraSetMode,
+        cameraGetMode,
+        cameraSetPreview,
+        cameraGetPreview,
         networkGetMac,
         networkSetMac,
         networkGetIp,
@@ -114,21 +332,63 @@ _fpgaCommander{std::make_unique<FpgaCommander>(&huart2)}
         networkGetGateway,
         networkSetGateway,
         networkPersistConfig,
+        networkBenchmarkStart,
+        networkBenchmarkGetResult,
+        networkSubscribe,
+        networkUnsubscribe,
+        networkGetSubscribers,
         pipelineSetInput,
         pipelineSetOutput,
         pipelineSetBinarizationThreshold,
+        pipelineGetStreamStats,
+        pipelineSetTransport,
+        pipelineSetTracking,
+        pipelineGetTracking,
+        pipelineSetBlinkCodes,
+        pipelineGetBlinkCodes,
+        pipelineSetDeltaEncoding,
+        pipelineGetDeltaEncoding,
+        pipelineSetStreaming,
         strobeEnablePulse,
         strobeSetOnDelay,
         strobeSetHoldTime,
-        strobeEnableConstant
+        strobeEnableConstant,
+        autoExposureEnable,
+        autoExposureSetConfig,
+        autoExposureGetConfig,
+        autoExposureGetState,
+        recorderSetConfig,
+        recorderGetState,
+        recorderFetch,
+        frameHistorySetConfig,
+        frameHistoryGetState,
+        frameHistoryTrigger,
+        frameHistoryTransfer,
+        metricsGet,
+        taskProfileGet,
+        memoryBenchmarkRun,
+        imageKernelBenchmarkRun,
+        sdramTestStart,
+        sdramTestGetState,
+        broadcastAwait,
+        networkTimeSyncSetConfig,
+        networkTimeSyncGetState
     );
     // assert product of constructor
     ASSERT(_camera != nullptr);
-    ASSERT(_bufferPoolMutex != nullptr);
     ASSERT(_blobReceiver != nullptr);
     ASSERT(_frameTransfer != nullptr);
-    ASSERT(_networkStats != nullptr);
+    ASSERT(_calibrationManager != nullptr);
+    ASSERT(_networkBenchmark != nullptr);
+    ASSERT(_timeSync != nullptr);
     ASSERT(_fpgaCommander != nullptr);
+    ASSERT(_autoExposure != nullptr);
+    ASSERT(_taskProfiler != nullptr);
+    ASSERT(_memoryBenchmark != nullptr);
+    ASSERT(_imageKernelBenchmark != nullptr);
+    ASSERT(_sdramTest != nullptr);
+    ASSERT(ImageKernelBenchmark::SCRATCH_SIZE <= EXTERNAL_SDRAM_SCRATCH_SIZE_BYTES);
+    ASSERT(_metrics != nullptr);
     ASSERT(_commandHandler != nullptr);
 }
 
@@ -144,10 +404,17 @@ void AppBuilder::initCamera() {
         Log::error("[AppBuilder] camera probably not connected");
         return;
     }    
-    if(!_camera->init(Fps::_72)) {
+    static constexpr SensorMode INIT_MODE {SensorMode::MODE_1280X800_72FPS};
+    if(!_camera->init(INIT_MODE)) {
         Log::error("[AppBuilder] camera init failed");
         return;
     }
+    // the fpga may still run the geometry of a previous session
+    if(!_fpgaCommander->pipelineGeometry(sensorModeInfo(INIT_MODE))) {
+        Log::error("[AppBuilder] pipeline geometry init failed");
+        return;
+    }
+    BootTimeline::reached(BOOT_PHASE_CAMERA);
 }
 
 void AppBuilder::initCommandHandler() {
@@ -155,9 +422,14 @@ void AppBuilder::initCommandHandler() {
 }
 
 void AppBuilder::initNetworkConfig() {
+    Log::openUdp(); // runs in the network task after lwip is up, the log subscriptions publish from every task
     _networkManager->init();
 }
 
+void AppBuilder::initCalibration() {
+    _calibrationManager->load();
+}
+
 uint8_t* AppBuilder::getMacFromStorage() {
     MacAddress mac {_networkManager->loadMacFromStorage()};
     _macAddress[0] = mac.octet0;
@@ -197,6 +469,11 @@ void app_init_network_config(){
     appBuilder->initNetworkConfig();
 }
 
+void app_init_calibration(){
+    ASSERT(appBuilder != nullptr);
+    appBuilder->initCalibration();
+}
+
 void app_run_command_handler() {
     ASSERT(appBuilder != nullptr);
     appBuilder->getCommandHandlerRunnable().run();
@@ -207,9 +484,39 @@ void app_run_blob_receiver() {
     appBuilder->getBlobReceiverRunnable().run();
 }
 
-void app_run_network_stats() {
+void app_run_auto_exposure() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getAutoExposureRunnable().run();
+}
+
+void app_run_network_benchmark() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getNetworkBenchmarkRunnable().run();
+}
+
+void app_run_task_profiler() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getTaskProfilerRunnable().run();
+}
+
+void app_run_frame_history() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getFrameHistoryRunnable().run();
+}
+
+void app_run_preview_stream() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getPreviewStreamRunnable().run();
+}
+
+void app_run_sdram_test() {
+    ASSERT(appBuilder != nullptr);
+    appBuilder->getSdramTestRunnable().run();
+}
+
+void app_run_time_sync() {
     ASSERT(appBuilder != nullptr);
-    appBuilder->getNetworkStatsRunnable().run();
+    appBuilder->getTimeSyncRunnable().run();
 }
 
 uint8_t* app_fetch_mac_address_from_storage(){
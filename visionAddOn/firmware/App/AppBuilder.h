@@ -4,14 +4,26 @@
 
 #include "c_app_builder.h"
 
+#include "autoExposure/AutoExposure.h"
 #include "blob/BlobReceiver.h"
 #include "blob/ExternalInterruptHandler.h"
+#include "camera/FrameHistory.h"
 #include "camera/Ov9281.h"
+#include "camera/PreviewStream.h"
+#include "calibration/CalibrationManager.h"
 #include "command/CommandHandler.h"
 #include "fpgaCommander/FpgaCommander.h"
 #include "frameTransfer/FrameTransfer.h"
+#include "metrics/ImageKernelBenchmark.h"
+#include "metrics/MemoryBenchmark.h"
+#include "metrics/Metrics.h"
+#include "metrics/SdramTest.h"
+#include "metrics/TaskProfiler.h"
+#include "network/NetworkBenchmark.h"
 #include "network/NetworkManager.h"
-#include "network/NetworkStats.h"
+#include "network/Subscriptions.h"
+#include "network/TimeSync.h"
+#include "utils/CycleCounter.h"
 #include "utils/mutex/Mutex.h"
 #include "utils/pool/BufferPool.h"
 #include "utils/IRunnable.h"
@@ -32,27 +44,46 @@ public:
     void initCamera();
     void initCommandHandler();
     void initNetworkConfig();
+    void initCalibration();
 
     IRunnable& getBlobReceiverRunnable(){return *_blobReceiver;};
-    IRunnable& getNetworkStatsRunnable(){return *_networkStats;};
     IRunnable& getCommandHandlerRunnable(){return *_commandHandler;};
+    IRunnable& getAutoExposureRunnable(){return *_autoExposure;};
+    IRunnable& getNetworkBenchmarkRunnable(){return *_networkBenchmark;};
+    IRunnable& getTaskProfilerRunnable(){return *_taskProfiler;};
+    IRunnable& getFrameHistoryRunnable(){return *_frameHistory;};
+    IRunnable& getPreviewStreamRunnable(){return *_previewStream;};
+    IRunnable& getSdramTestRunnable(){return *_sdramTest;};
+    IRunnable& getTimeSyncRunnable(){return *_timeSync;};
     
     uint8_t* getMacFromStorage();
 
 private:
     static struct netif* _networkInterface;
     std::unique_ptr<Ov9281> _camera;
-    std::unique_ptr<Mutex> _bufferPoolMutex;
     osMessageQueueId_t _spiRxToBlobReceiverQ;
     std::unique_ptr<ExternalInterruptHandler> _spiRxInterruptHandler;
+    osMessageQueueId_t _frameStatisticsQ;
+    std::unique_ptr<Subscriptions> _subscriptions;
     std::unique_ptr<BlobReceiver> _blobReceiver;
     std::unique_ptr<FrameTransfer> _frameTransfer;
+    std::unique_ptr<FrameHistory> _frameHistory;
+    std::unique_ptr<PreviewStream> _previewStream;
     std::unique_ptr<At24c02d> _eeprom;
     std::unique_ptr<NetworkManager> _networkManager;
-    std::unique_ptr<NetworkStats> _networkStats;
+    std::unique_ptr<CalibrationManager> _calibrationManager;
+    std::unique_ptr<NetworkBenchmark> _networkBenchmark;
+    std::unique_ptr<TimeSync> _timeSync;
     std::unique_ptr<FpgaCommander> _fpgaCommander;
+    std::unique_ptr<AutoExposure> _autoExposure;
+    std::unique_ptr<TaskProfiler> _taskProfiler;
+    std::unique_ptr<MemoryBenchmark> _memoryBenchmark;
+    std::unique_ptr<ImageKernelBenchmark> _imageKernelBenchmark;
+    std::unique_ptr<SdramTest> _sdramTest;
+    std::unique_ptr<Metrics> _metrics;
     std::unique_ptr<CommandHandler> _commandHandler;
     uint8_t _macAddress[6];
+    bool _pipelineStreaming {false}; //!< only accessed by the command task
 };
 
 #endif // VISIONADDON_APP_APPBUILDER_H
@@ -23,8 +23,8 @@ void initSdram(SDRAM_HandleTypeDef *handle) {
   /* Send the command */
   HAL_SDRAM_SendCommand(handle, &Command, 0x1000);
 
-  /* Step 4: Insert 100 ms delay */
-  HAL_Delay(100);
+  /* Step 4: Insert a delay, the AS4C16M16MSA needs 200 us after the clock is stable, one tick suffices */
+  HAL_Delay(1);
 
   /* Step 5: Configure a PALL (precharge all) command */
   Command.CommandMode            = FMC_SDRAM_CMD_PALL;
@@ -61,3 +61,56 @@ void initSdram(SDRAM_HandleTypeDef *handle) {
 
   HAL_SDRAM_ProgramRefreshRate(handle, 0x56A-20);
 }
+
+// the sdram is cached, write back to the chips and read from them and not from the cache
+static void flushSdram(void) {
+  SCB_CleanInvalidateDCache();
+}
+
+bool testSdramBus(uint32_t base, uint32_t sizeBytes, uint32_t* failedAddress) {
+  volatile uint32_t* sdram = (volatile uint32_t*)base;
+  const uint32_t words = sizeBytes / sizeof(uint32_t);
+  const uint32_t pattern = 0xaaaaaaaaU;
+  const uint32_t antipattern = 0x55555555U;
+
+  /* data bus: walking ones at the base address */
+  for(uint32_t bit = 0; bit < 32U; bit++) {
+    const uint32_t value = 1U << bit;
+    sdram[0] = value;
+    flushSdram();
+    if(sdram[0] != value) {
+      *failedAddress = base;
+      return false;
+    }
+  }
+
+  /* address bus: power of two offsets, stuck lines alias with the base or with each other */
+  for(uint32_t offset = 1; offset < words; offset <<= 1) {
+    sdram[offset] = pattern;
+  }
+  sdram[0] = antipattern;
+  flushSdram();
+  for(uint32_t offset = 1; offset < words; offset <<= 1) {
+    if(sdram[offset] != pattern) {
+      *failedAddress = base + (offset * sizeof(uint32_t));
+      return false;
+    }
+  }
+  sdram[0] = pattern;
+  for(uint32_t test = 1; test < words; test <<= 1) {
+    sdram[test] = antipattern;
+    flushSdram();
+    if(sdram[0] != pattern) {
+      *failedAddress = base + (test * sizeof(uint32_t));
+      return false;
+    }
+    for(uint32_t offset = 1; offset < words; offset <<= 1) {
+      if((offset != test) && (sdram[offset] != pattern)) {
+        *failedAddress = base + (offset * sizeof(uint32_t));
+        return false;
+      }
+    }
+    sdram[test] = pattern;
+  }
+  return true;
+}
@@ -15,6 +15,8 @@ extern "C" {
 
 #include "stm32f7xx_hal.h"
 
+#include <stdbool.h>
+
 
 #define SDRAM_MODEREG_BURST_LENGTH_1 0
 #define SDRAM_MODEREG_BURST_LENGTH_2 1
@@ -32,6 +34,15 @@ extern "C" {
 
 void initSdram(SDRAM_HandleTypeDef *handle);
 
+/**
+ * @brief Quick test of the data and address lines: walking ones on the data bus, power of two offsets on the address
+ *        bus. Some ms instead of the seconds of a full pattern test, the cells themselves are not tested.
+ *        The content at the tested addresses is overwritten.
+ * @param failedAddress first address read back wrong, untouched if the test passed
+ * @return true if all lines are ok
+ */
+bool testSdramBus(uint32_t base, uint32_t sizeBytes, uint32_t* failedAddress);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,300 @@
+#include "AutoExposure.h"
+
+#include "utils/assert.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+
+AutoExposure::AutoExposure(osMessageQueueId_t frameStatistics, Ov9281& camera, FpgaCommander& fpgaCommander) :
+_frameStatistics{frameStatistics},
+_camera{camera},
+_fpgaCommander{fpgaCommander},
+_thresholdNominal{FpgaCommander::INIT_BINARIZATION_THRESHOLD},
+_exposureLimit{sensorModeInfo(SensorMode::MODE_1280X800_72FPS).exposureLimit()}
+{
+    ASSERT(_frameStatistics != nullptr);
+    _state.exposure = Ov9281::INIT_EXPOSURE_LEVEL_INTEGER;
+    _state.gain = Ov9281::INIT_GAIN_LEVEL;
+    _state.threshold = FpgaCommander::INIT_BINARIZATION_THRESHOLD;
+}
+
+void AutoExposure::run() {
+    FrameStatistics statistics {};
+    auto qStatus = osMessageQueueGet(_frameStatistics, &statistics, NULL, osWaitForever);
+    if(qStatus != osOK) {
+        Log::error("[AutoExposure] osMessageQueueGet returned with status %d", qStatus);
+        return;
+    }
+
+    _writeMutex.lock();
+    control(statistics);
+    _writeMutex.unlock();
+}
+
+void AutoExposure::control(const FrameStatistics& statistics) {
+    _mutex.lock();
+    _state.framesProcessed++;
+    _state.lastFrameCount = statistics.frameCount;
+    if(!_state.active) {
+        _mutex.unlock();
+        return;
+    }
+    if(_skipFrames > 0) {
+        _skipFrames--;
+        _mutex.unlock();
+        return;
+    }
+
+    _windowFrames++;
+    _windowBlobCount += statistics.blobCount;
+    _windowAreaSum += statistics.areaSum;
+    if(_windowFrames < _config.settleFrames) {
+        _mutex.unlock();
+        return;
+    }
+
+    const uint32_t meanBlobCount = (_windowBlobCount + (_windowFrames / 2)) / _windowFrames;
+    const uint32_t meanBlobArea = (_windowBlobCount > 0) ? static_cast<uint32_t>(_windowAreaSum / _windowBlobCount) : 0U;
+    _state.meanBlobCount = static_cast<uint8_t>(std::min<uint32_t>(meanBlobCount, UINT8_MAX));
+    _state.meanBlobArea = static_cast<uint16_t>(std::min<uint32_t>(meanBlobArea, UINT16_MAX));
+
+    // too many or too large blobs means noise / blooming, too bright wins over too dark
+    Step step {};
+    if((meanBlobCount > _config.blobCountMax) || (meanBlobArea > _config.blobAreaMax)) {
+        step = darken();
+    } else if(meanBlobCount < _config.blobCountMin) {
+        step = brighten();
+    }
+
+    // the sensor and fpga writes take a while, state() and config() are not blocked meanwhile
+    _mutex.unlock();
+    const bool written = write(step);
+    _mutex.lock();
+
+    AutoExposureAction action {step.action};
+    if(!written) {
+        action = AutoExposureAction::ACTION_FAILED;
+    } else {
+        commit(step);
+    }
+    if((action != AutoExposureAction::ACTION_NONE) && (action != AutoExposureAction::ACTION_LIMIT_REACHED)) {
+        if(action != _state.lastAction) {
+            Log::debug("[AutoExposure] action %u, exposure %u, gain %u, threshold %u", action, _state.exposure, _state.gain, _state.threshold);
+        }
+        if(action != AutoExposureAction::ACTION_FAILED) {
+            _state.adjustments++;
+        }
+        resetWindow(_SENSOR_LATENCY_FRAMES);
+    } else {
+        resetWindow(0U);
+    }
+    if((action == AutoExposureAction::ACTION_LIMIT_REACHED) && (_state.lastAction != AutoExposureAction::ACTION_LIMIT_REACHED)) {
+        Log::warning("[AutoExposure] limit reached, mean blob count %u, mean blob area %u", meanBlobCount, meanBlobArea);
+    }
+    _state.lastAction = action;
+    _mutex.unlock();
+}
+
+AutoExposure::Step AutoExposure::brighten() const {
+    const uint8_t thresholdNominal = std::clamp(_thresholdNominal, _config.thresholdMin, _config.thresholdMax);
+    if(_state.threshold > thresholdNominal) {
+        const uint8_t threshold = static_cast<uint8_t>(std::max<int32_t>(_state.threshold - _THRESHOLD_STEP, thresholdNominal));
+        return {AutoExposureAction::ACTION_BRIGHTEN_THRESHOLD, threshold};
+    }
+    if(_state.exposure < exposureMax()) {
+        const uint16_t step = std::max<uint16_t>(_state.exposure / _EXPOSURE_STEP_DIVISOR, 1U);
+        const uint16_t exposure = static_cast<uint16_t>(std::clamp<uint32_t>(_state.exposure + step, exposureMin(), exposureMax()));
+        return {AutoExposureAction::ACTION_BRIGHTEN_EXPOSURE, exposure};
+    }
+    if(_state.gain < _config.gainMax) {
+        const uint8_t gain = static_cast<uint8_t>(std::clamp<uint32_t>(_state.gain + _GAIN_STEP, _config.gainMin, _config.gainMax));
+        return {AutoExposureAction::ACTION_BRIGHTEN_GAIN, gain};
+    }
+    if(_state.threshold > _config.thresholdMin) {
+        const uint8_t threshold = static_cast<uint8_t>(std::max<int32_t>(_state.threshold - _THRESHOLD_STEP, _config.thresholdMin));
+        return {AutoExposureAction::ACTION_BRIGHTEN_THRESHOLD, threshold};
+    }
+    return {AutoExposureAction::ACTION_LIMIT_REACHED, 0U};
+}
+
+AutoExposure::Step AutoExposure::darken() const {
+    const uint8_t thresholdNominal = std::clamp(_thresholdNominal, _config.thresholdMin, _config.thresholdMax);
+    if(_state.threshold < thresholdNominal) {
+        const uint8_t threshold = static_cast<uint8_t>(std::min<int32_t>(_state.threshold + _THRESHOLD_STEP, thresholdNominal));
+        return {AutoExposureAction::ACTION_DARKEN_THRESHOLD, threshold};
+    }
+    if(_state.gain > _config.gainMin) {
+        const uint8_t gain = static_cast<uint8_t>(std::clamp<int32_t>(_state.gain - _GAIN_STEP, _config.gainMin, _config.gainMax));
+        return {AutoExposureAction::ACTION_DARKEN_GAIN, gain};
+    }
+    if(_state.exposure > exposureMin()) {
+        const uint16_t step = std::max<uint16_t>(_state.exposure / _EXPOSURE_STEP_DIVISOR, 1U);
+        const uint16_t exposure = static_cast<uint16_t>(std::clamp<int32_t>(_state.exposure - step, exposureMin(), exposureMax()));
+        return {AutoExposureAction::ACTION_DARKEN_EXPOSURE, exposure};
+    }
+    if(_state.threshold < _config.thresholdMax) {
+        const uint8_t threshold = static_cast<uint8_t>(std::min<int32_t>(_state.threshold + _THRESHOLD_STEP, _config.thresholdMax));
+        return {AutoExposureAction::ACTION_DARKEN_THRESHOLD, threshold};
+    }
+    return {AutoExposureAction::ACTION_LIMIT_REACHED, 0U};
+}
+
+bool AutoExposure::write(const Step& step) {
+    switch(step.action) {
+        case AutoExposureAction::ACTION_BRIGHTEN_EXPOSURE:
+        case AutoExposureAction::ACTION_DARKEN_EXPOSURE:
+            return _camera.exposure(step.value);
+        case AutoExposureAction::ACTION_BRIGHTEN_GAIN:
+        case AutoExposureAction::ACTION_DARKEN_GAIN:
+            return _camera.gain(static_cast<uint8_t>(step.value));
+        case AutoExposureAction::ACTION_BRIGHTEN_THRESHOLD:
+        case AutoExposureAction::ACTION_DARKEN_THRESHOLD:
+            return _fpgaCommander.pipelineBinarizationThreshold(static_cast<uint8_t>(step.value));
+        default:
+            return true; // nothing to write
+    }
+}
+
+void AutoExposure::commit(const Step& step) {
+    switch(step.action) {
+        case AutoExposureAction::ACTION_BRIGHTEN_EXPOSURE:
+        case AutoExposureAction::ACTION_DARKEN_EXPOSURE:
+            _state.exposure = step.value;
+            break;
+        case AutoExposureAction::ACTION_BRIGHTEN_GAIN:
+        case AutoExposureAction::ACTION_DARKEN_GAIN:
+            _state.gain = static_cast<uint8_t>(step.value);
+            break;
+        case AutoExposureAction::ACTION_BRIGHTEN_THRESHOLD:
+        case AutoExposureAction::ACTION_DARKEN_THRESHOLD:
+            _state.threshold = static_cast<uint8_t>(step.value);
+            break;
+        default:
+            break;
+    }
+}
+
+void AutoExposure::resetWindow(uint8_t skipFrames) {
+    _windowFrames = 0U;
+    _windowBlobCount = 0U;
+    _windowAreaSum = 0U;
+    _skipFrames = skipFrames;
+}
+
+uint16_t AutoExposure::exposureMax() const {
+    return std::min(_config.exposureMax, _exposureLimit);
+}
+
+uint16_t AutoExposure::exposureMin() const {
+    return std::min(_config.exposureMin, exposureMax());
+}
+
+bool AutoExposure::active() {
+    _mutex.lock();
+    bool active = _state.active;
+    _mutex.unlock();
+    return active;
+}
+
+void AutoExposure::activate() {
+    _writeMutex.lock(); // a manual write in progress completes first
+    _mutex.lock();
+    resetWindow(0U);
+    _state.active = true;
+    _state.lastAction = AutoExposureAction::ACTION_NONE;
+    _mutex.unlock();
+    _writeMutex.unlock();
+    Log::info("[AutoExposure] activated");
+}
+
+void AutoExposure::deactivate() {
+    _mutex.lock();
+    _state.active = false;
+    _mutex.unlock();
+    Log::info("[AutoExposure] deactivated");
+}
+
+bool AutoExposure::config(const AutoExposureConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[AutoExposure] invalid config rejected");
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    resetWindow(0U);
+    _mutex.unlock();
+    return true;
+}
+
+AutoExposureConfig AutoExposure::config() {
+    _mutex.lock();
+    AutoExposureConfig config = _config;
+    _mutex.unlock();
+    return config;
+}
+
+AutoExposureState AutoExposure::state() {
+    _mutex.lock();
+    AutoExposureState state = _state;
+    _mutex.unlock();
+    return state;
+}
+
+bool AutoExposure::exposure(uint16_t levelInteger, uint8_t levelFraction) {
+    _writeMutex.lock();
+    if(active()) {
+        _writeMutex.unlock();
+        Log::warning("[AutoExposure] exposure is controlled by auto exposure");
+        return false;
+    }
+    const bool written = _camera.exposure(levelInteger, levelFraction);
+    if(written) {
+        _mutex.lock();
+        _state.exposure = levelInteger;
+        resetWindow(_SENSOR_LATENCY_FRAMES);
+        _mutex.unlock();
+    }
+    _writeMutex.unlock();
+    return written;
+}
+
+bool AutoExposure::gain(uint8_t level, uint8_t band) {
+    _writeMutex.lock();
+    if(active()) {
+        _writeMutex.unlock();
+        Log::warning("[AutoExposure] gain is controlled by auto exposure");
+        return false;
+    }
+    const bool written = _camera.gain(level, band);
+    if(written) {
+        _mutex.lock();
+        _state.gain = level;
+        resetWindow(_SENSOR_LATENCY_FRAMES);
+        _mutex.unlock();
+    }
+    _writeMutex.unlock();
+    return written;
+}
+
+bool AutoExposure::threshold(uint8_t threshold) {
+    _writeMutex.lock();
+    const bool written = _fpgaCommander.pipelineBinarizationThreshold(threshold);
+    if(written) {
+        _mutex.lock();
+        _state.threshold = threshold;
+        _thresholdNominal = threshold;
+        resetWindow(0U);
+        _mutex.unlock();
+    }
+    _writeMutex.unlock();
+    return written;
+}
+
+void AutoExposure::syncSensorMode(const SensorModeInfo& info) {
+    _mutex.lock();
+    _state.exposure = info.exposure;
+    _state.gain = Ov9281::INIT_GAIN_LEVEL;
+    _exposureLimit = info.exposureLimit();
+    resetWindow(_SENSOR_LATENCY_FRAMES);
+    _mutex.unlock();
+}
@@ -0,0 +1,110 @@
+#ifndef VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURE_H
+#define VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURE_H
+
+#include "AutoExposureTypes.h"
+#include "blob/BlobTypes.h"
+#include "camera/Ov9281.h"
+#include "cmsis_os2.h"
+#include "fpgaCommander/FpgaCommander.h"
+#include "utils/IActivatable.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <cstdint>
+
+// Closed loop control of exposure, gain and binarization threshold based on the per frame blob statistics.
+//
+// Statistics are averaged over a window of settleFrames frames, at most one parameter is changed by one step per window.
+// No correction is applied while the mean blob count lies within [blobCountMin, blobCountMax] and the mean blob area
+// stays below blobAreaMax, this band is the hysteresis of the controller.
+// Parameters are changed along a single path, from dark to bright:
+// threshold max -> nominal, exposure min -> max, gain min -> max, threshold nominal -> min.
+// Darken walks the same path backwards. This keeps noise low (gain only once exposure is exhausted)
+// and prevents the controller from trading one parameter against another.
+// The nominal threshold is the last manually set one.
+class AutoExposure final : public IRunnable, public IActivatable {
+public:
+    AutoExposure(osMessageQueueId_t frameStatistics, Ov9281& camera, FpgaCommander& fpgaCommander);
+    AutoExposure (const AutoExposure&) = delete;
+    AutoExposure& operator=(const AutoExposure&) = delete;
+    AutoExposure (const AutoExposure&&) = delete;
+    AutoExposure& operator=(const AutoExposure&&) = delete;
+
+    void run() override; //!< blocking!
+
+    bool active() override;
+    void activate() override;
+    void deactivate() override;
+
+    /**
+     * @brief Set the controller limits and target band.
+     *
+     * Parameters currently outside of the new limits are pulled in by the next control steps.
+     *
+     * @param config to apply
+     * @return true if config is valid and was applied, false otherwise
+     */
+    bool config(const AutoExposureConfig& config);
+    AutoExposureConfig config();
+
+    AutoExposureState state();
+
+    /**
+     * @brief Manually set exposure or gain, refused while the controller is active.
+     *
+     * The active check and the sensor write are atomic with respect to activate() and the control loop.
+     *
+     * @return true if written, false if refused or the write failed
+     */
+    bool exposure(uint16_t levelInteger, uint8_t levelFraction);
+    bool gain(uint8_t level, uint8_t band);
+
+    /**
+     * @brief Manually set the binarization threshold, also while active. It becomes the nominal threshold.
+     *
+     * @return true if written, false otherwise
+     */
+    bool threshold(uint8_t threshold);
+
+    /**
+     * @brief Inform the controller about a sensor mode change.
+     *
+     * The sensor resets exposure and gain to the mode defaults, the exposure is additionally limited by the frame length.
+     */
+    void syncSensorMode(const SensorModeInfo& info);
+
+private:
+    struct Step {
+        AutoExposureAction action {AutoExposureAction::ACTION_NONE};
+        uint16_t value {0U}; //!< exposure, gain or threshold, depending on the action
+    };
+
+    void control(const FrameStatistics& statistics); //!< must hold _writeMutex
+    Step brighten() const; //!< must hold _mutex
+    Step darken() const; //!< must hold _mutex
+    bool write(const Step& step); //!< must hold _writeMutex
+    void commit(const Step& step); //!< must hold _mutex
+    void resetWindow(uint8_t skipFrames);
+    uint16_t exposureMax() const; //!< configured maximum, limited by the sensor mode
+    uint16_t exposureMin() const; //!< configured minimum, limited by the sensor mode
+
+    osMessageQueueId_t _frameStatistics;
+    Ov9281& _camera;
+    FpgaCommander& _fpgaCommander;
+    Mutex _writeMutex; //!< serializes the sensor and fpga writes, taken before _mutex
+    Mutex _mutex;
+    AutoExposureConfig _config {};
+    AutoExposureState _state {};
+    uint8_t _thresholdNominal;
+    uint16_t _exposureLimit;
+    uint8_t _windowFrames {0U};
+    uint8_t _skipFrames {0U};
+    uint32_t _windowBlobCount {0U};
+    uint64_t _windowAreaSum {0U};
+    static constexpr uint8_t _SENSOR_LATENCY_FRAMES {2U}; //!< frames until a new exposure / gain is visible in the statistics
+    static constexpr uint16_t _EXPOSURE_STEP_DIVISOR {8U}; //!< exposure step is 1/8 of the current exposure
+    static constexpr uint8_t _GAIN_STEP {1U};
+    static constexpr uint8_t _THRESHOLD_STEP {4U};
+};
+
+#endif // VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURE_H
@@ -0,0 +1,137 @@
+#ifndef VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURETYPES_H
+#define VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURETYPES_H
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+enum AutoExposureAction : uint8_t {
+    ACTION_NONE = 0x00, //!< frame statistics within target band
+    ACTION_BRIGHTEN_EXPOSURE = 0x01,
+    ACTION_BRIGHTEN_GAIN = 0x02,
+    ACTION_BRIGHTEN_THRESHOLD = 0x03,
+    ACTION_DARKEN_EXPOSURE = 0x04,
+    ACTION_DARKEN_GAIN = 0x05,
+    ACTION_DARKEN_THRESHOLD = 0x06,
+    ACTION_LIMIT_REACHED = 0x07, //!< correction required but all parameters at their limit
+    ACTION_FAILED = 0x08, //!< applying the correction failed
+    ACTION_UNDEFINED = UINT8_MAX
+};
+
+class AutoExposureConfig {
+public:
+    uint8_t blobCountMin = {2}; //!< fewer blobs on average -> brighten
+    uint8_t blobCountMax = {8}; //!< more blobs on average -> darken
+    uint16_t blobAreaMax = {400}; //!< larger average blob area in px -> darken
+    uint16_t exposureMin = {16}; //!< exposure in row periods
+    uint16_t exposureMax = {880}; //!< exposure in row periods, additionally limited to the sensor mode frame length - 25
+    uint8_t gainMin = {0};
+    uint8_t gainMax = {16};
+    uint8_t thresholdMin = {64};
+    uint8_t thresholdMax = {240};
+    uint8_t settleFrames = {8}; //!< frames averaged per control step, at most one step per window
+
+    static constexpr size_t SIZE {13};
+    static constexpr size_t OFFSET_BLOB_COUNT_MIN {0};
+    static constexpr size_t OFFSET_BLOB_COUNT_MAX {OFFSET_BLOB_COUNT_MIN + sizeof(blobCountMin)};
+    static constexpr size_t OFFSET_BLOB_AREA_MAX {OFFSET_BLOB_COUNT_MAX + sizeof(blobCountMax)};
+    static constexpr size_t OFFSET_EXPOSURE_MIN {OFFSET_BLOB_AREA_MAX + sizeof(blobAreaMax)};
+    static constexpr size_t OFFSET_EXPOSURE_MAX {OFFSET_EXPOSURE_MIN + sizeof(exposureMin)};
+    static constexpr size_t OFFSET_GAIN_MIN {OFFSET_EXPOSURE_MAX + sizeof(exposureMax)};
+    static constexpr size_t OFFSET_GAIN_MAX {OFFSET_GAIN_MIN + sizeof(gainMin)};
+    static constexpr size_t OFFSET_THRESHOLD_MIN {OFFSET_GAIN_MAX + sizeof(gainMax)};
+    static constexpr size_t OFFSET_THRESHOLD_MAX {OFFSET_THRESHOLD_MIN + sizeof(thresholdMin)};
+    static constexpr size_t OFFSET_SETTLE_FRAMES {OFFSET_THRESHOLD_MAX + sizeof(thresholdMax)};
+    static_assert(OFFSET_SETTLE_FRAMES + sizeof(settleFrames) == SIZE);
+
+    bool valid() const {
+        static constexpr uint16_t EXPOSURE_LIMIT {0x0fff};
+        static constexpr uint8_t GAIN_LIMIT {31U};
+        return (blobCountMin <= blobCountMax)
+            && (exposureMin <= exposureMax) && (exposureMax <= EXPOSURE_LIMIT)
+            && (gainMin <= gainMax) && (gainMax <= GAIN_LIMIT)
+            && (thresholdMin <= thresholdMax)
+            && (settleFrames > 0);
+    }
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_BLOB_COUNT_MIN] = blobCountMin;
+        buffer[OFFSET_BLOB_COUNT_MAX] = blobCountMax;
+        std::memcpy(buffer + OFFSET_BLOB_AREA_MAX, &blobAreaMax, sizeof(blobAreaMax));
+        std::memcpy(buffer + OFFSET_EXPOSURE_MIN, &exposureMin, sizeof(exposureMin));
+        std::memcpy(buffer + OFFSET_EXPOSURE_MAX, &exposureMax, sizeof(exposureMax));
+        buffer[OFFSET_GAIN_MIN] = gainMin;
+        buffer[OFFSET_GAIN_MAX] = gainMax;
+        buffer[OFFSET_THRESHOLD_MIN] = thresholdMin;
+        buffer[OFFSET_THRESHOLD_MAX] = thresholdMax;
+        buffer[OFFSET_SETTLE_FRAMES] = settleFrames;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        blobCountMin = buffer[OFFSET_BLOB_COUNT_MIN];
+        blobCountMax = buffer[OFFSET_BLOB_COUNT_MAX];
+        std::memcpy(&blobAreaMax, buffer + OFFSET_BLOB_AREA_MAX, sizeof(blobAreaMax));
+        std::memcpy(&exposureMin, buffer + OFFSET_EXPOSURE_MIN, sizeof(exposureMin));
+        std::memcpy(&exposureMax, buffer + OFFSET_EXPOSURE_MAX, sizeof(exposureMax));
+        gainMin = buffer[OFFSET_GAIN_MIN];
+        gainMax = buffer[OFFSET_GAIN_MAX];
+        thresholdMin = buffer[OFFSET_THRESHOLD_MIN];
+        thresholdMax = buffer[OFFSET_THRESHOLD_MAX];
+        settleFrames = buffer[OFFSET_SETTLE_FRAMES];
+        return true;
+    }
+};
+
+class AutoExposureState {
+public:
+    bool active = {false};
+    AutoExposureAction lastAction = {AutoExposureAction::ACTION_NONE};
+    uint8_t lastFrameCount = {};
+    uint8_t meanBlobCount = {}; //!< mean of the last evaluated window
+    uint16_t meanBlobArea = {}; //!< mean of the last evaluated window in px
+    uint16_t exposure = {}; //!< in row periods
+    uint8_t gain = {};
+    uint8_t threshold = {};
+    uint32_t framesProcessed = {};
+    uint32_t adjustments = {};
+
+    static constexpr size_t SIZE {18};
+    static constexpr size_t OFFSET_ACTIVE {0};
+    static constexpr size_t OFFSET_LAST_ACTION {OFFSET_ACTIVE + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_LAST_FRAME_COUNT {OFFSET_LAST_ACTION + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_MEAN_BLOB_COUNT {OFFSET_LAST_FRAME_COUNT + sizeof(lastFrameCount)};
+    static constexpr size_t OFFSET_MEAN_BLOB_AREA {OFFSET_MEAN_BLOB_COUNT + sizeof(meanBlobCount)};
+    static constexpr size_t OFFSET_EXPOSURE {OFFSET_MEAN_BLOB_AREA + sizeof(meanBlobArea)};
+    static constexpr size_t OFFSET_GAIN {OFFSET_EXPOSURE + sizeof(exposure)};
+    static constexpr size_t OFFSET_THRESHOLD {OFFSET_GAIN + sizeof(gain)};
+    static constexpr size_t OFFSET_FRAMES_PROCESSED {OFFSET_THRESHOLD + sizeof(threshold)};
+    static constexpr size_t OFFSET_ADJUSTMENTS {OFFSET_FRAMES_PROCESSED + sizeof(framesProcessed)};
+    static_assert(OFFSET_ADJUSTMENTS + sizeof(adjustments) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ACTIVE] = active ? 1U : 0U;
+        buffer[OFFSET_LAST_ACTION] = static_cast<uint8_t>(lastAction);
+        buffer[OFFSET_LAST_FRAME_COUNT] = lastFrameCount;
+        buffer[OFFSET_MEAN_BLOB_COUNT] = meanBlobCount;
+        std::memcpy(buffer + OFFSET_MEAN_BLOB_AREA, &meanBlobArea, sizeof(meanBlobArea));
+        std::memcpy(buffer + OFFSET_EXPOSURE, &exposure, sizeof(exposure));
+        buffer[OFFSET_GAIN] = gain;
+        buffer[OFFSET_THRESHOLD] = threshold;
+        std::memcpy(buffer + OFFSET_FRAMES_PROCESSED, &framesProcessed, sizeof(framesProcessed));
+        std::memcpy(buffer + OFFSET_ADJUSTMENTS, &adjustments, sizeof(adjustments));
+        return true;
+    }
+};
+
+#endif // VISIONADDON_APP_AUTOEXPOSURE_AUTOEXPOSURETYPES_H
@@ -0,0 +1,230 @@
+#include "BlinkDecoder.h"
+
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+
+static uint16_t codeMask(uint8_t length) {
+    return static_cast<uint16_t>((1UL << length) - 1U);
+}
+
+static uint16_t rotate(uint16_t code, uint8_t length) {
+    return static_cast<uint16_t>(((code >> 1U) | ((code & 1U) << (length - 1U))) & codeMask(length));
+}
+
+//! longest cyclic run of 0 bits, the frames the tracker has to coast
+static uint8_t longestOffRun(uint16_t code, uint8_t length) {
+    uint8_t longest {0};
+    uint8_t run {0};
+    for(size_t i = 0; i < (2U * length); i++) {
+        if(((code >> (i % length)) & 1U) == 0U) {
+            run++;
+            longest = std::max(longest, run);
+        } else {
+            run = 0U;
+        }
+    }
+    return std::min(longest, length);
+}
+
+uint16_t BlinkDecoder::canonical(uint16_t code, uint8_t length) {
+    uint16_t smallest = code & codeMask(length);
+    uint16_t rotated = smallest;
+    for(uint8_t i = 1; i < length; i++) {
+        rotated = rotate(rotated, length);
+        smallest = std::min(smallest, rotated);
+    }
+    return smallest;
+}
+
+bool BlinkDecoder::config(const BlinkDecoderConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[BlinkDecoder] invalid config rejected, %u codes of %u bits", config.codeCount, config.codeLength);
+        return false;
+    }
+    const uint16_t mask = codeMask(config.codeLength);
+    uint8_t offRunMax {0};
+    for(size_t i = 0; i < config.codeCount; i++) {
+        const uint16_t code = config.codes[i] & mask;
+        if((code == 0U) || (code == mask)) {
+            Log::warning("[BlinkDecoder] code %u is constant, config rejected", i);
+            return false;
+        }
+        const uint16_t canonicalCode = canonical(code, config.codeLength);
+        for(size_t j = 0; j < i; j++) {
+            if(canonical(config.codes[j], config.codeLength) == canonicalCode) {
+                Log::warning("[BlinkDecoder] code %u is a rotation of code %u, config rejected", i, j);
+                return false;
+            }
+        }
+        offRunMax = std::max(offRunMax, longestOffRun(code, config.codeLength));
+    }
+    _mutex.lock();
+    _config = config;
+    _state.cyclesMax = 0U;
+    _resetPending = true;
+    _mutex.unlock();
+    Log::info("[BlinkDecoder] %s, %u codes of %u bits, requires tracker coast frames >= %u", config.enabled ? "enabled" : "disabled",
+        config.codeCount, config.codeLength, offRunMax);
+    return true;
+}
+
+BlinkDecoderState BlinkDecoder::state() {
+    _mutex.lock();
+    BlinkDecoderState state = _state;
+    state.config = _config;
+    _mutex.unlock();
+    return state;
+}
+
+size_t BlinkDecoder::process(uint8_t* packet, size_t size, size_t capacity) {
+    _mutex.lock();
+    const bool resetPending = _resetPending;
+    if(resetPending) {
+        _activeConfig = _config;
+    }
+    _resetPending = false;
+    _mutex.unlock();
+    if(resetPending) {
+        reset();
+    }
+    const BlinkDecoderConfig& config = _activeConfig;
+    if(!config.enabled || (size < BlobPacket::HEADER_SIZE)) {
+        return size;
+    }
+    const uint8_t format = packet[BlobPacket::OFFSET_SENSOR_MODE] >> BlobPacket::FORMAT_SHIFT;
+    if(format != BlobPacketFormat::PACKET_FORMAT_TRACKED) {
+        return size; // tracking disabled, there are no track ids to decode
+    }
+    const size_t featureCount = packet[BlobPacket::OFFSET_FEATURE_COUNT];
+    const size_t trackedSize = BlobPacket::HEADER_SIZE + (featureCount * TrackedFeature::SIZE);
+    if(size != trackedSize) {
+        Log::warning("[BlinkDecoder] unexpected packet size %u, %u features", size, featureCount);
+        return size;
+    }
+    if(capacity < trackedSize + 1 + (MAX_IDENTIFIED * TRAILER_ENTRY_SIZE)) {
+        Log::error("[BlinkDecoder] packet buffer too small, %u bytes", capacity);
+        return size;
+    }
+    const uint32_t start = CycleCounter::now();
+
+    // frame count wraps, a duplicate frame count is treated as the next frame
+    const uint8_t frameCount = packet[BlobPacket::OFFSET_FRAME_COUNT];
+    const uint8_t frames = std::max<uint8_t>(static_cast<uint8_t>(frameCount - _frameCount), 1U);
+    _frameCount = frameCount;
+
+    // shift in an off bit for every elapsed frame, the on bit of the current frame is set below
+    for(History& history : _histories) {
+        if(history.trackId == 0U) {
+            continue;
+        }
+        const uint8_t shift = std::min(frames, config.codeLength);
+        history.bits = static_cast<uint16_t>(history.bits >> shift);
+        history.frames = static_cast<uint8_t>(std::min<uint32_t>(history.frames + frames, config.codeLength));
+        history.framesSinceSeen = static_cast<uint8_t>(std::min<uint32_t>(history.framesSinceSeen + frames, UINT8_MAX));
+        history.seen = false;
+    }
+    const uint16_t latestBit = static_cast<uint16_t>(1U << (config.codeLength - 1U));
+    TrackedFeature feature {};
+    for(size_t i = 0; i < featureCount; i++) {
+        feature.fromBytes(packet + BlobPacket::OFFSET_FEATURES + (i * TrackedFeature::SIZE), TrackedFeature::SIZE);
+        if(feature.trackId == 0U) {
+            continue;
+        }
+        History* history = find(feature.trackId);
+        if(history == nullptr) {
+            history = find(0U);
+            if(history == nullptr) {
+                Log::debug("[BlinkDecoder] no free history, track %u not decoded", feature.trackId);
+                continue;
+            }
+            *history = History{};
+            history->trackId = feature.trackId;
+            history->frames = 1U;
+        }
+        history->bits |= latestBit;
+        history->framesSinceSeen = 0U;
+        history->seen = true;
+    }
+
+    uint8_t watched {0};
+    uint8_t identified {0};
+    for(History& history : _histories) {
+        if(history.trackId == 0U) {
+            continue;
+        }
+        if(history.framesSinceSeen >= config.codeLength) {
+            history.trackId = 0U; // closed by the tracker, every code has at least one on bit per window
+            continue;
+        }
+        watched++;
+        if(history.frames < config.codeLength) {
+            continue;
+        }
+        const uint8_t marker = match(history.bits);
+        if(marker != history.candidate) {
+            history.candidate = marker;
+            history.streak = 0U;
+        }
+        history.streak = static_cast<uint8_t>(std::min<uint32_t>(history.streak + 1U, UINT8_MAX));
+        if((marker != MARKER_NONE) && (history.streak >= config.confirmFrames)) {
+            history.marker = marker;
+        }
+        if(history.marker != MARKER_NONE) {
+            identified++;
+        }
+    }
+
+    // trailer: count followed by (feature index, marker id) pairs of the identified features of this packet
+    uint8_t* trailer = packet + trackedSize;
+    uint8_t entries {0};
+    for(size_t i = 0; (i < featureCount) && (entries < MAX_IDENTIFIED); i++) {
+        feature.fromBytes(packet + BlobPacket::OFFSET_FEATURES + (i * TrackedFeature::SIZE), TrackedFeature::SIZE);
+        const History* history = (feature.trackId == 0U) ? nullptr : find(feature.trackId);
+        if((history == nullptr) || (history->marker == MARKER_NONE)) {
+            continue;
+        }
+        trailer[1 + (entries * TRAILER_ENTRY_SIZE)] = static_cast<uint8_t>(i);
+        trailer[2 + (entries * TRAILER_ENTRY_SIZE)] = history->marker;
+        entries++;
+    }
+    trailer[0] = entries;
+
+    const uint32_t cycles = CycleCounter::now() - start;
+    _mutex.lock();
+    _state.watchedTracks = watched;
+    _state.identifiedTracks = identified;
+    _state.cyclesLast = cycles;
+    _state.cyclesMax = std::max(_state.cyclesMax, cycles);
+    _mutex.unlock();
+    return trackedSize + 1 + (entries * TRAILER_ENTRY_SIZE);
+}
+
+void BlinkDecoder::reset() {
+    for(History& history : _histories) {
+        history.trackId = 0U;
+    }
+    for(size_t i = 0; i < BlinkDecoderConfig::CODES_MAX; i++) {
+        _canonicalCodes[i] = canonical(_activeConfig.codes[i], _activeConfig.codeLength);
+    }
+}
+
+BlinkDecoder::History* BlinkDecoder::find(uint16_t trackId) {
+    for(History& history : _histories) {
+        if(history.trackId == trackId) {
+            return &history;
+        }
+    }
+    return nullptr;
+}
+
+uint8_t BlinkDecoder::match(uint16_t window) const {
+    const uint16_t canonicalWindow = canonical(window, _activeConfig.codeLength);
+    for(size_t i = 0; i < _activeConfig.codeCount; i++) {
+        if(_canonicalCodes[i] == canonicalWindow) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return MARKER_NONE;
+}
@@ -0,0 +1,83 @@
+#ifndef VISIONADDON_APP_BLOB_BLINKDECODER_H
+#define VISIONADDON_APP_BLOB_BLINKDECODER_H
+
+#include "BlobTracker.h"
+#include "BlobTypes.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstdint>
+
+// Identifies active markers by the on/off pattern of their tracks.
+//
+// Every marker repeats its code with one bit per frame, the led is on for a 1 bit. The decoder keeps the
+// last codeLength frames of every track id of the tracked packets: on if the track was detected, off if it
+// coasted. Markers are not synchronized to the frames, a window therefore matches a code in any rotation.
+// Windows and codes are compared by their canonical rotation (the smallest value of all rotations), so the
+// code book must not contain two rotations of the same code.
+// A marker id is assigned once the same code matched in confirmFrames consecutive frames and kept until
+// another code is confirmed, a window disturbed by a missed detection does not drop the id.
+// Off bits coast the track, the longest run of 0 bits of a code must not exceed the coast frames of the tracker.
+class BlinkDecoder final {
+public:
+    BlinkDecoder() = default;
+    BlinkDecoder (const BlinkDecoder&) = delete;
+    BlinkDecoder& operator=(const BlinkDecoder&) = delete;
+    BlinkDecoder (const BlinkDecoder&&) = delete;
+    BlinkDecoder& operator=(const BlinkDecoder&&) = delete;
+
+    static constexpr size_t MAX_IDENTIFIED {32}; //!< markers per packet, keeps the packet in a single datagram
+    static constexpr size_t TRAILER_ENTRY_SIZE {2};
+    static constexpr size_t MAX_PACKET_SIZE {BlobTracker::MAX_PACKET_SIZE + 1 + (MAX_IDENTIFIED * TRAILER_ENTRY_SIZE)};
+    static constexpr uint8_t MARKER_NONE {UINT8_MAX};
+
+    /**
+     * @brief Apply a new code book, resets all histories and the cycle maximum.
+     *
+     * @return false if config is invalid or a code is constant or a rotation of another code
+     */
+    bool config(const BlinkDecoderConfig& config);
+    BlinkDecoderState state();
+
+    /**
+     * @brief Decode the tracks of a tracked packet and append the marker trailer.
+     *
+     * @param packet tracked packet, see trackedFeaturePacket.md
+     * @param size of the tracked packet
+     * @param capacity of the packet buffer, at least MAX_PACKET_SIZE
+     * @return size including the trailer, size if decoding is disabled or the packet is not tracked
+     */
+    size_t process(uint8_t* packet, size_t size, size_t capacity);
+
+private:
+    class History {
+    public:
+        uint16_t trackId {0}; //!< 0 marks a free entry
+        uint16_t bits {0}; //!< bit codeLength-1 is the latest frame
+        uint8_t frames {0}; //!< observed frames, saturated at codeLength
+        uint8_t framesSinceSeen {0};
+        uint8_t candidate {MARKER_NONE};
+        uint8_t streak {0}; //!< consecutive matches of candidate
+        uint8_t marker {MARKER_NONE};
+        bool seen {false}; //!< in the current packet
+    };
+    void reset();
+    History* find(uint16_t trackId);
+    uint8_t match(uint16_t window) const;
+    static uint16_t canonical(uint16_t code, uint8_t length);
+
+    static constexpr size_t _MAX_HISTORIES {BlobPacket::MAX_FEATURE_COUNT + 2}; //!< one per open track
+
+    Mutex _mutex;
+    BlinkDecoderConfig _config {};
+    BlinkDecoderState _state {};
+    bool _resetPending {false};
+
+    // decoding task only
+    BlinkDecoderConfig _activeConfig {};
+    std::array<uint16_t, BlinkDecoderConfig::CODES_MAX> _canonicalCodes {};
+    std::array<History, _MAX_HISTORIES> _histories {};
+    uint8_t _frameCount {0};
+};
+
+#endif // VISIONADDON_APP_BLOB_BLINKDECODER_H
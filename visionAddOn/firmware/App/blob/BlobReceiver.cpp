@@ -5,16 +5,26 @@
 #include "lwip/sockets.h"
 #undef bind // to avoid conflicts with std functional bind
 
+#include "camera/CameraTypes.h"
+#include "metrics/BootTimeline.h"
 #include "utils/assert.h"
 #include "utils/constants.h"
+#include "utils/CycleCounter.h"
 #include "utils/Log.h"
+#include "utils/SyncClock.h"
 
-BlobReceiver::BlobReceiver(osMessageQueueId_t newData, bool useUdp) :
+#include <algorithm>
+#include <cstring>
+
+BlobReceiver::BlobReceiver(osMessageQueueId_t newData, Subscriptions& subscriptions, BlobTransport transport, osMessageQueueId_t frameStatistics) :
 _newData{newData},
-_useUdp{useUdp},
-_targetPort{PORT_BLOB_RECEIVER}
+_frameStatistics{frameStatistics},
+_subscriptions{subscriptions},
+_transport{transport},
+_recorder{reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_RECORDER_ADDRESS), EXTERNAL_SDRAM_RECORDER_SIZE_BYTES},
+_pool{_poolStorage, _BLOCK_SIZE, _POOL_DEPTH}
 {
-_targetAddress = inet_addr(HOST_IP);
+    ASSERT(_transport < BlobTransport::TRANSPORT_UNDEFINED);
 }
 
 void BlobReceiver::run() {
@@ -40,28 +50,213 @@ void BlobReceiver::run() {
         Log::info("[BlobReceiver] dropping message, invalid buffer");
         return;
     }
-    
-    Log::debug("[BlobReceiver] %u bytes received", message.bytesReceived);
-    Log::debug("[BlobReceiver] data: %.*s", message.bytesReceived, message.bufferBase);
+    _statsMutex.lock();
+    const uint32_t messagesDropped = message.messagesDropped - _stats.messagesDropped;
+    _stats.messagesDropped = message.messagesDropped;
+    _statsMutex.unlock();
+    if(messagesDropped > 0) {
+        Log::warning("[BlobReceiver] queue full, %lu interrupt messages dropped", messagesDropped);
+    }
+
+    const uint32_t bytesPending = message.bytesTotal - _bytesParsed;
+    if(bytesPending > message.bufferSize) {
+        Log::warning("[BlobReceiver] receive buffer overrun, dropping %lu bytes", bytesPending);
+        _statsMutex.lock();
+        _stats.overruns++;
+        _stats.bytesDiscarded += bytesPending;
+        _statsMutex.unlock();
+        _bytesParsed = message.bytesTotal;
+        return;
+    }
+    Log::debug("[BlobReceiver] %lu bytes received", bytesPending);
+
+    _statsMutex.lock();
+    const BlobTransport transport = _transport;
+    _statsMutex.unlock();
+
+    // bytesTotal marks a packet end, all complete packets up to it are handled
+    // packets are extracted into pool blocks, the raw udp transport hands the block to lwip without a further copy
+    BufferPool::Buffer packet = _pool.acquire(_BLOCK_SIZE);
+    size_t packetSize = extractPacket(message.bufferBase, message.bufferSize, message.bytesTotal, packet.data());
+    while(packetSize > 0) {
+        const bool extracted = static_cast<bool>(packet);
+        bool intact = false;
+        bool sent = false;
+        uint32_t sendCycles = 0U;
+        if(!extracted) {
+            Log::warning("[BlobReceiver] packet pool exhausted, dropping packet");
+        } else if(_crc.compute(packet.data(), packetSize) != 0U) { // the crc over a packet including its trailing crc is 0
+            Log::warning("[BlobReceiver] crc mismatch, dropping frame %u", packet.data()[BlobPacket::OFFSET_FRAME_COUNT]);
+        } else {
+            intact = true;
+            BootTimeline::reached(BOOT_PHASE_FIRST_BLOB);
+            // the crc is only meaningful on the spi link, the host receives the packet without it
+            const size_t payloadSize = packetSize - BlobPacket::CRC_SIZE;
+            const uint8_t frameCount = packet.data()[BlobPacket::OFFSET_FRAME_COUNT]; // the raw udp transport takes the block
+            const uint8_t format = packet.data()[BlobPacket::OFFSET_SENSOR_MODE] >> BlobPacket::FORMAT_SHIFT;
+            if(format == BlobPacketFormat::PACKET_FORMAT_RAW) {
+                const size_t decodedSize = processFrame(packet.data(), payloadSize);
+                const size_t encodedSize = _deltaEncoder.process(packet.data(), decodedSize, _PROCESSED_SIZE_MAX);
+                const size_t sendSize = _stampPackets.load() ? appendTime(packet.data(), encodedSize, message.receivedUs) : encodedSize;
+                const uint32_t sendStart = CycleCounter::now();
+                sent = forward(packet, sendSize, transport);
+                sendCycles = CycleCounter::now() - sendStart;
+                if(!sent) {
+                    _deltaEncoder.resync(); // the next delta frame would reference the lost packet
+                }
+                _frameClock.tick(frameCount);
+            } else {
+                // chunks are forwarded as received, tracking, blink decoding and delta encoding are refused while streaming (see AppBuilder),
+                // the per frame processing only feeds the recorder, the statistics and the observer
+                const size_t frameSize = assembleChunk(packet.data(), payloadSize);
+                const size_t sendSize = _stampPackets.load() ? appendTime(packet.data(), payloadSize, message.receivedUs) : payloadSize;
+                const uint32_t sendStart = CycleCounter::now();
+                sent = forward(packet, sendSize, transport);
+                sendCycles = CycleCounter::now() - sendStart;
+                if(frameSize > 0) {
+                    processFrame(_frame, frameSize);
+                    _frameClock.tick(frameCount);
+                }
+            }
+        }
+        _statsMutex.lock();
+        _stats.packetsReceived++;
+        if(!extracted) {
+            _stats.sendFailures++;
+        } else if(!intact) {
+            _stats.packetsCorrupt++;
+        } else if(sent) {
+            _stats.packetsSent++;
+        } else {
+            _stats.sendFailures++;
+        }
+        if(intact && (transport == _transport)) {
+            _sendCyclesSum += sendCycles;
+            _sendCount++;
+            _stats.sendCyclesMax = std::max(_stats.sendCyclesMax, sendCycles);
+        }
+        _statsMutex.unlock();
+        if(!packet) {
+            packet = _pool.acquire(_BLOCK_SIZE); // handed to lwip or not available before
+        }
+        packetSize = extractPacket(message.bufferBase, message.bufferSize, message.bytesTotal, packet.data());
+    }
+    // the dma counter read by the interrupt may lag the packet end while the spi and dma fifos drain,
+    // an incomplete packet with a valid header is completed by the next message
+    const uint32_t bytesLeft = message.bytesTotal - _bytesParsed;
+    const bool incomplete = (bytesLeft < BlobPacket::HEADER_SIZE) || (pendingPacketSize(message.bufferBase, message.bufferSize) > 0);
+    if((bytesLeft > 0) && !incomplete) {
+        // corrupt header or reception started mid packet, resynchronize on the packet end
+        const uint32_t bytesDiscarded = bytesLeft;
+        Log::warning("[BlobReceiver] packet boundary mismatch, dropping %lu bytes", bytesDiscarded);
+        _statsMutex.lock();
+        _stats.resyncs++;
+        _stats.bytesDiscarded += bytesDiscarded;
+        _statsMutex.unlock();
+        _bytesParsed = message.bytesTotal;
+    }
+}
+
+FeatureStreamStats BlobReceiver::stats() {
+    _statsMutex.lock();
+    FeatureStreamStats stats = _stats;
+    stats.sendCyclesMean = (_sendCount > 0) ? static_cast<uint32_t>(_sendCyclesSum / _sendCount) : 0U;
+    _statsMutex.unlock();
+    return stats;
+}
+
+bool BlobReceiver::transport(BlobTransport transport) {
+    if(transport >= BlobTransport::TRANSPORT_UNDEFINED) {
+        Log::warning("[BlobReceiver] invalid transport %u", transport);
+        return false;
+    }
+    _statsMutex.lock();
+    _transport = transport;
+    _sendCyclesSum = 0U;
+    _sendCount = 0U;
+    _stats.sendCyclesMax = 0U;
+    _statsMutex.unlock();
+    Log::info("[BlobReceiver] transport %u", transport);
+    return true;
+}
+
+size_t BlobReceiver::extractPacket(const uint8_t* bufferBase, size_t bufferSize, uint32_t bytesTotal, uint8_t* packet) {
+    const uint32_t bytesPending = bytesTotal - _bytesParsed;
+    if(bytesPending < BlobPacket::HEADER_SIZE) {
+        return 0;
+    }
+    const size_t packetSize = pendingPacketSize(bufferBase, bufferSize);
+    if((packetSize == 0) || (packetSize > bytesPending)) {
+        return 0;
+    }
+    if(packet != nullptr) {
+        const size_t readIndex = _bytesParsed % bufferSize;
+        const size_t sizeToEnd = std::min(packetSize, bufferSize - readIndex);
+        std::memcpy(packet, bufferBase + readIndex, sizeToEnd);
+        std::memcpy(packet + sizeToEnd, bufferBase, packetSize - sizeToEnd);
+    }
+    _bytesParsed += packetSize;
+    return packetSize;
+}
+
+size_t BlobReceiver::pendingPacketSize(const uint8_t* bufferBase, size_t bufferSize) const {
+    const size_t readIndex = _bytesParsed % bufferSize;
+    const uint8_t featureCount = bufferBase[(readIndex + BlobPacket::OFFSET_FEATURE_COUNT) % bufferSize];
+    const uint8_t modeFormat = bufferBase[(readIndex + BlobPacket::OFFSET_SENSOR_MODE) % bufferSize];
+    const uint8_t sensorMode = modeFormat & BlobPacket::SENSOR_MODE_MASK;
+    const uint8_t format = modeFormat >> BlobPacket::FORMAT_SHIFT;
+    const bool formatValid = (format == BlobPacketFormat::PACKET_FORMAT_RAW) || (format == BlobPacketFormat::PACKET_FORMAT_CHUNK) || (format == BlobPacketFormat::PACKET_FORMAT_CHUNK_LAST);
+    const size_t packetSize = BlobPacket::HEADER_SIZE + (featureCount * BoundingBox::SIZE) + BlobPacket::CRC_SIZE;
+    const bool headerValid = (featureCount <= BlobPacket::MAX_FEATURE_COUNT) && (sensorMode < NUMBER_OF_SENSOR_MODES) && formatValid;
+    return headerValid ? packetSize : 0;
+}
 
+bool BlobReceiver::forward(BufferPool::Buffer& packet, size_t size, BlobTransport transport) {
+    Subscriptions::Destinations destinations {};
+    const size_t count = _subscriptions.next(SubscriberStream::STREAM_BLOBS, destinations);
+    switch(transport) {
+        case BlobTransport::TRANSPORT_UDP_RAW: {
+            // on success the block returns to the pool once the ethernet dma is done with it for every subscriber
+            struct pbuf* p = packet.toPbuf(size);
+            if(p == nullptr) {
+                Log::warning("[BlobReceiver] pbuf allocation failed");
+                return false;
+            }
+            return _udpSender.sendTo(p, destinations.data(), count) == count;
+        }
+        case BlobTransport::TRANSPORT_UDP_SOCKET:
+        case BlobTransport::TRANSPORT_TCP_SOCKET: {
+            bool sent = true;
+            for(size_t i = 0; i < count; i++) {
+                sent &= forwardSocket(packet.data(), size, destinations[i], transport == BlobTransport::TRANSPORT_UDP_SOCKET);
+            }
+            return sent;
+        }
+        default: return false;
+    }
+}
+
+bool BlobReceiver::forwardSocket(const uint8_t* packet, size_t size, const UdpDestination& destination, bool useUdp) {
     int32_t socketType{SOCK_STREAM}; // TCP
-    if(_useUdp){
+    if(useUdp){
         socketType = SOCK_DGRAM; // UDP
     }
     int32_t clientSocket = lwip_socket(AF_INET, socketType, 0);
     struct sockaddr_in addr = {};
     addr.sin_len = sizeof(addr);
     addr.sin_family = AF_INET;
-    addr.sin_port = htons(_targetPort);
-    addr.sin_addr.s_addr = _targetAddress;
+    addr.sin_port = htons(destination.port);
+    addr.sin_addr.s_addr = destination.address;
+    bool sent = false;
     auto resultConnect = lwip_connect(clientSocket, (struct sockaddr*)&addr, sizeof(addr));
     if(resultConnect == 0) {
-        if(!_useUdp){
+        if(!useUdp){
             static constexpr int32_t OPT_DISABLE {1};
             lwip_setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (void*)&OPT_DISABLE, sizeof(OPT_DISABLE));
         }
-        auto resultWrite = lwip_write(clientSocket, (void*)message.bufferBase, message.bytesReceived); // blocking!
-        if(resultWrite != static_cast<int32_t>(message.bytesReceived)) {
+        auto resultWrite = lwip_write(clientSocket, (const void*)packet, size); // blocking!
+        sent = (resultWrite == static_cast<int32_t>(size));
+        if(!sent) {
             Log::warning("[BlobReceiver] send failed, return code: %d", resultWrite);
         }
     }
@@ -69,4 +264,87 @@ void BlobReceiver::run() {
     if(resultClose != 0) {
       Log::warning("[BlobReceiver] closing socket failed, ret: %d", resultClose);
     }
+    return sent;
+}
+
+size_t BlobReceiver::processFrame(uint8_t* packet, size_t size) {
+    _recorder.append(packet, size, osKernelGetTickCount() / TICKS_PER_MILLISECOND);
+    publishStatistics(packet, size);
+    const uint8_t blobCount = packet[BlobPacket::OFFSET_FEATURE_COUNT];
+    const size_t trackedSize = _tracker.process(packet, size, _PROCESSED_SIZE_MAX);
+    const size_t decodedSize = _blinkDecoder.process(packet, trackedSize, _PROCESSED_SIZE_MAX);
+    if(_observer) {
+        _observer(blobCount, _blinkDecoder.state().identifiedTracks);
+    }
+    return decodedSize;
+}
+
+size_t BlobReceiver::assembleChunk(const uint8_t* chunk, size_t size) {
+    ASSERT(size >= BlobPacket::HEADER_SIZE);
+    const uint8_t frameCount = chunk[BlobPacket::OFFSET_FRAME_COUNT];
+    if((_frameSize > 0) && (_frame[BlobPacket::OFFSET_FRAME_COUNT] != frameCount)) {
+        Log::debug("[BlobReceiver] last chunk of frame %u lost, dropping the frame", _frame[BlobPacket::OFFSET_FRAME_COUNT]);
+        _frameSize = 0;
+    }
+    if(_frameSize == 0) {
+        _frame[BlobPacket::OFFSET_FRAME_COUNT] = frameCount;
+        _frame[BlobPacket::OFFSET_FEATURE_COUNT] = 0U;
+        _frame[BlobPacket::OFFSET_SENSOR_MODE] = chunk[BlobPacket::OFFSET_SENSOR_MODE] & BlobPacket::SENSOR_MODE_MASK; // raw format
+        _frameSize = BlobPacket::HEADER_SIZE;
+    }
+    const size_t featureCount = std::min<size_t>(chunk[BlobPacket::OFFSET_FEATURE_COUNT], (size - BlobPacket::HEADER_SIZE) / BoundingBox::SIZE);
+    const size_t featuresAssembled = _frame[BlobPacket::OFFSET_FEATURE_COUNT];
+    if((featuresAssembled + featureCount) <= BlobPacket::MAX_FEATURE_COUNT) { // the fpga sends at most this many per frame
+        std::memcpy(_frame + _frameSize, chunk + BlobPacket::OFFSET_FEATURES, featureCount * BoundingBox::SIZE);
+        _frameSize += featureCount * BoundingBox::SIZE;
+        _frame[BlobPacket::OFFSET_FEATURE_COUNT] = static_cast<uint8_t>(featuresAssembled + featureCount);
+    }
+    if((chunk[BlobPacket::OFFSET_SENSOR_MODE] >> BlobPacket::FORMAT_SHIFT) != BlobPacketFormat::PACKET_FORMAT_CHUNK_LAST) {
+        return 0;
+    }
+    const size_t frameSize = _frameSize;
+    _frameSize = 0;
+    return frameSize;
+}
+
+size_t BlobReceiver::appendTime(uint8_t* packet, size_t size, uint64_t receivedUs) {
+    ASSERT((size >= BlobPacket::HEADER_SIZE) && ((size + BlobPacket::TIME_TRAILER_SIZE) <= _BLOCK_SIZE));
+    // every packet announced by one interrupt gets its time, the interrupt follows each packet unless the queue was full
+    const uint64_t timeUs = SyncClock::toSynchronized(receivedUs);
+    std::memcpy(packet + size, &timeUs, sizeof(timeUs));
+    packet[BlobPacket::OFFSET_SENSOR_MODE] |= BlobPacket::TIME_TRAILER_FLAG;
+    return size + BlobPacket::TIME_TRAILER_SIZE;
+}
+
+void BlobReceiver::publishStatistics(const uint8_t* packet, size_t size) {
+    if(_frameStatistics == nullptr) {
+        return;
+    }
+    if(size < BlobPacket::HEADER_SIZE) {
+        Log::debug("[BlobReceiver] packet too short for statistics, %u bytes", size);
+        return;
+    }
+    FrameStatistics statistics {};
+    statistics.frameCount = packet[BlobPacket::OFFSET_FRAME_COUNT];
+    statistics.blobCount = packet[BlobPacket::OFFSET_FEATURE_COUNT];
+    statistics.sensorMode = packet[BlobPacket::OFFSET_SENSOR_MODE];
+    // binned modes report coordinates in binned px, scale areas to full resolution px to keep limits mode independent
+    const SensorModeInfo info {sensorModeInfo(static_cast<SensorMode>(statistics.sensorMode))};
+    const uint32_t areaScale = (info.binning > 0) ? (static_cast<uint32_t>(info.binning) * info.binning) : 1U;
+    const size_t featuresAvailable = (size - BlobPacket::HEADER_SIZE) / BoundingBox::SIZE;
+    if(statistics.blobCount > featuresAvailable) {
+        Log::debug("[BlobReceiver] packet truncated, %u of %u features", featuresAvailable, statistics.blobCount);
+        statistics.blobCount = static_cast<uint8_t>(featuresAvailable);
+    }
+    BoundingBox box {};
+    for(size_t i = 0; i < statistics.blobCount; i++) {
+        box.fromBytes(packet + BlobPacket::OFFSET_FEATURES + (i * BoundingBox::SIZE), BoundingBox::SIZE);
+        const uint32_t area = box.area() * areaScale;
+        statistics.areaSum += area;
+        if(area > statistics.areaMax) {
+            statistics.areaMax = area;
+        }
+    }
+    static constexpr uint32_t Q_NO_TIMEOUT {0U}; // never block the blob path, the consumer only needs a representative subset
+    osMessageQueuePut(_frameStatistics, &statistics, 0U, Q_NO_TIMEOUT);
 }
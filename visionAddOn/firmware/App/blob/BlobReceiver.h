@@ -1,30 +1,119 @@
 #ifndef VISIONADDON_APP_BLOB_BLOBRECEIVER_H
 #define VISIONADDON_APP_BLOB_BLOBRECEIVER_H
 
+#include "BlinkDecoder.h"
+#include "BlobTracker.h"
+#include "BlobTypes.h"
+#include "DeltaEncoder.h"
+#include "FlightRecorder.h"
+#include "FrameClock.h"
 #include "cmsis_os2.h"
 #include "lwip/api.h"
+#include "network/Subscriptions.h"
+#include "network/UdpSender.h"
 #include "utils/IRunnable.h"
 #include "utils/IActivatable.h"
+#include "utils/crc/Crc16.h"
+#include "utils/mutex/Mutex.h"
 #include "utils/pool/BufferPool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 
 // TODO: rework to support 2-way coms and command fpga (threshold, trigger sync, reset?)
 // -> will be renamed 
 
 class BlobReceiver final : public IRunnable {
 public:
-    BlobReceiver(osMessageQueueId_t newData, bool useUdp=false);
+    using PacketObserver = std::function<void(uint8_t blobCount, uint8_t identifiedMarkers)>;
+
+    /**
+     * @param newData queue of received spi packets
+     * @param subscriptions packets are forwarded to the blob subscribers
+     * @param transport how packets are forwarded to the subscribers
+     * @param frameStatistics optional queue the per frame statistics are published to, dropped if full
+     */
+    BlobReceiver(osMessageQueueId_t newData, Subscriptions& subscriptions, BlobTransport transport=TRANSPORT_UDP_RAW, osMessageQueueId_t frameStatistics=nullptr);
     BlobReceiver (const BlobReceiver&) = delete;
     BlobReceiver& operator=(const BlobReceiver&) = delete;
     BlobReceiver (const BlobReceiver&&) = delete;
     BlobReceiver& operator=(const BlobReceiver&&) = delete;
     void run() override;
+
+    FeatureStreamStats stats(); //!< counters since boot
+    BufferPoolStats poolStats() const {return _pool.stats();};
+    BlobTracker& tracker() {return _tracker;}; //!< applied to every intact packet before forwarding
+    BlinkDecoder& blinkDecoder() {return _blinkDecoder;}; //!< applied to every tracked packet before forwarding
+    DeltaEncoder& deltaEncoder() {return _deltaEncoder;}; //!< applied last, after the blink decoder
+    FlightRecorder& recorder() {return _recorder;}; //!< records every intact packet before processing
+    FrameClock& frameClock() {return _frameClock;}; //!< ticked per frame, after its packet or its last chunk was forwarded
+    void observe(PacketObserver observer) {_observer = observer;}; //!< called per intact packet, register before the scheduler starts
+    void stampPackets(bool enabled) {_stampPackets.store(enabled);}; //!< append the time trailer to the forwarded packets
+
+    /**
+     * @brief Change the transport, applied from the next packet on. Resets the send cycle statistics.
+     *
+     * @return false if transport is invalid
+     */
+    bool transport(BlobTransport transport);
 private:
+    /**
+     * @brief Copy the next complete packet out of the circular receive buffer.
+     *
+     * @param packet destination of at least _MAX_PACKET_SIZE bytes, nullptr skips the packet
+     * @return packet size including the crc, 0 if no complete packet is available
+     */
+    size_t extractPacket(const uint8_t* bufferBase, size_t bufferSize, uint32_t bytesTotal, uint8_t* packet);
+    size_t pendingPacketSize(const uint8_t* bufferBase, size_t bufferSize) const; //!< from the header at the read position, 0 if invalid, needs a complete header
+    /**
+     * @brief Per frame processing ahead of forwarding: recorder, statistics, tracker, blink decoder and observer.
+     *
+     * @param packet raw packet without crc, rewritten in place, capacity _PROCESSED_SIZE_MAX
+     * @return size of the processed packet
+     */
+    size_t processFrame(uint8_t* packet, size_t size);
+
+    /**
+     * @brief Append the bounding boxes of a chunk to the streamed frame.
+     *
+     * A frame whose last chunk was lost is dropped once a chunk of another frame arrives.
+     *
+     * @param chunk without crc
+     * @return size of the raw frame packet in _frame once the last chunk arrived, 0 otherwise
+     */
+    size_t assembleChunk(const uint8_t* chunk, size_t size);
+    void publishStatistics(const uint8_t* packet, size_t size);
+    size_t appendTime(uint8_t* packet, size_t size, uint64_t receivedUs); //!< @return size with the trailer
+    bool forward(BufferPool::Buffer& packet, size_t size, BlobTransport transport); //!< @return true if the packet was sent to all due subscribers
+    bool forwardSocket(const uint8_t* packet, size_t size, const UdpDestination& destination, bool useUdp);
     osMessageQueueId_t _newData;
-    bool _useUdp;
-    uint32_t _targetPort;
-    in_addr_t _targetAddress;
+    osMessageQueueId_t _frameStatistics;
+    Subscriptions& _subscriptions;
+    BlobTransport _transport;
+    UdpSender _udpSender; //!< unconnected, one pcb for all subscribers
+    uint32_t _bytesParsed {0}; //!< read position in the circular receive buffer, same wrap as bytesTotal
+    Crc16 _crc;
+    BlobTracker _tracker;
+    BlinkDecoder _blinkDecoder;
+    DeltaEncoder _deltaEncoder;
+    FlightRecorder _recorder;
+    FrameClock _frameClock;
+    PacketObserver _observer {};
+    std::atomic<bool> _stampPackets {false};
+    Mutex _statsMutex;
+    FeatureStreamStats _stats {};
+    uint64_t _sendCyclesSum {0};
+    uint32_t _sendCount {0};
+    static constexpr size_t _MAX_PACKET_SIZE {BlobPacket::HEADER_SIZE + (BlobPacket::MAX_FEATURE_COUNT * BoundingBox::SIZE) + BlobPacket::CRC_SIZE};
+    static constexpr size_t _PROCESSED_SIZE_MAX {std::max(_MAX_PACKET_SIZE, BlinkDecoder::MAX_PACKET_SIZE)}; //!< tracked packets are rewritten in place
+    static constexpr size_t _BLOCK_SIZE {_PROCESSED_SIZE_MAX + BlobPacket::TIME_TRAILER_SIZE};
+    static constexpr size_t _POOL_DEPTH {8}; //!< packets in flight in the network stack
+    alignas(BufferPool::ALIGNMENT) uint8_t _poolStorage[BufferPool::storageSize(_BLOCK_SIZE, _POOL_DEPTH)];
+    BufferPool _pool;
+    uint8_t _frame[_PROCESSED_SIZE_MAX]; //!< streamed frame reassembled from its chunks for the per frame processing
+    size_t _frameSize {0}; //!< 0 while no frame is assembled
 };
 
 #endif // VISIONADDON_APP_BLOB_BLOBRECEIVER_H
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "BlobTracker.h"
+
+#include "camera/CameraTypes.h"
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(NUMBER_OF_SENSOR_MODES <= BlobPacket::SENSOR_MODE_MASK, "sensor mode must fit below the packet format");
+
+static int8_t toVelocity(int32_t subpixelPerFrame, int32_t subpixel) {
+    const int32_t velocity = (subpixelPerFrame * TrackedFeature::VELOCITY_SCALE) / subpixel;
+    return static_cast<int8_t>(std::clamp<int32_t>(velocity, INT8_MIN, INT8_MAX));
+}
+
+bool BlobTracker::config(const BlobTrackerConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[BlobTracker] invalid config rejected, gate %u px, coast %u frames", config.gatePx, config.coastFrames);
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    _state.cyclesMax = 0U;
+    _resetPending = true;
+    _mutex.unlock();
+    Log::info("[BlobTracker] %s, gate %u px, coast %u frames", config.enabled ? "enabled" : "disabled", config.gatePx, config.coastFrames);
+    return true;
+}
+
+BlobTrackerState BlobTracker::state() {
+    _mutex.lock();
+    BlobTrackerState state = _state;
+    state.config = _config;
+    _mutex.unlock();
+    return state;
+}
+
+size_t BlobTracker::process(uint8_t* packet, size_t size, size_t capacity) {
+    _mutex.lock();
+    const BlobTrackerConfig config = _config;
+    const bool resetPending = _resetPending;
+    _resetPending = false;
+    _mutex.unlock();
+    if(resetPending) {
+        reset();
+    }
+    if(!config.enabled || (size < BlobPacket::HEADER_SIZE)) {
+        return size;
+    }
+    const uint32_t start = CycleCounter::now();
+
+    const uint8_t frameCount = packet[BlobPacket::OFFSET_FRAME_COUNT];
+    const uint8_t sensorMode = packet[BlobPacket::OFFSET_SENSOR_MODE] & BlobPacket::SENSOR_MODE_MASK;
+    const size_t detectionCount = std::min<size_t>(packet[BlobPacket::OFFSET_FEATURE_COUNT], (size - BlobPacket::HEADER_SIZE) / BoundingBox::SIZE);
+    if(capacity < BlobPacket::HEADER_SIZE + (detectionCount * TrackedFeature::SIZE)) {
+        Log::error("[BlobTracker] packet buffer too small, %u bytes", capacity);
+        return size;
+    }
+    if(sensorMode != _sensorMode) {
+        reset();
+        _sensorMode = sensorMode;
+    }
+    // frame count wraps, a duplicate frame count is treated as the next frame
+    const uint8_t frames = std::max<uint8_t>(static_cast<uint8_t>(frameCount - _frameCount), 1U);
+    _frameCount = frameCount;
+
+    BoundingBox box {};
+    for(size_t i = 0; i < detectionCount; i++) {
+        Detection& detection = _detections[i];
+        const uint8_t* raw = packet + BlobPacket::OFFSET_FEATURES + (i * BoundingBox::SIZE);
+        std::memcpy(detection.box, raw, BoundingBox::SIZE);
+        box.fromBytes(raw, BoundingBox::SIZE);
+        detection.x = ((box.xMin + box.xMax) * _SUBPIXEL) / 2;
+        detection.y = ((box.yMin + box.yMax) * _SUBPIXEL) / 2;
+        detection.track = _NONE;
+    }
+    predict(frames);
+    associate(detectionCount, config);
+    update(detectionCount, config);
+    const size_t trackedSize = write(packet, detectionCount);
+
+    const uint32_t cycles = CycleCounter::now() - start;
+    const uint8_t activeTracks = static_cast<uint8_t>(std::count_if(_tracks.cbegin(), _tracks.cend(), [](const Track& track) {
+        return track.active;
+    }));
+    _mutex.lock();
+    _state.activeTracks = activeTracks;
+    _state.tracksCreated = _tracksCreated;
+    _state.cyclesLast = cycles;
+    _state.cyclesMax = std::max(_state.cyclesMax, cycles);
+    _mutex.unlock();
+    return trackedSize;
+}
+
+void BlobTracker::reset() {
+    for(Track& track : _tracks) {
+        track.active = false;
+    }
+    _sensorMode = UINT8_MAX;
+}
+
+void BlobTracker::predict(uint8_t frames) {
+    for(Track& track : _tracks) {
+        if(track.active) {
+            track.framesSinceHit = static_cast<uint8_t>(std::min<uint32_t>(track.framesSinceHit + frames, UINT8_MAX));
+            track.associated = false;
+        }
+    }
+}
+
+void BlobTracker::associate(size_t detectionCount, const BlobTrackerConfig& config) {
+    const int32_t gate = static_cast<int32_t>(config.gatePx) * _SUBPIXEL;
+    const uint32_t gateSquared = static_cast<uint32_t>(gate * gate);
+    for(size_t round = 0; round < _MAX_ROUNDS; round++) {
+        // one pass over all open pairs finds the nearest track of every detection and vice versa
+        _nearestDetectionDistance.fill(UINT32_MAX);
+        _nearestDetection.fill(_NONE);
+        for(size_t d = 0; d < detectionCount; d++) {
+            _nearestTrack[d] = _NONE;
+            const Detection& detection = _detections[d];
+            if(detection.track != _NONE) {
+                continue;
+            }
+            uint32_t detectionDistance {UINT32_MAX};
+            for(size_t t = 0; t < _MAX_TRACKS; t++) {
+                const Track& track = _tracks[t];
+                if(!track.active || track.associated) {
+                    continue;
+                }
+                const int32_t dx = detection.x - (track.x + (track.velocityX * track.framesSinceHit));
+                const int32_t dy = detection.y - (track.y + (track.velocityY * track.framesSinceHit));
+                if((dx > gate) || (dx < -gate) || (dy > gate) || (dy < -gate)) {
+                    continue;
+                }
+                const uint32_t distance = static_cast<uint32_t>((dx * dx) + (dy * dy));
+                if(distance > gateSquared) {
+                    continue;
+                }
+                if(distance < detectionDistance) {
+                    detectionDistance = distance;
+                    _nearestTrack[d] = static_cast<int16_t>(t);
+                }
+                if(distance < _nearestDetectionDistance[t]) {
+                    _nearestDetectionDistance[t] = distance;
+                    _nearestDetection[t] = static_cast<int16_t>(d);
+                }
+            }
+        }
+        size_t associated {0};
+        for(size_t d = 0; d < detectionCount; d++) {
+            const int16_t t = _nearestTrack[d];
+            if((t != _NONE) && (_nearestDetection[t] == static_cast<int16_t>(d))) {
+                _detections[d].track = t;
+                _tracks[t].associated = true;
+                associated++;
+            }
+        }
+        if(associated == 0U) {
+            return;
+        }
+    }
+}
+
+void BlobTracker::update(size_t detectionCount, const BlobTrackerConfig& config) {
+    for(size_t d = 0; d < detectionCount; d++) {
+        Detection& detection = _detections[d];
+        if(detection.track == _NONE) {
+            continue;
+        }
+        Track& track = _tracks[detection.track];
+        const uint8_t frames = std::max<uint8_t>(track.framesSinceHit, 1U);
+        const int32_t measuredX = (detection.x - track.x) / frames;
+        const int32_t measuredY = (detection.y - track.y) / frames;
+        if(track.hits < 2U) {
+            track.velocityX = measuredX;
+            track.velocityY = measuredY;
+        } else {
+            track.velocityX += (measuredX - track.velocityX) / 2;
+            track.velocityY += (measuredY - track.velocityY) / 2;
+        }
+        track.x = detection.x;
+        track.y = detection.y;
+        track.framesSinceHit = 0U;
+        track.hits = static_cast<uint8_t>(std::min<uint32_t>(track.hits + 1U, UINT8_MAX));
+        track.confidence = static_cast<uint8_t>(std::min<uint32_t>(track.confidence + _CONFIDENCE_STEP, UINT8_MAX));
+    }
+    for(Track& track : _tracks) {
+        if(!track.active || track.associated) {
+            continue;
+        }
+        if(track.framesSinceHit > config.coastFrames) {
+            track.active = false;
+            continue;
+        }
+        track.confidence >>= 1U;
+    }
+    // open new tracks after closing the lost ones, frees slots for blobs entering the view
+    size_t slot {0};
+    for(size_t d = 0; d < detectionCount; d++) {
+        Detection& detection = _detections[d];
+        if(detection.track != _NONE) {
+            continue;
+        }
+        while((slot < _MAX_TRACKS) && _tracks[slot].active) {
+            slot++;
+        }
+        if(slot == _MAX_TRACKS) {
+            Log::debug("[BlobTracker] no free track, blob untracked");
+            break;
+        }
+        Track& track = _tracks[slot];
+        track = Track{};
+        track.active = true;
+        track.associated = true;
+        track.x = detection.x;
+        track.y = detection.y;
+        track.id = _nextTrackId;
+        track.hits = 1U;
+        _nextTrackId = (_nextTrackId == UINT16_MAX) ? 1U : (_nextTrackId + 1U); // 0 marks untracked blobs
+        _tracksCreated++;
+        detection.track = static_cast<int16_t>(slot);
+    }
+}
+
+size_t BlobTracker::write(uint8_t* packet, size_t detectionCount) const {
+    packet[BlobPacket::OFFSET_FEATURE_COUNT] = static_cast<uint8_t>(detectionCount);
+    packet[BlobPacket::OFFSET_SENSOR_MODE] = _sensorMode | (BlobPacketFormat::PACKET_FORMAT_TRACKED << BlobPacket::FORMAT_SHIFT);
+    TrackedFeature feature {};
+    for(size_t d = 0; d < detectionCount; d++) {
+        const Detection& detection = _detections[d];
+        std::memcpy(feature.box, detection.box, BoundingBox::SIZE);
+        feature.trackId = 0U;
+        feature.velocityX = 0;
+        feature.velocityY = 0;
+        feature.confidence = 0U;
+        if(detection.track != _NONE) {
+            const Track& track = _tracks[detection.track];
+            feature.trackId = track.id;
+            feature.velocityX = toVelocity(track.velocityX, _SUBPIXEL);
+            feature.velocityY = toVelocity(track.velocityY, _SUBPIXEL);
+            feature.confidence = track.confidence;
+        }
+        feature.toBytes(packet + BlobPacket::OFFSET_FEATURES + (d * TrackedFeature::SIZE), TrackedFeature::SIZE);
+    }
+    return BlobPacket::HEADER_SIZE + (detectionCount * TrackedFeature::SIZE);
+}
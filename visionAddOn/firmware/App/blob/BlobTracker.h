@@ -0,0 +1,99 @@
+#ifndef VISIONADDON_APP_BLOB_BLOBTRACKER_H
+#define VISIONADDON_APP_BLOB_BLOBTRACKER_H
+
+#include "BlobTypes.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstdint>
+
+// Frame to frame association of the blobs of one camera, assigns stable track ids.
+//
+// Constant velocity model: the centroid of every track is predicted by its velocity times the frames since
+// its last detection. Detections are associated with predictions by mutual nearest neighbour within the gate,
+// repeated until no further pair is found. The closest remaining pair is always mutual, so every round
+// associates at least one pair. Much cheaper than an optimal (hungarian) assignment and equivalent as long as
+// the gate is smaller than half the distance between blobs.
+// Unassociated detections open new tracks, tracks not detected for more than coastFrames frames are closed.
+// Tracks are reset whenever the sensor mode changes, coordinates of different modes are not comparable.
+// Centroids and velocities are kept in 1/16 px.
+class BlobTracker final {
+public:
+    BlobTracker() = default;
+    BlobTracker (const BlobTracker&) = delete;
+    BlobTracker& operator=(const BlobTracker&) = delete;
+    BlobTracker (const BlobTracker&&) = delete;
+    BlobTracker& operator=(const BlobTracker&&) = delete;
+
+    static constexpr size_t MAX_PACKET_SIZE {BlobPacket::HEADER_SIZE + (BlobPacket::MAX_FEATURE_COUNT * TrackedFeature::SIZE)};
+
+    /**
+     * @brief Apply a new config, resets all tracks and the cycle maximum.
+     *
+     * @return false if config is invalid
+     */
+    bool config(const BlobTrackerConfig& config);
+    BlobTrackerState state();
+
+    /**
+     * @brief Track the features of a raw packet and rewrite it in place as tracked packet.
+     *
+     * @param packet raw packet without crc
+     * @param size of the raw packet
+     * @param capacity of the packet buffer, at least MAX_PACKET_SIZE
+     * @return size of the tracked packet, size if tracking is disabled (packet stays raw)
+     */
+    size_t process(uint8_t* packet, size_t size, size_t capacity);
+
+private:
+    class Track {
+    public:
+        int32_t x {0};
+        int32_t y {0};
+        int32_t velocityX {0}; //!< per frame
+        int32_t velocityY {0}; //!< per frame
+        uint16_t id {0};
+        uint8_t confidence {0};
+        uint8_t framesSinceHit {0};
+        uint8_t hits {0}; //!< saturated, velocity is unknown before the second hit
+        bool active {false};
+        bool associated {false}; //!< with a detection of the current packet
+    };
+    class Detection {
+    public:
+        int32_t x {0};
+        int32_t y {0};
+        int16_t track {_NONE}; //!< associated track index
+        uint8_t box[BoundingBox::SIZE] {};
+    };
+    void reset();
+    void predict(uint8_t frames);
+    void associate(size_t detectionCount, const BlobTrackerConfig& config);
+    void update(size_t detectionCount, const BlobTrackerConfig& config);
+    size_t write(uint8_t* packet, size_t detectionCount) const;
+
+    static constexpr size_t _MAX_TRACKS {BlobPacket::MAX_FEATURE_COUNT + 2}; //!< room for coasting tracks
+    static constexpr int16_t _NONE {-1};
+    static constexpr int32_t _SUBPIXEL {16};
+    static constexpr uint8_t _CONFIDENCE_STEP {32}; //!< per hit, halved per miss
+    static constexpr size_t _MAX_ROUNDS {8}; //!< limits the worst case, remaining detections open new tracks
+
+    Mutex _mutex;
+    BlobTrackerConfig _config {};
+    BlobTrackerState _state {};
+    bool _resetPending {false};
+
+    // tracking task only
+    std::array<Track, _MAX_TRACKS> _tracks {};
+    std::array<Detection, BlobPacket::MAX_FEATURE_COUNT> _detections {};
+    // association scratch, kept off the stack of the blob receiver task
+    std::array<int16_t, _MAX_TRACKS> _nearestDetection {};
+    std::array<uint32_t, _MAX_TRACKS> _nearestDetectionDistance {};
+    std::array<int16_t, BlobPacket::MAX_FEATURE_COUNT> _nearestTrack {};
+    uint16_t _nextTrackId {1};
+    uint32_t _tracksCreated {0};
+    uint8_t _sensorMode {UINT8_MAX};
+    uint8_t _frameCount {0};
+};
+
+#endif // VISIONADDON_APP_BLOB_BLOBTRACKER_H
@@ -0,0 +1,529 @@
+#ifndef VISIONADDON_APP_BLOB_BLOBTYPES_H
+#define VISIONADDON_APP_BLOB_BLOBTYPES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// layout of the feature packet sent by the fpga, see gecko5/hdl/modules/featureTransferSpi/featureTransferPacket.md
+namespace BlobPacket {
+    static constexpr size_t OFFSET_FRAME_COUNT {0};
+    static constexpr size_t OFFSET_FEATURE_COUNT {1};
+    static constexpr size_t OFFSET_SENSOR_MODE {2}; //!< SensorMode the features were detected in, coordinates are in px of this mode
+    static constexpr size_t HEADER_SIZE {3};
+    static constexpr size_t OFFSET_FEATURES {HEADER_SIZE};
+    static constexpr size_t MAX_FEATURE_COUNT {126}; //!< depth of the fpga feature buffer, also per streamed frame
+    static constexpr size_t CRC_SIZE {2}; //!< crc16 trailing the features, stripped before forwarding
+    // the BlobPacketFormat is carried in the upper nibble of the sensor mode byte, the fpga sets it for chunks
+    static constexpr uint8_t SENSOR_MODE_MASK {0x0F};
+    static constexpr uint8_t FORMAT_SHIFT {4};
+    // set in the sensor mode byte if the synchronised receive time (U64 us) is appended to the packet, formats stay below 0x8
+    static constexpr uint8_t TIME_TRAILER_FLAG {0x80};
+    static constexpr size_t TIME_TRAILER_SIZE {sizeof(uint64_t)};
+}
+
+// format of the packets forwarded to the host, the fpga delivers raw packets or, when streaming, chunks
+enum BlobPacketFormat : uint8_t {
+    PACKET_FORMAT_RAW = 0x00, //!< bounding boxes as received from the fpga
+    PACKET_FORMAT_TRACKED = 0x01, //!< TrackedFeature per bounding box, see BlobTracker
+    PACKET_FORMAT_DELTA = 0x02, //!< keyframes and per track deltas, see DeltaEncoder
+    PACKET_FORMAT_CHUNK = 0x03, //!< raw bounding boxes of a frame still being processed, forwarded as received
+    PACKET_FORMAT_CHUNK_LAST = 0x04, //!< last chunk of a frame, sent on the frame end, may have no bounding box
+    PACKET_FORMAT_UNDEFINED = BlobPacket::SENSOR_MODE_MASK
+};
+
+class BoundingBox {
+public:
+    BoundingBox() = default;
+
+    uint16_t xMin = {};
+    uint16_t xMax = {};
+    uint16_t yMin = {};
+    uint16_t yMax = {};
+
+    static constexpr size_t SIZE {6}; //!< padded to full bytes
+    static constexpr size_t BITS_X {11}; //!< up to 1280 px wide
+    static constexpr size_t BITS_Y {10}; //!< up to 800 px high
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        uint64_t raw {0};
+        for(size_t i = 0; i < SIZE; i++) {
+            raw |= static_cast<uint64_t>(buffer[i]) << (i * 8);
+        }
+        static constexpr uint64_t MASK_X {(1U << BITS_X) - 1};
+        static constexpr uint64_t MASK_Y {(1U << BITS_Y) - 1};
+        yMax = static_cast<uint16_t>(raw & MASK_Y);
+        raw >>= BITS_Y;
+        yMin = static_cast<uint16_t>(raw & MASK_Y);
+        raw >>= BITS_Y;
+        xMax = static_cast<uint16_t>(raw & MASK_X);
+        raw >>= BITS_X;
+        xMin = static_cast<uint16_t>(raw & MASK_X);
+        return true;
+    }
+
+    uint32_t area() const {
+        if((xMax < xMin) || (yMax < yMin)) {
+            return 0;
+        }
+        return static_cast<uint32_t>(xMax - xMin + 1) * static_cast<uint32_t>(yMax - yMin + 1);
+    }
+};
+
+//! bounding box extended by the BlobTracker, see trackedFeaturePacket.md
+class TrackedFeature {
+public:
+    uint8_t box[BoundingBox::SIZE] = {}; //!< as received from the fpga
+    uint16_t trackId = {}; //!< stable while the blob is tracked, 0 if no track was available
+    int8_t velocityX = {}; //!< 1/4 px per frame, saturated
+    int8_t velocityY = {}; //!< 1/4 px per frame, saturated
+    uint8_t confidence = {}; //!< 0 (new or untracked) to 255 (tracked for many frames)
+
+    static constexpr size_t SIZE {11};
+    static constexpr int32_t VELOCITY_SCALE {4}; //!< velocity units per px
+    static constexpr size_t OFFSET_BOX {0};
+    static constexpr size_t OFFSET_TRACK_ID {OFFSET_BOX + BoundingBox::SIZE};
+    static constexpr size_t OFFSET_VELOCITY_X {OFFSET_TRACK_ID + sizeof(trackId)};
+    static constexpr size_t OFFSET_VELOCITY_Y {OFFSET_VELOCITY_X + sizeof(velocityX)};
+    static constexpr size_t OFFSET_CONFIDENCE {OFFSET_VELOCITY_Y + sizeof(velocityY)};
+    static_assert(OFFSET_CONFIDENCE + sizeof(confidence) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_BOX, box, BoundingBox::SIZE);
+        std::memcpy(buffer + OFFSET_TRACK_ID, &trackId, sizeof(trackId));
+        std::memcpy(buffer + OFFSET_VELOCITY_X, &velocityX, sizeof(velocityX));
+        std::memcpy(buffer + OFFSET_VELOCITY_Y, &velocityY, sizeof(velocityY));
+        buffer[OFFSET_CONFIDENCE] = confidence;
+        return true;
+    }
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(box, buffer + OFFSET_BOX, BoundingBox::SIZE);
+        std::memcpy(&trackId, buffer + OFFSET_TRACK_ID, sizeof(trackId));
+        std::memcpy(&velocityX, buffer + OFFSET_VELOCITY_X, sizeof(velocityX));
+        std::memcpy(&velocityY, buffer + OFFSET_VELOCITY_Y, sizeof(velocityY));
+        confidence = buffer[OFFSET_CONFIDENCE];
+        return true;
+    }
+};
+
+class BlobTrackerConfig {
+public:
+    bool enabled = {}; //!< forward tracked packets instead of raw ones
+    uint16_t gatePx = {16}; //!< largest distance between predicted and detected centroid, px of the sensor mode
+    uint8_t coastFrames = {3}; //!< frames a track survives without detection
+
+    static constexpr uint16_t GATE_PX_MIN {1};
+    static constexpr uint16_t GATE_PX_MAX {255};
+    static constexpr uint8_t COAST_FRAMES_MAX {30};
+
+    static constexpr size_t SIZE {4};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static constexpr size_t OFFSET_GATE_PX {OFFSET_ENABLED + sizeof(enabled)};
+    static constexpr size_t OFFSET_COAST_FRAMES {OFFSET_GATE_PX + sizeof(gatePx)};
+    static_assert(OFFSET_COAST_FRAMES + sizeof(coastFrames) == SIZE);
+
+    bool valid() const {
+        return (gatePx >= GATE_PX_MIN) && (gatePx <= GATE_PX_MAX) && (coastFrames <= COAST_FRAMES_MAX);
+    }
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+        std::memcpy(buffer + OFFSET_GATE_PX, &gatePx, sizeof(gatePx));
+        buffer[OFFSET_COAST_FRAMES] = coastFrames;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        enabled = buffer[OFFSET_ENABLED] != 0U;
+        std::memcpy(&gatePx, buffer + OFFSET_GATE_PX, sizeof(gatePx));
+        coastFrames = buffer[OFFSET_COAST_FRAMES];
+        return true;
+    }
+};
+
+class BlobTrackerState {
+public:
+    BlobTrackerConfig config {};
+    uint8_t activeTracks = {}; //!< including coasting tracks
+    uint32_t tracksCreated = {}; //!< since boot
+    uint32_t cyclesLast = {}; //!< core clock cycles spent tracking the latest packet
+    uint32_t cyclesMax = {}; //!< since the last config change
+
+    static constexpr size_t SIZE {BlobTrackerConfig::SIZE + 13};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_ACTIVE_TRACKS {OFFSET_CONFIG + BlobTrackerConfig::SIZE};
+    static constexpr size_t OFFSET_TRACKS_CREATED {OFFSET_ACTIVE_TRACKS + sizeof(activeTracks)};
+    static constexpr size_t OFFSET_CYCLES_LAST {OFFSET_TRACKS_CREATED + sizeof(tracksCreated)};
+    static constexpr size_t OFFSET_CYCLES_MAX {OFFSET_CYCLES_LAST + sizeof(cyclesLast)};
+    static_assert(OFFSET_CYCLES_MAX + sizeof(cyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, BlobTrackerConfig::SIZE);
+        buffer[OFFSET_ACTIVE_TRACKS] = activeTracks;
+        std::memcpy(buffer + OFFSET_TRACKS_CREATED, &tracksCreated, sizeof(tracksCreated));
+        std::memcpy(buffer + OFFSET_CYCLES_LAST, &cyclesLast, sizeof(cyclesLast));
+        std::memcpy(buffer + OFFSET_CYCLES_MAX, &cyclesMax, sizeof(cyclesMax));
+        return true;
+    }
+};
+
+// code book of the active markers, every marker repeats its code with one bit per frame (led on = blob detected)
+class BlinkDecoderConfig {
+public:
+    static constexpr size_t CODES_MAX {16};
+    static constexpr uint8_t CODE_LENGTH_MIN {4};
+    static constexpr uint8_t CODE_LENGTH_MAX {16};
+    static constexpr uint8_t CONFIRM_FRAMES_MAX {16};
+
+    bool enabled = {}; //!< append the marker ids to tracked packets
+    uint8_t codeLength = {8}; //!< bits per code, the same for all codes
+    uint8_t confirmFrames = {2}; //!< consecutive matches of the same code before a marker id is assigned
+    uint8_t codeCount = {}; //!< valid entries in codes
+    std::array<uint16_t, CODES_MAX> codes {}; //!< bit 0 is the first frame, the marker id is the index
+
+    //! range check only, the codes are checked by the decoder
+    bool valid() const {
+        return (codeLength >= CODE_LENGTH_MIN) && (codeLength <= CODE_LENGTH_MAX) && (confirmFrames >= 1U) &&
+            (confirmFrames <= CONFIRM_FRAMES_MAX) && (codeCount <= CODES_MAX);
+    }
+
+    static constexpr size_t SIZE {4 + (CODES_MAX * sizeof(uint16_t))};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static constexpr size_t OFFSET_CODE_LENGTH {OFFSET_ENABLED + sizeof(enabled)};
+    static constexpr size_t OFFSET_CONFIRM_FRAMES {OFFSET_CODE_LENGTH + sizeof(codeLength)};
+    static constexpr size_t OFFSET_CODE_COUNT {OFFSET_CONFIRM_FRAMES + sizeof(confirmFrames)};
+    static constexpr size_t OFFSET_CODES {OFFSET_CODE_COUNT + sizeof(codeCount)};
+    static_assert(OFFSET_CODES + (CODES_MAX * sizeof(uint16_t)) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+        buffer[OFFSET_CODE_LENGTH] = codeLength;
+        buffer[OFFSET_CONFIRM_FRAMES] = confirmFrames;
+        buffer[OFFSET_CODE_COUNT] = codeCount;
+        std::memcpy(buffer + OFFSET_CODES, codes.data(), CODES_MAX * sizeof(uint16_t));
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        enabled = buffer[OFFSET_ENABLED] != 0U;
+        codeLength = buffer[OFFSET_CODE_LENGTH];
+        confirmFrames = buffer[OFFSET_CONFIRM_FRAMES];
+        codeCount = buffer[OFFSET_CODE_COUNT];
+        std::memcpy(codes.data(), buffer + OFFSET_CODES, CODES_MAX * sizeof(uint16_t));
+        return true;
+    }
+};
+
+class BlinkDecoderState {
+public:
+    BlinkDecoderConfig config {};
+    uint8_t watchedTracks = {}; //!< tracks with a blink history
+    uint8_t identifiedTracks = {}; //!< tracks with an assigned marker id
+    uint32_t cyclesLast = {}; //!< core clock cycles spent decoding the latest packet
+    uint32_t cyclesMax = {}; //!< since the last config change
+
+    static constexpr size_t SIZE {BlinkDecoderConfig::SIZE + 10};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_WATCHED_TRACKS {OFFSET_CONFIG + BlinkDecoderConfig::SIZE};
+    static constexpr size_t OFFSET_IDENTIFIED_TRACKS {OFFSET_WATCHED_TRACKS + sizeof(watchedTracks)};
+    static constexpr size_t OFFSET_CYCLES_LAST {OFFSET_IDENTIFIED_TRACKS + sizeof(identifiedTracks)};
+    static constexpr size_t OFFSET_CYCLES_MAX {OFFSET_CYCLES_LAST + sizeof(cyclesLast)};
+    static_assert(OFFSET_CYCLES_MAX + sizeof(cyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, BlinkDecoderConfig::SIZE);
+        buffer[OFFSET_WATCHED_TRACKS] = watchedTracks;
+        buffer[OFFSET_IDENTIFIED_TRACKS] = identifiedTracks;
+        std::memcpy(buffer + OFFSET_CYCLES_LAST, &cyclesLast, sizeof(cyclesLast));
+        std::memcpy(buffer + OFFSET_CYCLES_MAX, &cyclesMax, sizeof(cyclesMax));
+        return true;
+    }
+};
+
+// compact packets: keyframes with absolute bounding boxes, delta frames with per track changes
+class DeltaEncoderConfig {
+public:
+    static constexpr uint8_t KEYFRAME_INTERVAL_MIN {1};
+
+    bool enabled = {}; //!< forward delta packets instead of tracked ones, requires tracking
+    uint8_t keyframeInterval = {30}; //!< packets from one keyframe to the next, 1 sends keyframes only
+
+    static constexpr size_t SIZE {2};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static constexpr size_t OFFSET_KEYFRAME_INTERVAL {OFFSET_ENABLED + sizeof(enabled)};
+    static_assert(OFFSET_KEYFRAME_INTERVAL + sizeof(keyframeInterval) == SIZE);
+
+    bool valid() const {
+        return keyframeInterval >= KEYFRAME_INTERVAL_MIN;
+    }
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+        buffer[OFFSET_KEYFRAME_INTERVAL] = keyframeInterval;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        enabled = buffer[OFFSET_ENABLED] != 0U;
+        keyframeInterval = buffer[OFFSET_KEYFRAME_INTERVAL];
+        return true;
+    }
+};
+
+class DeltaEncoderState {
+public:
+    DeltaEncoderConfig config {};
+    uint32_t keyframes = {};
+    uint32_t deltaFrames = {};
+    uint32_t rawBytes = {}; //!< size the encoded packets would have had as raw packets
+    uint32_t encodedBytes = {};
+    uint32_t cyclesLast = {}; //!< core clock cycles spent encoding the latest packet
+    uint32_t cyclesMax = {}; //!< since the last config change
+
+    static constexpr size_t SIZE {DeltaEncoderConfig::SIZE + 24};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_KEYFRAMES {OFFSET_CONFIG + DeltaEncoderConfig::SIZE};
+    static constexpr size_t OFFSET_DELTA_FRAMES {OFFSET_KEYFRAMES + sizeof(keyframes)};
+    static constexpr size_t OFFSET_RAW_BYTES {OFFSET_DELTA_FRAMES + sizeof(deltaFrames)};
+    static constexpr size_t OFFSET_ENCODED_BYTES {OFFSET_RAW_BYTES + sizeof(rawBytes)};
+    static constexpr size_t OFFSET_CYCLES_LAST {OFFSET_ENCODED_BYTES + sizeof(encodedBytes)};
+    static constexpr size_t OFFSET_CYCLES_MAX {OFFSET_CYCLES_LAST + sizeof(cyclesLast)};
+    static_assert(OFFSET_CYCLES_MAX + sizeof(cyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, DeltaEncoderConfig::SIZE);
+        std::memcpy(buffer + OFFSET_KEYFRAMES, &keyframes, sizeof(keyframes));
+        std::memcpy(buffer + OFFSET_DELTA_FRAMES, &deltaFrames, sizeof(deltaFrames));
+        std::memcpy(buffer + OFFSET_RAW_BYTES, &rawBytes, sizeof(rawBytes));
+        std::memcpy(buffer + OFFSET_ENCODED_BYTES, &encodedBytes, sizeof(encodedBytes));
+        std::memcpy(buffer + OFFSET_CYCLES_LAST, &cyclesLast, sizeof(cyclesLast));
+        std::memcpy(buffer + OFFSET_CYCLES_MAX, &cyclesMax, sizeof(cyclesMax));
+        return true;
+    }
+};
+
+class RecorderConfig {
+public:
+    bool enabled = {true}; //!< record every intact packet as received from the fpga
+
+    static constexpr size_t SIZE {1};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static_assert(OFFSET_ENABLED + sizeof(enabled) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        enabled = buffer[OFFSET_ENABLED] != 0U;
+        return true;
+    }
+};
+
+class RecorderState {
+public:
+    RecorderConfig config {};
+    uint32_t records = {}; //!< held in the recorder
+    uint32_t recordsOverwritten = {}; //!< oldest records dropped for new ones since boot
+    uint32_t oldestFrame = {}; //!< frame numbers are the unwrapped fpga frame counter
+    uint32_t newestFrame = {};
+    uint32_t oldestTimeMs = {}; //!< ms since boot
+    uint32_t newestTimeMs = {};
+    uint32_t bytesUsed = {}; //!< packet data, without the index
+    uint32_t bytesCapacity = {};
+    uint32_t appendCyclesMax = {}; //!< core clock cycles, since boot
+
+    static constexpr size_t SIZE {RecorderConfig::SIZE + 36};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_RECORDS {OFFSET_CONFIG + RecorderConfig::SIZE};
+    static constexpr size_t OFFSET_RECORDS_OVERWRITTEN {OFFSET_RECORDS + sizeof(records)};
+    static constexpr size_t OFFSET_OLDEST_FRAME {OFFSET_RECORDS_OVERWRITTEN + sizeof(recordsOverwritten)};
+    static constexpr size_t OFFSET_NEWEST_FRAME {OFFSET_OLDEST_FRAME + sizeof(oldestFrame)};
+    static constexpr size_t OFFSET_OLDEST_TIME_MS {OFFSET_NEWEST_FRAME + sizeof(newestFrame)};
+    static constexpr size_t OFFSET_NEWEST_TIME_MS {OFFSET_OLDEST_TIME_MS + sizeof(oldestTimeMs)};
+    static constexpr size_t OFFSET_BYTES_USED {OFFSET_NEWEST_TIME_MS + sizeof(newestTimeMs)};
+    static constexpr size_t OFFSET_BYTES_CAPACITY {OFFSET_BYTES_USED + sizeof(bytesUsed)};
+    static constexpr size_t OFFSET_APPEND_CYCLES_MAX {OFFSET_BYTES_CAPACITY + sizeof(bytesCapacity)};
+    static_assert(OFFSET_APPEND_CYCLES_MAX + sizeof(appendCyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, RecorderConfig::SIZE);
+        std::memcpy(buffer + OFFSET_RECORDS, &records, sizeof(records));
+        std::memcpy(buffer + OFFSET_RECORDS_OVERWRITTEN, &recordsOverwritten, sizeof(recordsOverwritten));
+        std::memcpy(buffer + OFFSET_OLDEST_FRAME, &oldestFrame, sizeof(oldestFrame));
+        std::memcpy(buffer + OFFSET_NEWEST_FRAME, &newestFrame, sizeof(newestFrame));
+        std::memcpy(buffer + OFFSET_OLDEST_TIME_MS, &oldestTimeMs, sizeof(oldestTimeMs));
+        std::memcpy(buffer + OFFSET_NEWEST_TIME_MS, &newestTimeMs, sizeof(newestTimeMs));
+        std::memcpy(buffer + OFFSET_BYTES_USED, &bytesUsed, sizeof(bytesUsed));
+        std::memcpy(buffer + OFFSET_BYTES_CAPACITY, &bytesCapacity, sizeof(bytesCapacity));
+        std::memcpy(buffer + OFFSET_APPEND_CYCLES_MAX, &appendCyclesMax, sizeof(appendCyclesMax));
+        return true;
+    }
+};
+
+enum RecorderRangeType : uint8_t {
+    RANGE_FRAMES = 0, //!< first and last are frame numbers
+    RANGE_TIME_MS = 1, //!< first and last are ms since boot
+    RANGE_UNDEFINED = UINT8_MAX
+};
+
+class RecorderRange {
+public:
+    RecorderRangeType type = {RecorderRangeType::RANGE_UNDEFINED};
+    uint32_t first = {}; //!< inclusive
+    uint32_t last = {}; //!< inclusive
+
+    static constexpr size_t SIZE {9};
+    static constexpr size_t OFFSET_TYPE {0};
+    static constexpr size_t OFFSET_FIRST {OFFSET_TYPE + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_LAST {OFFSET_FIRST + sizeof(first)};
+    static_assert(OFFSET_LAST + sizeof(last) == SIZE);
+
+    bool valid() const {
+        return (type <= RecorderRangeType::RANGE_TIME_MS) && (first <= last);
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        type = static_cast<RecorderRangeType>(buffer[OFFSET_TYPE]);
+        std::memcpy(&first, buffer + OFFSET_FIRST, sizeof(first));
+        std::memcpy(&last, buffer + OFFSET_LAST, sizeof(last));
+        return true;
+    }
+};
+
+class RecorderFetchResult {
+public:
+    uint32_t records = {}; //!< sent
+    uint32_t bytes = {}; //!< sent, including the record headers
+    uint32_t recordsLost = {}; //!< overwritten while the fetch was running
+
+    static constexpr size_t SIZE {12};
+    static constexpr size_t OFFSET_RECORDS {0};
+    static constexpr size_t OFFSET_BYTES {OFFSET_RECORDS + sizeof(records)};
+    static constexpr size_t OFFSET_RECORDS_LOST {OFFSET_BYTES + sizeof(bytes)};
+    static_assert(OFFSET_RECORDS_LOST + sizeof(recordsLost) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_RECORDS, &records, sizeof(records));
+        std::memcpy(buffer + OFFSET_BYTES, &bytes, sizeof(bytes));
+        std::memcpy(buffer + OFFSET_RECORDS_LOST, &recordsLost, sizeof(recordsLost));
+        return true;
+    }
+};
+
+//! per frame summary of the received features, published by the BlobReceiver
+struct FrameStatistics {
+    uint8_t frameCount;
+    uint8_t blobCount;
+    uint8_t sensorMode;
+    uint32_t areaSum; //!< sum of all bounding box areas in full resolution px
+    uint32_t areaMax; //!< largest bounding box area in full resolution px
+};
+
+// how feature packets are forwarded to the host
+enum BlobTransport : uint8_t {
+    TRANSPORT_TCP_SOCKET = 0x00, //!< new tcp connection per packet
+    TRANSPORT_UDP_SOCKET = 0x01, //!< socket api, new socket per packet
+    TRANSPORT_UDP_RAW = 0x02, //!< raw api, connected pcb, zero copy
+    TRANSPORT_UNDEFINED = UINT8_MAX
+};
+
+//! feature stream counters since boot, tells spi (cabling) faults apart from network drops
+class FeatureStreamStats {
+public:
+    uint32_t packetsReceived = {}; //!< complete packets read from the spi buffer, including corrupt ones
+    uint32_t packetsCorrupt = {}; //!< crc mismatch, dropped
+    uint32_t packetsSent = {}; //!< forwarded to the host
+    uint32_t sendFailures = {}; //!< forwarding failed, dropped
+    uint32_t overruns = {}; //!< spi buffer overwritten before it was read, the receiver could not keep up
+    uint32_t resyncs = {}; //!< packet boundary lost (invalid header), an incomplete packet waits for the next interrupt
+    uint32_t messagesDropped = {}; //!< interrupt messages lost on a full queue, their packets are parsed with the next one
+    uint32_t bytesDiscarded = {}; //!< bytes skipped by overruns and resyncs
+    uint32_t sendCyclesMean = {}; //!< core clock cycles per forwarded packet since the last transport change
+    uint32_t sendCyclesMax = {}; //!< since the last transport change
+
+    static constexpr size_t SIZE {40};
+    static constexpr size_t OFFSET_PACKETS_RECEIVED {0};
+    static constexpr size_t OFFSET_PACKETS_CORRUPT {OFFSET_PACKETS_RECEIVED + sizeof(packetsReceived)};
+    static constexpr size_t OFFSET_PACKETS_SENT {OFFSET_PACKETS_CORRUPT + sizeof(packetsCorrupt)};
+    static constexpr size_t OFFSET_SEND_FAILURES {OFFSET_PACKETS_SENT + sizeof(packetsSent)};
+    static constexpr size_t OFFSET_OVERRUNS {OFFSET_SEND_FAILURES + sizeof(sendFailures)};
+    static constexpr size_t OFFSET_RESYNCS {OFFSET_OVERRUNS + sizeof(overruns)};
+    static constexpr size_t OFFSET_MESSAGES_DROPPED {OFFSET_RESYNCS + sizeof(resyncs)};
+    static constexpr size_t OFFSET_BYTES_DISCARDED {OFFSET_MESSAGES_DROPPED + sizeof(messagesDropped)};
+    static constexpr size_t OFFSET_SEND_CYCLES_MEAN {OFFSET_BYTES_DISCARDED + sizeof(bytesDiscarded)};
+    static constexpr size_t OFFSET_SEND_CYCLES_MAX {OFFSET_SEND_CYCLES_MEAN + sizeof(sendCyclesMean)};
+    static_assert(OFFSET_SEND_CYCLES_MAX + sizeof(sendCyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_PACKETS_RECEIVED, &packetsReceived, sizeof(packetsReceived));
+        std::memcpy(buffer + OFFSET_PACKETS_CORRUPT, &packetsCorrupt, sizeof(packetsCorrupt));
+        std::memcpy(buffer + OFFSET_PACKETS_SENT, &packetsSent, sizeof(packetsSent));
+        std::memcpy(buffer + OFFSET_SEND_FAILURES, &sendFailures, sizeof(sendFailures));
+        std::memcpy(buffer + OFFSET_OVERRUNS, &overruns, sizeof(overruns));
+        std::memcpy(buffer + OFFSET_RESYNCS, &resyncs, sizeof(resyncs));
+        std::memcpy(buffer + OFFSET_MESSAGES_DROPPED, &messagesDropped, sizeof(messagesDropped));
+        std::memcpy(buffer + OFFSET_BYTES_DISCARDED, &bytesDiscarded, sizeof(bytesDiscarded));
+        std::memcpy(buffer + OFFSET_SEND_CYCLES_MEAN, &sendCyclesMean, sizeof(sendCyclesMean));
+        std::memcpy(buffer + OFFSET_SEND_CYCLES_MAX, &sendCyclesMax, sizeof(sendCyclesMax));
+        return true;
+    }
+};
+
+#endif // VISIONADDON_APP_BLOB_BLOBTYPES_H
@@ -0,0 +1,252 @@
+#include "DeltaEncoder.h"
+
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+
+static bool fitsNibble(int32_t value) {
+    return (value >= -8) && (value <= 7);
+}
+
+//! within the sensor, keeps every residual below 2 varint bytes
+static int32_t predict(int32_t center2, int32_t motion2, int32_t packets, size_t bits) {
+    return std::clamp<int32_t>(center2 + (motion2 * packets), 0, 2 * ((1 << bits) - 1));
+}
+
+static uint8_t nibbles(int32_t low, int32_t high) {
+    return static_cast<uint8_t>((static_cast<uint32_t>(low) & 0x0FU) | ((static_cast<uint32_t>(high) & 0x0FU) << 4U));
+}
+
+bool DeltaEncoder::config(const DeltaEncoderConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[DeltaEncoder] invalid config rejected, keyframe interval %u", config.keyframeInterval);
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    _state.cyclesMax = 0U;
+    _keyframePending = true;
+    _mutex.unlock();
+    Log::info("[DeltaEncoder] %s, keyframe interval %u", config.enabled ? "enabled" : "disabled", config.keyframeInterval);
+    return true;
+}
+
+DeltaEncoderState DeltaEncoder::state() {
+    _mutex.lock();
+    DeltaEncoderState state = _state;
+    state.config = _config;
+    _mutex.unlock();
+    return state;
+}
+
+void DeltaEncoder::resync() {
+    _mutex.lock();
+    _keyframePending = true;
+    _mutex.unlock();
+}
+
+size_t DeltaEncoder::process(uint8_t* packet, size_t size, size_t capacity) {
+    _mutex.lock();
+    const DeltaEncoderConfig config = _config;
+    _mutex.unlock();
+    if(!config.enabled || (size < BlobPacket::HEADER_SIZE)) {
+        resync(); // the host loses the reference with the first packet of another format
+        return size;
+    }
+    const uint8_t format = packet[BlobPacket::OFFSET_SENSOR_MODE] >> BlobPacket::FORMAT_SHIFT;
+    const size_t featureCount = packet[BlobPacket::OFFSET_FEATURE_COUNT];
+    const size_t trackedSize = BlobPacket::HEADER_SIZE + (featureCount * TrackedFeature::SIZE);
+    if((format != BlobPacketFormat::PACKET_FORMAT_TRACKED) || (size < trackedSize)) {
+        resync();
+        return size; // tracking disabled, there are no track ids to reference
+    }
+    const size_t trailerSize = size - trackedSize;
+    if(trailerSize > (1 + (BlinkDecoder::MAX_IDENTIFIED * BlinkDecoder::TRAILER_ENTRY_SIZE))) {
+        Log::warning("[DeltaEncoder] unexpected packet size %u, %u features", size, featureCount);
+        resync();
+        return size;
+    }
+    const uint32_t start = CycleCounter::now();
+
+    _mutex.lock();
+    bool keyframe = _keyframePending;
+    _keyframePending = false;
+    _mutex.unlock();
+    const uint8_t sensorMode = packet[BlobPacket::OFFSET_SENSOR_MODE] & BlobPacket::SENSOR_MODE_MASK;
+    if(sensorMode != _sensorMode) {
+        keyframe = true;
+        _sensorMode = sensorMode;
+    }
+    if(_packetsSinceKeyframe >= (config.keyframeInterval - 1U)) {
+        keyframe = true;
+    }
+
+    TrackedFeature tracked {};
+    BoundingBox box {};
+    for(size_t i = 0; i < featureCount; i++) {
+        tracked.fromBytes(packet + BlobPacket::OFFSET_FEATURES + (i * TrackedFeature::SIZE), TrackedFeature::SIZE);
+        box.fromBytes(tracked.box, BoundingBox::SIZE);
+        Feature& feature = _features[i];
+        feature.trackId = tracked.trackId;
+        feature.centerX2 = static_cast<int32_t>(box.xMin) + box.xMax;
+        feature.centerY2 = static_cast<int32_t>(box.yMin) + box.yMax;
+        feature.width = static_cast<int32_t>(box.xMax) - box.xMin;
+        feature.height = static_cast<int32_t>(box.yMax) - box.yMin;
+        feature.motionX2 = 0;
+        feature.motionY2 = 0;
+        feature.missed = 0U;
+    }
+
+    uint8_t* out = _encoded.data();
+    out[BlobPacket::OFFSET_FRAME_COUNT] = packet[BlobPacket::OFFSET_FRAME_COUNT];
+    out[BlobPacket::OFFSET_FEATURE_COUNT] = static_cast<uint8_t>(featureCount);
+    out[BlobPacket::OFFSET_SENSOR_MODE] = sensorMode | (BlobPacketFormat::PACKET_FORMAT_DELTA << BlobPacket::FORMAT_SHIFT);
+    out[DeltaPacket::OFFSET_SEQUENCE] = _sequence;
+    out[DeltaPacket::OFFSET_FLAGS] = keyframe ? DeltaPacket::FLAG_KEYFRAME : 0U;
+    size_t encodedSize {DeltaPacket::HEADER_SIZE};
+    _nextReferenceCount = 0;
+    if(keyframe) {
+        for(size_t i = 0; i < featureCount; i++) {
+            appendReference(_features[i]);
+            const uint8_t* raw = packet + BlobPacket::OFFSET_FEATURES + (i * TrackedFeature::SIZE);
+            std::memcpy(out + encodedSize, raw + TrackedFeature::OFFSET_TRACK_ID, sizeof(uint16_t));
+            std::memcpy(out + encodedSize + sizeof(uint16_t), raw + TrackedFeature::OFFSET_BOX, BoundingBox::SIZE);
+            encodedSize += DeltaPacket::ENTRY_SIZE;
+            _decodedIndex[i] = static_cast<uint8_t>(i);
+        }
+    } else {
+        encodedSize += encodeDelta(packet, featureCount, out + encodedSize);
+    }
+
+    // the marker trailer refers to the decoded feature order
+    if(trailerSize > 0U) {
+        const uint8_t* trailer = packet + trackedSize;
+        const size_t entries = std::min<size_t>(trailer[0], (trailerSize - 1) / BlinkDecoder::TRAILER_ENTRY_SIZE);
+        out[encodedSize] = static_cast<uint8_t>(entries);
+        for(size_t i = 0; i < entries; i++) {
+            const uint8_t featureIndex = trailer[1 + (i * BlinkDecoder::TRAILER_ENTRY_SIZE)];
+            out[encodedSize + 1 + (i * BlinkDecoder::TRAILER_ENTRY_SIZE)] = (featureIndex < featureCount) ? _decodedIndex[featureIndex] : featureIndex;
+            out[encodedSize + 2 + (i * BlinkDecoder::TRAILER_ENTRY_SIZE)] = trailer[2 + (i * BlinkDecoder::TRAILER_ENTRY_SIZE)];
+        }
+        encodedSize += 1 + (entries * BlinkDecoder::TRAILER_ENTRY_SIZE);
+    }
+    if(encodedSize > capacity) {
+        Log::error("[DeltaEncoder] packet buffer too small, %u bytes", capacity);
+        resync();
+        return size;
+    }
+    std::memcpy(packet, out, encodedSize);
+
+    std::copy_n(_nextReference.cbegin(), _nextReferenceCount, _reference.begin());
+    _referenceCount = _nextReferenceCount;
+    _sequence++;
+    _packetsSinceKeyframe = keyframe ? 0U : static_cast<uint8_t>(_packetsSinceKeyframe + 1U);
+
+    const uint32_t cycles = CycleCounter::now() - start;
+    _mutex.lock();
+    if(keyframe) {
+        _state.keyframes++;
+    } else {
+        _state.deltaFrames++;
+    }
+    _state.rawBytes += BlobPacket::HEADER_SIZE + (featureCount * BoundingBox::SIZE) + trailerSize;
+    _state.encodedBytes += encodedSize;
+    _state.cyclesLast = cycles;
+    _state.cyclesMax = std::max(_state.cyclesMax, cycles);
+    _mutex.unlock();
+    return encodedSize;
+}
+
+size_t DeltaEncoder::encodeDelta(const uint8_t* packet, size_t featureCount, uint8_t* out) {
+    // match the features of this packet with the reference by track id
+    std::fill_n(_referenceFeature.begin(), _referenceCount, _NONE);
+    std::fill_n(_decodedIndex.begin(), featureCount, UINT8_MAX);
+    for(size_t i = 0; i < featureCount; i++) {
+        if(_features[i].trackId == 0U) {
+            continue;
+        }
+        for(size_t r = 0; r < _referenceCount; r++) {
+            if(_reference[r].trackId == _features[i].trackId) {
+                _referenceFeature[r] = static_cast<int16_t>(i);
+                break;
+            }
+        }
+    }
+
+    const size_t modesSize = (_referenceCount + DeltaPacket::MODES_PER_BYTE - 1) / DeltaPacket::MODES_PER_BYTE;
+    uint8_t* modes = out;
+    std::fill_n(modes, modesSize, 0U);
+    uint8_t* payload = out + modesSize;
+    size_t decoded {0};
+    for(size_t r = 0; r < _referenceCount; r++) {
+        const int16_t i = _referenceFeature[r];
+        const Feature& reference = _reference[r];
+        if(i == _NONE) {
+            // MODE_ABSENT, position and motion are held
+            if(reference.missed < REFERENCE_HOLD) {
+                Feature held = reference;
+                held.missed++;
+                appendReference(held);
+            }
+            continue;
+        }
+        Feature& feature = _features[i];
+        const int32_t packets = static_cast<int32_t>(reference.missed) + 1;
+        const int32_t residualX = feature.centerX2 - predict(reference.centerX2, reference.motionX2, packets, BoundingBox::BITS_X);
+        const int32_t residualY = feature.centerY2 - predict(reference.centerY2, reference.motionY2, packets, BoundingBox::BITS_Y);
+        // the motion is only measured between consecutive packets
+        feature.motionX2 = (reference.missed == 0U) ? (feature.centerX2 - reference.centerX2) : reference.motionX2;
+        feature.motionY2 = (reference.missed == 0U) ? (feature.centerY2 - reference.centerY2) : reference.motionY2;
+        const int32_t changeWidth = feature.width - reference.width;
+        const int32_t changeHeight = feature.height - reference.height;
+        Mode mode {MODE_VARINT};
+        if(fitsNibble(residualX) && fitsNibble(residualY) && (changeWidth == 0) && (changeHeight == 0)) {
+            mode = MODE_POSITION;
+            *payload++ = nibbles(residualX, residualY);
+        } else if(fitsNibble(residualX) && fitsNibble(residualY) && fitsNibble(changeWidth) && fitsNibble(changeHeight)) {
+            mode = MODE_POSITION_SIZE;
+            *payload++ = nibbles(residualX, residualY);
+            *payload++ = nibbles(changeWidth, changeHeight);
+        } else {
+            payload = writeVarint(payload, residualX);
+            payload = writeVarint(payload, residualY);
+            payload = writeVarint(payload, changeWidth);
+            payload = writeVarint(payload, changeHeight);
+        }
+        modes[r / DeltaPacket::MODES_PER_BYTE] |= static_cast<uint8_t>(mode << (2U * (r % DeltaPacket::MODES_PER_BYTE)));
+        appendReference(feature);
+        _decodedIndex[i] = static_cast<uint8_t>(decoded++);
+    }
+    // features without reference: new tracks and untracked blobs
+    for(size_t i = 0; i < featureCount; i++) {
+        if(_decodedIndex[i] != UINT8_MAX) {
+            continue;
+        }
+        const uint8_t* raw = packet + BlobPacket::OFFSET_FEATURES + (i * TrackedFeature::SIZE);
+        std::memcpy(payload, raw + TrackedFeature::OFFSET_TRACK_ID, sizeof(uint16_t));
+        std::memcpy(payload + sizeof(uint16_t), raw + TrackedFeature::OFFSET_BOX, BoundingBox::SIZE);
+        payload += DeltaPacket::ENTRY_SIZE;
+        appendReference(_features[i]);
+        _decodedIndex[i] = static_cast<uint8_t>(decoded++);
+    }
+    return static_cast<size_t>(payload - out);
+}
+
+void DeltaEncoder::appendReference(const Feature& feature) {
+    // untracked features can not be referenced, features beyond the reference size are sent as new ones again
+    if((feature.trackId != 0U) && (_nextReferenceCount < MAX_REFERENCE)) {
+        _nextReference[_nextReferenceCount++] = feature;
+    }
+}
+
+uint8_t* DeltaEncoder::writeVarint(uint8_t* out, int32_t value) {
+    // zigzag maps small magnitudes of either sign to small codes, 7 bits per byte, msb set if more bytes follow
+    uint32_t code = (static_cast<uint32_t>(value) << 1U) ^ static_cast<uint32_t>(value >> 31);
+    while(code >= 0x80U) {
+        *out++ = static_cast<uint8_t>(code | 0x80U);
+        code >>= 7U;
+    }
+    *out++ = static_cast<uint8_t>(code);
+    return out;
+}
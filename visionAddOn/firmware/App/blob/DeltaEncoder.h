@@ -0,0 +1,107 @@
+#ifndef VISIONADDON_APP_BLOB_DELTAENCODER_H
+#define VISIONADDON_APP_BLOB_DELTAENCODER_H
+
+#include "BlinkDecoder.h"
+#include "BlobTypes.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstdint>
+
+// layout of the delta packets, see App/blob/deltaFeaturePacket.md
+namespace DeltaPacket {
+    static constexpr size_t OFFSET_SEQUENCE {BlobPacket::HEADER_SIZE}; //!< incremented per packet, a gap invalidates the reference
+    static constexpr size_t OFFSET_FLAGS {OFFSET_SEQUENCE + 1};
+    static constexpr size_t HEADER_SIZE {OFFSET_FLAGS + 1};
+    static constexpr uint8_t FLAG_KEYFRAME {0x01};
+    static constexpr size_t ENTRY_SIZE {sizeof(uint16_t) + BoundingBox::SIZE}; //!< track id and bounding box of keyframes and new tracks
+    static constexpr size_t MODES_PER_BYTE {4};
+}
+
+// Encodes tracked packets as keyframes and delta frames, typically 4-5x smaller than raw packets.
+//
+// Keyframes carry the track id and bounding box of every feature. The features of a packet become the reference
+// of the next one, a delta frame carries a 2 bit mode per reference feature followed by the changes of the present
+// ones. The centroid (doubled, to stay integer) is predicted by the motion since the previous packet, the size by the
+// previous size. Small residuals are packed into nibbles, larger ones are zigzag varints. Features without reference
+// (new tracks) follow with their track id and bounding box. The host reconstructs the bounding boxes bit-exact.
+// Absent features stay in the reference for a few packets, blinking or briefly occluded markers return as deltas.
+// A keyframe is sent every keyframeInterval packets, on sensor mode changes, after a failed send and on request.
+// Velocity and confidence of the tracked packet are dropped, the marker trailer is kept.
+class DeltaEncoder final {
+public:
+    DeltaEncoder() = default;
+    DeltaEncoder (const DeltaEncoder&) = delete;
+    DeltaEncoder& operator=(const DeltaEncoder&) = delete;
+    DeltaEncoder (const DeltaEncoder&&) = delete;
+    DeltaEncoder& operator=(const DeltaEncoder&&) = delete;
+
+    enum Mode : uint8_t {
+        MODE_ABSENT = 0x0, //!< reference feature not detected
+        MODE_POSITION = 0x1, //!< 1 byte: centroid residual x, y as nibbles, size unchanged
+        MODE_POSITION_SIZE = 0x2, //!< 2 bytes: centroid residual x, y and size change width, height as nibbles
+        MODE_VARINT = 0x3 //!< 4 zigzag varints: centroid residual x, y and size change width, height
+    };
+
+    static constexpr size_t MAX_REFERENCE {BlobPacket::MAX_FEATURE_COUNT + 2}; //!< absent features are dropped first
+    static constexpr uint8_t REFERENCE_HOLD {4}; //!< packets an absent feature stays in the reference
+    static constexpr size_t MAX_PACKET_SIZE {DeltaPacket::HEADER_SIZE + (MAX_REFERENCE / DeltaPacket::MODES_PER_BYTE) +
+        (BlobPacket::MAX_FEATURE_COUNT * DeltaPacket::ENTRY_SIZE) + 1 + (BlinkDecoder::MAX_IDENTIFIED * BlinkDecoder::TRAILER_ENTRY_SIZE)};
+
+    /**
+     * @brief Apply a new config, forces a keyframe and resets the cycle maximum.
+     *
+     * @return false if config is invalid
+     */
+    bool config(const DeltaEncoderConfig& config);
+    DeltaEncoderState state();
+    void resync(); //!< send a keyframe next
+
+    /**
+     * @brief Encode a tracked packet in place.
+     *
+     * @param packet tracked packet, optionally followed by the marker trailer
+     * @param size of the tracked packet
+     * @param capacity of the packet buffer
+     * @return size of the delta packet, size if encoding is disabled or the packet is not tracked
+     */
+    size_t process(uint8_t* packet, size_t size, size_t capacity);
+
+private:
+    class Feature {
+    public:
+        int32_t centerX2 {0}; //!< xMin + xMax
+        int32_t centerY2 {0}; //!< yMin + yMax
+        int32_t width {0}; //!< xMax - xMin
+        int32_t height {0}; //!< yMax - yMin
+        int32_t motionX2 {0}; //!< centerX2 change since the previous packet
+        int32_t motionY2 {0}; //!< centerY2 change since the previous packet
+        uint16_t trackId {0};
+        uint8_t missed {0}; //!< packets since the feature was present
+    };
+    size_t encodeDelta(const uint8_t* packet, size_t featureCount, uint8_t* out);
+    void appendReference(const Feature& feature);
+    static uint8_t* writeVarint(uint8_t* out, int32_t value);
+
+    static constexpr int16_t _NONE {-1};
+
+    Mutex _mutex;
+    DeltaEncoderConfig _config {};
+    DeltaEncoderState _state {};
+    bool _keyframePending {true};
+
+    // encoding task only
+    std::array<Feature, BlobPacket::MAX_FEATURE_COUNT> _features {}; //!< of the current packet, input order
+    std::array<Feature, MAX_REFERENCE> _reference {};
+    std::array<Feature, MAX_REFERENCE> _nextReference {};
+    std::array<int16_t, MAX_REFERENCE> _referenceFeature {}; //!< input index per reference entry
+    std::array<uint8_t, BlobPacket::MAX_FEATURE_COUNT> _decodedIndex {}; //!< decoded index per input index
+    std::array<uint8_t, MAX_PACKET_SIZE> _encoded {};
+    size_t _referenceCount {0};
+    size_t _nextReferenceCount {0};
+    uint8_t _packetsSinceKeyframe {0};
+    uint8_t _sequence {0};
+    uint8_t _sensorMode {UINT8_MAX};
+};
+
+#endif // VISIONADDON_APP_BLOB_DELTAENCODER_H
@@ -1,12 +1,17 @@
 #include "ExternalInterruptHandler.h"
 
+#include "metrics/PeripheralErrors.h"
 #include "stm32f7xx_hal_dma.h"
 #include "utils/assert.h"
+#include "utils/Cache.h"
+#include "utils/interrupt/InterruptProfiler.h"
 #include "utils/Log.h"
+#include "utils/SyncClock.h"
 
 #include <algorithm>
-#include <mutex>
-std::unordered_map<uint16_t, ExternalInterruptHandler&> ExternalInterruptHandler::_handleToHandler {};
+
+std::array<ExternalInterruptHandler*, ExternalInterruptHandler::_NUMBER_OF_EXTI_LINES> ExternalInterruptHandler::_handlers {};
+uint8_t ExternalInterruptHandler::_rxBuffer[ExternalInterruptHandler::_RX_BUFFER_SIZE] DMA_BUFFER;
 
 ExternalInterruptHandler::ExternalInterruptHandler(
     SPI_HandleTypeDef* spiHandle,
@@ -18,16 +23,9 @@ _messageQId{messageQId}
     ASSERT(_messageQId != nullptr);
 }
 
-bool ExternalInterruptHandler::dmaRxStart()
+bool ExternalInterruptHandler::start()
 {
-    static constexpr size_t BUFFER_SIZE {1024};
-    uint8_t* bufferBase = static_cast<uint8_t*>(_bufferPool.acquire(BUFFER_SIZE));
-    if(bufferBase == nullptr) {
-        Log::warning("[ExternalInterruptHandler] Abort, buffer acquire failed");
-        return false;
-    }
-
-    HAL_StatusTypeDef startRet = HAL_SPI_Receive_DMA(_spiHandle, bufferBase, BUFFER_SIZE);
+    HAL_StatusTypeDef startRet = HAL_SPI_Receive_DMA(_spiHandle, _rxBuffer, _RX_BUFFER_SIZE);
     if(startRet != HAL_OK) {
         Log::warning("[ExternalInterruptHandler] Abort, DMA start failed with code %d", startRet);
         return false;
@@ -36,42 +34,39 @@ bool ExternalInterruptHandler::dmaRxStart()
     return true;
 }
 
-bool ExternalInterruptHandler::dmaRxStop()
-{
-    HAL_StatusTypeDef stopRet = HAL_SPI_DMAStop(_spiHandle);
-    if(stopRet != HAL_OK) {
-        Log::warning("[ExternalInterruptHandler] Abort, DMA stop failed with code %d", stopRet);
-        return false;
-    }
-
-    return true;
-}
-
 void ExternalInterruptHandler::handleInterrupt()
 {
-    dmaRxStop();
-
-    // publish data
-    uint32_t bytesReceived = _spiHandle->RxXferSize - __HAL_DMA_GET_COUNTER(_spiHandle->hdmarx);
-
-    _message.bytesReceived = bytesReceived; // bytes received in previous buffer
-    _message.bufferBase =  _spiHandle->pRxBuffPtr;
-    ASSERT(osMessageQueuePut(_messageQId, &_message, 0, 0) == osOK);
-
-    dmaRxStart();
+    // constant time, the receiver does the parsing
+    const uint32_t writeIndex = (_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(_spiHandle->hdmarx)) & (_RX_BUFFER_SIZE - 1);
+    _bytesTotal += (writeIndex - _writeIndex) & (_RX_BUFFER_SIZE - 1); // packets are smaller than the buffer
+    _writeIndex = writeIndex;
+
+    // a message lost on a full queue is recovered with the next one, bytesTotal is cumulative
+    _message.bytesTotal = _bytesTotal;
+    _message.receivedUs = SyncClock::localUs();
+    _message.messagesDropped = _messagesDropped.load();
+    if(osMessageQueuePut(_messageQId, &_message, 0, 0) != osOK) {
+        _messagesDropped++;
+    }
 }
 
 void ExternalInterruptHandler::registerHandler(uint16_t gpioPin, ExternalInterruptHandler& handler){
+    ASSERT((gpioPin != 0) && ((gpioPin & (gpioPin - 1)) == 0));
     Log::debug("[ExternalInterruptHandler] register handler for external interrupt on GPIO pin %#x", gpioPin);
-    _handleToHandler.insert({gpioPin, handler});
+    _handlers[extiLine(gpioPin)] = &handler;
 }
 
 bool ExternalInterruptHandler::callHandler(uint16_t gpioPin){
-    auto it = _handleToHandler.find(gpioPin);
-    if(it == _handleToHandler.end()){
+    if(gpioPin == 0) {
+        return false;
+    }
+    ExternalInterruptHandler* handler = _handlers[extiLine(gpioPin)];
+    if(handler == nullptr){
         return false;
     }
-    it->second.handleInterrupt();
+    const uint32_t handlerStart = CycleCounter::now();
+    handler->handleInterrupt();
+    InterruptProfiler::record(INTERRUPT_SOURCE_EXTI, handlerStart);
     return true;
 }
 
@@ -83,6 +78,5 @@ void HAL_GPIO_EXTI_Callback(uint16_t gpioPin)
 //TODO: move to different file
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 {
-    (void)hspi;
-    Log::error("[HAL_SPI_ErrorCallback]");
+    PeripheralErrors::record(PERIPHERAL_SPI, hspi->ErrorCode);
 }
@@ -4,19 +4,27 @@
 #include "cmsis_os2.h"
 #include "utils/ITransfer.h"
 #include "utils/mutex/Mutex.h"
-#include "utils/pool/CyclicPool.h"
 #include "stm32f7xx_hal.h"
 #include "utils/IActivatable.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <unordered_map>
 
 //TODO: move out of this header
 struct ExternalIsrToBlobReceiverQMessage {
-    std::uint8_t* bufferBase;
-    size_t bytesReceived;
+    const std::uint8_t* bufferBase; //!< base of the circular receive buffer
+    size_t bufferSize;
+    uint32_t bytesTotal; //!< bytes received since start (wraps), marks the end of a packet, write index is bytesTotal % bufferSize
+    uint64_t receivedUs; //!< SyncClock local time of the interrupt
+    uint32_t messagesDropped; //!< messages lost on a full queue since start, at the time of this one
 };
 
+// The spi slave receives into a circular DMA buffer which is never stopped.
+// The fpga raises the external interrupt after every packet, the interrupt only publishes the current write position,
+// the packets are extracted from the buffer by the receiver using the packet header.
+// The buffer is in the non cacheable DMA region, the receiver reads it while the DMA writes, there is one spi slave.
+
 class ExternalInterruptHandler final {
 public:
     ExternalInterruptHandler(SPI_HandleTypeDef* spiHandle, osMessageQueueId_t messageQId);
@@ -24,18 +32,26 @@ public:
     ExternalInterruptHandler& operator=(const ExternalInterruptHandler&) = delete;
     ExternalInterruptHandler (const ExternalInterruptHandler&&) = delete;
     ExternalInterruptHandler& operator=(const ExternalInterruptHandler&&) = delete;
+    bool start(); //!< start the circular reception, must be called once
     void handleInterrupt();
-    static void registerHandler(uint16_t gpioPin, ExternalInterruptHandler& handler);
-    static bool callHandler(uint16_t gpioPin);
+    uint32_t messagesDropped() const {return _messagesDropped.load();}; //!< lost on a full queue since start
+    static void registerHandler(uint16_t gpioPin, ExternalInterruptHandler& handler); //!< gpioPin has exactly one bit set
+    static bool callHandler(uint16_t gpioPin); //!< interrupt context, constant time
 private:
-    bool dmaRxStart();
-    bool dmaRxStop();
+    static constexpr size_t _NUMBER_OF_EXTI_LINES {16};
+    static constexpr size_t extiLine(uint16_t gpioPin) {return static_cast<size_t>(__builtin_ctz(gpioPin));}; //!< GPIO_PIN_x is 1 << x, compiles to rbit + clz
+
+    static constexpr size_t _RX_BUFFER_SIZE {8192}; //!< power of 2, >10 worst case packets (761 bytes)
+    static_assert((_RX_BUFFER_SIZE & (_RX_BUFFER_SIZE - 1)) == 0);
 
     SPI_HandleTypeDef* _spiHandle;
     osMessageQueueId_t _messageQId;
-    CyclicPool _bufferPool = CyclicPool(1024, 2);
-    ExternalIsrToBlobReceiverQMessage _message {nullptr, 0};
-    static std::unordered_map<uint16_t, ExternalInterruptHandler&> _handleToHandler;
+    static uint8_t _rxBuffer[_RX_BUFFER_SIZE];
+    uint32_t _writeIndex {0};
+    uint32_t _bytesTotal {0};
+    std::atomic<uint32_t> _messagesDropped {0};
+    ExternalIsrToBlobReceiverQMessage _message {_rxBuffer, _RX_BUFFER_SIZE, 0, 0, 0};
+    static std::array<ExternalInterruptHandler*, _NUMBER_OF_EXTI_LINES> _handlers; //!< indexed by exti line, filled once at build time
 };
 
 void registerInterruptHandler(ExternalInterruptHandler* handler);
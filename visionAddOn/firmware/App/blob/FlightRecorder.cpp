@@ -0,0 +1,197 @@
+#include "FlightRecorder.h"
+
+#include "lwip.h"
+#include "utils/assert.h"
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+FlightRecorder::FlightRecorder(uint8_t* memory, size_t size)
+{
+    ASSERT(memory != nullptr);
+    size_t indexCapacity = 1;
+    while((indexCapacity * 2 * sizeof(IndexEntry)) <= (size / _INDEX_SHARE)) {
+        indexCapacity *= 2;
+    }
+    _index = reinterpret_cast<IndexEntry*>(memory);
+    _indexMask = static_cast<uint32_t>(indexCapacity - 1);
+    _data = memory + (indexCapacity * sizeof(IndexEntry));
+    _dataCapacity = size - (indexCapacity * sizeof(IndexEntry));
+    ASSERT(_dataCapacity >= RecorderRecord::MAX_PACKET_SIZE);
+}
+
+void FlightRecorder::config(const RecorderConfig& config)
+{
+    _mutex.lock();
+    _config = config;
+    _mutex.unlock();
+    Log::info("[FlightRecorder] %s", config.enabled ? "enabled" : "disabled");
+}
+
+void FlightRecorder::clear()
+{
+    _mutex.lock();
+    _tail = _head;
+    _bytesUsed = 0;
+    _mutex.unlock();
+    Log::info("[FlightRecorder] cleared");
+}
+
+RecorderState FlightRecorder::state()
+{
+    RecorderState state {};
+    _mutex.lock();
+    state.config = _config;
+    state.records = _head - _tail;
+    state.recordsOverwritten = _tail;
+    if(state.records > 0) {
+        state.oldestFrame = entry(_tail).frame;
+        state.newestFrame = entry(_head - 1).frame;
+        state.oldestTimeMs = entry(_tail).timeMs;
+        state.newestTimeMs = entry(_head - 1).timeMs;
+    }
+    state.bytesUsed = _bytesUsed;
+    state.bytesCapacity = _dataCapacity;
+    state.appendCyclesMax = _appendCyclesMax;
+    _mutex.unlock();
+    return state;
+}
+
+void FlightRecorder::append(const uint8_t* packet, size_t size, uint32_t timeMs)
+{
+    if((size < BlobPacket::HEADER_SIZE) || (size > RecorderRecord::MAX_PACKET_SIZE)) {
+        return;
+    }
+    const uint32_t start = CycleCounter::now();
+    _mutex.lock();
+    if(!_config.enabled) {
+        _mutex.unlock();
+        return;
+    }
+    const uint8_t frameCount = packet[BlobPacket::OFFSET_FRAME_COUNT];
+    if(_head == 0) {
+        _frame = frameCount;
+    } else {
+        _frame += static_cast<uint8_t>(frameCount - _frameCountLast);
+    }
+    _frameCountLast = frameCount;
+
+    while((_head != _tail) && (((_head - _tail) > _indexMask) || ((_bytesUsed + size) > _dataCapacity))) {
+        dropOldest();
+    }
+    IndexEntry& record = entry(_head);
+    record.frame = _frame;
+    record.timeMs = timeMs;
+    record.position = static_cast<uint32_t>(_writePosition);
+    record.size = static_cast<uint16_t>(size);
+    const size_t sizeToEnd = std::min(size, _dataCapacity - _writePosition);
+    std::memcpy(_data + _writePosition, packet, sizeToEnd);
+    std::memcpy(_data, packet + sizeToEnd, size - sizeToEnd);
+    _writePosition = (_writePosition + size) % _dataCapacity;
+    _bytesUsed += size;
+    _head++;
+    _appendCyclesMax = std::max(_appendCyclesMax, CycleCounter::now() - start);
+    _mutex.unlock();
+}
+
+void FlightRecorder::dropOldest()
+{
+    _bytesUsed -= entry(_tail).size;
+    _tail++;
+}
+
+uint32_t FlightRecorder::lowerBound(RecorderRangeType type, uint32_t value)
+{
+    // frame numbers and receive times never decrease from one record to the next
+    uint32_t first = _tail;
+    uint32_t count = _head - _tail;
+    while(count > 0) {
+        const uint32_t step = count / 2;
+        if(key(first + step, type) < value) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+size_t FlightRecorder::copyRecord(uint32_t record, uint8_t* out)
+{
+    const IndexEntry& source = entry(record);
+    std::memcpy(out + RecorderRecord::OFFSET_FRAME, &source.frame, sizeof(source.frame));
+    std::memcpy(out + RecorderRecord::OFFSET_TIME_MS, &source.timeMs, sizeof(source.timeMs));
+    std::memcpy(out + RecorderRecord::OFFSET_SIZE, &source.size, sizeof(source.size));
+    uint8_t* packet = out + RecorderRecord::HEADER_SIZE;
+    const size_t sizeToEnd = std::min(static_cast<size_t>(source.size), _dataCapacity - source.position);
+    std::memcpy(packet, _data + source.position, sizeToEnd);
+    std::memcpy(packet + sizeToEnd, _data, source.size - sizeToEnd);
+    return RecorderRecord::HEADER_SIZE + source.size;
+}
+
+bool FlightRecorder::fetch(const RecorderRange& range, in_addr_t address, uint16_t port, RecorderFetchResult& result)
+{
+    result = RecorderFetchResult{};
+    if(!range.valid()) {
+        Log::warning("[FlightRecorder] invalid range, type %u, %lu to %lu", range.type, range.first, range.last);
+        return false;
+    }
+    int32_t clientSocket = lwip_socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_len = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = address;
+    if(lwip_connect(clientSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        Log::warning("[FlightRecorder] connecting to the host failed");
+        lwip_close(clientSocket);
+        return false;
+    }
+
+    _mutex.lock();
+    uint32_t next = lowerBound(range.type, range.first);
+    const uint32_t end = _head;
+    _mutex.unlock();
+
+    static_assert(RecorderRecord::HEADER_SIZE + RecorderRecord::MAX_PACKET_SIZE <= std::tuple_size<decltype(_fetchBuffer)>::value);
+    size_t fill = 0;
+    bool connected = true;
+    bool done = false;
+    while(connected && !done) {
+        // collect records until the buffer is full, the copy from SDRAM is short compared to the tcp write
+        bool full = false;
+        while(!done && !full) {
+            _mutex.lock();
+            if((_head - next) > (_head - _tail)) {
+                result.recordsLost += _tail - next; // overwritten by new records since the fetch started
+                next = _tail;
+            }
+            if((static_cast<int32_t>(next - end) >= 0) || (key(next, range.type) > range.last)) {
+                done = true;
+            } else if((fill + RecorderRecord::HEADER_SIZE + entry(next).size) > _fetchBuffer.size()) {
+                full = true;
+            } else {
+                fill += copyRecord(next, _fetchBuffer.data() + fill);
+                next++;
+                result.records++;
+            }
+            _mutex.unlock();
+        }
+        if(fill > 0) {
+            const auto written = lwip_write(clientSocket, _fetchBuffer.data(), fill); // blocking!
+            connected = (written == static_cast<int32_t>(fill));
+            if(!connected) {
+                Log::warning("[FlightRecorder] write failed, return code: %d", written);
+            } else {
+                result.bytes += fill;
+            }
+            fill = 0;
+        }
+    }
+    lwip_close(clientSocket);
+    Log::info("[FlightRecorder] fetched %lu records, %lu bytes, %lu lost", result.records, result.bytes, result.recordsLost);
+    return connected;
+}
@@ -0,0 +1,101 @@
+#ifndef VISIONADDON_APP_BLOB_FLIGHTRECORDER_H
+#define VISIONADDON_APP_BLOB_FLIGHTRECORDER_H
+
+#include "BlobTypes.h"
+#include "lwip/sockets.h"
+#undef bind // to avoid conflicts with std functional bind
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// layout of the records fetched from the flight recorder, see App/blob/flightRecorder.md
+namespace RecorderRecord {
+    static constexpr size_t OFFSET_FRAME {0}; //!< U32 frame number
+    static constexpr size_t OFFSET_TIME_MS {4}; //!< U32 ms since boot the packet was received at
+    static constexpr size_t OFFSET_SIZE {8}; //!< U16 packet size
+    static constexpr size_t HEADER_SIZE {10};
+    static constexpr size_t MAX_PACKET_SIZE {BlobPacket::HEADER_SIZE + (BlobPacket::MAX_FEATURE_COUNT * BoundingBox::SIZE)};
+}
+
+// Ring buffer recorder of the received feature packets in the external SDRAM, fetched in bulk after the fact.
+//
+// Every intact packet is appended as received from the fpga (raw, without crc) with its frame number and receive time.
+// The frame number unwraps the 8 bit fpga frame counter, a gap of more than 255 frames is counted short.
+// The memory is split into an index with one fixed size entry per record, searched binary by frame number or time,
+// and a data ring the packets wrap around in. When either is full the oldest records are dropped.
+// 16 MB hold about 30 minutes of 20 features at 72 fps, or 5 minutes of full packets.
+// Recording and fetching run in different tasks, the mutex is held per record. One fetch at a time.
+class FlightRecorder final {
+public:
+    /**
+     * @param memory at least 64 KB, word aligned, the content is ignored
+     * @param size of memory in bytes
+     */
+    FlightRecorder(uint8_t* memory, size_t size);
+    FlightRecorder (const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    FlightRecorder (const FlightRecorder&&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&&) = delete;
+
+    void config(const RecorderConfig& config); //!< the records are kept
+    void clear(); //!< drops all records, they count as overwritten
+    RecorderState state();
+
+    /**
+     * @brief Append a packet, drops the oldest records if required.
+     *
+     * @param packet raw packet without the crc
+     * @param timeMs receive time, ms since boot
+     */
+    void append(const uint8_t* packet, size_t size, uint32_t timeMs);
+
+    /**
+     * @brief Send the records of a range over a tcp connection, records appended after the start are not sent. Blocking!
+     *
+     * @param address network byte order
+     * @param result records and bytes sent
+     * @return false if the range is invalid, the connection failed or was lost
+     */
+    bool fetch(const RecorderRange& range, in_addr_t address, uint16_t port, RecorderFetchResult& result);
+
+private:
+    class IndexEntry {
+    public:
+        uint32_t frame;
+        uint32_t timeMs;
+        uint32_t position; //!< offset in the data ring
+        uint16_t size;
+        uint16_t reserved;
+    };
+    IndexEntry& entry(uint32_t record) {return _index[record & _indexMask];};
+    uint32_t key(uint32_t record, RecorderRangeType type) {
+        return (type == RecorderRangeType::RANGE_FRAMES) ? entry(record).frame : entry(record).timeMs;
+    };
+    uint32_t lowerBound(RecorderRangeType type, uint32_t value); //!< first record with a key not less than value
+    void dropOldest();
+    size_t copyRecord(uint32_t record, uint8_t* out); //!< @return bytes written, header and packet
+
+    static constexpr size_t _INDEX_SHARE {16}; //!< 1/16 of the memory, about 240 packet bytes per record
+
+    IndexEntry* _index;
+    uint32_t _indexMask; //!< capacity - 1, the capacity is a power of two
+    uint8_t* _data;
+    size_t _dataCapacity;
+
+    Mutex _mutex;
+    RecorderConfig _config {};
+    uint32_t _head {0}; //!< records appended since boot
+    uint32_t _tail {0}; //!< records dropped since boot
+    size_t _writePosition {0};
+    size_t _bytesUsed {0};
+    uint32_t _frame {0};
+    uint8_t _frameCountLast {0};
+    uint32_t _appendCyclesMax {0};
+
+    // fetching task only
+    std::array<uint8_t, 4096> _fetchBuffer {}; //!< records are collected into few large tcp writes
+};
+
+#endif // VISIONADDON_APP_BLOB_FLIGHTRECORDER_H
@@ -0,0 +1,56 @@
+#include "FrameClock.h"
+
+#include "utils/assert.h"
+#include "utils/constants.h"
+
+FrameClock::FrameClock() :
+_reached{osSemaphoreNew(1, 0, NULL)}
+{
+    ASSERT(_reached != nullptr);
+}
+
+void FrameClock::tick(uint8_t frameCount)
+{
+    _frameCount.store(frameCount);
+    _tickMs.store(osKernelGetTickCount() / TICKS_PER_MILLISECOND);
+    _ticked.store(true);
+    // released on the frame or, if its packet was lost, on the first one past it
+    uint16_t target = _target.load();
+    if((target != NO_TARGET) && (static_cast<uint8_t>(frameCount - target) <= HORIZON)
+        && _target.compare_exchange_strong(target, NO_TARGET)) {
+        _late.store(frameCount != target);
+        osSemaphoreRelease(_reached);
+    }
+}
+
+FrameClock::Wait FrameClock::waitFor(uint8_t frameCount, uint32_t timeoutMs)
+{
+    const uint32_t nowMs = osKernelGetTickCount() / TICKS_PER_MILLISECOND;
+    if(!_ticked.load() || ((nowMs - _tickMs.load()) > STALE_MS)) {
+        return Wait::TIMEOUT;
+    }
+    auto ahead = [&]() -> uint8_t {
+        return static_cast<uint8_t>(frameCount - _frameCount.load());
+    };
+    if((ahead() == 0U) || (ahead() > HORIZON)) {
+        return Wait::PASSED;
+    }
+
+    _target.store(frameCount);
+    // the packet may have arrived between the check and the store
+    const uint8_t aheadNow = ahead();
+    uint16_t target {frameCount};
+    if(((aheadNow == 0U) || (aheadNow > HORIZON)) && _target.compare_exchange_strong(target, NO_TARGET)) {
+        return (aheadNow == 0U) ? Wait::REACHED : Wait::PASSED;
+    }
+    if(osSemaphoreAcquire(_reached, timeoutMs * TICKS_PER_MILLISECOND) == osOK) {
+        return _late.load() ? Wait::PASSED : Wait::REACHED;
+    }
+    target = frameCount;
+    if(_target.compare_exchange_strong(target, NO_TARGET)) {
+        return Wait::TIMEOUT;
+    }
+    // released by a tick racing the timeout, the release follows its exchange, consume it
+    osSemaphoreAcquire(_reached, osWaitForever);
+    return _late.load() ? Wait::PASSED : Wait::REACHED;
+}
@@ -0,0 +1,49 @@
+#ifndef VISIONADDON_APP_BLOB_FRAMECLOCK_H
+#define VISIONADDON_APP_BLOB_FRAMECLOCK_H
+
+#include "cmsis_os2.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Frame count of the intact feature packets (8 bit fpga frame counter, wraps every 256 frames), lets a task wait
+// for the packet of a given frame, e.g. to apply a command at a frame boundary.
+// Ticked by the blob receiver task, one waiting task at a time.
+class FrameClock final {
+public:
+    FrameClock();
+    FrameClock (const FrameClock&) = delete;
+    FrameClock& operator=(const FrameClock&) = delete;
+    FrameClock (const FrameClock&&) = delete;
+    FrameClock& operator=(const FrameClock&&) = delete;
+
+    void tick(uint8_t frameCount); //!< per intact packet, after it was forwarded
+    uint8_t frameCount() const {return _frameCount.load();}; //!< of the last packet
+
+    enum class Wait : uint8_t {
+        REACHED, //!< the packet of the frame arrived while waiting
+        PASSED, //!< the frame is the last one or more than HORIZON frames ahead (behind after the wrap), or its packet was lost and a later one arrived
+        TIMEOUT, //!< no packet of the frame or a later one within the timeout, or no packets at all
+    };
+
+    /**
+     * @brief Block until the packet of a frame or, if it was lost, of a later one (up to HORIZON frames) arrived.
+     *
+     * Returns TIMEOUT right away if the last packet is older than STALE_MS, the camera is not streaming.
+     */
+    Wait waitFor(uint8_t frameCount, uint32_t timeoutMs);
+
+    static constexpr uint8_t HORIZON {127}; //!< frames ahead which are waited for, some 1.7 s at 72 fps
+    static constexpr uint32_t STALE_MS {500};
+
+private:
+    static constexpr uint16_t NO_TARGET {0x100}; //!< outside the frame count range
+    std::atomic<uint8_t> _frameCount {0};
+    std::atomic<uint32_t> _tickMs {0};
+    std::atomic<bool> _ticked {false};
+    std::atomic<uint16_t> _target {NO_TARGET};
+    std::atomic<bool> _late {false}; //!< the last release was on a frame past the target
+    osSemaphoreId_t _reached;
+};
+
+#endif // VISIONADDON_APP_BLOB_FRAMECLOCK_H
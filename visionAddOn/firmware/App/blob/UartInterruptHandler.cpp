@@ -1,12 +1,13 @@
 #include "UartInterruptHandler.h"
 
+#include "metrics/PeripheralErrors.h"
 #include "utils/assert.h"
+#include "utils/interrupt/InterruptProfiler.h"
 #include "utils/Log.h"
 
 #include <algorithm>
-#include <mutex>
 
-std::unordered_map<volatile uint32_t*, UartInterruptHandler&> UartInterruptHandler::_handleToHandler {};
+std::array<UartInterruptHandler*, UartInterruptHandler::_NUMBER_OF_UART_SLOTS> UartInterruptHandler::_handlers {};
 
 UartInterruptHandler::UartInterruptHandler(
     UART_HandleTypeDef* uartHandle,
@@ -21,27 +22,21 @@ _bufferPool{bufferPool}
 }
 
 bool UartInterruptHandler::isActive(){
-    std::scoped_lock lock(_transferActiveMutex);
-    return _transferActive;
+    return _transferActive.load();
 }
 
 void UartInterruptHandler::start()
 {
-    Log::trace("[UartInterruptHandler] start - acquiring mutex");
-    std::scoped_lock lock(_transferActiveMutex);
-    Log::trace("[UartInterruptHandler] start - mutex acquired");
-    if(_transferActive){
+    if(_transferActive.exchange(true)){
         Log::warning("[UartInterruptHandler] Abort start, transfer active");
         return;
     }
-    static constexpr size_t BUFFER_SIZE {1024};
-    uint8_t* bufferBase = _bufferPool.acquire(BUFFER_SIZE);
-    if(bufferBase == nullptr) {
+    _rxBuffer = _bufferPool.acquire(_bufferPool.blockSize());
+    if(!_rxBuffer) {
         Log::warning("[UartInterruptHandler] Abort start, buffer acquire failed");
         _transferActive = false;
         return;
     }
-    _message.bufferBase = bufferBase;
     __HAL_UART_DISABLE_IT(_uartHandle, UART_IT_CM);
     __HAL_UART_DISABLE_IT(_uartHandle, UART_IT_CTS);
     __HAL_UART_DISABLE_IT(_uartHandle, UART_IT_LBD);
@@ -63,68 +58,61 @@ void UartInterruptHandler::start()
     __HAL_UART_CLEAR_FLAG(_uartHandle, UART_CLEAR_LBDF);
     __HAL_UART_CLEAR_FLAG(_uartHandle, UART_CLEAR_CTSF);
     __HAL_UART_CLEAR_FLAG(_uartHandle, UART_CLEAR_CMF);
-    auto status = HAL_UARTEx_ReceiveToIdle_DMA(_uartHandle, bufferBase, BUFFER_SIZE);
+    auto status = HAL_UARTEx_ReceiveToIdle_DMA(_uartHandle, _rxBuffer.data(), static_cast<uint16_t>(_rxBuffer.capacity()));
     if(status != HAL_StatusTypeDef::HAL_OK){
         Log::error("[setupNewUartRx] hal status %d", status);
+        _rxBuffer.reset();
         _transferActive = false;
         return;
     }
-    _transferActive = true;
 }
 
 void UartInterruptHandler::handleInterrupt(size_t bytesReceived)
 {
-    Log::trace("[UartInterruptHandler] handling interrupt, %d bytes received", bytesReceived);
+    // interrupt context, no logging
     switch(HAL_UARTEx_GetRxEventType(_uartHandle)) {
         case HAL_UART_RXEVENT_IDLE: {
-            Log::trace("[HAL_UARTEx_RxEventCallback] idle event, received %d bytes", bytesReceived);
             _message.bytesReceived = bytesReceived; // bytes received in previous buffer
-            ASSERT(osMessageQueuePut(_messageQId, &_message, 0, 0) == osOK);
-            {
-                //FIXME: If task has lock and ISR fires, mutex can never be acquired
-                std::scoped_lock lock(_transferActiveMutex);
-                _transferActive = false;
+            _message.bufferBase = _rxBuffer.detach();
+            if(osMessageQueuePut(_messageQId, &_message, 0, 0) != osOK) {
+                // queue full, the block goes straight back to the pool
+                _bufferPool.adopt(_message.bufferBase);
             }
+            _transferActive = false;
             start();
             break;
         }
-        case HAL_UART_RXEVENT_TC: {
-            Log::warning("[HAL_UARTEx_RxEventCallback] TC complete interrupt should never happen");
-            break;
-        }
-        case HAL_UART_RXEVENT_HT: {
-            Log::warning("[HAL_UARTEx_RxEventCallback] HT complete interrupt must be disabled");
-            break;
-        }
+        case HAL_UART_RXEVENT_TC: // should never happen, the buffer is larger than any message
+        case HAL_UART_RXEVENT_HT: // must be disabled
         default: {
-            Log::warning("[HAL_UARTEx_RxEventCallback] unknown interrupt");
+            _unexpectedEvents++;
             break;
         }
     }
 }
 
 void UartInterruptHandler::registerHandler(UART_HandleTypeDef* huart, UartInterruptHandler& handler){
-    volatile uint32_t* uartBase = &(huart->Instance->CR1);
+    static_assert(uartSlotsUnique());
+    const uintptr_t uartBase = reinterpret_cast<uintptr_t>(huart->Instance);
     Log::debug("[UartInterruptHandler] register handler for uart %#x", uartBase);
-    _handleToHandler.insert({uartBase, handler});
+    ASSERT(_handlers[uartSlot(uartBase)] == nullptr);
+    _handlers[uartSlot(uartBase)] = &handler;
 }
 
 bool UartInterruptHandler::callHandler(UART_HandleTypeDef* huart, size_t bytesReceived){
-    volatile uint32_t* uartBase = &(huart->Instance->CR1);
-    auto it = _handleToHandler.find(uartBase);
-    if(it == _handleToHandler.end()){
-        Log::warning("[UartInterruptHandler] no handler registered for uart %#x", uartBase);
+    UartInterruptHandler* handler = _handlers[uartSlot(reinterpret_cast<uintptr_t>(huart->Instance))];
+    if(handler == nullptr){
         return false;
     }
-    Log::trace("[UartInterruptHandler] calling handler for uart %#x", uartBase);
-    it->second.handleInterrupt(bytesReceived);
+    const uint32_t handlerStart = CycleCounter::now();
+    handler->handleInterrupt(bytesReceived);
+    InterruptProfiler::record(INTERRUPT_SOURCE_UART_RX, handlerStart);
     return true;
 }
 
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-    (void)huart;
-    Log::trace("[HAL_UART_RxCpltCallback]");
+    (void)huart; // receptions to idle complete through HAL_UARTEx_RxEventCallback, interrupt context, no logging
 }
 
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
@@ -134,6 +122,5 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
-    (void)huart;
-    Log::error("[HAL_UART_ErrorCallback]");
+    PeripheralErrors::record(PERIPHERAL_UART, huart->ErrorCode);
 }
@@ -3,15 +3,15 @@
 
 #include "cmsis_os2.h"
 #include "utils/ITransfer.h"
-#include "utils/mutex/Mutex.h"
 #include "utils/pool/BufferPool.h"
 #include "stm32f7xx_hal.h"
 
-#include <unordered_map>
+#include <array>
+#include <atomic>
 
 //TODO: move out of this header
 struct UartIsrToBlobReceiverQMessage {
-    uint8_t* bufferBase;
+    uint8_t* bufferBase; //!< detached pool block, the receiver takes ownership with BufferPool::adopt
     size_t bytesReceived;
 };
 
@@ -25,16 +25,33 @@ public:
     bool isActive() override;
     void start() override;
     void handleInterrupt(size_t bytesReceived);
+    uint32_t unexpectedEvents() const {return _unexpectedEvents;}; //!< receive events other than idle, should stay 0
     static void registerHandler(UART_HandleTypeDef* huart, UartInterruptHandler& handler);
-    static bool callHandler(UART_HandleTypeDef* huart, size_t bytesReceived);
+    static bool callHandler(UART_HandleTypeDef* huart, size_t bytesReceived); //!< interrupt context, constant time
 private:
-    Mutex _transferActiveMutex {Mutex()};
-    bool _transferActive {false};
+    // the uart register blocks are 1 KiB apart, bits [14:10] of the base address are unique for all 8 uarts
+    static constexpr size_t _NUMBER_OF_UART_SLOTS {32};
+    static constexpr size_t uartSlot(uintptr_t base) {return (base >> 10) & (_NUMBER_OF_UART_SLOTS - 1);};
+    static constexpr bool uartSlotsUnique() {
+        constexpr uintptr_t BASES[] {USART1_BASE, USART2_BASE, USART3_BASE, UART4_BASE, UART5_BASE, USART6_BASE, UART7_BASE, UART8_BASE};
+        for(size_t i = 0; i < (sizeof(BASES) / sizeof(BASES[0])); i++) {
+            for(size_t j = i + 1; j < (sizeof(BASES) / sizeof(BASES[0])); j++) {
+                if(uartSlot(BASES[i]) == uartSlot(BASES[j])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    std::atomic<bool> _transferActive {false}; //!< start is called from task and interrupt context
     UART_HandleTypeDef* _uartHandle;
     osMessageQueueId_t _messageQId;
     BufferPool& _bufferPool;
+    BufferPool::Buffer _rxBuffer {};
     UartIsrToBlobReceiverQMessage _message {nullptr, 0};
-    static std::unordered_map<volatile uint32_t*, UartInterruptHandler&> _handleToHandler;
+    uint32_t _unexpectedEvents {0}; //!< transfer complete / half transfer / unknown receive events
+    static std::array<UartInterruptHandler*, _NUMBER_OF_UART_SLOTS> _handlers; //!< indexed by uartSlot, filled once at build time
 };
 
 void registerInterruptHandler(UartInterruptHandler* handler);
@@ -14,9 +14,16 @@ void app_build();
 void app_init_camera();
 void app_init_command_handler();
 void app_init_network_config();
+void app_init_calibration();
 void app_run_command_handler();
 void app_run_blob_receiver();
-void app_run_network_stats();
+void app_run_auto_exposure();
+void app_run_network_benchmark();
+void app_run_task_profiler();
+void app_run_frame_history();
+void app_run_preview_stream();
+void app_run_sdram_test();
+void app_run_time_sync();
 uint8_t* app_fetch_mac_address_from_storage();
 
 #ifdef __cplusplus
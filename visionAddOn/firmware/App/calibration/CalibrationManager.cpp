@@ -1,63 +1,138 @@
 #include "CalibrationManager.h"
+
+#include "stm32f7xx_hal.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/crc/Crc16.h"
 #include "utils/Log.h"
 
+#include <algorithm>
 #include <cstring>
 
+namespace {
+constexpr uint8_t VERSION {1}; // bump on layout changes, a blob of another version is dropped
+constexpr size_t OFFSET_VERSION {0};
+constexpr size_t OFFSET_STORED {1};
+constexpr size_t HEADER_SIZE {4};
+constexpr size_t CRC_SIZE {sizeof(uint16_t)};
+constexpr uint32_t READ_TIMEOUT_MS {50U}; // one burst of the whole blob
+constexpr uint32_t WRITE_TIMEOUT_MS {20U}; // one page, write cycle 5 ms
+}
+
+static_assert((EEPROM_ADDRESS_CALIBRATION % EEPROM_PAGE_SIZE_BYTES) == 0U, "blob must be page aligned");
+static_assert((EEPROM_ADDRESS_CALIBRATION + CalibrationManager::BLOB_SIZE) <= EEPROM_SIZE_BYTES, "blob exceeds the eeprom");
+
 CalibrationManager::CalibrationManager(IStorage& storage) :
 _storage{storage}
 {
-};
+    clear();
+}
 
-bool CalibrationManager::restoreToDefaults() {
-    return persist(CalibrationStatus::UNDEFINED);
-    //TODO: blink
+size_t CalibrationManager::size(Part part)
+{
+    switch(part) {
+        case Part::CAMERA_MATRIX: return Matrix<3,3>::SIZE();
+        case Part::DISTORTION_COEFFICIENTS: return Matrix<1,5>::SIZE();
+        case Part::ROTATION_MATRIX: return Matrix<3,3>::SIZE();
+        case Part::TRANSLATION_VECTOR: return Matrix<1,3>::SIZE();
+        default: return 0;
+    }
 }
 
-bool CalibrationManager::persist(Matrix<3,3>& cameraMatrix) {
-    //TODO
-    persist(_ADDRESS_CAMERA_MATRIX, cameraMatrix.data().data(), std::remove_reference_t<decltype(cameraMatrix)>::SIZE());
-    return false;
+size_t CalibrationManager::offset(Part part)
+{
+    size_t offset {HEADER_SIZE};
+    for(uint8_t i = 0; i < part; i++) {
+        offset += size(static_cast<Part>(i));
+    }
+    return offset;
 }
 
-bool CalibrationManager::load(Matrix<3,3>& cameraMatrix) {
-    //TODO
-    return false;
+bool CalibrationManager::load()
+{
+    clear();
+    const uint32_t start = HAL_GetTick();
+    if(!_storage.readData(EEPROM_ADDRESS_CALIBRATION, _persisted.data(), BLOB_SIZE, READ_TIMEOUT_MS)) {
+        Log::warning("[CalibrationManager] read failed");
+        return false;
+    }
+    _persistedKnown = true;
+    if(Crc16::computeSoftware(_persisted.data(), BLOB_SIZE) != 0U) {
+        Log::warning("[CalibrationManager] no valid calibration stored");
+        return false;
+    }
+    if(_persisted[OFFSET_VERSION] != VERSION) {
+        Log::warning("[CalibrationManager] calibration version %u unknown, dropped", _persisted[OFFSET_VERSION]);
+        return false;
+    }
+    _blob = _persisted;
+    Log::info("[CalibrationManager] calibration loaded in %lu ms, stored parts: %#x", HAL_GetTick() - start, stored());
+    return true;
 }
 
-bool CalibrationManager::persist(Matrix<1,5>& distortionCoefficients) {
-    //TODO
-    return false;
+bool CalibrationManager::restoreToDefaults()
+{
+    clear();
+    return persist();
 }
 
-bool CalibrationManager::load(Matrix<1,5>& distortionCoefficients) {
-    //TODO
-    return false;
+bool CalibrationManager::get(Part part, uint8_t* buffer, size_t size) const
+{
+    ASSERT(buffer != nullptr);
+    if((part >= Part::NUMBER_OF_PARTS) || (size != CalibrationManager::size(part))) {
+        return false;
+    }
+    if((stored() & (1U << part)) == 0U) {
+        Log::warning("[CalibrationManager] part %u not stored", part);
+        return false;
+    }
+    std::memcpy(buffer, &_blob[offset(part)], size);
+    return true;
 }
 
-CalibrationManager::CalibrationStatus CalibrationManager::calibrationStatus() {
-    //TODO
-    return CalibrationStatus::UNDEFINED;
+bool CalibrationManager::set(Part part, const uint8_t* data, size_t size)
+{
+    ASSERT(data != nullptr);
+    if((part >= Part::NUMBER_OF_PARTS) || (size != CalibrationManager::size(part))) {
+        return false;
+    }
+    std::memcpy(&_blob[offset(part)], data, size);
+    _blob[OFFSET_STORED] = static_cast<uint8_t>(_blob[OFFSET_STORED] | (1U << part));
+    return persist();
 }
 
-bool CalibrationManager::persist(CalibrationStatus calibrationStatus) {
-    //TODO
-    return false;
+uint8_t CalibrationManager::stored() const
+{
+    return _blob[OFFSET_STORED];
 }
 
-bool CalibrationManager::persist(const uint8_t address, const uint8_t* data, size_t size) {
-    //TODO
-    static constexpr size_t MAX_RETRIES {5};    
-    size_t retries {0};
-    for(; retries < MAX_RETRIES; retries++){
-        if(!_storage.isBusy()){
-            break;
+bool CalibrationManager::persist()
+{
+    const uint16_t crc = Crc16::computeSoftware(_blob.data(), BLOB_SIZE - CRC_SIZE);
+    _blob[BLOB_SIZE - 2] = static_cast<uint8_t>(crc >> 8);
+    _blob[BLOB_SIZE - 1] = static_cast<uint8_t>(crc);
+
+    // page by page in address order, the crc is in the last page
+    size_t pagesWritten {0};
+    for(size_t offset = 0; offset < BLOB_SIZE; offset += EEPROM_PAGE_SIZE_BYTES) {
+        const size_t size = std::min<size_t>(EEPROM_PAGE_SIZE_BYTES, BLOB_SIZE - offset);
+        if(_persistedKnown && (std::memcmp(&_blob[offset], &_persisted[offset], size) == 0)) {
+            continue;
         }
-        static constexpr uint32_t DELAY_MS {1};
-        HAL_Delay(DELAY_MS * TICKS_PER_MILLISECOND); // intentionally blocking
-    }
-    if(retries == MAX_RETRIES){ // still busy
-        Log::warning("[NetworkManager] storage busy");
-        return false;
+        const uint8_t address = static_cast<uint8_t>(EEPROM_ADDRESS_CALIBRATION + offset);
+        if(!_storage.writeData(address, &_blob[offset], size, WRITE_TIMEOUT_MS)) {
+            Log::warning("[CalibrationManager] write to %#x failed", address);
+            return false;
+        }
+        std::memcpy(&_persisted[offset], &_blob[offset], size);
+        pagesWritten++;
     }
-    return _storage.writeData(address, data);        
-}
\ No newline at end of file
+    Log::info("[CalibrationManager] calibration persisted, %u pages written", pagesWritten);
+    return true;
+}
+
+void CalibrationManager::clear()
+{
+    _blob.fill(0);
+    _blob[OFFSET_VERSION] = VERSION;
+}
@@ -1,40 +1,62 @@
 #ifndef VISIONADDON_APP_CALIBRATION_CALIBRATIONMANAGER_H
 #define VISIONADDON_APP_CALIBRATION_CALIBRATIONMANAGER_H
 
-#include "utils/constants.h"
 #include "utils/matrix/Matrix.h"
 #include "storage/IStorage.h"
-#include "stm32f7xx_hal.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+// Camera calibration persisted as one versioned blob in the eeprom, cached in RAM.
+//
+// load() reads the whole blob with a single sequential read at boot, get() serves from the cache and never touches the
+// eeprom. set() updates the cache and rewrites the eeprom pages which changed, the crc page last: a blob torn by a
+// reset during the write fails the crc and is dropped as a whole at the next boot.
+// Blob at EEPROM_ADDRESS_CALIBRATION (page aligned): U8 version, U8 stored parts (bit per Part), U16 reserved,
+// the parts in Part order as float, U16 crc (CRC-16/CCITT-FALSE, most significant byte first).
+// Shares the eeprom with the NetworkManager, networkTask only.
 class CalibrationManager final {
 public:
-    CalibrationManager(IStorage& storage);
+    explicit CalibrationManager(IStorage& storage);
     CalibrationManager() = delete;
     CalibrationManager (const CalibrationManager&) = delete;
     CalibrationManager& operator=(const CalibrationManager&) = delete;
     CalibrationManager (const CalibrationManager&&) = delete;
     CalibrationManager& operator=(const CalibrationManager&&) = delete;
 
-    bool restoreToDefaults();
-    bool persist(Matrix<3,3>& cameraMatrix);
-    bool load(Matrix<3,3>& cameraMatrix);
-    bool persist(Matrix<1,5>& distortionCoefficients);
-    bool load(Matrix<1,5>& distortionCoefficients);
-    enum CalibrationStatus : uint8_t {
-        CALIBRATED = 1,
-        UNDEFINED = UINT8_MAX,
+    enum Part : uint8_t {
+        CAMERA_MATRIX = 0, //!< Matrix<3,3>
+        DISTORTION_COEFFICIENTS = 1, //!< Matrix<1,5>
+        ROTATION_MATRIX = 2, //!< Matrix<3,3>
+        TRANSLATION_VECTOR = 3, //!< Matrix<1,3>
+        NUMBER_OF_PARTS,
     };
-    CalibrationStatus calibrationStatus();
+    static size_t size(Part part); //!< bytes
+
+    bool load(); //!< read the blob into the cache, false if there is none or it is corrupt (the cache is empty then)
+    bool restoreToDefaults(); //!< forget all parts, persisted
+    bool get(Part part, uint8_t* buffer, size_t size) const; //!< from the cache, false if the part was never stored
+    /**
+     * @brief Cache and persist a part.
+     *
+     * @return false if the size mismatches or the eeprom write failed, in the latter case the part is cached anyway and
+     *         the remaining pages are written by the next set
+     */
+    bool set(Part part, const uint8_t* data, size_t size);
+    uint8_t stored() const; //!< bit per part
+
+    static constexpr size_t BLOB_SIZE {4 + Matrix<3,3>::SIZE() + Matrix<1,5>::SIZE() + Matrix<3,3>::SIZE() + Matrix<1,3>::SIZE() + sizeof(uint16_t)};
+
 private:
-    bool persist(CalibrationStatus calibrationStatus);
-    bool persist(const uint8_t address, const uint8_t* data, size_t size);
-    static constexpr uint8_t _ADDRESS_CAMERA_MATRIX {EEPROM_ADDRESS_CAMERA_MATRIX};
-    static constexpr uint8_t _ADDRESS_DISTORTION_COEFFICIENTS {EEPROM_ADDRESS_DISTORTION_COEFFICIENTS};
-    static constexpr uint8_t _ADDRESS_CALIBRATION_STATUS {EEPROM_CALIBRATION_STATUS};
-    IStorage& _storage;
+    bool persist();
+    void clear();
+    static size_t offset(Part part);
 
+    IStorage& _storage;
+    std::array<uint8_t, BLOB_SIZE> _blob {}; //!< cache
+    std::array<uint8_t, BLOB_SIZE> _persisted {}; //!< eeprom content, pages equal to the cache are not rewritten
+    bool _persistedKnown {false}; //!< false until the eeprom was read, every page is written then
 };
 
-#endif // VISIONADDON_APP_CALIBRATION_CALIBRATIONMANAGER_H
\ No newline at end of file
+#endif // VISIONADDON_APP_CALIBRATION_CALIBRATIONMANAGER_H
@@ -1,7 +1,9 @@
 #ifndef VISIONADDON_APP_CAMERA_TYPES_H
 #define VISIONADDON_APP_CAMERA_TYPES_H
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 enum Fps : uint8_t
 {
@@ -10,4 +12,269 @@ enum Fps : uint8_t
     UNDEFINED = 0xff,
 };
 
-#endif // VISIONADDON_APP_CAMERA_TYPES_H
\ No newline at end of file
+// the mode id is forwarded by the fpga in the blob packet header, host tables must match
+enum SensorMode : uint8_t
+{
+    MODE_1280X800_13FPS = 0, //!< same as Fps::_13
+    MODE_1280X800_72FPS = 1, //!< same as Fps::_72
+    MODE_640X400_BINNED_144FPS = 2, //!< full field of view, 2x2 binned
+    MODE_640X400_WINDOW_144FPS = 3, //!< center window, full resolution
+    MODE_640X200_WINDOW_240FPS = 4, //!< center window, full resolution
+    MODE_UNDEFINED = 0xff,
+};
+
+static constexpr SensorMode sensorModeFromFps(Fps fps) {
+    switch(fps) {
+        case Fps::_13: return SensorMode::MODE_1280X800_13FPS;
+        case Fps::_72: return SensorMode::MODE_1280X800_72FPS;
+        default: return SensorMode::MODE_UNDEFINED;
+    }
+}
+
+class SensorModeInfo {
+public:
+    SensorMode mode = {SensorMode::MODE_UNDEFINED};
+    uint16_t width = {}; //!< output width in px
+    uint16_t height = {}; //!< output height in px
+    uint16_t offsetX = {}; //!< left edge of the output in full resolution (1280x800) px
+    uint16_t offsetY = {}; //!< top edge of the output in full resolution (1280x800) px
+    uint8_t binning = {}; //!< full resolution px per output px, per axis
+    uint16_t fps = {};
+    uint16_t frameLength = {}; //!< VTS in row periods
+    uint16_t exposure = {}; //!< exposure set on init in row periods
+
+    static constexpr uint16_t EXPOSURE_MARGIN {25}; //!< sensor requires exposure <= frame length - 25
+    constexpr uint16_t exposureLimit() const {
+        return frameLength - EXPOSURE_MARGIN;
+    }
+
+    static constexpr size_t SIZE {14};
+    static constexpr size_t OFFSET_MODE {0};
+    static constexpr size_t OFFSET_WIDTH {OFFSET_MODE + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_HEIGHT {OFFSET_WIDTH + sizeof(width)};
+    static constexpr size_t OFFSET_OFFSET_X {OFFSET_HEIGHT + sizeof(height)};
+    static constexpr size_t OFFSET_OFFSET_Y {OFFSET_OFFSET_X + sizeof(offsetX)};
+    static constexpr size_t OFFSET_BINNING {OFFSET_OFFSET_Y + sizeof(offsetY)};
+    static constexpr size_t OFFSET_FPS {OFFSET_BINNING + sizeof(binning)};
+    static constexpr size_t OFFSET_FRAME_LENGTH {OFFSET_FPS + sizeof(fps)};
+    static_assert(OFFSET_FRAME_LENGTH + sizeof(frameLength) == SIZE); // exposure is not serialized
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_MODE] = static_cast<uint8_t>(mode);
+        std::memcpy(buffer + OFFSET_WIDTH, &width, sizeof(width));
+        std::memcpy(buffer + OFFSET_HEIGHT, &height, sizeof(height));
+        std::memcpy(buffer + OFFSET_OFFSET_X, &offsetX, sizeof(offsetX));
+        std::memcpy(buffer + OFFSET_OFFSET_Y, &offsetY, sizeof(offsetY));
+        buffer[OFFSET_BINNING] = binning;
+        std::memcpy(buffer + OFFSET_FPS, &fps, sizeof(fps));
+        std::memcpy(buffer + OFFSET_FRAME_LENGTH, &frameLength, sizeof(frameLength));
+        return true;
+    }
+};
+
+// row period is the same in all modes (HTS 728 at 72 fps pll settings, HTS 4056 at 13 fps pll settings),
+// the frame rate is set by the frame length (VTS) only
+static constexpr SensorModeInfo SENSOR_MODES[] {
+    //  mode                                      width  height offsetX offsetY binning fps   VTS  exposure
+    {SensorMode::MODE_1280X800_13FPS,             1280,  800,   0,      0,      1,      13,   910, 0x2a9},
+    {SensorMode::MODE_1280X800_72FPS,             1280,  800,   0,      0,      1,      72,   910, 0x2a9},
+    {SensorMode::MODE_640X400_BINNED_144FPS,      640,   400,   0,      0,      2,      144,  455, 0x1a0},
+    {SensorMode::MODE_640X400_WINDOW_144FPS,      640,   400,   320,    200,    1,      144,  455, 0x1a0},
+    {SensorMode::MODE_640X200_WINDOW_240FPS,      640,   200,   320,    300,    1,      240,  273, 0x0f0},
+};
+static constexpr size_t NUMBER_OF_SENSOR_MODES {sizeof(SENSOR_MODES) / sizeof(SENSOR_MODES[0])};
+
+/**
+ * @brief Look up the geometry and timing of a sensor mode.
+ *
+ * @return mode info, mode is MODE_UNDEFINED if not supported
+ */
+static constexpr SensorModeInfo sensorModeInfo(SensorMode mode) {
+    for(size_t i = 0; i < NUMBER_OF_SENSOR_MODES; i++) {
+        if(SENSOR_MODES[i].mode == mode) {
+            return SENSOR_MODES[i];
+        }
+    }
+    return SensorModeInfo{};
+}
+
+enum HistoryStatus : uint8_t {
+    HISTORY_OFF = 0, //!< no frames are captured
+    HISTORY_RECORDING = 1, //!< the ring is overwritten continuously, waiting for a trigger
+    HISTORY_TRIGGERED = 2, //!< capturing the frames after the trigger
+    HISTORY_FROZEN = 3, //!< the ring holds the frames around the trigger until the next config
+};
+
+enum HistoryTrigger : uint8_t {
+    TRIGGER_NONE = 0,
+    TRIGGER_HOST = 1, //!< history_trigger command
+    TRIGGER_BLOB_COUNT = 2, //!< blob count changed by at least blobCountJump between two packets
+    TRIGGER_MARKER_LOST = 3, //!< an identified blink marker was lost
+};
+
+class FrameHistoryConfig {
+public:
+    bool enabled = {false}; //!< capture continuously into the ring while the sensor runs at 13 fps
+    uint8_t slots = {8}; //!< frames held in the ring
+    uint8_t postTriggerFrames = {4}; //!< frames captured after the trigger before the ring is frozen, less than slots
+    uint8_t blobCountJump = {0}; //!< blob count change between two packets that triggers, 0 disables
+    bool markerLost = {false}; //!< trigger when an identified blink marker is lost
+
+    static constexpr size_t SIZE {5};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static constexpr size_t OFFSET_SLOTS {OFFSET_ENABLED + sizeof(enabled)};
+    static constexpr size_t OFFSET_POST_TRIGGER_FRAMES {OFFSET_SLOTS + sizeof(slots)};
+    static constexpr size_t OFFSET_BLOB_COUNT_JUMP {OFFSET_POST_TRIGGER_FRAMES + sizeof(postTriggerFrames)};
+    static constexpr size_t OFFSET_MARKER_LOST {OFFSET_BLOB_COUNT_JUMP + sizeof(blobCountJump)};
+    static_assert(OFFSET_MARKER_LOST + sizeof(markerLost) == SIZE);
+
+    bool valid(uint8_t slotsMax) const {
+        return (slots > 0U) && (slots <= slotsMax) && (postTriggerFrames < slots);
+    }
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+        buffer[OFFSET_SLOTS] = slots;
+        buffer[OFFSET_POST_TRIGGER_FRAMES] = postTriggerFrames;
+        buffer[OFFSET_BLOB_COUNT_JUMP] = blobCountJump;
+        buffer[OFFSET_MARKER_LOST] = markerLost ? 1U : 0U;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        enabled = buffer[OFFSET_ENABLED] != 0U;
+        slots = buffer[OFFSET_SLOTS];
+        postTriggerFrames = buffer[OFFSET_POST_TRIGGER_FRAMES];
+        blobCountJump = buffer[OFFSET_BLOB_COUNT_JUMP];
+        markerLost = buffer[OFFSET_MARKER_LOST] != 0U;
+        return true;
+    }
+};
+
+class FrameHistoryState {
+public:
+    FrameHistoryConfig config {};
+    HistoryStatus status = {HistoryStatus::HISTORY_OFF};
+    HistoryTrigger trigger = {HistoryTrigger::TRIGGER_NONE}; //!< source of the latest trigger
+    uint8_t slotsMax = {}; //!< frames fitting the reserved SDRAM
+    uint8_t frames = {}; //!< held in the ring, index 0 is the oldest
+    uint8_t framesAfterTrigger = {}; //!< the newest frames, captured after the trigger
+    uint32_t triggerTimeMs = {}; //!< ms since boot
+    uint32_t framesCaptured = {}; //!< since boot
+    uint32_t captureFailures = {}; //!< since boot
+
+    static constexpr size_t SIZE {FrameHistoryConfig::SIZE + 17};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_STATUS {OFFSET_CONFIG + FrameHistoryConfig::SIZE};
+    static constexpr size_t OFFSET_TRIGGER {OFFSET_STATUS + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_SLOTS_MAX {OFFSET_TRIGGER + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_FRAMES {OFFSET_SLOTS_MAX + sizeof(slotsMax)};
+    static constexpr size_t OFFSET_FRAMES_AFTER_TRIGGER {OFFSET_FRAMES + sizeof(frames)};
+    static constexpr size_t OFFSET_TRIGGER_TIME_MS {OFFSET_FRAMES_AFTER_TRIGGER + sizeof(framesAfterTrigger)};
+    static constexpr size_t OFFSET_FRAMES_CAPTURED {OFFSET_TRIGGER_TIME_MS + sizeof(triggerTimeMs)};
+    static constexpr size_t OFFSET_CAPTURE_FAILURES {OFFSET_FRAMES_CAPTURED + sizeof(framesCaptured)};
+    static_assert(OFFSET_CAPTURE_FAILURES + sizeof(captureFailures) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, FrameHistoryConfig::SIZE);
+        buffer[OFFSET_STATUS] = static_cast<uint8_t>(status);
+        buffer[OFFSET_TRIGGER] = static_cast<uint8_t>(trigger);
+        buffer[OFFSET_SLOTS_MAX] = slotsMax;
+        buffer[OFFSET_FRAMES] = frames;
+        buffer[OFFSET_FRAMES_AFTER_TRIGGER] = framesAfterTrigger;
+        std::memcpy(buffer + OFFSET_TRIGGER_TIME_MS, &triggerTimeMs, sizeof(triggerTimeMs));
+        std::memcpy(buffer + OFFSET_FRAMES_CAPTURED, &framesCaptured, sizeof(framesCaptured));
+        std::memcpy(buffer + OFFSET_CAPTURE_FAILURES, &captureFailures, sizeof(captureFailures));
+        return true;
+    }
+};
+
+enum PreviewFilter : uint8_t {
+    PREVIEW_DECIMATE = 0, //!< every factor-th px of every factor-th row
+    PREVIEW_BOX = 1, //!< mean of factor x factor px
+};
+
+class PreviewConfig {
+public:
+    uint8_t factor = {8}; //!< 4 (320x200) or 8 (160x100)
+    PreviewFilter filter = {PreviewFilter::PREVIEW_BOX};
+    uint8_t fpsMax = {10}; //!< [1, 30], the 13 fps snapshots limit the actual rate
+
+    static constexpr size_t SIZE {3};
+    static constexpr size_t OFFSET_FACTOR {0};
+    static constexpr size_t OFFSET_FILTER {OFFSET_FACTOR + sizeof(factor)};
+    static constexpr size_t OFFSET_FPS_MAX {OFFSET_FILTER + sizeof(uint8_t)};
+    static_assert(OFFSET_FPS_MAX + sizeof(fpsMax) == SIZE);
+
+    static constexpr uint8_t FPS_MAX {30};
+
+    bool valid() const {
+        return ((factor == 4U) || (factor == 8U)) && (filter <= PreviewFilter::PREVIEW_BOX) && (fpsMax > 0U) && (fpsMax <= FPS_MAX);
+    }
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_FACTOR] = factor;
+        buffer[OFFSET_FILTER] = static_cast<uint8_t>(filter);
+        buffer[OFFSET_FPS_MAX] = fpsMax;
+        return true;
+    }
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        factor = buffer[OFFSET_FACTOR];
+        filter = static_cast<PreviewFilter>(buffer[OFFSET_FILTER]);
+        fpsMax = buffer[OFFSET_FPS_MAX];
+        return true;
+    }
+};
+
+class PreviewState {
+public:
+    PreviewConfig config {};
+    uint32_t framesSent = {}; //!< since boot, to at least one subscriber
+    uint32_t datagramsFailed = {}; //!< since boot, not handed to the network interface for all due subscribers
+    uint32_t captureFailures = {}; //!< since boot
+    uint32_t filterCyclesLast = {}; //!< core clock cycles spent scaling the latest frame
+    uint32_t filterCyclesMax = {}; //!< since the last config change
+
+    static constexpr size_t SIZE {PreviewConfig::SIZE + 20};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_FRAMES_SENT {OFFSET_CONFIG + PreviewConfig::SIZE};
+    static constexpr size_t OFFSET_DATAGRAMS_FAILED {OFFSET_FRAMES_SENT + sizeof(framesSent)};
+    static constexpr size_t OFFSET_CAPTURE_FAILURES {OFFSET_DATAGRAMS_FAILED + sizeof(datagramsFailed)};
+    static constexpr size_t OFFSET_FILTER_CYCLES_LAST {OFFSET_CAPTURE_FAILURES + sizeof(captureFailures)};
+    static constexpr size_t OFFSET_FILTER_CYCLES_MAX {OFFSET_FILTER_CYCLES_LAST + sizeof(filterCyclesLast)};
+    static_assert(OFFSET_FILTER_CYCLES_MAX + sizeof(filterCyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        config.toBytes(buffer + OFFSET_CONFIG, PreviewConfig::SIZE);
+        std::memcpy(buffer + OFFSET_FRAMES_SENT, &framesSent, sizeof(framesSent));
+        std::memcpy(buffer + OFFSET_DATAGRAMS_FAILED, &datagramsFailed, sizeof(datagramsFailed));
+        std::memcpy(buffer + OFFSET_CAPTURE_FAILURES, &captureFailures, sizeof(captureFailures));
+        std::memcpy(buffer + OFFSET_FILTER_CYCLES_LAST, &filterCyclesLast, sizeof(filterCyclesLast));
+        std::memcpy(buffer + OFFSET_FILTER_CYCLES_MAX, &filterCyclesMax, sizeof(filterCyclesMax));
+        return true;
+    }
+};
+
+#endif // VISIONADDON_APP_CAMERA_TYPES_H
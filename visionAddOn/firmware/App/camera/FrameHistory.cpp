@@ -0,0 +1,179 @@
+#include "FrameHistory.h"
+
+#include "cmsis_os2.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+
+FrameHistory::FrameHistory(Ov9281& camera, uint8_t* memory, size_t size) :
+_camera{camera},
+_memory{memory},
+_slotsMax{static_cast<uint8_t>(std::min(size / FRAME_SIZE, static_cast<size_t>(SLOTS_MAX)))}
+{
+    ASSERT(memory != nullptr);
+    ASSERT(_slotsMax > 0U);
+    _config.slots = std::min(_config.slots, _slotsMax);
+    _config.postTriggerFrames = std::min<uint8_t>(_config.postTriggerFrames, _config.slots - 1U);
+}
+
+void FrameHistory::run()
+{
+    _mutex.lock();
+    const bool frozen = (_status == HistoryStatus::HISTORY_TRIGGERED) && (_framesAfterTrigger >= _config.postTriggerFrames);
+    if(frozen) {
+        freeze();
+    }
+    const uint8_t frames = _frames;
+    const bool recording = (_status == HistoryStatus::HISTORY_RECORDING) || (_status == HistoryStatus::HISTORY_TRIGGERED);
+    const bool afterTrigger = (_status == HistoryStatus::HISTORY_TRIGGERED);
+    const uint32_t generation = _generation;
+    const uint8_t next = _next;
+    _mutex.unlock();
+    if(frozen) {
+        Log::info("[FrameHistory] frozen, %u frames", frames);
+    }
+    if(!recording || (_camera.mode() != SensorMode::MODE_1280X800_13FPS)) {
+        osDelay(_IDLE_DELAY_TICKS);
+        return;
+    }
+
+    _captureMutex.lock();
+    const bool captured = _camera.capture(slot(next));
+    _captureMutex.unlock();
+    const uint32_t timeMs = nowMs();
+
+    _mutex.lock();
+    if(generation != _generation) {
+        _mutex.unlock();
+        return; // reconfigured while capturing
+    }
+    if(!captured) {
+        _captureFailures++;
+        _mutex.unlock();
+        osDelay(_IDLE_DELAY_TICKS);
+        return;
+    }
+    _timeMs[next] = timeMs;
+    _next = (next + 1U) % _config.slots;
+    _frames = std::min<uint8_t>(_frames + 1U, _config.slots);
+    _framesCaptured++;
+    if(afterTrigger) {
+        _framesAfterTrigger++;
+    }
+    _mutex.unlock();
+}
+
+bool FrameHistory::config(const FrameHistoryConfig& config)
+{
+    if(!config.valid(_slotsMax)) {
+        Log::warning("[FrameHistory] invalid config, slots %u of %u, post trigger frames %u", config.slots, _slotsMax, config.postTriggerFrames);
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    _status = config.enabled ? HistoryStatus::HISTORY_RECORDING : HistoryStatus::HISTORY_OFF;
+    _trigger = HistoryTrigger::TRIGGER_NONE;
+    _generation++;
+    _next = 0;
+    _frames = 0;
+    _framesAfterTrigger = 0;
+    _triggerTimeMs = 0;
+    _observed = false;
+    _mutex.unlock();
+    Log::info("[FrameHistory] %s, %u slots, %u frames after the trigger", config.enabled ? "recording" : "off", config.slots, config.postTriggerFrames);
+    return true;
+}
+
+FrameHistoryState FrameHistory::state()
+{
+    FrameHistoryState state {};
+    _mutex.lock();
+    state.config = _config;
+    state.status = _status;
+    state.trigger = _trigger;
+    state.slotsMax = _slotsMax;
+    state.frames = _frames;
+    state.framesAfterTrigger = _framesAfterTrigger;
+    state.triggerTimeMs = _triggerTimeMs;
+    state.framesCaptured = _framesCaptured;
+    state.captureFailures = _captureFailures;
+    _mutex.unlock();
+    return state;
+}
+
+bool FrameHistory::trigger(HistoryTrigger source)
+{
+    _mutex.lock();
+    if(_status != HistoryStatus::HISTORY_RECORDING) {
+        _mutex.unlock();
+        return false;
+    }
+    _status = HistoryStatus::HISTORY_TRIGGERED;
+    _trigger = source;
+    _triggerTimeMs = nowMs();
+    _framesAfterTrigger = 0;
+    _mutex.unlock();
+    Log::info("[FrameHistory] triggered, source %u", source);
+    return true;
+}
+
+void FrameHistory::observe(uint8_t blobCount, uint8_t identifiedMarkers)
+{
+    HistoryTrigger source {HistoryTrigger::TRIGGER_NONE};
+    _mutex.lock();
+    if(_status == HistoryStatus::HISTORY_RECORDING) {
+        const uint8_t blobCountChange = (blobCount > _blobCountLast) ? (blobCount - _blobCountLast) : (_blobCountLast - blobCount);
+        if(_observed && (_config.blobCountJump > 0U) && (blobCountChange >= _config.blobCountJump)) {
+            source = HistoryTrigger::TRIGGER_BLOB_COUNT;
+        } else if(_observed && _config.markerLost && (identifiedMarkers < _identifiedMarkersLast)) {
+            source = HistoryTrigger::TRIGGER_MARKER_LOST;
+        }
+    }
+    _observed = true;
+    _blobCountLast = blobCount;
+    _identifiedMarkersLast = identifiedMarkers;
+    _mutex.unlock();
+    if(source != HistoryTrigger::TRIGGER_NONE) {
+        trigger(source);
+    }
+}
+
+const uint8_t* FrameHistory::frame(uint8_t index, uint32_t& timeMs)
+{
+    _mutex.lock();
+    if((_status != HistoryStatus::HISTORY_FROZEN) || (index >= _frames)) {
+        _mutex.unlock();
+        return nullptr;
+    }
+    const uint8_t oldest = (_next + _config.slots - _frames) % _config.slots;
+    const uint8_t slotIndex = (oldest + index) % _config.slots;
+    timeMs = _timeMs[slotIndex];
+    _mutex.unlock();
+    return slot(slotIndex);
+}
+
+bool FrameHistory::capture()
+{
+    return capture(reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS));
+}
+
+bool FrameHistory::capture(uint8_t* frameBuffer)
+{
+    _captureMutex.lock(); // the ring skips a frame while recording
+    const bool captured = _camera.capture(frameBuffer);
+    _captureMutex.unlock();
+    return captured;
+}
+
+void FrameHistory::freeze()
+{
+    _status = HistoryStatus::HISTORY_FROZEN;
+    _framesAfterTrigger = std::min(_framesAfterTrigger, _frames);
+}
+
+uint32_t FrameHistory::nowMs()
+{
+    return osKernelGetTickCount() / TICKS_PER_MILLISECOND;
+}
@@ -0,0 +1,100 @@
+#ifndef VISIONADDON_APP_CAMERA_FRAMEHISTORY_H
+#define VISIONADDON_APP_CAMERA_FRAMEHISTORY_H
+
+#include "CameraTypes.h"
+#include "Ov9281.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Triggered ring of full frames in the external SDRAM, the frames before and after an event are kept for inspection.
+//
+// While enabled the frames are captured back to back into the ring, as selected by pipeline_set_output
+// (unprocessed or binarized). Snapshots are only supported at 13 fps and take one to two sensor frames each.
+// A trigger (host, blob count jump or lost blink marker) lets postTriggerFrames more frames be captured,
+// then the ring is frozen until the next config. Only the first trigger is kept.
+// The DCMI is shared with the single snapshots requested by the host, these must go through capture().
+class FrameHistory final : public IRunnable {
+public:
+    /**
+     * @param camera captures the frames
+     * @param memory at least one frame, word aligned, the content is ignored
+     * @param size of memory in bytes
+     */
+    FrameHistory(Ov9281& camera, uint8_t* memory, size_t size);
+    FrameHistory (const FrameHistory&) = delete;
+    FrameHistory& operator=(const FrameHistory&) = delete;
+    FrameHistory (const FrameHistory&&) = delete;
+    FrameHistory& operator=(const FrameHistory&&) = delete;
+
+    void run() override; //!< captures the next frame into the ring while recording, blocking!
+
+    /**
+     * @brief Apply a config, the ring is cleared and recording restarts if enabled.
+     *
+     * @return false if the slots do not fit the memory or postTriggerFrames is not less than slots
+     */
+    bool config(const FrameHistoryConfig& config);
+    FrameHistoryState state();
+
+    /**
+     * @brief Freeze the ring after postTriggerFrames more frames.
+     *
+     * @return false if not recording or already triggered
+     */
+    bool trigger(HistoryTrigger source);
+
+    /**
+     * @brief Evaluate the blob count and blink marker triggers, called per intact feature packet.
+     *
+     * @param blobCount features in the packet
+     * @param identifiedMarkers tracks with an assigned blink marker id after the packet
+     */
+    void observe(uint8_t blobCount, uint8_t identifiedMarkers);
+
+    /**
+     * @brief Look up a frame of the frozen ring.
+     *
+     * @param index 0 is the oldest frame
+     * @param timeMs capture time, ms since boot
+     * @return the frame, nullptr if the ring is not frozen or index is out of range
+     */
+    const uint8_t* frame(uint8_t index, uint32_t& timeMs);
+
+    bool capture(); //!< single snapshot into the camera frame buffer, waits for a running ring capture, blocking!
+    bool capture(uint8_t* frameBuffer); //!< single snapshot into another buffer of FRAME_SIZE bytes, blocking!
+
+    static constexpr size_t FRAME_SIZE {1280 * 800}; //!< 13 fps mode, one byte per px
+    static constexpr uint8_t SLOTS_MAX {16};
+
+private:
+    uint8_t* slot(uint8_t index) {return _memory + (FRAME_SIZE * index);};
+    void freeze(); //!< must hold _mutex
+    static uint32_t nowMs();
+
+    Ov9281& _camera;
+    uint8_t* _memory;
+    uint8_t _slotsMax;
+    Mutex _captureMutex; //!< held while the DCMI captures
+    Mutex _mutex;
+    FrameHistoryConfig _config {};
+    HistoryStatus _status {HistoryStatus::HISTORY_OFF};
+    HistoryTrigger _trigger {HistoryTrigger::TRIGGER_NONE};
+    uint32_t _generation {0}; //!< incremented per config, captures started before are discarded
+    uint8_t _next {0}; //!< slot of the next capture
+    uint8_t _frames {0};
+    uint8_t _framesAfterTrigger {0};
+    uint32_t _triggerTimeMs {0};
+    uint32_t _framesCaptured {0};
+    uint32_t _captureFailures {0};
+    std::array<uint32_t, SLOTS_MAX> _timeMs {}; //!< capture time per slot
+    bool _observed {false}; //!< a packet was observed since the config
+    uint8_t _blobCountLast {0};
+    uint8_t _identifiedMarkersLast {0};
+    static constexpr uint32_t _IDLE_DELAY_TICKS {100};
+};
+
+#endif // VISIONADDON_APP_CAMERA_FRAMEHISTORY_H
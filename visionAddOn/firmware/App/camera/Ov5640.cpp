@@ -4,6 +4,7 @@
 #include "lwip/sockets.h"
 #undef bind // to avoid conflicts with std functional bind
 #include "utils/assert.h"
+#include "utils/Cache.h"
 #include "utils/constants.h"
 #include "utils/Log.h"
 #include <stdio.h>
@@ -264,11 +265,14 @@ bool Ov5640::capture()
     static constexpr size_t IMAGE_HEIGHT_PIXELS {480};
     static constexpr size_t BYTES_PER_PIXEL {2};
     static constexpr size_t BYTES_PER_DMA_TRANSFER {4};
+    static constexpr size_t FRAME_SIZE_BYTES {IMAGE_WIDTH_PIXELS * IMAGE_HEIGHT_PIXELS * BYTES_PER_PIXEL};
+    uint8_t* frameBuffer = reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS);
+    Cache::beforeDmaWrite(frameBuffer, FRAME_SIZE_BYTES);
     auto startStatus = HAL_DCMI_Start_DMA(
         _dcmi,
         DCMI_MODE_SNAPSHOT,
         EXTERNAL_SDRAM_BASE_ADDRESS,
-        IMAGE_WIDTH_PIXELS * IMAGE_HEIGHT_PIXELS * BYTES_PER_PIXEL / BYTES_PER_DMA_TRANSFER
+        FRAME_SIZE_BYTES / BYTES_PER_DMA_TRANSFER
     );
 
     if (startStatus != HAL_StatusTypeDef::HAL_OK){
@@ -302,6 +306,7 @@ bool Ov5640::capture()
         Log::warning("[Ov5640] capture timeout, status: %u, errorCode: %d", dcmiState, dcmiErrorCode);
     }
     HAL_DCMI_Stop(_dcmi);
+    Cache::afterDmaWrite(frameBuffer, FRAME_SIZE_BYTES);
     return success;
 }
 
@@ -4,22 +4,20 @@
 #include "cmsis_gcc.h"
 #include "lwip/sockets.h"
 #undef bind // to avoid conflicts with std functional bind
+#include "metrics/PeripheralErrors.h"
 #include "utils/assert.h"
+#include "utils/Cache.h"
 #include "utils/constants.h"
 #include "utils/Log.h"
-#include <stdio.h>
 
+#include <cstring>
+#include <stdio.h>
 
-// initial sequences are based on 
-// https://github.com/torvalds/linux/blob/master/drivers/media/i2c/ov9282.c
-// and then modified using Ov9281 and Ov9282 data sheets
 
 Ov9281::Ov9281(I2C_HandleTypeDef* i2c, uint8_t i2cSlaveAddress, DCMI_HandleTypeDef* dcmi) :
 _i2c{i2c},
 _i2cSlaveAddress{static_cast<uint16_t>(i2cSlaveAddress)},
-_dcmi{dcmi},
-_init13Fps{std::move(build13FpsSequence())},
-_init72Fps{std::move(build72FpsSequence())}
+_dcmi{dcmi}
 {
     ASSERT(_i2c != nullptr);
     ASSERT(_dcmi != nullptr);
@@ -30,7 +28,55 @@ _init72Fps{std::move(build72FpsSequence())}
 }
 
 bool Ov9281::init(Fps fps) {
-    _fps = fps;
+    return init(sensorModeFromFps(fps));
+}
+
+bool Ov9281::init(SensorMode mode) {
+    _mutex.lock();
+    const bool success = writeMode(mode);
+    _mutex.unlock();
+    return success;
+}
+
+uint16_t Ov9281::chipId() {
+    _mutex.lock();
+    const uint16_t id = readChipId();
+    _mutex.unlock();
+    return id;
+}
+
+bool Ov9281::exposure(uint16_t levelInteger, uint8_t levelFraction) {
+    _mutex.lock();
+    const bool success = writeExposure(levelInteger, levelFraction);
+    _mutex.unlock();
+    return success;
+}
+
+bool Ov9281::gain(uint8_t level, uint8_t band) {
+    _mutex.lock();
+    const bool success = writeGain(level, band);
+    _mutex.unlock();
+    return success;
+}
+
+bool Ov9281::whitebalance(uint16_t red, uint16_t green, uint16_t blue) {
+    _mutex.lock();
+    const bool success = writeWhitebalance(red, green, blue);
+    _mutex.unlock();
+    return success;
+}
+
+bool Ov9281::writeMode(SensorMode mode) {
+    const SensorModeInfo info {sensorModeInfo(mode)};
+    const Ov9281Registers::Sequence* sequence {Ov9281Registers::sequence(mode)};
+    if((info.mode == SensorMode::MODE_UNDEFINED) || (sequence == nullptr)) {
+        Log::error("[Ov9281] initializing abort mode %u is not supported", static_cast<uint8_t>(mode));
+        return false;
+    }
+    const uint32_t startTicks {osKernelGetTickCount()};
+    // nullptr if the sensor state is unknown, the full sequence is written in that case
+    const Ov9281Registers::Sequence* active {Ov9281Registers::sequence(_mode)};
+    _mode = SensorMode::MODE_UNDEFINED;
     static constexpr uint16_t REGISTER_ADDRESS_MODE_SELECT {0x0100};
     static constexpr uint8_t MODE_STANDBY {0x00};
     static constexpr uint8_t MODE_STREAMING {0x01};
@@ -39,25 +85,18 @@ bool Ov9281::init(Fps fps) {
         Log::error("[Ov9281] select standby mode failed");
         return false;
     }
-
-    switch (fps) {
-        case Fps::_72:
-            Log::info("[Ov9281] initializing ov9281 for high fps mode");
-            if(!writeRegisters(_init72Fps)){
-                Log::error("[Ov9281] write 72 fps sequence failed");
-                return false;
-            }
-        break;
-        case Fps::_13:
-            Log::info("[Ov9281] initializing ov9281 for low fps mode");
-            if(!writeRegisters(_init13Fps)){
-                Log::error("[Ov9281] write 13 fps sequence failed");
-                return false;
-            }
-        break;
-        default:
-            Log::error("[Ov9281] initializing abort fps %u is not supported", static_cast<uint8_t>(fps));
+    if(active == nullptr) {
+        static constexpr uint16_t REGISTER_ADDRESS_SOFTWARE_RESET {0x0103};
+        static constexpr uint8_t SOFTWARE_RESET {0x01};
+        if(!writeRegister(REGISTER_ADDRESS_SOFTWARE_RESET, SOFTWARE_RESET)){
+            Log::error("[Ov9281] software reset failed");
             return false;
+        }
+    }
+
+    if(!writeRegisters(*sequence, active)){
+        Log::error("[Ov9281] write mode %u sequence failed", static_cast<uint8_t>(mode));
+        return false;
     }
 
     // start streaming
@@ -65,10 +104,13 @@ bool Ov9281::init(Fps fps) {
         Log::error("[Ov9281] select streaming mode failed");
         return false;
     }
+    _mode = mode;
+    Log::info("[Ov9281] initialized %ux%u %u fps mode (%s), took %lu ms", info.width, info.height, info.fps,
+        (active == nullptr) ? "full" : "diff", (osKernelGetTickCount() - startTicks) / TICKS_PER_MILLISECOND);
     return true;
 }
 
-uint16_t Ov9281::chipId() {
+uint16_t Ov9281::readChipId() {
     static constexpr uint16_t REGISTER_ADDRESS_SC_CHIP_ID_HIGH {0x300a};
     static constexpr uint16_t REGISTER_ADDRESS_SC_CHIP_ID_LOW {0x300b};
     const auto idHighResult = readRegister(REGISTER_ADDRESS_SC_CHIP_ID_HIGH);
@@ -84,7 +126,7 @@ uint16_t Ov9281::chipId() {
     return static_cast<uint16_t>(std::get<1>(idHighResult)) << 8 | static_cast<uint16_t>(std::get<1>(idLowResult));
 }
 
-bool Ov9281::exposure(uint16_t levelInteger, uint8_t levelFraction)
+bool Ov9281::writeExposure(uint16_t levelInteger, uint8_t levelFraction)
 {
     static constexpr uint16_t REGISTER_ADDRESS_FRAME_LENGTH_HIGH {0x380E};
     static constexpr uint16_t REGISTER_ADDRESS_FRAME_LENGTH_LOW {0x380F};
@@ -139,7 +181,7 @@ bool Ov9281::exposure(uint16_t levelInteger, uint8_t levelFraction)
     return true;
 }
 
-bool Ov9281::gain(uint8_t level, uint8_t band)
+bool Ov9281::writeGain(uint8_t level, uint8_t band)
 {
     static constexpr uint8_t MAX_LEVEL {31U};
     if(level > MAX_LEVEL) {
@@ -170,7 +212,7 @@ bool Ov9281::gain(uint8_t level, uint8_t band)
     return true;
 }
 
-bool Ov9281::whitebalance(uint16_t red, uint16_t green, uint16_t blue)
+bool Ov9281::writeWhitebalance(uint16_t red, uint16_t green, uint16_t blue)
 {
     static constexpr uint16_t MAX_LEVEL{0xfff};
     if((red > MAX_LEVEL) || (green > MAX_LEVEL) || (blue > MAX_LEVEL)){
@@ -217,10 +259,14 @@ bool Ov9281::whitebalance(uint16_t red, uint16_t green, uint16_t blue)
     return true;
 }
 
-//TODO: pass framebuffer
 bool Ov9281::capture()
 {
-    if(_fps != Fps::_13) {
+    return capture(reinterpret_cast<uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS));
+}
+
+bool Ov9281::capture(uint8_t* frameBuffer)
+{
+    if(_mode != SensorMode::MODE_1280X800_13FPS) {
         Log::error("[Ov9281] capture abort, camera frame rate is not set to 13 fps");
         return false;
     }
@@ -252,16 +298,18 @@ bool Ov9281::capture()
         }
     }
     
-    Log::info("[Ov9281] starting capture");
+    Log::debug("[Ov9281] starting capture");
     static constexpr size_t IMAGE_WIDTH_PIXELS {1280}; // Hardcoded to match 13 fps sequence
     static constexpr size_t IMAGE_HEIGHT_PIXELS {800}; // Hardcoded to match 13 fps sequence
     static constexpr size_t BYTES_PER_PIXEL {1};
     static constexpr size_t BYTES_PER_DMA_TRANSFER {4};
+    static constexpr size_t FRAME_SIZE_BYTES {IMAGE_WIDTH_PIXELS * IMAGE_HEIGHT_PIXELS * BYTES_PER_PIXEL};
+    Cache::beforeDmaWrite(frameBuffer, FRAME_SIZE_BYTES);
     auto startStatus = HAL_DCMI_Start_DMA(
         _dcmi,
         DCMI_MODE_SNAPSHOT,
-        EXTERNAL_SDRAM_BASE_ADDRESS,
-        IMAGE_WIDTH_PIXELS * IMAGE_HEIGHT_PIXELS * BYTES_PER_PIXEL / BYTES_PER_DMA_TRANSFER
+        reinterpret_cast<uint32_t>(frameBuffer),
+        FRAME_SIZE_BYTES / BYTES_PER_DMA_TRANSFER
     );
 
     if (startStatus != HAL_StatusTypeDef::HAL_OK){
@@ -280,7 +328,7 @@ bool Ov9281::capture()
         dcmiState = _dcmi->State;
         dcmiErrorCode = _dcmi->ErrorCode;
         if(dcmiState == HAL_DCMI_StateTypeDef::HAL_DCMI_STATE_READY){
-            Log::info("[Ov9281] capture success, took %u cycles", i);
+            Log::debug("[Ov9281] capture success, took %u cycles", i);
             success = true;
             timeout = false;
             break;
@@ -297,6 +345,7 @@ bool Ov9281::capture()
         Log::warning("[Ov9281] capture timeout, status: %u, errorCode: %d", dcmiState, dcmiErrorCode);
     }
     HAL_DCMI_Stop(_dcmi);
+    Cache::afterDmaWrite(frameBuffer, FRAME_SIZE_BYTES); // also after a failure, the frame is partially written
     return success;
 }
 
@@ -355,18 +404,54 @@ bool Ov9281::writeRegister(uint16_t address, uint8_t data, uint32_t timeoutMs) {
     return true;
 }
 
-bool Ov9281::writeRegisters(const std::map<uint16_t, uint8_t>& registerValueMap, const uint32_t timeoutMs) {
-    for (auto const& addressValuePair : registerValueMap){
-        if(!writeRegister(addressValuePair.first, addressValuePair.second, timeoutMs)){
-            return false;
+bool Ov9281::writeRegisters(const Ov9281Registers::Sequence& sequence, const Ov9281Registers::Sequence* active, uint32_t timeoutMs) {
+    uint8_t burst[_MAX_BURST_SIZE];
+    size_t burstSize {0};
+    uint16_t burstAddress {0};
+    for(size_t i = 0; i < Ov9281Registers::SEQUENCE_LENGTH; i++) {
+        const auto& entry = sequence[i];
+        const bool runtime {(entry.address >= Ov9281Registers::RUNTIME_ADDRESS_FIRST) && (entry.address <= Ov9281Registers::RUNTIME_ADDRESS_LAST)};
+        const bool differs {(active == nullptr) || ((*active)[i].value != entry.value)};
+        if(!runtime && !differs) {
+            continue;
+        }
+        const bool consecutive {(burstSize > 0) && (entry.address == burstAddress + burstSize)};
+        if((burstSize > 0) && (!consecutive || (burstSize == _MAX_BURST_SIZE))) {
+            if(!writeBurst(burstAddress, burst, burstSize, timeoutMs)) {
+                return false;
+            }
+            burstSize = 0;
+        }
+        if(burstSize == 0) {
+            burstAddress = entry.address;
         }
+        burst[burstSize++] = entry.value;
+    }
+    if(burstSize > 0) {
+        return writeBurst(burstAddress, burst, burstSize, timeoutMs);
+    }
+    return true;
+}
+
+bool Ov9281::writeBurst(uint16_t address, const uint8_t* data, size_t size, uint32_t timeoutMs) {
+    // the sensor increments the register address after every data byte
+    static constexpr size_t ADDRESS_SIZE {2};
+    if(size > _MAX_BURST_SIZE) {
+        return false;
+    }
+    uint8_t writeBuffer[ADDRESS_SIZE + _MAX_BURST_SIZE] {uint8_t(address >> 8), uint8_t(address >> 0)};
+    std::memcpy(writeBuffer + ADDRESS_SIZE, data, size);
+    const uint32_t timeoutTicks {timeoutMs * TICKS_PER_MILLISECOND};
+    auto status = HAL_I2C_Master_Transmit(_i2c, _i2cSlaveAddress, writeBuffer, static_cast<uint16_t>(ADDRESS_SIZE + size), timeoutTicks);
+    if(status != HAL_StatusTypeDef::HAL_OK){
+        Log::debug("[Ov9281] write burst at 0x%04x (%u bytes) failed, status: %u", address, static_cast<unsigned int>(size), status);
+        return false;
     }
     return true;
 }
 
 void HAL_DCMI_ErrorCallback(DCMI_HandleTypeDef *hdcmi) {
-    (void)hdcmi;
-    Log::error("[HAL_DCMI_ErrorCallback]");
+    PeripheralErrors::record(PERIPHERAL_DCMI, hdcmi->ErrorCode);
 }
 
 //void HAL_DCMI_LineEventCallback(DCMI_HandleTypeDef *hdcmi) {
@@ -383,258 +468,3 @@ void HAL_DCMI_ErrorCallback(DCMI_HandleTypeDef *hdcmi) {
 //    (void)hdcmi;
 //    Log::debug("[HAL_DCMI_VsyncEventCallback]");
 //}
-
-const std::map<uint16_t, uint8_t> Ov9281::build13FpsSequence() {
-    // default:
-    //  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
-    //  Value matched default register value as documented in OV9281 data sheet v1.53
-    // non-default:
-    //  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
-    //  Value differs from default register value as documented in OV9281 data sheet v1.53.
-    // user-modified:
-    //  Value changed by user
-    // user-added:
-    //  Value not configured in reference sequence
-    return {
-        {0x0103, 0x01}, // software reset on
-        {0x0302, 0x30}, // pll1 multiplier[7:0]
-        {0x030d, 0x60}, // pll2 multiplier[7:0] -> 140
-        {0x030e, 0x06}, // pll2 system divider -> 1/4
-        {0x0303, 0x01}, // user-added, slow down PCLK <- slow down to 13 fps
-        {0x3001, 0x62}, // non-default, I/O pin drive capacity 4x
-        {0x3004, 0x01}, // non-default, output control enable D9
-        {0x3005, 0xfe}, // user-modified, output control enable D8-D2, disable D1
-        {0x3006, 0x62}, // user-modified, output control disable D0, enable PCLK, HREF, VYSNC
-        {0x3011, 0x0a}, // non-default, system control
-        {0x3013, 0x18}, // non-default, system control
-        {0x301c, 0xf0}, // non-default, system control
-        {0x3022, 0x07}, // non-default, system control
-        {0x3030, 0x10}, // default, system control
-        {0x3039, 0x2e}, // non-default, system control enable DVP
-        {0x303a, 0xf0}, // non-default, MIPI lane disable
-        {0x3500, 0x00}, // default, exposure control
-        {0x3501, 0x2a}, // non-default, exposure control
-        {0x3502, 0x90}, // non-default, exposure control
-        {0x3503, 0x08}, // non-default, AEC manual
-        {0x3505, 0x8c}, // non-default, gain conversation option
-        {0x3507, 0x03}, // non-default, gain shift
-        {0x3508, 0x00}, // unknown, undocumented debug register
-        {0x3509, 0x10}, // non-default, gain control
-        {0x3610, 0x80}, // unknown, undocumented analog register
-        {0x3611, 0xa0}, // unknown, undocumented analog register
-        {0x3620, 0x6e}, // unknown, undocumented analog register
-        {0x3632, 0x56}, // unknown, undocumented analog register
-        {0x3633, 0x78}, // unknown, undocumented analog register
-        {0x3662, 0x05}, // default, MIPI 2-lane, RAW10
-        {0x3666, 0x5a}, // non-default, VSYNC output select, internal frame sync fixed value 0
-        {0x366f, 0x7e}, // unknown, undocumented analog register
-        {0x3680, 0x84}, // unknown, undocumented analog register
-        {0x3712, 0x80}, // unknown, undocumented sensor control register
-        {0x372d, 0x22}, // unknown, undocumented sensor control register
-        {0x3731, 0x80}, // unknown, undocumented sensor control register
-        {0x3732, 0x30}, // unknown, undocumented sensor control register
-        {0x3778, 0x00}, // default, disable vertical binning
-        {0x377d, 0x22}, // unknown, undocumented sensor control register
-        {0x3788, 0x02}, // unknown, undocumented sensor control register
-        {0x3789, 0xa4}, // unknown, undocumented sensor control register
-        {0x378a, 0x00}, // unknown, undocumented sensor control register
-        {0x378b, 0x4a}, // unknown, undocumented sensor control register
-        {0x3799, 0x20}, // unknown, undocumented sensor control register
-        {0x3800, 0x00},
-        {0x3801, 0x00}, // default, Timing X addr start 0
-        {0x3802, 0x00},
-        {0x3803, 0x00}, // default, Timing Y addr start 0
-        {0x3804, 0x05},
-        {0x3805, 0x0f}, // default, Timing X addr end 1295
-        {0x3806, 0x03},
-        {0x3807, 0x2f}, // default, Timing X addr end 815
-        {0x3808, 0x05},
-        {0x3809, 0x00}, // default, Timing X output size 1280
-        {0x380a, 0x03}, 
-        {0x380b, 0x20}, // default, Timing Y output size 800
-        {0x380c, 0x0f},
-        {0x380d, 0xd8}, // user-modified, HTS 4056 <- slow down to 13 fps
-        {0x380e, 0x03},
-        {0x380f, 0x8e}, // default, VTS 910
-        {0x3810, 0x00},
-        {0x3811, 0x08}, // default, Timing ISP X win offset 8
-        {0x3812, 0x00},
-        {0x3813, 0x08}, // default, Timing ISP Y win offset 8
-        {0x3814, 0x11}, // default, Timing X increment odd 1 even 1
-        {0x3815, 0x11}, // default, Timing Y increment odd 1 even 1
-        {0x3820, 0x44}, // user-modified, flip image orientation
-        {0x3821, 0x04}, // user-modified, mirror image
-        {0x382c, 0x05},
-        {0x382d, 0xb0}, // default, HTS global TX 1456
-        {0x389d, 0x00}, // unknown, undocumented global shutter control
-        {0x3881, 0x42}, // unknown, undocumented global shutter control
-        {0x3882, 0x01}, // unknown, undocumented global shutter control
-        {0x3883, 0x00}, // unknown, undocumented global shutter control
-        {0x3885, 0x02}, // unknown, undocumented global shutter control
-        {0x38a8, 0x02}, // unknown, undocumented global shutter control
-        {0x38a9, 0x80}, // unknown, undocumented global shutter control
-        {0x38b1, 0x00}, // unknown, undocumented global shutter control
-        {0x38b3, 0x02}, // unknown, undocumented global shutter control
-        {0x38c4, 0x00}, // unknown, undocumented global shutter control
-        {0x38c5, 0xc0}, // unknown, undocumented global shutter control
-        {0x38c6, 0x04}, // unknown, undocumented global shutter control
-        {0x38c7, 0x80}, // unknown, undocumented global shutter control
-        {0x3920, 0xff}, // non-default, strobe pattern
-        {0x4003, 0x40}, // non-default, BLC
-        {0x4008, 0x04}, // non-default, BLC
-        {0x4009, 0x0b}, // non-default, BLC
-        {0x400c, 0x00}, // default, BLC
-        {0x400d, 0x07}, // default, BLC
-        {0x4010, 0x40}, // default, BLC
-        {0x4043, 0x40}, // non-default, BLC
-        {0x4307, 0x30}, // default, format control "embed_st"
-        {0x4317, 0x01}, // non-default, enable DVP
-        {0x4501, 0x00}, // unknown, undocumented readout control registers
-        {0x4507, 0x00}, // unknown, undocumented readout control registers
-        {0x4509, 0x00}, // unknown, undocumented readout control register
-        {0x450a, 0x08}, // unknown, undocumented readout control register
-        {0x4601, 0x04}, // default, VFIFO read start point
-        {0x470f, 0xe0}, // non-default, DVP control "Reserved" section of BYP_SEL register
-        {0x4f07, 0x00}, // non-default, low power mode control
-        {0x4800, 0x00}, // non-default, MIPI control
-        {0x5000, 0x9f}, // default, BLC enable
-        {0x5001, 0x00}, // default, ISP control
-        {0x5e00, 0x00}, // default, disable test pattern (0x80 to enable)
-        {0x5d00, 0x0b}, // undocumented sensor control register
-        {0x5d01, 0x02}, // undocumented sensor control register
-        {0x4f00, 0x00}, // user-modified, low power control pclk free running
-        {0x4f10, 0x00}, // low power control "ana_psv_pch[15:8]"
-        {0x4f11, 0x98}, // low power control "ana_psv_pch[7:0]" -> 152
-        {0x4f12, 0x0f}, // low power control "ana_psv_stm[15:8]"
-        {0x4f13, 0xc4}, // low power control "ana_psv_stm[7:0]" -> 4036
-
-        {0x0100, 0x01}, // select streaming mode
-    };
-}
-
-const std::map<uint16_t, uint8_t> Ov9281::build72FpsSequence() {
-    // default:
-    //  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
-    //  Value matched default register value as documented in OV9281 data sheet v1.53
-    // non-default:
-    //  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
-    //  Value differs from default register value as documented in OV9281 data sheet v1.53.
-    // user-modified:
-    //  Value changed by user
-    // user-added:
-    //  Value not configured in reference sequence
-    return {
-        {0x0103, 0x01}, // software reset on
-        {0x0302, 0x30}, // pll1 multiplier[7:0]
-        {0x030d, 0x60}, // pll2 multiplier[7:0] -> 140
-        {0x030e, 0x06}, // pll2 system divider -> 1/4
-        {0x3001, 0x62}, // non-default, I/O pin drive capacity 4x
-        {0x3004, 0x01}, // non-default, output control enable D9
-        {0x3005, 0xfe}, // user-modified, output control enable D8-D2, disable D1
-        {0x3006, 0x62}, // user-modified, output control disable D0, enable PCLK, HREF, VYSNC
-        {0x3011, 0x0a}, // non-default, system control
-        {0x3013, 0x18}, // non-default, system control
-        {0x301c, 0xf0}, // non-default, system control
-        {0x3022, 0x07}, // non-default, system control
-        {0x3030, 0x10}, // default, system control
-        {0x3039, 0x2e}, // non-default, system control enable DVP
-        {0x303a, 0xf0}, // non-default, MIPI lane disable
-        {0x3500, 0x00}, // default, exposure control
-        {0x3501, 0x2a}, // non-default, exposure control
-        {0x3502, 0x90}, // non-default, exposure control
-        {0x3503, 0x08}, // non-default, AEC manual
-        {0x3505, 0x8c}, // non-default, gain conversation option
-        {0x3507, 0x03}, // non-default, gain shift
-        {0x3508, 0x00}, // unknown, undocumented debug register
-        {0x3509, 0x10}, // non-default, gain control
-        {0x3610, 0x80}, // unknown, undocumented analog register
-        {0x3611, 0xa0}, // unknown, undocumented analog register
-        {0x3620, 0x6e}, // unknown, undocumented analog register
-        {0x3632, 0x56}, // unknown, undocumented analog register
-        {0x3633, 0x78}, // unknown, undocumented analog register
-        {0x3662, 0x05}, // default, MIPI 2-lane, RAW10
-        {0x3666, 0x5a}, // non-default, VSYNC output select, internal frame sync fixed value 0
-        {0x366f, 0x7e}, // unknown, undocumented analog register
-        {0x3680, 0x84}, // unknown, undocumented analog register
-        {0x3712, 0x80}, // unknown, undocumented sensor control register
-        {0x372d, 0x22}, // unknown, undocumented sensor control register
-        {0x3731, 0x80}, // unknown, undocumented sensor control register
-        {0x3732, 0x30}, // unknown, undocumented sensor control register
-        {0x3778, 0x00}, // default, disable vertical binning
-        {0x377d, 0x22}, // unknown, undocumented sensor control register
-        {0x3788, 0x02}, // unknown, undocumented sensor control register
-        {0x3789, 0xa4}, // unknown, undocumented sensor control register
-        {0x378a, 0x00}, // unknown, undocumented sensor control register
-        {0x378b, 0x4a}, // unknown, undocumented sensor control register
-        {0x3799, 0x20}, // unknown, undocumented sensor control register
-        {0x3800, 0x00},
-        {0x3801, 0x00}, // default, Timing X addr start 0
-        {0x3802, 0x00},
-        {0x3803, 0x00}, // default, Timing Y addr start 0
-        {0x3804, 0x05},
-        {0x3805, 0x0f}, // default, Timing X addr end 1295
-        {0x3806, 0x03},
-        {0x3807, 0x2f}, // default, Timing X addr end 815
-        {0x3808, 0x05},
-        {0x3809, 0x00}, // default, Timing X output size 1280
-        {0x380a, 0x03}, 
-        {0x380b, 0x20}, // default, Timing Y output size 800
-        {0x380c, 0x02},
-        {0x380d, 0xd8}, // default, HTS 728
-        {0x380e, 0x03},
-        {0x380f, 0x8e}, // default, VTS 910
-        {0x3810, 0x00},
-        {0x3811, 0x08}, // default, Timing ISP X win offset 8
-        {0x3812, 0x00},
-        {0x3813, 0x08}, // default, Timing ISP Y win offset 8
-        {0x3814, 0x11}, // default, Timing X increment odd 1 even 1
-        {0x3815, 0x11}, // default, Timing Y increment odd 1 even 1
-        {0x3820, 0x44}, // user-modified, flip image orientation
-        {0x3821, 0x04}, // user-modified, mirror image
-        {0x382c, 0x05},
-        {0x382d, 0xb0}, // default, HTS global TX 1456
-        {0x389d, 0x00}, // unknown, undocumented global shutter control
-        {0x3881, 0x42}, // unknown, undocumented global shutter control
-        {0x3882, 0x01}, // unknown, undocumented global shutter control
-        {0x3883, 0x00}, // unknown, undocumented global shutter control
-        {0x3885, 0x02}, // unknown, undocumented global shutter control
-        {0x38a8, 0x02}, // unknown, undocumented global shutter control
-        {0x38a9, 0x80}, // unknown, undocumented global shutter control
-        {0x38b1, 0x00}, // unknown, undocumented global shutter control
-        {0x38b3, 0x02}, // unknown, undocumented global shutter control
-        {0x38c4, 0x00}, // unknown, undocumented global shutter control
-        {0x38c5, 0xc0}, // unknown, undocumented global shutter control
-        {0x38c6, 0x04}, // unknown, undocumented global shutter control
-        {0x38c7, 0x80}, // unknown, undocumented global shutter control
-        {0x3920, 0xff}, // non-default, strobe pattern
-        {0x4003, 0x40}, // non-default, BLC
-        {0x4008, 0x04}, // non-default, BLC
-        {0x4009, 0x0b}, // non-default, BLC
-        {0x400c, 0x00}, // default, BLC
-        {0x400d, 0x07}, // default, BLC
-        {0x4010, 0x40}, // default, BLC
-        {0x4043, 0x40}, // non-default, BLC
-        {0x4307, 0x30}, // default, format control "embed_st"
-        {0x4317, 0x01}, // non-default, enable DVP
-        {0x4501, 0x00}, // unknown, undocumented readout control registers
-        {0x4507, 0x00}, // unknown, undocumented readout control registers
-        {0x4509, 0x00}, // unknown, undocumented readout control register
-        {0x450a, 0x08}, // unknown, undocumented readout control register
-        {0x4601, 0x04}, // default, VFIFO read start point
-        {0x470f, 0xe0}, // non-default, DVP control "Reserved" section of BYP_SEL register
-        {0x4f07, 0x00}, // non-default, low power mode control
-        {0x4800, 0x00}, // non-default, MIPI control
-        {0x5000, 0x9f}, // default, BLC enable
-        {0x5001, 0x00}, // default, ISP control
-        {0x5e00, 0x00}, // default, disable test pattern (0x80 to enable)
-        {0x5d00, 0x0b}, // undocumented sensor control register
-        {0x5d01, 0x02}, // undocumented sensor control register
-        {0x4f00, 0x00}, // user-modified, low power control pclk free running
-        {0x4f10, 0x00}, // low power control "ana_psv_pch[15:8]"
-        {0x4f11, 0x98}, // low power control "ana_psv_pch[7:0]" -> 152
-        {0x4f12, 0x0f}, // low power control "ana_psv_stm[15:8]"
-        {0x4f13, 0xc4}, // low power control "ana_psv_stm[7:0]" -> 4036
-
-        {0x0100, 0x01}, // select streaming mode
-    };
-}
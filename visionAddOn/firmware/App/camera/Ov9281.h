@@ -2,13 +2,14 @@
 #define VISIONADDON_APP_CAMERA_OV9281_H
 
 #include "CameraTypes.h"
+#include "Ov9281Registers.h"
 #include "stm32f7xx_hal.h"
+#include "utils/mutex/Mutex.h"
 
 #include <cstdint>
 #include <tuple>
 #include <stdbool.h>
 #include <variant>
-#include <map>
 
 class Ov9281 final {
 public:
@@ -21,7 +22,23 @@ public:
     uint16_t chipId();
 
     bool init(Fps fps);
+
+    /**
+     * @brief Initialize the sensor for the given mode and start streaming.
+     *
+     * Exposure and gain are set to the mode defaults, see SENSOR_MODES.
+     * The first init (or the first after a failed one) resets the sensor and writes the full sequence,
+     * subsequent calls only write the registers which differ from the active mode.
+     *
+     * @param mode to initialize
+     * @return true if sequence was written successfully, false otherwise
+     */
+    bool init(SensorMode mode);
+    SensorMode mode() const {return _mode;};
     
+    static constexpr uint16_t INIT_EXPOSURE_LEVEL_INTEGER {0x2a9}; //!< exposure level set by init()
+    static constexpr uint8_t INIT_GAIN_LEVEL {0x10}; //!< gain level set by init()
+
     static constexpr uint8_t DEFAULT_EXPOSURE_LEVEL_FRACTION {0U};
     /**
      * @brief Set the sensor exposure level
@@ -58,26 +75,44 @@ public:
      * @return true if command was sent successfully, false otherwise
      */
     bool whitebalance(uint16_t red, uint16_t green, uint16_t blue);
-    bool capture();
+    bool capture(); //!< snapshot into the frame buffer at the SDRAM base, blocking!
+    /**
+     * @brief Capture a single 1280x800 frame, only supported at 13 fps. Blocking!
+     *
+     * @param frameBuffer destination of 1280 * 800 bytes, word aligned
+     * @return true if the frame was captured, false otherwise
+     */
+    bool capture(uint8_t* frameBuffer);
     void abortCapture();
 
 private:
-    static const std::map<uint16_t, uint8_t> build13FpsSequence();
-    static const std::map<uint16_t, uint8_t> build72FpsSequence();
-
+    // the public register accessors lock _mutex, the command and the auto exposure task share the i2c bus
+    bool writeMode(SensorMode mode); //!< must hold _mutex
+    uint16_t readChipId(); //!< must hold _mutex
+    bool writeExposure(uint16_t levelInteger, uint8_t levelFraction); //!< must hold _mutex
+    bool writeGain(uint8_t level, uint8_t band); //!< must hold _mutex
+    bool writeWhitebalance(uint16_t red, uint16_t green, uint16_t blue); //!< must hold _mutex
     bool i2cMasterReady();
     bool i2cSlaveReady(uint32_t retires = 1, uint32_t timeoutMs = 10);
         std::tuple<bool, uint8_t> readRegister(uint16_t address, uint32_t timeoutMs = 10);
 
     bool writeRegister(uint16_t address, uint8_t data, uint32_t timeoutMs = 10);
-    bool writeRegisters(const std::map<uint16_t, uint8_t>& registerValueMap, uint32_t timeoutMs = 10);
+    /**
+     * @brief Write a register sequence, consecutive addresses are written in one burst (auto increment).
+     *
+     * @param sequence to write
+     * @param active sequence currently configured in the sensor, only differing and runtime registers are written,
+     *        nullptr to write all registers
+     */
+    bool writeRegisters(const Ov9281Registers::Sequence& sequence, const Ov9281Registers::Sequence* active, uint32_t timeoutMs = 10);
+    bool writeBurst(uint16_t address, const uint8_t* data, size_t size, uint32_t timeoutMs);
 
     I2C_HandleTypeDef* _i2c;
     const uint16_t _i2cSlaveAddress;
     DCMI_HandleTypeDef* _dcmi;
-    Fps _fps {Fps::UNDEFINED};
-    const std::map<uint16_t, uint8_t> _init13Fps;
-    const std::map<uint16_t, uint8_t> _init72Fps;
+    SensorMode _mode {SensorMode::MODE_UNDEFINED};
+    Mutex _mutex;
+    static constexpr size_t _MAX_BURST_SIZE {32}; //!< data bytes per i2c transfer
 };
 
 #endif // VISIONADDON_APP_CAMERA_OV9281_H
\ No newline at end of file
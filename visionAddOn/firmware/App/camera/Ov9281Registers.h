@@ -0,0 +1,410 @@
+#ifndef VISIONADDON_APP_CAMERA_OV9281REGISTERS_H
+#define VISIONADDON_APP_CAMERA_OV9281REGISTERS_H
+
+#include "CameraTypes.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Register sequences of the Ov9281, stored in flash.
+//
+// initial sequences are based on
+// https://github.com/torvalds/linux/blob/master/drivers/media/i2c/ov9282.c
+// and then modified using Ov9281 and Ov9282 data sheets
+//
+// All sequences are sorted by address and contain the same addresses, so a mode switch only has to write
+// the registers which differ (see Ov9281::init) and consecutive addresses can be written in one burst.
+// Software reset and mode select are not part of the sequences, they are written by Ov9281::init.
+namespace Ov9281Registers {
+
+struct RegisterValue {
+    uint16_t address;
+    uint8_t value;
+};
+
+static constexpr size_t SEQUENCE_LENGTH {110};
+using Sequence = std::array<RegisterValue, SEQUENCE_LENGTH>;
+
+// default:
+//  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
+//  Value matched default register value as documented in OV9281 data sheet v1.53
+// non-default:
+//  Value as described in OV9282 Camera Module Application Notes R1.00 1280x800  RAW10 72 FPS DVP sequence.
+//  Value differs from default register value as documented in OV9281 data sheet v1.53.
+// user-modified:
+//  Value changed by user
+// user-added:
+//  Value not configured in reference sequence
+
+static constexpr Sequence SEQUENCE_13FPS {{
+    {0x0302, 0x30}, // pll1 multiplier[7:0]
+    {0x0303, 0x01}, // user-added, slow down PCLK <- slow down to 13 fps
+    {0x030d, 0x60}, // pll2 multiplier[7:0] -> 140
+    {0x030e, 0x06}, // pll2 system divider -> 1/4
+    {0x3001, 0x62}, // non-default, I/O pin drive capacity 4x
+    {0x3004, 0x01}, // non-default, output control enable D9
+    {0x3005, 0xfe}, // user-modified, output control enable D8-D2, disable D1
+    {0x3006, 0x62}, // user-modified, output control disable D0, enable PCLK, HREF, VYSNC
+    {0x3011, 0x0a}, // non-default, system control
+    {0x3013, 0x18}, // non-default, system control
+    {0x301c, 0xf0}, // non-default, system control
+    {0x3022, 0x07}, // non-default, system control
+    {0x3030, 0x10}, // default, system control
+    {0x3039, 0x2e}, // non-default, system control enable DVP
+    {0x303a, 0xf0}, // non-default, MIPI lane disable
+    {0x3500, 0x00}, // default, exposure control
+    {0x3501, 0x2a}, // non-default, exposure control
+    {0x3502, 0x90}, // non-default, exposure control
+    {0x3503, 0x08}, // non-default, AEC manual
+    {0x3505, 0x8c}, // non-default, gain conversation option
+    {0x3507, 0x03}, // non-default, gain shift
+    {0x3508, 0x00}, // unknown, undocumented debug register
+    {0x3509, 0x10}, // non-default, gain control
+    {0x3610, 0x80}, // unknown, undocumented analog register
+    {0x3611, 0xa0}, // unknown, undocumented analog register
+    {0x3620, 0x6e}, // unknown, undocumented analog register
+    {0x3632, 0x56}, // unknown, undocumented analog register
+    {0x3633, 0x78}, // unknown, undocumented analog register
+    {0x3662, 0x05}, // default, MIPI 2-lane, RAW10
+    {0x3666, 0x5a}, // non-default, VSYNC output select, internal frame sync fixed value 0
+    {0x366f, 0x7e}, // unknown, undocumented analog register
+    {0x3680, 0x84}, // unknown, undocumented analog register
+    {0x3712, 0x80}, // unknown, undocumented sensor control register
+    {0x372d, 0x22}, // unknown, undocumented sensor control register
+    {0x3731, 0x80}, // unknown, undocumented sensor control register
+    {0x3732, 0x30}, // unknown, undocumented sensor control register
+    {0x3778, 0x00}, // default, disable vertical binning
+    {0x377d, 0x22}, // unknown, undocumented sensor control register
+    {0x3788, 0x02}, // unknown, undocumented sensor control register
+    {0x3789, 0xa4}, // unknown, undocumented sensor control register
+    {0x378a, 0x00}, // unknown, undocumented sensor control register
+    {0x378b, 0x4a}, // unknown, undocumented sensor control register
+    {0x3799, 0x20}, // unknown, undocumented sensor control register
+    {0x3800, 0x00},
+    {0x3801, 0x00}, // default, Timing X addr start 0
+    {0x3802, 0x00},
+    {0x3803, 0x00}, // default, Timing Y addr start 0
+    {0x3804, 0x05},
+    {0x3805, 0x0f}, // default, Timing X addr end 1295
+    {0x3806, 0x03},
+    {0x3807, 0x2f}, // default, Timing X addr end 815
+    {0x3808, 0x05},
+    {0x3809, 0x00}, // default, Timing X output size 1280
+    {0x380a, 0x03},
+    {0x380b, 0x20}, // default, Timing Y output size 800
+    {0x380c, 0x0f},
+    {0x380d, 0xd8}, // user-modified, HTS 4056 <- slow down to 13 fps
+    {0x380e, 0x03},
+    {0x380f, 0x8e}, // default, VTS 910
+    {0x3810, 0x00},
+    {0x3811, 0x08}, // default, Timing ISP X win offset 8
+    {0x3812, 0x00},
+    {0x3813, 0x08}, // default, Timing ISP Y win offset 8
+    {0x3814, 0x11}, // default, Timing X increment odd 1 even 1
+    {0x3815, 0x11}, // default, Timing Y increment odd 1 even 1
+    {0x3820, 0x44}, // user-modified, flip image orientation
+    {0x3821, 0x04}, // user-modified, mirror image
+    {0x382c, 0x05},
+    {0x382d, 0xb0}, // default, HTS global TX 1456
+    {0x3881, 0x42}, // unknown, undocumented global shutter control
+    {0x3882, 0x01}, // unknown, undocumented global shutter control
+    {0x3883, 0x00}, // unknown, undocumented global shutter control
+    {0x3885, 0x02}, // unknown, undocumented global shutter control
+    {0x389d, 0x00}, // unknown, undocumented global shutter control
+    {0x38a8, 0x02}, // unknown, undocumented global shutter control
+    {0x38a9, 0x80}, // unknown, undocumented global shutter control
+    {0x38b1, 0x00}, // unknown, undocumented global shutter control
+    {0x38b3, 0x02}, // unknown, undocumented global shutter control
+    {0x38c4, 0x00}, // unknown, undocumented global shutter control
+    {0x38c5, 0xc0}, // unknown, undocumented global shutter control
+    {0x38c6, 0x04}, // unknown, undocumented global shutter control
+    {0x38c7, 0x80}, // unknown, undocumented global shutter control
+    {0x3920, 0xff}, // non-default, strobe pattern
+    {0x4003, 0x40}, // non-default, BLC
+    {0x4008, 0x04}, // non-default, BLC
+    {0x4009, 0x0b}, // non-default, BLC
+    {0x400c, 0x00}, // default, BLC
+    {0x400d, 0x07}, // default, BLC
+    {0x4010, 0x40}, // default, BLC
+    {0x4043, 0x40}, // non-default, BLC
+    {0x4307, 0x30}, // default, format control "embed_st"
+    {0x4317, 0x01}, // non-default, enable DVP
+    {0x4501, 0x00}, // unknown, undocumented readout control registers
+    {0x4507, 0x00}, // unknown, undocumented readout control registers
+    {0x4509, 0x00}, // unknown, undocumented readout control register
+    {0x450a, 0x08}, // unknown, undocumented readout control register
+    {0x4601, 0x04}, // default, VFIFO read start point
+    {0x470f, 0xe0}, // non-default, DVP control "Reserved" section of BYP_SEL register
+    {0x4800, 0x00}, // non-default, MIPI control
+    {0x4f00, 0x00}, // user-modified, low power control pclk free running
+    {0x4f07, 0x00}, // non-default, low power mode control
+    {0x4f10, 0x00}, // low power control "ana_psv_pch[15:8]"
+    {0x4f11, 0x98}, // low power control "ana_psv_pch[7:0]" -> 152
+    {0x4f12, 0x0f}, // low power control "ana_psv_stm[15:8]"
+    {0x4f13, 0xc4}, // low power control "ana_psv_stm[7:0]" -> 4036
+    {0x5000, 0x9f}, // default, BLC enable
+    {0x5001, 0x00}, // default, ISP control
+    {0x5d00, 0x0b}, // undocumented sensor control register
+    {0x5d01, 0x02}, // undocumented sensor control register
+    {0x5e00, 0x00}, // default, disable test pattern (0x80 to enable)
+}};
+
+static constexpr Sequence SEQUENCE_72FPS {{
+    {0x0302, 0x30}, // pll1 multiplier[7:0]
+    {0x0303, 0x00}, // default, pll1 divider, listed to match the 13 fps sequence
+    {0x030d, 0x60}, // pll2 multiplier[7:0] -> 140
+    {0x030e, 0x06}, // pll2 system divider -> 1/4
+    {0x3001, 0x62}, // non-default, I/O pin drive capacity 4x
+    {0x3004, 0x01}, // non-default, output control enable D9
+    {0x3005, 0xfe}, // user-modified, output control enable D8-D2, disable D1
+    {0x3006, 0x62}, // user-modified, output control disable D0, enable PCLK, HREF, VYSNC
+    {0x3011, 0x0a}, // non-default, system control
+    {0x3013, 0x18}, // non-default, system control
+    {0x301c, 0xf0}, // non-default, system control
+    {0x3022, 0x07}, // non-default, system control
+    {0x3030, 0x10}, // default, system control
+    {0x3039, 0x2e}, // non-default, system control enable DVP
+    {0x303a, 0xf0}, // non-default, MIPI lane disable
+    {0x3500, 0x00}, // default, exposure control
+    {0x3501, 0x2a}, // non-default, exposure control
+    {0x3502, 0x90}, // non-default, exposure control
+    {0x3503, 0x08}, // non-default, AEC manual
+    {0x3505, 0x8c}, // non-default, gain conversation option
+    {0x3507, 0x03}, // non-default, gain shift
+    {0x3508, 0x00}, // unknown, undocumented debug register
+    {0x3509, 0x10}, // non-default, gain control
+    {0x3610, 0x80}, // unknown, undocumented analog register
+    {0x3611, 0xa0}, // unknown, undocumented analog register
+    {0x3620, 0x6e}, // unknown, undocumented analog register
+    {0x3632, 0x56}, // unknown, undocumented analog register
+    {0x3633, 0x78}, // unknown, undocumented analog register
+    {0x3662, 0x05}, // default, MIPI 2-lane, RAW10
+    {0x3666, 0x5a}, // non-default, VSYNC output select, internal frame sync fixed value 0
+    {0x366f, 0x7e}, // unknown, undocumented analog register
+    {0x3680, 0x84}, // unknown, undocumented analog register
+    {0x3712, 0x80}, // unknown, undocumented sensor control register
+    {0x372d, 0x22}, // unknown, undocumented sensor control register
+    {0x3731, 0x80}, // unknown, undocumented sensor control register
+    {0x3732, 0x30}, // unknown, undocumented sensor control register
+    {0x3778, 0x00}, // default, disable vertical binning
+    {0x377d, 0x22}, // unknown, undocumented sensor control register
+    {0x3788, 0x02}, // unknown, undocumented sensor control register
+    {0x3789, 0xa4}, // unknown, undocumented sensor control register
+    {0x378a, 0x00}, // unknown, undocumented sensor control register
+    {0x378b, 0x4a}, // unknown, undocumented sensor control register
+    {0x3799, 0x20}, // unknown, undocumented sensor control register
+    {0x3800, 0x00},
+    {0x3801, 0x00}, // default, Timing X addr start 0
+    {0x3802, 0x00},
+    {0x3803, 0x00}, // default, Timing Y addr start 0
+    {0x3804, 0x05},
+    {0x3805, 0x0f}, // default, Timing X addr end 1295
+    {0x3806, 0x03},
+    {0x3807, 0x2f}, // default, Timing X addr end 815
+    {0x3808, 0x05},
+    {0x3809, 0x00}, // default, Timing X output size 1280
+    {0x380a, 0x03},
+    {0x380b, 0x20}, // default, Timing Y output size 800
+    {0x380c, 0x02},
+    {0x380d, 0xd8}, // default, HTS 728
+    {0x380e, 0x03},
+    {0x380f, 0x8e}, // default, VTS 910
+    {0x3810, 0x00},
+    {0x3811, 0x08}, // default, Timing ISP X win offset 8
+    {0x3812, 0x00},
+    {0x3813, 0x08}, // default, Timing ISP Y win offset 8
+    {0x3814, 0x11}, // default, Timing X increment odd 1 even 1
+    {0x3815, 0x11}, // default, Timing Y increment odd 1 even 1
+    {0x3820, 0x44}, // user-modified, flip image orientation
+    {0x3821, 0x04}, // user-modified, mirror image
+    {0x382c, 0x05},
+    {0x382d, 0xb0}, // default, HTS global TX 1456
+    {0x3881, 0x42}, // unknown, undocumented global shutter control
+    {0x3882, 0x01}, // unknown, undocumented global shutter control
+    {0x3883, 0x00}, // unknown, undocumented global shutter control
+    {0x3885, 0x02}, // unknown, undocumented global shutter control
+    {0x389d, 0x00}, // unknown, undocumented global shutter control
+    {0x38a8, 0x02}, // unknown, undocumented global shutter control
+    {0x38a9, 0x80}, // unknown, undocumented global shutter control
+    {0x38b1, 0x00}, // unknown, undocumented global shutter control
+    {0x38b3, 0x02}, // unknown, undocumented global shutter control
+    {0x38c4, 0x00}, // unknown, undocumented global shutter control
+    {0x38c5, 0xc0}, // unknown, undocumented global shutter control
+    {0x38c6, 0x04}, // unknown, undocumented global shutter control
+    {0x38c7, 0x80}, // unknown, undocumented global shutter control
+    {0x3920, 0xff}, // non-default, strobe pattern
+    {0x4003, 0x40}, // non-default, BLC
+    {0x4008, 0x04}, // non-default, BLC
+    {0x4009, 0x0b}, // non-default, BLC
+    {0x400c, 0x00}, // default, BLC
+    {0x400d, 0x07}, // default, BLC
+    {0x4010, 0x40}, // default, BLC
+    {0x4043, 0x40}, // non-default, BLC
+    {0x4307, 0x30}, // default, format control "embed_st"
+    {0x4317, 0x01}, // non-default, enable DVP
+    {0x4501, 0x00}, // unknown, undocumented readout control registers
+    {0x4507, 0x00}, // unknown, undocumented readout control registers
+    {0x4509, 0x00}, // unknown, undocumented readout control register
+    {0x450a, 0x08}, // unknown, undocumented readout control register
+    {0x4601, 0x04}, // default, VFIFO read start point
+    {0x470f, 0xe0}, // non-default, DVP control "Reserved" section of BYP_SEL register
+    {0x4800, 0x00}, // non-default, MIPI control
+    {0x4f00, 0x00}, // user-modified, low power control pclk free running
+    {0x4f07, 0x00}, // non-default, low power mode control
+    {0x4f10, 0x00}, // low power control "ana_psv_pch[15:8]"
+    {0x4f11, 0x98}, // low power control "ana_psv_pch[7:0]" -> 152
+    {0x4f12, 0x0f}, // low power control "ana_psv_stm[15:8]"
+    {0x4f13, 0xc4}, // low power control "ana_psv_stm[7:0]" -> 4036
+    {0x5000, 0x9f}, // default, BLC enable
+    {0x5001, 0x00}, // default, ISP control
+    {0x5d00, 0x0b}, // undocumented sensor control register
+    {0x5d01, 0x02}, // undocumented sensor control register
+    {0x5e00, 0x00}, // default, disable test pattern (0x80 to enable)
+}};
+
+// The overlays are applied on top of the 72 fps sequence, they only contain the registers which differ.
+// Row period (HTS 728) is kept, the frame rate is raised by shortening the frame length (VTS).
+// Exposure is lowered to stay below VTS - 25, see SENSOR_MODES.
+// Values marked "linux" are taken from the 640x400 mode of the linux ov9282 driver.
+
+static constexpr std::array<RegisterValue, 20> OVERLAY_BINNED_144FPS {{
+    {0x3501, 0x1a},
+    {0x3502, 0x00}, // user-modified, exposure 0x1a0 <- below VTS - 25
+    {0x3778, 0x10}, // linux, enable vertical binning
+    {0x3808, 0x02},
+    {0x3809, 0x80}, // linux, Timing X output size 640
+    {0x380a, 0x01},
+    {0x380b, 0x90}, // linux, Timing Y output size 400
+    {0x380e, 0x01},
+    {0x380f, 0xc7}, // user-modified, VTS 455 -> 144 fps
+    {0x3811, 0x04}, // linux, Timing ISP X win offset 4
+    {0x3813, 0x04}, // linux, Timing ISP Y win offset 4
+    {0x3814, 0x31}, // linux, Timing X increment odd 3 even 1
+    {0x3815, 0x22}, // linux, Timing Y increment odd 2 even 2
+    {0x3820, 0x64}, // linux, vertical binning, user-modified flip image orientation
+    {0x3821, 0x05}, // linux, horizontal binning, user-modified mirror image
+    {0x4008, 0x02}, // linux, BLC
+    {0x4009, 0x05}, // linux, BLC
+    {0x400d, 0x03}, // linux, BLC
+    {0x4507, 0x03}, // linux, undocumented readout control register
+    {0x4509, 0x80}, // linux, undocumented readout control register
+}};
+
+static constexpr std::array<RegisterValue, 16> OVERLAY_WINDOW_144FPS {{
+    {0x3501, 0x1a},
+    {0x3502, 0x00}, // user-modified, exposure 0x1a0 <- below VTS - 25
+    {0x3800, 0x01},
+    {0x3801, 0x40}, // user-modified, Timing X addr start 320
+    {0x3802, 0x00},
+    {0x3803, 0xc8}, // user-modified, Timing Y addr start 200
+    {0x3804, 0x03},
+    {0x3805, 0xcf}, // user-modified, Timing X addr end 975
+    {0x3806, 0x02},
+    {0x3807, 0x67}, // user-modified, Timing Y addr end 615
+    {0x3808, 0x02},
+    {0x3809, 0x80}, // user-modified, Timing X output size 640
+    {0x380a, 0x01},
+    {0x380b, 0x90}, // user-modified, Timing Y output size 400
+    {0x380e, 0x01},
+    {0x380f, 0xc7}, // user-modified, VTS 455 -> 144 fps
+}};
+
+static constexpr std::array<RegisterValue, 16> OVERLAY_WINDOW_240FPS {{
+    {0x3501, 0x0f},
+    {0x3502, 0x00}, // user-modified, exposure 0x0f0 <- below VTS - 25
+    {0x3800, 0x01},
+    {0x3801, 0x40}, // user-modified, Timing X addr start 320
+    {0x3802, 0x01},
+    {0x3803, 0x2c}, // user-modified, Timing Y addr start 300
+    {0x3804, 0x03},
+    {0x3805, 0xcf}, // user-modified, Timing X addr end 975
+    {0x3806, 0x02},
+    {0x3807, 0x03}, // user-modified, Timing Y addr end 515
+    {0x3808, 0x02},
+    {0x3809, 0x80}, // user-modified, Timing X output size 640
+    {0x380a, 0x00},
+    {0x380b, 0xc8}, // user-modified, Timing Y output size 200
+    {0x380e, 0x01},
+    {0x380f, 0x11}, // user-modified, VTS 273 -> 240 fps
+}};
+
+template<size_t N>
+constexpr bool sortedAndUnique(const std::array<RegisterValue, N>& registers) {
+    for(size_t i = 1; i < N; i++) {
+        if(registers[i - 1].address >= registers[i].address) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool sameAddresses(const Sequence& a, const Sequence& b) {
+    for(size_t i = 0; i < SEQUENCE_LENGTH; i++) {
+        if(a[i].address != b[i].address) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true if every overlay address is part of the base sequence
+template<size_t N>
+constexpr bool overlayCovered(const Sequence& base, const std::array<RegisterValue, N>& overlay) {
+    size_t j = 0;
+    for(size_t i = 0; (i < SEQUENCE_LENGTH) && (j < N); i++) {
+        if(base[i].address == overlay[j].address) {
+            j++;
+        }
+    }
+    return j == N;
+}
+
+template<size_t N>
+constexpr Sequence applyOverlay(const Sequence& base, const std::array<RegisterValue, N>& overlay) {
+    Sequence sequence {base};
+    size_t j = 0;
+    for(size_t i = 0; (i < SEQUENCE_LENGTH) && (j < N); i++) {
+        if(sequence[i].address == overlay[j].address) {
+            sequence[i].value = overlay[j].value;
+            j++;
+        }
+    }
+    return sequence;
+}
+
+static_assert(sortedAndUnique(SEQUENCE_13FPS));
+static_assert(sortedAndUnique(SEQUENCE_72FPS));
+static_assert(sameAddresses(SEQUENCE_13FPS, SEQUENCE_72FPS));
+static_assert(sortedAndUnique(OVERLAY_BINNED_144FPS) && overlayCovered(SEQUENCE_72FPS, OVERLAY_BINNED_144FPS));
+static_assert(sortedAndUnique(OVERLAY_WINDOW_144FPS) && overlayCovered(SEQUENCE_72FPS, OVERLAY_WINDOW_144FPS));
+static_assert(sortedAndUnique(OVERLAY_WINDOW_240FPS) && overlayCovered(SEQUENCE_72FPS, OVERLAY_WINDOW_240FPS));
+
+static constexpr Sequence SEQUENCE_BINNED_144FPS {applyOverlay(SEQUENCE_72FPS, OVERLAY_BINNED_144FPS)};
+static constexpr Sequence SEQUENCE_WINDOW_144FPS {applyOverlay(SEQUENCE_72FPS, OVERLAY_WINDOW_144FPS)};
+static constexpr Sequence SEQUENCE_WINDOW_240FPS {applyOverlay(SEQUENCE_72FPS, OVERLAY_WINDOW_240FPS)};
+
+/**
+ * @brief Look up the full register sequence of a sensor mode.
+ *
+ * @return sequence, nullptr if mode is not supported
+ */
+static constexpr const Sequence* sequence(SensorMode mode) {
+    switch(mode) {
+        case SensorMode::MODE_1280X800_13FPS: return &SEQUENCE_13FPS;
+        case SensorMode::MODE_1280X800_72FPS: return &SEQUENCE_72FPS;
+        case SensorMode::MODE_640X400_BINNED_144FPS: return &SEQUENCE_BINNED_144FPS;
+        case SensorMode::MODE_640X400_WINDOW_144FPS: return &SEQUENCE_WINDOW_144FPS;
+        case SensorMode::MODE_640X200_WINDOW_240FPS: return &SEQUENCE_WINDOW_240FPS;
+        default: return nullptr;
+    }
+}
+
+// registers changed at runtime by Ov9281::exposure and Ov9281::gain, always written on a mode switch
+// so the mode defaults apply regardless of the previous values
+static constexpr uint16_t RUNTIME_ADDRESS_FIRST {0x3500};
+static constexpr uint16_t RUNTIME_ADDRESS_LAST {0x3509};
+
+} // namespace Ov9281Registers
+
+#endif // VISIONADDON_APP_CAMERA_OV9281REGISTERS_H
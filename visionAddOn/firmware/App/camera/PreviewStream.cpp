@@ -0,0 +1,123 @@
+#include "PreviewStream.h"
+
+#include "cmsis_os2.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/CycleCounter.h"
+#include "utils/image/ImageKernels.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+PreviewStream::PreviewStream(Ov9281& camera, FrameHistory& frameHistory, Subscriptions& subscriptions, uint8_t* frame) :
+_camera{camera},
+_frameHistory{frameHistory},
+_subscriptions{subscriptions},
+_frame{frame}
+{
+    ASSERT(frame != nullptr);
+    _state.config = _config;
+}
+
+void PreviewStream::run()
+{
+    _mutex.lock();
+    const PreviewConfig config = _config;
+    _mutex.unlock();
+    _nextFrameTick += TICKS_PER_SECOND / config.fpsMax;
+    if(osDelayUntil(_nextFrameTick) != osOK) {
+        // idle or fell behind, start over instead of catching up
+        _nextFrameTick = osKernelGetTickCount();
+    }
+
+    if(_camera.mode() != SensorMode::MODE_1280X800_13FPS) {
+        return;
+    }
+    Subscriptions::Destinations destinations {};
+    const size_t count = _subscriptions.next(SubscriberStream::STREAM_PREVIEW, destinations);
+    if(count == 0) {
+        return;
+    }
+    if(!_frameHistory.capture(_frame)) {
+        _mutex.lock();
+        _state.captureFailures++;
+        _mutex.unlock();
+        return;
+    }
+
+    const size_t width = FRAME_WIDTH / config.factor;
+    const size_t height = FRAME_HEIGHT / config.factor;
+    const size_t rowsPerDatagram = PreviewPacket::PAYLOAD_SIZE / width;
+    uint32_t filterCycles = 0;
+    uint32_t datagramsFailed = 0;
+    bool sent = false;
+    for(size_t firstRow = 0; firstRow < height; firstRow += rowsPerDatagram) {
+        const size_t rows = std::min(rowsPerDatagram, height - firstRow);
+        struct pbuf* datagram = pbuf_alloc(PBUF_RAW, static_cast<uint16_t>(PreviewPacket::HEADER_SIZE + (rows * width)), PBUF_RAM);
+        if(datagram == nullptr) {
+            datagramsFailed++;
+            continue;
+        }
+        uint8_t* header = static_cast<uint8_t*>(datagram->payload);
+        const uint16_t header16[] {_sequence, static_cast<uint16_t>(width), static_cast<uint16_t>(height), static_cast<uint16_t>(firstRow)};
+        std::memcpy(header + PreviewPacket::OFFSET_SEQUENCE, header16, sizeof(header16));
+        header[PreviewPacket::OFFSET_ROWS] = static_cast<uint8_t>(rows);
+        header[PreviewPacket::OFFSET_FACTOR] = config.factor;
+        const uint32_t start = CycleCounter::now();
+        scale(_frame, firstRow, rows, config.factor, config.filter, header + PreviewPacket::HEADER_SIZE);
+        filterCycles += CycleCounter::now() - start;
+        const size_t handed = _udpSender.sendTo(datagram, destinations.data(), count);
+        sent = sent || (handed > 0);
+        if(handed != count) {
+            datagramsFailed++;
+        }
+    }
+    _sequence++;
+
+    _mutex.lock();
+    if(sent) {
+        _state.framesSent++;
+    }
+    _state.datagramsFailed += datagramsFailed;
+    _state.filterCyclesLast = filterCycles;
+    _state.filterCyclesMax = std::max(_state.filterCyclesMax, filterCycles);
+    _mutex.unlock();
+}
+
+bool PreviewStream::config(const PreviewConfig& config)
+{
+    if(!config.valid()) {
+        Log::warning("[PreviewStream] invalid config, factor %u, filter %u, fps max %u", config.factor, config.filter, config.fpsMax);
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    _state.config = config;
+    _state.filterCyclesMax = 0;
+    _mutex.unlock();
+    Log::info("[PreviewStream] %ux%u, filter %u, at most %u fps", FRAME_WIDTH / config.factor, FRAME_HEIGHT / config.factor, config.filter, config.fpsMax);
+    return true;
+}
+
+PreviewState PreviewStream::state()
+{
+    _mutex.lock();
+    const PreviewState state = _state;
+    _mutex.unlock();
+    return state;
+}
+
+void PreviewStream::scale(const uint8_t* frame, size_t firstRow, size_t rows, uint8_t factor, PreviewFilter filter, uint8_t* out)
+{
+    const size_t width = FRAME_WIDTH / factor;
+    for(size_t row = firstRow; row < (firstRow + rows); row++) {
+        const uint8_t* source = frame + (row * factor * FRAME_WIDTH);
+        if(filter == PreviewFilter::PREVIEW_DECIMATE) {
+            ImageKernels::decimate(source, FRAME_WIDTH, factor, out);
+        } else {
+            ImageKernels::boxDown(source, FRAME_WIDTH, FRAME_WIDTH, factor, _sums.data(), out);
+        }
+        out += width;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef VISIONADDON_APP_CAMERA_PREVIEWSTREAM_H
+#define VISIONADDON_APP_CAMERA_PREVIEWSTREAM_H
+
+#include "CameraTypes.h"
+#include "FrameHistory.h"
+#include "Ov9281.h"
+#include "network/Subscriptions.h"
+#include "network/UdpSender.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// layout of the preview datagrams, see App/camera/previewPacket.md
+namespace PreviewPacket {
+    static constexpr size_t OFFSET_SEQUENCE {0}; //!< U16 frame sequence
+    static constexpr size_t OFFSET_WIDTH {2}; //!< U16 preview width in px
+    static constexpr size_t OFFSET_HEIGHT {4}; //!< U16 preview height in px
+    static constexpr size_t OFFSET_FIRST_ROW {6}; //!< U16 first preview row in the datagram
+    static constexpr size_t OFFSET_ROWS {8}; //!< U8 rows in the datagram
+    static constexpr size_t OFFSET_FACTOR {9}; //!< U8 full resolution px per preview px, per axis
+    static constexpr size_t HEADER_SIZE {10};
+    static constexpr size_t PAYLOAD_SIZE {1280}; //!< rows per datagram times the width, fits a single ethernet frame
+}
+
+// Decimated preview video for aiming and rig setup, streamed to the preview subscribers over udp.
+//
+// Frames are only captured while at least one preview subscriber is due and the sensor runs at 13 fps.
+// A full frame is captured into its own SDRAM buffer (through the frame history, which shares the DCMI) and
+// scaled down row band by row band straight into the datagrams, 320x200 or 160x100 at 8 bpp.
+// The rate is limited by fpsMax and by the snapshot capture, which takes one to two sensor frames.
+// The blob path is not involved.
+class PreviewStream final : public IRunnable {
+public:
+    /**
+     * @param frame capture buffer of FrameHistory::FRAME_SIZE bytes, word aligned
+     */
+    PreviewStream(Ov9281& camera, FrameHistory& frameHistory, Subscriptions& subscriptions, uint8_t* frame);
+    PreviewStream (const PreviewStream&) = delete;
+    PreviewStream& operator=(const PreviewStream&) = delete;
+    PreviewStream (const PreviewStream&&) = delete;
+    PreviewStream& operator=(const PreviewStream&&) = delete;
+
+    void run() override; //!< one preview frame per call, paced by fpsMax, blocking!
+
+    bool config(const PreviewConfig& config); //!< @return false if the config is invalid
+    PreviewState state();
+
+    /**
+     * @brief Scale preview rows out of a full resolution frame.
+     *
+     * @param frame 1280x800, word aligned
+     * @param firstRow first preview row
+     * @param rows preview rows to scale
+     * @param out rows * 1280 / factor bytes
+     */
+    void scale(const uint8_t* frame, size_t firstRow, size_t rows, uint8_t factor, PreviewFilter filter, uint8_t* out);
+
+    static constexpr size_t FRAME_WIDTH {1280};
+    static constexpr size_t FRAME_HEIGHT {800};
+
+private:
+    Ov9281& _camera;
+    FrameHistory& _frameHistory;
+    Subscriptions& _subscriptions;
+    uint8_t* _frame;
+    UdpSender _udpSender; //!< unconnected, one pcb for all subscribers
+    Mutex _mutex;
+    PreviewConfig _config {};
+    PreviewState _state {};
+    uint16_t _sequence {0};
+    uint32_t _nextFrameTick {0};
+
+    // streaming task only
+    std::array<uint32_t, FRAME_WIDTH / 4> _sums {}; //!< box filter sums of one preview row
+};
+
+#endif // VISIONADDON_APP_CAMERA_PREVIEWSTREAM_H
@@ -6,11 +6,14 @@
 #include "lwip.h"
 #include "lwip/arch.h"
 #include "lwip/opt.h"
+#include "metrics/BootTimeline.h"
 #include "string.h"
 #include "utils/assert.h"
+#include "utils/interrupt/InterruptProfiler.h"
 #include "utils/Log.h"
 #include "tcpip.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <errno.h>
@@ -22,13 +25,17 @@
 // interface based on STM32CubeF7/Projects/STM32F769I-Discovery/Applications/LwIP/LwIP_HTTP_Server_Socket_RTOS/Src/main.c
 // socket based on STM32CubeF7/Projects/STM32F769I-Discovery/Applications/LwIP/LwIP_HTTP_Server_Socket_RTOS/Src/httpserver-socket.c
 CommandHandler::CommandHandler(
-  IStorage& storage,
+  CalibrationManager& calibrationManager,
   CameraRequestCapture cameraRequestCapture,
   CameraRequestFrameTransfer cameraRequestFrameTransfer,
   CameraSetWhitebalance cameraSetWhitebalance,
   CameraSetExposure cameraSetExposure,
   CameraSetGain cameraSetGain,
   CameraSetFps cameraSetFps,
+  CameraSetMode cameraSetMode,
+  CameraGetMode cameraGetMode,
+  CameraSetPreview cameraSetPreview,
+  CameraGetPreview cameraGetPreview,
   NetworkGetMac networkGetMac,
   NetworkSetMac networkSetMac,
   NetworkGetIp networkGetIp,
@@ -38,21 +45,59 @@ CommandHandler::CommandHandler(
   NetworkGetGateway networkGetGateway,
   NetworkSetGateway networkSetGateway,
   NetworkPersistConfig networkPersistConfig,
+  NetworkBenchmarkStart networkBenchmarkStart,
+  NetworkBenchmarkGetResult networkBenchmarkGetResult,
+  NetworkSubscribe networkSubscribe,
+  NetworkUnsubscribe networkUnsubscribe,
+  NetworkGetSubscribers networkGetSubscribers,
   PipelineSetInput pipelineSetInput,
   PipelineSetOutput pipelineSetOutput,
   PipelineSetBinarizationThreshold pipelineSetBinarizationThreshold,
+  PipelineGetStreamStats pipelineGetStreamStats,
+  PipelineSetTransport pipelineSetTransport,
+  PipelineSetTracking pipelineSetTracking,
+  PipelineGetTracking pipelineGetTracking,
+  PipelineSetBlinkCodes pipelineSetBlinkCodes,
+  PipelineGetBlinkCodes pipelineGetBlinkCodes,
+  PipelineSetDeltaEncoding pipelineSetDeltaEncoding,
+  PipelineGetDeltaEncoding pipelineGetDeltaEncoding,
+  PipelineSetStreaming pipelineSetStreaming,
   StrobeEnablePulse strobeEnablePulse,
   StrobeSetOnDelay strobeSetOnDelay,
   StrobeSetHoldTime strobeSetHoldTime,
-  StrobeEnableConstant strobeEnableConstant
+  StrobeEnableConstant strobeEnableConstant,
+  AutoExposureEnable autoExposureEnable,
+  AutoExposureSetConfig autoExposureSetConfig,
+  AutoExposureGetConfig autoExposureGetConfig,
+  AutoExposureGetState autoExposureGetState,
+  RecorderSetConfig recorderSetConfig,
+  RecorderGetState recorderGetState,
+  RecorderFetch recorderFetch,
+  FrameHistorySetConfig frameHistorySetConfig,
+  FrameHistoryGetState frameHistoryGetState,
+  FrameHistoryTrigger frameHistoryTrigger,
+  FrameHistoryTransfer frameHistoryTransfer,
+  MetricsGet metricsGet,
+  TaskProfileGet taskProfileGet,
+  MemoryBenchmarkRun memoryBenchmarkRun,
+  ImageKernelBenchmarkRun imageKernelBenchmarkRun,
+  SdramTestStart sdramTestStart,
+  SdramTestGetState sdramTestGetState,
+  BroadcastAwait broadcastAwait,
+  NetworkTimeSyncSetConfig networkTimeSyncSetConfig,
+  NetworkTimeSyncGetState networkTimeSyncGetState
 ):
-_storage{storage},
+_calibrationManager{calibrationManager},
 _cameraRequestCapture{std::move(cameraRequestCapture)},
 _cameraRequestFrameTransfer{std::move(cameraRequestFrameTransfer)},
 _cameraSetWhitebalance{std::move(cameraSetWhitebalance)},
 _cameraSetExposure{std::move(cameraSetExposure)},
 _cameraSetGain{std::move(cameraSetGain)},
 _cameraSetFps{std::move(cameraSetFps)},
+_cameraSetMode{std::move(cameraSetMode)},
+_cameraGetMode{std::move(cameraGetMode)},
+_cameraSetPreview{std::move(cameraSetPreview)},
+_cameraGetPreview{std::move(cameraGetPreview)},
 _networkGetMac{std::move(networkGetMac)},
 _networkSetMac{std::move(networkSetMac)},
 _networkGetIp{std::move(networkGetIp)},
@@ -62,13 +107,47 @@ _networkSetNetmask{std::move(networkSetNetmask)},
 _networkGetGateway{std::move(networkGetGateway)},
 _networkSetGateway{std::move(networkSetGateway)},
 _networkPersistConfig{std::move(networkPersistConfig)},
+_networkBenchmarkStart{std::move(networkBenchmarkStart)},
+_networkBenchmarkGetResult{std::move(networkBenchmarkGetResult)},
+_networkSubscribe{std::move(networkSubscribe)},
+_networkUnsubscribe{std::move(networkUnsubscribe)},
+_networkGetSubscribers{std::move(networkGetSubscribers)},
 _pipelineSetInput{std::move(pipelineSetInput)},
 _pipelineSetOutput{std::move(pipelineSetOutput)},
 _pipelineSetBinarizationThreshold{std::move(pipelineSetBinarizationThreshold)},
+_pipelineGetStreamStats{std::move(pipelineGetStreamStats)},
+_pipelineSetTransport{std::move(pipelineSetTransport)},
+_pipelineSetTracking{std::move(pipelineSetTracking)},
+_pipelineGetTracking{std::move(pipelineGetTracking)},
+_pipelineSetBlinkCodes{std::move(pipelineSetBlinkCodes)},
+_pipelineGetBlinkCodes{std::move(pipelineGetBlinkCodes)},
+_pipelineSetDeltaEncoding{std::move(pipelineSetDeltaEncoding)},
+_pipelineGetDeltaEncoding{std::move(pipelineGetDeltaEncoding)},
+_pipelineSetStreaming{std::move(pipelineSetStreaming)},
 _strobeEnablePulse{std::move(strobeEnablePulse)},
 _strobeSetOnDelay{std::move(strobeSetOnDelay)},
 _strobeSetHoldTime{std::move(strobeSetHoldTime)},
-_strobeEnableConstant{std::move(strobeEnableConstant)}
+_strobeEnableConstant{std::move(strobeEnableConstant)},
+_autoExposureEnable{std::move(autoExposureEnable)},
+_autoExposureSetConfig{std::move(autoExposureSetConfig)},
+_autoExposureGetConfig{std::move(autoExposureGetConfig)},
+_autoExposureGetState{std::move(autoExposureGetState)},
+_recorderSetConfig{std::move(recorderSetConfig)},
+_recorderGetState{std::move(recorderGetState)},
+_recorderFetch{std::move(recorderFetch)},
+_frameHistorySetConfig{std::move(frameHistorySetConfig)},
+_frameHistoryGetState{std::move(frameHistoryGetState)},
+_frameHistoryTrigger{std::move(frameHistoryTrigger)},
+_frameHistoryTransfer{std::move(frameHistoryTransfer)},
+_metricsGet{std::move(metricsGet)},
+_taskProfileGet{std::move(taskProfileGet)},
+_memoryBenchmarkRun{std::move(memoryBenchmarkRun)},
+_imageKernelBenchmarkRun{std::move(imageKernelBenchmarkRun)},
+_sdramTestStart{std::move(sdramTestStart)},
+_sdramTestGetState{std::move(sdramTestGetState)},
+_broadcastAwait{std::move(broadcastAwait)},
+_networkTimeSyncSetConfig{std::move(networkTimeSyncSetConfig)},
+_networkTimeSyncGetState{std::move(networkTimeSyncGetState)}
 {
 }
 
@@ -91,6 +170,20 @@ void CommandHandler::init() {
   // listen for incoming connections (TCP listen backlog = 5)
   lwip_listen(_serverSocket, 5);
   Log::info("[CommandHandler] listening on port %u", SERVER_SOCKET_PORT);
+
+  // broadcast commands, one datagram reaches every device on the subnet
+  _broadcastSocket = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+  if (_broadcastSocket < 0) {
+    Log::error("[CommandHandler] Socket error: %d", errno);
+  }
+  ASSERT(_broadcastSocket >= 0);
+  struct sockaddr_in broadcastAddress {};
+  broadcastAddress.sin_family = AF_INET;
+  broadcastAddress.sin_port = htons(PORT_COMMAND_BROADCAST);
+  broadcastAddress.sin_addr.s_addr = INADDR_ANY;
+  ret = lwip_bind(_broadcastSocket, (struct sockaddr *)&broadcastAddress, sizeof (broadcastAddress));
+  ASSERT(ret >= 0);
+  Log::info("[CommandHandler] listening for broadcasts on port %u", PORT_COMMAND_BROADCAST);
 }
 
 bool CommandHandler::deserialize(const uint8_t* buffer, const size_t size) {
@@ -121,11 +214,104 @@ bool CommandHandler::handle() {
       Log::level(level);
       return true;
     }
+    case CommandIds::INTERRUPT_GET_STATS : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] INTERRUPT_GET_STATS: abort, invalid command format");
+        return false;
+      }
+      const uint8_t source = _requestPacket.data()[0];
+      if(source >= NUMBER_OF_INTERRUPT_SOURCES) {
+        Log::warning("[CommandHandler] invalid interrupt source %u", source);
+        return false;
+      }
+      const InterruptStats interruptStats = InterruptProfiler::stats(static_cast<InterruptSource>(source));
+      static_assert(InterruptStats::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(InterruptStats::SIZE);
+      return interruptStats.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::METRICS_GET : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] METRICS_GET: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const RuntimeMetrics runtimeMetrics = _metricsGet();
+      static_assert(RuntimeMetrics::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(RuntimeMetrics::SIZE);
+      return runtimeMetrics.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::TASK_PROFILE_GET : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] TASK_PROFILE_GET: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const uint8_t index = _requestPacket.data()[0];
+      const TaskProfile taskProfile = _taskProfileGet();
+      if(index >= taskProfile.taskCount) {
+        Log::warning("[CommandHandler] TASK_PROFILE_GET: invalid task index %u, %u tasks", index, taskProfile.taskCount);
+        return false;
+      }
+      static_assert(TaskProfile::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(TaskProfile::SIZE);
+      return taskProfile.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX, index);
+    }
+    case CommandIds::MEMORY_BENCHMARK_RUN : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] MEMORY_BENCHMARK_RUN: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const MemoryBenchmarkResult memoryBenchmarkResult = _memoryBenchmarkRun();
+      static_assert(MemoryBenchmarkResult::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(MemoryBenchmarkResult::SIZE);
+      return memoryBenchmarkResult.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::IMAGE_KERNEL_BENCHMARK_RUN : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] IMAGE_KERNEL_BENCHMARK_RUN: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const uint8_t threshold = _requestPacket.data()[0];
+      const ImageKernelBenchmarkResult imageKernelBenchmarkResult = _imageKernelBenchmarkRun(threshold);
+      static_assert(ImageKernelBenchmarkResult::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(ImageKernelBenchmarkResult::SIZE);
+      return imageKernelBenchmarkResult.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::BOOT_TIMELINE_GET : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] BOOT_TIMELINE_GET: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const BootTimes bootTimes = BootTimeline::times();
+      static_assert(BootTimes::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(BootTimes::SIZE);
+      return bootTimes.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::SDRAM_TEST_START : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] SDRAM_TEST_START: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const uint8_t region = _requestPacket.data()[0];
+      if(region >= NUMBER_OF_SDRAM_REGIONS) {
+        Log::warning("[CommandHandler] invalid sdram region %u", region);
+        return false;
+      }
+      return _sdramTestStart(static_cast<SdramRegion>(region));
+    }
+    case CommandIds::SDRAM_TEST_GET_STATE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] SDRAM_TEST_GET_STATE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const SdramTestState sdramTestState = _sdramTestGetState();
+      static_assert(SdramTestState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(SdramTestState::SIZE);
+      return sdramTestState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
     case CommandIds::CAMERA_REQUEST_CAPTURE : {
       return _cameraRequestCapture();
     }
     case  CommandIds::CAMERA_REQUEST_TRANSFER : {
-      return _cameraRequestFrameTransfer(inet_addr(HOST_IP), PORT_FRAME_TRANSFER); // TODO: use _remotehost as addr
+      return _cameraRequestFrameTransfer(_remotehost.sin_addr.s_addr, PORT_FRAME_TRANSFER);
     };
     case CommandIds::CAMERA_SET_WHITEBALANCE : {
       if(_requestPacket.dataSize() != 6){
@@ -166,6 +352,47 @@ bool CommandHandler::handle() {
       Fps fps = static_cast<Fps>(_requestPacket.data()[0]);
       return _cameraSetFps(fps);
     }
+    case CommandIds::CAMERA_SET_MODE : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] CAMERA_SET_MODE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      SensorMode mode = static_cast<SensorMode>(_requestPacket.data()[0]);
+      Log::info("[CommandHandler] CAMERA_SET_MODE: mode: %u", mode);
+      return _cameraSetMode(mode);
+    }
+    case CommandIds::CAMERA_GET_MODE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] CAMERA_GET_MODE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const SensorModeInfo sensorModeInfo = _cameraGetMode();
+      static_assert(SensorModeInfo::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(SensorModeInfo::SIZE);
+      return sensorModeInfo.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::CAMERA_SET_PREVIEW : {
+      if(_requestPacket.dataSize() != PreviewConfig::SIZE){
+        Log::warning("[CommandHandler] CAMERA_SET_PREVIEW: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      PreviewConfig previewConfig {};
+      if(!previewConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] CAMERA_SET_PREVIEW: abort, deserialization failed");
+        return false;
+      }
+      return _cameraSetPreview(previewConfig);
+    }
+    case CommandIds::CAMERA_GET_PREVIEW : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] CAMERA_GET_PREVIEW: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const PreviewState previewState = _cameraGetPreview();
+      static_assert(PreviewState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(PreviewState::SIZE);
+      return previewState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
     case CommandIds::NETWORK_GET_CONFIG : {
       if(_requestPacket.dataSize() != 0){
         Log::warning("[CommandHandler] NETWORK_GET_NETWORK_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
@@ -206,91 +433,122 @@ bool CommandHandler::handle() {
       _networkPersistConfig();
       return true;
     };
-    case CommandIds::CALIBRATION_LOAD_CAMERA_MATRIX : {
-      if(_requestPacket.dataSize() != 0){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_CAMERA_MATRIX: abort, invalid command format, size: %u", _requestPacket.dataSize());
+    case CommandIds::NETWORK_BENCHMARK_START : {
+      if(_requestPacket.dataSize() != NetworkBenchmarkConfig::SIZE){
+        Log::warning("[CommandHandler] NETWORK_BENCHMARK_START: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      if(_responsePacket.DATA_SIZE_MAX < _cameraMatrix.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_CAMERA_MATRIX: abort, response won't fit into data buffer");
+      NetworkBenchmarkConfig networkBenchmarkConfig {};
+      if(!networkBenchmarkConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] NETWORK_BENCHMARK_START: abort, deserialization failed");
         return false;
       }
-      _responsePacket.dataSize(_cameraMatrix.SIZE());
-      Log::info("[CommandHandler] CALIBRATION_LOAD_CAMERA_MATRIX: reading data from storage");
-      return _storage.readData(EEPROM_ADDRESS_CAMERA_MATRIX, _responsePacket.data(), _cameraMatrix.SIZE());
-    };
-    case CommandIds::CALIBRATION_STORE_CAMERA_MATRIX : {
-      if(_requestPacket.dataSize() != _cameraMatrix.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_STORE_CAMERA_MATRIX: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      return _networkBenchmarkStart(networkBenchmarkConfig);
+    }
+    case CommandIds::NETWORK_BENCHMARK_GET_RESULT : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] NETWORK_BENCHMARK_GET_RESULT: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      Log::info("[CommandHandler] CALIBRATION_STORE_CAMERA_MATRIX: writing data to storage");
-      static constexpr uint32_t WRITE_TIMEOUT_MS {200U};
-      return _storage.writeData(EEPROM_ADDRESS_CAMERA_MATRIX, _requestPacket.data(), _requestPacket.dataSize(), WRITE_TIMEOUT_MS);
-    };
-    case CommandIds::CALIBRATION_LOAD_DISTORTION_COEFFICIENTS : {
-      if(_requestPacket.dataSize() != 0){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_DISTORTION_COEFFICIENTS: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      const NetworkBenchmarkResult networkBenchmarkResult = _networkBenchmarkGetResult();
+      static_assert(NetworkBenchmarkResult::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(NetworkBenchmarkResult::SIZE);
+      return networkBenchmarkResult.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::NETWORK_SUBSCRIBE : {
+      if(_requestPacket.dataSize() != Subscriber::SIZE){
+        Log::warning("[CommandHandler] NETWORK_SUBSCRIBE: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      if(_responsePacket.DATA_SIZE_MAX < _distortionCoefficients.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_DISTORTION_COEFFICIENTS: abort, response won't fit into data buffer");        return false;
+      Subscriber subscriber {};
+      if(!subscriber.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] NETWORK_SUBSCRIBE: abort, deserialization failed");
+        return false;
       }
-      _responsePacket.dataSize(_distortionCoefficients.SIZE());
-      Log::info("[CommandHandler] CALIBRATION_LOAD_DISTORTION_COEFFICIENTS: reading data from storage");
-      return _storage.readData(EEPROM_ADDRESS_DISTORTION_COEFFICIENTS, _responsePacket.data(), _distortionCoefficients.SIZE());
-    };
-    case CommandIds::CALIBRATION_STORE_DISTORTION_COEFFICIENTS : {
-      if(_requestPacket.dataSize() != _distortionCoefficients.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_STORE_DISTORTION_COEFFICIENTS: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      return _networkSubscribe(subscriber);
+    }
+    case CommandIds::NETWORK_UNSUBSCRIBE : {
+      if(_requestPacket.dataSize() != Subscriber::SIZE){
+        Log::warning("[CommandHandler] NETWORK_UNSUBSCRIBE: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      Log::info("[CommandHandler] CALIBRATION_STORE_DISTORTION_COEFFICIENTS: writing data to storage");
-      static constexpr uint32_t WRITE_TIMEOUT_MS {200U};
-      return _storage.writeData(EEPROM_ADDRESS_DISTORTION_COEFFICIENTS, _requestPacket.data(), _requestPacket.dataSize(), WRITE_TIMEOUT_MS);
-    };
-    case CommandIds::CALIBRATION_LOAD_ROTATION_MATRIX : {
+      Subscriber subscriber {};
+      if(!subscriber.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] NETWORK_UNSUBSCRIBE: abort, deserialization failed");
+        return false;
+      }
+      return _networkUnsubscribe(subscriber);
+    }
+    case CommandIds::NETWORK_GET_SUBSCRIBERS : {
       if(_requestPacket.dataSize() != 0){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_ROTATION_MATRIX: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        Log::warning("[CommandHandler] NETWORK_GET_SUBSCRIBERS: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      if(_responsePacket.DATA_SIZE_MAX < _rotationMatrix.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_ROTATION_MATRIX: abort, response won't fit into data buffer");        return false;
+      std::array<Subscriber, Subscriptions::MAX_SUBSCRIBERS> subscribers {};
+      const size_t count = _networkGetSubscribers(subscribers);
+      static_assert(1 + (Subscriptions::MAX_SUBSCRIBERS * Subscriber::SIZE) <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(1 + (count * Subscriber::SIZE));
+      _responsePacket.data()[0] = static_cast<uint8_t>(count);
+      for(size_t i = 0; i < count; i++) {
+        subscribers[i].toBytes(_responsePacket.data() + 1 + (i * Subscriber::SIZE), Subscriber::SIZE);
       }
-      _responsePacket.dataSize(_rotationMatrix.SIZE());
-      Log::info("[CommandHandler] CALIBRATION_LOAD_ROTATION_MATRIX: reading data from storage");
-      return _storage.readData(EEPROM_ADDRESS_ROTATION_MATRIX, _responsePacket.data(), _rotationMatrix.SIZE());
-    };
-    case CommandIds::CALIBRATION_STORE_ROTATION_MATRIX : {
-      if(_requestPacket.dataSize() != _rotationMatrix.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_STORE_ROTATION_MATRIX: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      return true;
+    }
+    case CommandIds::NETWORK_TIME_SYNC_SET_CONFIG : {
+      if(_requestPacket.dataSize() != TimeSyncConfig::SIZE){
+        Log::warning("[CommandHandler] NETWORK_TIME_SYNC_SET_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      Log::info("[CommandHandler] CALIBRATION_STORE_ROTATION_MATRIX: writing data to storage");
-      static constexpr uint32_t WRITE_TIMEOUT_MS {200U};
-      return _storage.writeData(EEPROM_ADDRESS_ROTATION_MATRIX, _requestPacket.data(), _requestPacket.dataSize(), WRITE_TIMEOUT_MS);
-    };
-    case CommandIds::CALIBRATION_LOAD_TRANSLATION_VECTOR : {
-      if(_requestPacket.dataSize() != 0){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_TRANSLATION_VECTOR: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      TimeSyncConfig timeSyncConfig {};
+      if(!timeSyncConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] NETWORK_TIME_SYNC_SET_CONFIG: abort, deserialization failed");
         return false;
       }
-      if(_responsePacket.DATA_SIZE_MAX < _translationVector.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_LOAD_TRANSLATION_VECTOR: abort, response won't fit into data buffer");        return false;
+      return _networkTimeSyncSetConfig(timeSyncConfig);
+    }
+    case CommandIds::NETWORK_TIME_SYNC_GET_STATE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] NETWORK_TIME_SYNC_GET_STATE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
       }
-      _responsePacket.dataSize(_translationVector.SIZE());
-      Log::info("[CommandHandler] CALIBRATION_LOAD_TRANSLATION_VECTOR: reading data from storage");
-      return _storage.readData(EEPROM_ADDRESS_TRANSLATION_VECTOR, _responsePacket.data(), _translationVector.SIZE());
+      const TimeSyncState timeSyncState = _networkTimeSyncGetState();
+      static_assert(TimeSyncState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(TimeSyncState::SIZE);
+      return timeSyncState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::CALIBRATION_LOAD_CAMERA_MATRIX : {
+      return calibrationLoad(CalibrationManager::Part::CAMERA_MATRIX);
+    };
+    case CommandIds::CALIBRATION_STORE_CAMERA_MATRIX : {
+      return calibrationStore(CalibrationManager::Part::CAMERA_MATRIX);
+    };
+    case CommandIds::CALIBRATION_LOAD_DISTORTION_COEFFICIENTS : {
+      return calibrationLoad(CalibrationManager::Part::DISTORTION_COEFFICIENTS);
+    };
+    case CommandIds::CALIBRATION_STORE_DISTORTION_COEFFICIENTS : {
+      return calibrationStore(CalibrationManager::Part::DISTORTION_COEFFICIENTS);
+    };
+    case CommandIds::CALIBRATION_LOAD_ROTATION_MATRIX : {
+      return calibrationLoad(CalibrationManager::Part::ROTATION_MATRIX);
+    };
+    case CommandIds::CALIBRATION_STORE_ROTATION_MATRIX : {
+      return calibrationStore(CalibrationManager::Part::ROTATION_MATRIX);
+    };
+    case CommandIds::CALIBRATION_LOAD_TRANSLATION_VECTOR : {
+      return calibrationLoad(CalibrationManager::Part::TRANSLATION_VECTOR);
     };
     case CommandIds::CALIBRATION_STORE_TRANSLATION_VECTOR : {
-      if(_requestPacket.dataSize() != _translationVector.SIZE()){
-        Log::warning("[CommandHandler] CALIBRATION_STORE_TRANSLATION_VECTOR: abort, invalid command format, size: %u", _requestPacket.dataSize());
+      return calibrationStore(CalibrationManager::Part::TRANSLATION_VECTOR);
+    };
+    case CommandIds::CALIBRATION_GET_STATUS : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] CALIBRATION_GET_STATUS: abort, invalid command format, size: %u", _requestPacket.dataSize());
         return false;
       }
-      Log::info("[CommandHandler] CALIBRATION_STORE_TRANSLATION_VECTOR: writing data to storage");
-      static constexpr uint32_t WRITE_TIMEOUT_MS {200U};
-      return _storage.writeData(EEPROM_ADDRESS_TRANSLATION_VECTOR, _requestPacket.data(), _requestPacket.dataSize(), WRITE_TIMEOUT_MS);
-    };
+      _responsePacket.dataSize(1);
+      _responsePacket.data()[0] = _calibrationManager.stored();
+      return true;
+    }
     case CommandIds::PIPELINE_SET_INPUT : {
       if(_requestPacket.dataSize() != 1){
         Log::warning("[CommandHandler] PIPELINE_SET_INPUT: abort, invalid command format");
@@ -312,6 +570,96 @@ bool CommandHandler::handle() {
       }
       return _pipelineSetBinarizationThreshold(_requestPacket.data()[0]);
     }
+    case CommandIds::PIPELINE_GET_STREAM_STATS : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] PIPELINE_GET_STREAM_STATS: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const FeatureStreamStats streamStats = _pipelineGetStreamStats();
+      static_assert(FeatureStreamStats::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(FeatureStreamStats::SIZE);
+      return streamStats.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::PIPELINE_SET_TRANSPORT : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] PIPELINE_SET_TRANSPORT: abort, invalid command format");
+        return false;
+      }
+      return _pipelineSetTransport(static_cast<BlobTransport>(_requestPacket.data()[0]));
+    }
+    case CommandIds::PIPELINE_SET_TRACKING : {
+      if(_requestPacket.dataSize() != BlobTrackerConfig::SIZE){
+        Log::warning("[CommandHandler] PIPELINE_SET_TRACKING: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      BlobTrackerConfig trackerConfig {};
+      if(!trackerConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] PIPELINE_SET_TRACKING: abort, deserialization failed");
+        return false;
+      }
+      return _pipelineSetTracking(trackerConfig);
+    }
+    case CommandIds::PIPELINE_GET_TRACKING : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] PIPELINE_GET_TRACKING: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const BlobTrackerState trackerState = _pipelineGetTracking();
+      static_assert(BlobTrackerState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(BlobTrackerState::SIZE);
+      return trackerState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::PIPELINE_SET_BLINK_CODES : {
+      if(_requestPacket.dataSize() != BlinkDecoderConfig::SIZE){
+        Log::warning("[CommandHandler] PIPELINE_SET_BLINK_CODES: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      BlinkDecoderConfig decoderConfig {};
+      if(!decoderConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] PIPELINE_SET_BLINK_CODES: abort, deserialization failed");
+        return false;
+      }
+      return _pipelineSetBlinkCodes(decoderConfig);
+    }
+    case CommandIds::PIPELINE_GET_BLINK_CODES : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] PIPELINE_GET_BLINK_CODES: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const BlinkDecoderState decoderState = _pipelineGetBlinkCodes();
+      static_assert(BlinkDecoderState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(BlinkDecoderState::SIZE);
+      return decoderState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::PIPELINE_SET_DELTA_ENCODING : {
+      if(_requestPacket.dataSize() != DeltaEncoderConfig::SIZE){
+        Log::warning("[CommandHandler] PIPELINE_SET_DELTA_ENCODING: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      DeltaEncoderConfig encoderConfig {};
+      if(!encoderConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] PIPELINE_SET_DELTA_ENCODING: abort, deserialization failed");
+        return false;
+      }
+      return _pipelineSetDeltaEncoding(encoderConfig);
+    }
+    case CommandIds::PIPELINE_GET_DELTA_ENCODING : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] PIPELINE_GET_DELTA_ENCODING: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const DeltaEncoderState encoderState = _pipelineGetDeltaEncoding();
+      static_assert(DeltaEncoderState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(DeltaEncoderState::SIZE);
+      return encoderState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::PIPELINE_SET_STREAMING : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] PIPELINE_SET_STREAMING: abort, invalid command format");
+        return false;
+      }
+      return _pipelineSetStreaming(_requestPacket.data()[0]);
+    }
     case CommandIds::STROBE_ENABLE_PULSE : {
       if(_requestPacket.dataSize() != 1){
         Log::warning("[CommandHandler] STROBE_ENABLE_PULSE: abort, invalid command format");
@@ -342,6 +690,130 @@ bool CommandHandler::handle() {
       }
       return _strobeEnableConstant(_requestPacket.data()[0]);
     }
+    case CommandIds::AUTO_EXPOSURE_ENABLE : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] AUTO_EXPOSURE_ENABLE: abort, invalid command format");
+        return false;
+      }
+      _autoExposureEnable(_requestPacket.data()[0]);
+      return true;
+    }
+    case CommandIds::AUTO_EXPOSURE_SET_CONFIG : {
+      if(_requestPacket.dataSize() != AutoExposureConfig::SIZE){
+        Log::warning("[CommandHandler] AUTO_EXPOSURE_SET_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      AutoExposureConfig autoExposureConfig {};
+      if(!autoExposureConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] AUTO_EXPOSURE_SET_CONFIG: abort, deserialization failed");
+        return false;
+      }
+      return _autoExposureSetConfig(autoExposureConfig);
+    }
+    case CommandIds::AUTO_EXPOSURE_GET_CONFIG : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] AUTO_EXPOSURE_GET_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const AutoExposureConfig autoExposureConfig = _autoExposureGetConfig();
+      static_assert(AutoExposureConfig::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(AutoExposureConfig::SIZE);
+      return autoExposureConfig.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::AUTO_EXPOSURE_GET_STATE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] AUTO_EXPOSURE_GET_STATE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const AutoExposureState autoExposureState = _autoExposureGetState();
+      static_assert(AutoExposureState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(AutoExposureState::SIZE);
+      return autoExposureState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::RECORDER_SET_CONFIG : {
+      if(_requestPacket.dataSize() != RecorderConfig::SIZE){
+        Log::warning("[CommandHandler] RECORDER_SET_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      RecorderConfig recorderConfig {};
+      if(!recorderConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] RECORDER_SET_CONFIG: abort, deserialization failed");
+        return false;
+      }
+      _recorderSetConfig(recorderConfig);
+      return true;
+    }
+    case CommandIds::RECORDER_GET_STATE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] RECORDER_GET_STATE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const RecorderState recorderState = _recorderGetState();
+      static_assert(RecorderState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(RecorderState::SIZE);
+      return recorderState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::RECORDER_FETCH : {
+      if(_requestPacket.dataSize() != RecorderRange::SIZE){
+        Log::warning("[CommandHandler] RECORDER_FETCH: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      RecorderRange range {};
+      if(!range.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] RECORDER_FETCH: abort, deserialization failed");
+        return false;
+      }
+      RecorderFetchResult fetchResult {};
+      if(!_recorderFetch(range, _remotehost.sin_addr.s_addr, fetchResult)) {
+        return false;
+      }
+      static_assert(RecorderFetchResult::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(RecorderFetchResult::SIZE);
+      return fetchResult.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::FRAME_HISTORY_SET_CONFIG : {
+      if(_requestPacket.dataSize() != FrameHistoryConfig::SIZE){
+        Log::warning("[CommandHandler] FRAME_HISTORY_SET_CONFIG: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      FrameHistoryConfig frameHistoryConfig {};
+      if(!frameHistoryConfig.fromBytes(_requestPacket.data(), _requestPacket.dataSize())) {
+        Log::warning("[CommandHandler] FRAME_HISTORY_SET_CONFIG: abort, deserialization failed");
+        return false;
+      }
+      return _frameHistorySetConfig(frameHistoryConfig);
+    }
+    case CommandIds::FRAME_HISTORY_GET_STATE : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] FRAME_HISTORY_GET_STATE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const FrameHistoryState frameHistoryState = _frameHistoryGetState();
+      static_assert(FrameHistoryState::SIZE <= CommandPacket::DATA_SIZE_MAX);
+      _responsePacket.dataSize(FrameHistoryState::SIZE);
+      return frameHistoryState.toBytes(_responsePacket.data(), _responsePacket.DATA_SIZE_MAX);
+    }
+    case CommandIds::FRAME_HISTORY_TRIGGER : {
+      if(_requestPacket.dataSize() != 0){
+        Log::warning("[CommandHandler] FRAME_HISTORY_TRIGGER: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      return _frameHistoryTrigger();
+    }
+    case CommandIds::FRAME_HISTORY_TRANSFER : {
+      if(_requestPacket.dataSize() != 1){
+        Log::warning("[CommandHandler] FRAME_HISTORY_TRANSFER: abort, invalid command format, size: %u", _requestPacket.dataSize());
+        return false;
+      }
+      const uint8_t index = _requestPacket.data()[0];
+      uint32_t timeMs {0};
+      if(!_frameHistoryTransfer(index, _remotehost.sin_addr.s_addr, PORT_FRAME_TRANSFER, timeMs)) {
+        return false;
+      }
+      _responsePacket.dataSize(sizeof(timeMs));
+      std::memcpy(_responsePacket.data(), &timeMs, sizeof(timeMs));
+      return true;
+    }
     default: {
       Log::debug("[CommandHandler] command %u not supported", _requestPacket.commandId());
       return false;
@@ -349,18 +821,49 @@ bool CommandHandler::handle() {
   }
 }
 
-void CommandHandler::run() {
-  size_t addressLength = sizeof(_remotehost);
-  int clientSocket = lwip_accept(_serverSocket, (struct sockaddr *)&_remotehost, (socklen_t *)&addressLength);
+bool CommandHandler::calibrationLoad(CalibrationManager::Part part) {
+  if(_requestPacket.dataSize() != 0){
+    Log::warning("[CommandHandler] CALIBRATION_LOAD: abort, invalid command format, size: %u", _requestPacket.dataSize());
+    return false;
+  }
+  const size_t size = CalibrationManager::size(part);
+  if(_responsePacket.DATA_SIZE_MAX < size){
+    Log::warning("[CommandHandler] CALIBRATION_LOAD: abort, response won't fit into data buffer");
+    return false;
+  }
+  _responsePacket.dataSize(size);
+  return _calibrationManager.get(part, _responsePacket.data(), size); // cached, no eeprom access
+}
 
+bool CommandHandler::calibrationStore(CalibrationManager::Part part) {
+  if(_requestPacket.dataSize() != CalibrationManager::size(part)){
+    Log::warning("[CommandHandler] CALIBRATION_STORE: abort, invalid command format, size: %u", _requestPacket.dataSize());
+    return false;
+  }
+  Log::info("[CommandHandler] CALIBRATION_STORE: part %u", part);
+  return _calibrationManager.set(part, _requestPacket.data(), _requestPacket.dataSize());
+}
 
-  int bytesReceived = lwip_read(clientSocket, _receiveBuffer, _RECEIVE_BUFFER_SIZE);
-  if(bytesReceived < 0){
-    Log::error("[CommandHandler] Socket read error: %d", errno);
+void CommandHandler::run() {
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(_serverSocket, &readSet);
+  FD_SET(_broadcastSocket, &readSet);
+  const int socketCount = std::max(_serverSocket, _broadcastSocket) + 1;
+  if(lwip_select(socketCount, &readSet, nullptr, nullptr, nullptr) <= 0){
+    Log::error("[CommandHandler] select error: %d", errno);
     return;
-  };
+  }
+  if(FD_ISSET(_broadcastSocket, &readSet)){
+    serveBroadcast();
+  }
+  if(FD_ISSET(_serverSocket, &readSet)){
+    serveConnection();
+  }
+}
 
-  if(!deserialize(_receiveBuffer, bytesReceived)){
+void CommandHandler::respond(bool deserialized) {
+  if(!deserialized){
     static constexpr size_t BROADCAST_REQUEST_ID {0U};
     _responsePacket.requestId(BROADCAST_REQUEST_ID);
     _responsePacket.completionStatus(static_cast<uint8_t>(CompletionStatus::COMPLETION_FAILURE));
@@ -372,6 +875,58 @@ void CommandHandler::run() {
     uint8_t completionStatus = handle() ? CompletionStatus::COMPLETION_SUCCESS : CompletionStatus::COMPLETION_FAILURE;
     _responsePacket.completionStatus(static_cast<uint8_t>(completionStatus));  
   }
+}
+
+void CommandHandler::serveBroadcast() {
+  struct sockaddr_in sender {};
+  socklen_t senderLength = sizeof(sender);
+  int bytesReceived = lwip_recvfrom(_broadcastSocket, _receiveBuffer, _RECEIVE_BUFFER_SIZE, 0, (struct sockaddr *)&sender, &senderLength);
+  if(bytesReceived < 0){
+    Log::error("[CommandHandler] Socket read error: %d", errno);
+    return;
+  }
+  _remotehost = sender; // transfers requested by a broadcast command go to its sender
+  BroadcastSchedule schedule {};
+  if(!schedule.fromBytes(_receiveBuffer, bytesReceived)){
+    Log::warning("[CommandHandler] invalid broadcast schedule, dropped");
+    return;
+  }
+  const bool deserialized = deserialize(_receiveBuffer + BroadcastSchedule::SIZE, bytesReceived - BroadcastSchedule::SIZE);
+  BroadcastAck ack {};
+  ack.timing = BroadcastTiming::BROADCAST_IMMEDIATE;
+  if(deserialized){
+    ack = _broadcastAwait(schedule);
+  }
+  if(ack.timing == BroadcastTiming::BROADCAST_TIMEOUT){
+    // applied anyway, the other devices of the rig may have reached the frame
+    Log::warning("[CommandHandler] broadcast command %u applied late, frame %u not reached", _requestPacket.commandId(), schedule.frameCount);
+  }
+  respond(deserialized);
+
+  ack.toBytes(_replyBuffer, _REPLY_BUFFER_SIZE);
+  auto serializeResult = _responsePacket.toBytes(_replyBuffer + BroadcastAck::SIZE, _REPLY_BUFFER_SIZE - BroadcastAck::SIZE);
+  if(!std::get<0>(serializeResult)){
+    Log::error("[CommandHandler] serialize failed, unable to send reply");
+    return;
+  }
+  int bytesSent = lwip_sendto(_broadcastSocket, _replyBuffer, BroadcastAck::SIZE + std::get<1>(serializeResult), 0, (struct sockaddr *)&sender, senderLength);
+  if(bytesSent < 0){
+    Log::error("[CommandHandler] Socket write error: %d", errno);
+  }
+}
+
+void CommandHandler::serveConnection() {
+  size_t addressLength = sizeof(_remotehost);
+  int clientSocket = lwip_accept(_serverSocket, (struct sockaddr *)&_remotehost, (socklen_t *)&addressLength);
+
+
+  int bytesReceived = lwip_read(clientSocket, _receiveBuffer, _RECEIVE_BUFFER_SIZE);
+  if(bytesReceived < 0){
+    Log::error("[CommandHandler] Socket read error: %d", errno);
+    return;
+  };
+
+  respond(deserialize(_receiveBuffer, bytesReceived));
   
   auto serializeResult = _responsePacket.toBytes(_replyBuffer, _REPLY_BUFFER_SIZE);
   if(!std::get<0>(serializeResult)){
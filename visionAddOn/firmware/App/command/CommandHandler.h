@@ -1,6 +1,9 @@
 #ifndef VISIONADDON_APP_COMMAND_COMMANDHANDLER_H
 #define VISIONADDON_APP_COMMAND_COMMANDHANDLER_H
 
+#include "autoExposure/AutoExposureTypes.h"
+#include "blob/BlobTypes.h"
+#include "calibration/CalibrationManager.h"
 #include "camera/CameraTypes.h"
 #include "command/CommandPacket.h"
 #include "command/CommandTypes.h"
@@ -8,10 +11,10 @@
 #include "lwip/api.h"
 #include "lwip/sockets.h"
 #undef bind // to avoid conflicts with std functional bind
+#include "metrics/MetricsTypes.h"
 #include "network/NetworkTypes.h"
-#include "storage/IStorage.h"
+#include "network/Subscriptions.h"
 #include "utils/IRunnable.h"
-#include "utils/matrix/Matrix.h"
 #include <cstdint>
 #include <functional>
 
@@ -23,6 +26,10 @@ public:
     using CameraSetExposure = std::function<bool(uint16_t levelInteger, uint8_t levelFraction)>;
     using CameraSetGain = std::function<bool(uint8_t level, uint8_t band)>;
     using CameraSetFps = std::function<bool(Fps fps)>;
+    using CameraSetMode = std::function<bool(SensorMode mode)>;
+    using CameraGetMode = std::function<SensorModeInfo(void)>;
+    using CameraSetPreview = std::function<bool(const PreviewConfig&)>;
+    using CameraGetPreview = std::function<PreviewState(void)>;
     using NetworkGetMac = std::function<MacAddress(void)>;
     using NetworkSetMac = std::function<void(MacAddress mac)>;
     using NetworkGetIp = std::function<IpV4Address(void)>;
@@ -32,21 +39,59 @@ public:
     using NetworkGetGateway = std::function<IpV4Address(void)>;
     using NetworkSetGateway = std::function<void(IpV4Address gateway)>;
     using NetworkPersistConfig = std::function<void(void)>;
+    using NetworkBenchmarkStart = std::function<bool(const NetworkBenchmarkConfig&)>;
+    using NetworkBenchmarkGetResult = std::function<NetworkBenchmarkResult(void)>;
+    using NetworkSubscribe = std::function<bool(const Subscriber&)>;
+    using NetworkUnsubscribe = std::function<bool(const Subscriber&)>;
+    using NetworkGetSubscribers = std::function<size_t(std::array<Subscriber, Subscriptions::MAX_SUBSCRIBERS>&)>;
     using PipelineSetInput = std::function<bool(PipelineInput)>;
     using PipelineSetOutput = std::function<bool(PipelineOutput)>;
     using PipelineSetBinarizationThreshold = std::function<bool(uint8_t)>;
+    using PipelineGetStreamStats = std::function<FeatureStreamStats(void)>;
+    using PipelineSetTransport = std::function<bool(BlobTransport)>;
+    using PipelineSetTracking = std::function<bool(const BlobTrackerConfig&)>;
+    using PipelineGetTracking = std::function<BlobTrackerState(void)>;
+    using PipelineSetBlinkCodes = std::function<bool(const BlinkDecoderConfig&)>;
+    using PipelineGetBlinkCodes = std::function<BlinkDecoderState(void)>;
+    using PipelineSetDeltaEncoding = std::function<bool(const DeltaEncoderConfig&)>;
+    using PipelineGetDeltaEncoding = std::function<DeltaEncoderState(void)>;
+    using PipelineSetStreaming = std::function<bool(bool)>;
     using StrobeEnablePulse = std::function<bool(bool)>;
     using StrobeSetOnDelay = std::function<bool(uint32_t)>;
     using StrobeSetHoldTime = std::function<bool(uint32_t)>;
     using StrobeEnableConstant = std::function<bool(bool)>;
+    using AutoExposureEnable = std::function<void(bool)>;
+    using AutoExposureSetConfig = std::function<bool(const AutoExposureConfig&)>;
+    using AutoExposureGetConfig = std::function<AutoExposureConfig(void)>;
+    using AutoExposureGetState = std::function<AutoExposureState(void)>;
+    using RecorderSetConfig = std::function<void(const RecorderConfig&)>;
+    using RecorderGetState = std::function<RecorderState(void)>;
+    using RecorderFetch = std::function<bool(const RecorderRange&, uint32_t address, RecorderFetchResult&)>;
+    using FrameHistorySetConfig = std::function<bool(const FrameHistoryConfig&)>;
+    using FrameHistoryGetState = std::function<FrameHistoryState(void)>;
+    using FrameHistoryTrigger = std::function<bool(void)>;
+    using FrameHistoryTransfer = std::function<bool(uint8_t index, uint32_t address, uint32_t port, uint32_t& timeMs)>;
+    using MetricsGet = std::function<RuntimeMetrics(void)>;
+    using TaskProfileGet = std::function<TaskProfile(void)>;
+    using MemoryBenchmarkRun = std::function<MemoryBenchmarkResult(void)>;
+    using ImageKernelBenchmarkRun = std::function<ImageKernelBenchmarkResult(uint8_t threshold)>;
+    using SdramTestStart = std::function<bool(SdramRegion region)>;
+    using SdramTestGetState = std::function<SdramTestState(void)>;
+    using BroadcastAwait = std::function<BroadcastAck(const BroadcastSchedule&)>;
+    using NetworkTimeSyncSetConfig = std::function<bool(const TimeSyncConfig&)>;
+    using NetworkTimeSyncGetState = std::function<TimeSyncState(void)>;
     CommandHandler(
-        IStorage& storage,
+        CalibrationManager& calibrationManager,
         CameraRequestCapture cameraRequestCapture,
         CameraRequestFrameTransfer cameraRequestFrameTransfer,
         CameraSetWhitebalance cameraSetWhitebalance,
         CameraSetExposure cameraSetExposure,
         CameraSetGain cameraSetGain,
         CameraSetFps cameraSetFps,
+        CameraSetMode cameraSetMode,
+        CameraGetMode cameraGetMode,
+        CameraSetPreview cameraSetPreview,
+        CameraGetPreview cameraGetPreview,
         NetworkGetMac networkGetMac,
         NetworkSetMac networkSetMac,
         NetworkGetIp networkGetIp,
@@ -56,13 +101,47 @@ public:
         NetworkGetGateway networkGetGateway,
         NetworkSetGateway networkSetGateway,
         NetworkPersistConfig networkPersistConfig,
+        NetworkBenchmarkStart networkBenchmarkStart,
+        NetworkBenchmarkGetResult networkBenchmarkGetResult,
+        NetworkSubscribe networkSubscribe,
+        NetworkUnsubscribe networkUnsubscribe,
+        NetworkGetSubscribers networkGetSubscribers,
         PipelineSetInput pipelineSetInput,
         PipelineSetOutput pipelineSetOutput,
         PipelineSetBinarizationThreshold pipelineSetBinarizationThreshold,
+        PipelineGetStreamStats pipelineGetStreamStats,
+        PipelineSetTransport pipelineSetTransport,
+        PipelineSetTracking pipelineSetTracking,
+        PipelineGetTracking pipelineGetTracking,
+        PipelineSetBlinkCodes pipelineSetBlinkCodes,
+        PipelineGetBlinkCodes pipelineGetBlinkCodes,
+        PipelineSetDeltaEncoding pipelineSetDeltaEncoding,
+        PipelineGetDeltaEncoding pipelineGetDeltaEncoding,
+        PipelineSetStreaming pipelineSetStreaming,
         StrobeEnablePulse strobeEnablePulse,
         StrobeSetOnDelay strobeSetOnDelay,
         StrobeSetHoldTime strobeSetHoldTime,
-        StrobeEnableConstant strobeEnableConstant
+        StrobeEnableConstant strobeEnableConstant,
+        AutoExposureEnable autoExposureEnable,
+        AutoExposureSetConfig autoExposureSetConfig,
+        AutoExposureGetConfig autoExposureGetConfig,
+        AutoExposureGetState autoExposureGetState,
+        RecorderSetConfig recorderSetConfig,
+        RecorderGetState recorderGetState,
+        RecorderFetch recorderFetch,
+        FrameHistorySetConfig frameHistorySetConfig,
+        FrameHistoryGetState frameHistoryGetState,
+        FrameHistoryTrigger frameHistoryTrigger,
+        FrameHistoryTransfer frameHistoryTransfer,
+        MetricsGet metricsGet,
+        TaskProfileGet taskProfileGet,
+        MemoryBenchmarkRun memoryBenchmarkRun,
+        ImageKernelBenchmarkRun imageKernelBenchmarkRun,
+        SdramTestStart sdramTestStart,
+        SdramTestGetState sdramTestGetState,
+        BroadcastAwait broadcastAwait,
+        NetworkTimeSyncSetConfig networkTimeSyncSetConfig,
+        NetworkTimeSyncGetState networkTimeSyncGetState
     );
     CommandHandler (const CommandHandler&) = delete;
     CommandHandler& operator=(const CommandHandler&) = delete;
@@ -70,18 +149,33 @@ public:
     CommandHandler& operator=(const CommandHandler&&) = delete;
 
     void init(); //!< must be called after MX_LWIP_Init()
-    void run() override; //!< blocking!
+    void run() override; //!< blocking! serves one connection or one broadcast datagram
 
 private:
     bool deserialize(const uint8_t* buffer, const size_t size);
     bool handle();
-    IStorage& _storage;
+    void serveConnection();
+    /**
+     * @brief Serve a datagram of the broadcast command port: schedule, then the request packet.
+     *
+     * The command is applied at the scheduled frame, the task blocks until then. Answered with a unicast to the sender:
+     * broadcast ack, then the response packet.
+     */
+    void serveBroadcast();
+    void respond(bool deserialized); //!< handle the request packet into the response packet
+    bool calibrationLoad(CalibrationManager::Part part);
+    bool calibrationStore(CalibrationManager::Part part);
+    CalibrationManager& _calibrationManager;
     CameraRequestCapture _cameraRequestCapture;
     CameraRequestFrameTransfer _cameraRequestFrameTransfer;
     CameraSetWhitebalance _cameraSetWhitebalance;
     CameraSetExposure _cameraSetExposure;
     CameraSetGain _cameraSetGain;
     CameraSetFps _cameraSetFps;
+    CameraSetMode _cameraSetMode;
+    CameraGetMode _cameraGetMode;
+    CameraSetPreview _cameraSetPreview;
+    CameraGetPreview _cameraGetPreview;
     NetworkGetMac _networkGetMac;
     NetworkSetMac _networkSetMac;
     NetworkGetIp _networkGetIp;
@@ -91,18 +185,49 @@ private:
     NetworkGetGateway _networkGetGateway;
     NetworkSetGateway _networkSetGateway;
     NetworkPersistConfig _networkPersistConfig;
+    NetworkBenchmarkStart _networkBenchmarkStart;
+    NetworkBenchmarkGetResult _networkBenchmarkGetResult;
+    NetworkSubscribe _networkSubscribe;
+    NetworkUnsubscribe _networkUnsubscribe;
+    NetworkGetSubscribers _networkGetSubscribers;
     PipelineSetInput _pipelineSetInput;
     PipelineSetOutput _pipelineSetOutput;
     PipelineSetBinarizationThreshold _pipelineSetBinarizationThreshold;
+    PipelineGetStreamStats _pipelineGetStreamStats;
+    PipelineSetTransport _pipelineSetTransport;
+    PipelineSetTracking _pipelineSetTracking;
+    PipelineGetTracking _pipelineGetTracking;
+    PipelineSetBlinkCodes _pipelineSetBlinkCodes;
+    PipelineGetBlinkCodes _pipelineGetBlinkCodes;
+    PipelineSetDeltaEncoding _pipelineSetDeltaEncoding;
+    PipelineGetDeltaEncoding _pipelineGetDeltaEncoding;
+    PipelineSetStreaming _pipelineSetStreaming;
     StrobeEnablePulse _strobeEnablePulse;
     StrobeSetOnDelay _strobeSetOnDelay;
     StrobeSetHoldTime _strobeSetHoldTime;
     StrobeEnableConstant _strobeEnableConstant;
-    Matrix<3,3> _cameraMatrix;
-    Matrix<1,5> _distortionCoefficients;
-    Matrix<3,3> _rotationMatrix;
-    Matrix<1,3> _translationVector;
+    AutoExposureEnable _autoExposureEnable;
+    AutoExposureSetConfig _autoExposureSetConfig;
+    AutoExposureGetConfig _autoExposureGetConfig;
+    AutoExposureGetState _autoExposureGetState;
+    RecorderSetConfig _recorderSetConfig;
+    RecorderGetState _recorderGetState;
+    RecorderFetch _recorderFetch;
+    FrameHistorySetConfig _frameHistorySetConfig;
+    FrameHistoryGetState _frameHistoryGetState;
+    FrameHistoryTrigger _frameHistoryTrigger;
+    FrameHistoryTransfer _frameHistoryTransfer;
+    MetricsGet _metricsGet;
+    TaskProfileGet _taskProfileGet;
+    MemoryBenchmarkRun _memoryBenchmarkRun;
+    ImageKernelBenchmarkRun _imageKernelBenchmarkRun;
+    SdramTestStart _sdramTestStart;
+    SdramTestGetState _sdramTestGetState;
+    BroadcastAwait _broadcastAwait;
+    NetworkTimeSyncSetConfig _networkTimeSyncSetConfig;
+    NetworkTimeSyncGetState _networkTimeSyncGetState;
     int _serverSocket;
+    int _broadcastSocket;
     struct sockaddr_in _serverAddress;
     struct sockaddr_in _remotehost;
     CommandPacket _requestPacket;
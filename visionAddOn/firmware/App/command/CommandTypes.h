@@ -9,15 +9,34 @@
 
 enum CommandIds : uint8_t {
     LOG_SET_LEVEL = 0x10,
+    INTERRUPT_GET_STATS = 0x11,
+    METRICS_GET = 0x12,
+    TASK_PROFILE_GET = 0x13,
+    MEMORY_BENCHMARK_RUN = 0x14,
+    IMAGE_KERNEL_BENCHMARK_RUN = 0x15,
+    BOOT_TIMELINE_GET = 0x16,
+    SDRAM_TEST_START = 0x17,
+    SDRAM_TEST_GET_STATE = 0x18,
     CAMERA_REQUEST_CAPTURE = 0x20,
     CAMERA_REQUEST_TRANSFER = 0x21,
     CAMERA_SET_WHITEBALANCE = 0x22,
     CAMERA_SET_EXPOSURE = 0x23,
     CAMERA_SET_GAIN = 0x24,
     CAMERA_SET_FPS = 0x25,
+    CAMERA_SET_MODE = 0x26,
+    CAMERA_GET_MODE = 0x27,
+    CAMERA_SET_PREVIEW = 0x28,
+    CAMERA_GET_PREVIEW = 0x29,
     NETWORK_GET_CONFIG = 0x30,
     NETWORK_SET_CONFIG = 0x31,
     NETWORK_PERSIST_CONFIG = 0x32,
+    NETWORK_BENCHMARK_START = 0x33,
+    NETWORK_BENCHMARK_GET_RESULT = 0x34,
+    NETWORK_SUBSCRIBE = 0x35,
+    NETWORK_UNSUBSCRIBE = 0x36,
+    NETWORK_GET_SUBSCRIBERS = 0x37,
+    NETWORK_TIME_SYNC_SET_CONFIG = 0x38,
+    NETWORK_TIME_SYNC_GET_STATE = 0x39,
     CALIBRATION_LOAD_CAMERA_MATRIX = 0x40,
     CALIBRATION_STORE_CAMERA_MATRIX = 0x41,
     CALIBRATION_LOAD_DISTORTION_COEFFICIENTS = 0x42,
@@ -26,13 +45,34 @@ enum CommandIds : uint8_t {
     CALIBRATION_STORE_ROTATION_MATRIX = 0x45,
     CALIBRATION_LOAD_TRANSLATION_VECTOR = 0x46,
     CALIBRATION_STORE_TRANSLATION_VECTOR = 0x47,
+    CALIBRATION_GET_STATUS = 0x48,
     PIPELINE_SET_INPUT = 0x50,
     PIPELINE_SET_OUTPUT = 0x51,
     PIPELINE_SET_BINARIZATION_THRESHOLD = 0x52,
+    PIPELINE_GET_STREAM_STATS = 0x53,
+    PIPELINE_SET_TRANSPORT = 0x54,
+    PIPELINE_SET_TRACKING = 0x55,
+    PIPELINE_GET_TRACKING = 0x56,
+    PIPELINE_SET_BLINK_CODES = 0x57,
+    PIPELINE_GET_BLINK_CODES = 0x58,
+    PIPELINE_SET_DELTA_ENCODING = 0x59,
+    PIPELINE_GET_DELTA_ENCODING = 0x5A,
+    PIPELINE_SET_STREAMING = 0x5B,
     STROBE_ENABLE_PULSE = 0x60,
     STROBE_SET_ON_DELAY = 0x61,
     STROBE_SET_HOLD_TIME = 0x62,
     STROBE_ENABLE_CONSTANT = 0x63,
+    AUTO_EXPOSURE_ENABLE = 0x70,
+    AUTO_EXPOSURE_SET_CONFIG = 0x71,
+    AUTO_EXPOSURE_GET_CONFIG = 0x72,
+    AUTO_EXPOSURE_GET_STATE = 0x73,
+    RECORDER_SET_CONFIG = 0x80,
+    RECORDER_GET_STATE = 0x81,
+    RECORDER_FETCH = 0x82,
+    FRAME_HISTORY_SET_CONFIG = 0x90,
+    FRAME_HISTORY_GET_STATE = 0x91,
+    FRAME_HISTORY_TRIGGER = 0x92,
+    FRAME_HISTORY_TRANSFER = 0x93,
     COMMAND_UNDEFINED = UINT8_MAX
 };
 
@@ -42,6 +82,52 @@ enum CompletionStatus : uint8_t {
     COMPLETION_UNDEFINED = UINT8_MAX
 };
 
+enum BroadcastTiming : uint8_t {
+    BROADCAST_IMMEDIATE = 0x00, //!< applied on reception
+    BROADCAST_ON_FRAME = 0x01, //!< applied right after the feature packet of the scheduled frame
+    BROADCAST_LATE = 0x02, //!< the scheduled frame already passed or its packet was lost, applied on reception or the next packet
+    BROADCAST_TIMEOUT = 0x03, //!< neither the scheduled frame nor a later one was reached (camera not streaming), applied on the timeout
+    BROADCAST_TIMING_UNDEFINED = UINT8_MAX
+};
+
+// prefix of a datagram on the broadcast command port, the request packet follows
+class BroadcastSchedule {
+public:
+    BroadcastTiming timing = {BROADCAST_IMMEDIATE}; //!< BROADCAST_IMMEDIATE or BROADCAST_ON_FRAME
+    uint8_t frameCount = {}; //!< feature packet frame count the command is applied after, BROADCAST_ON_FRAME only
+    static constexpr size_t SIZE {sizeof(timing) + sizeof(frameCount)};
+    static constexpr size_t OFFSET_TIMING {0};
+    static constexpr size_t OFFSET_FRAME_COUNT {OFFSET_TIMING + sizeof(timing)};
+
+    bool fromBytes(const uint8_t* buffer, size_t size) {
+        if(SIZE > size) {
+            return false;
+        }
+        timing = static_cast<BroadcastTiming>(buffer[OFFSET_TIMING]);
+        frameCount = buffer[OFFSET_FRAME_COUNT];
+        return (timing == BROADCAST_IMMEDIATE) || (timing == BROADCAST_ON_FRAME);
+    }
+};
+
+// prefix of the unicast reply to a broadcast command, the response packet follows
+class BroadcastAck {
+public:
+    BroadcastTiming timing = {BROADCAST_TIMING_UNDEFINED};
+    uint8_t frameCount = {}; //!< frame count of the last feature packet when the command was applied
+    static constexpr size_t SIZE {sizeof(timing) + sizeof(frameCount)};
+    static constexpr size_t OFFSET_TIMING {0};
+    static constexpr size_t OFFSET_FRAME_COUNT {OFFSET_TIMING + sizeof(timing)};
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_TIMING] = timing;
+        buffer[OFFSET_FRAME_COUNT] = frameCount;
+        return true;
+    }
+};
+
 class NetworkConfiguration {
 public:
     MacAddress mac = {};
@@ -12,7 +12,9 @@ FpgaCommander::FpgaCommander(UART_HandleTypeDef *uartHandle) : _uartHandle{uartH
 
 bool FpgaCommander::sendCommand(const char *buffer, size_t size)
 {
+    _mutex.lock();
     auto ret = HAL_UART_Transmit(_uartHandle, (const uint8_t *)buffer, size, UART_TIMEOUT_MS * TICKS_PER_MILLISECOND);
+    _mutex.unlock();
     if (ret != HAL_StatusTypeDef::HAL_OK)
     {
         Log::warning("[FpgaCommander] sending command failed with return code %d", ret);
@@ -102,6 +104,54 @@ bool FpgaCommander::pipelineBinarizationThreshold(uint8_t threshold)
     return sendCommand(buffer, size);
 }
 
+bool FpgaCommander::pipelineGeometry(const SensorModeInfo& info)
+{
+    static constexpr uint16_t WIDTH_MAX{1280U}; // refer to pipeline.v
+    static constexpr uint16_t HEIGHT_MAX{800U}; // refer to pipeline.v
+    if ((info.mode == SensorMode::MODE_UNDEFINED) || (info.width > WIDTH_MAX) || (info.height > HEIGHT_MAX))
+    {
+        Log::error("[FpgaCommander] set pipeline geometry failed, invalid mode %u (%ux%u)", info.mode, info.width, info.height);
+        return false;
+    }
+
+    static constexpr char PREFIX[] {"g"};
+    static constexpr size_t DIGIT_SIZE_MIN{5}; // 0,0,0
+    static constexpr size_t DIGIT_SIZE_MAX{12}; // 1280,800,255
+    static constexpr size_t BUFFER_SIZE{sizeof(PREFIX) + DIGIT_SIZE_MAX};
+    char buffer[BUFFER_SIZE];
+    int32_t size = snprintf(buffer, BUFFER_SIZE, "%s%u,%u,%u", PREFIX, info.width, info.height, info.mode);
+    size = size + NULL_TERMINATION_SIZE;
+    static constexpr int32_t COMMAND_SIZE_MIN{sizeof(PREFIX) + DIGIT_SIZE_MIN};
+    if ((size < COMMAND_SIZE_MIN) || (size > static_cast<int32_t>(BUFFER_SIZE)))
+    {
+        Log::error("[FpgaCommander] set pipeline geometry failed, populating buffer failed with code %d", size);
+        return false;
+    }
+    Log::info("[FpgaCommander] set pipeline geometry to %ux%u, mode %u", info.width, info.height, info.mode);
+    return sendCommand(buffer, size);
+}
+
+bool FpgaCommander::pipelineStreaming(bool enable)
+{
+    static constexpr char ENABLE[] {"f1"};
+    static constexpr char DISABLE[] {"f0"};
+
+    const char *buffer{nullptr};
+    size_t size{0U};
+    if (enable)
+    {
+        buffer = ENABLE;
+        size = sizeof(ENABLE);
+    }
+    else
+    {
+        buffer = DISABLE;
+        size = sizeof(DISABLE);
+    }
+    Log::info("[FpgaCommander] set pipeline streaming to %u", enable);
+    return sendCommand(buffer, size);
+}
+
 bool FpgaCommander::strobeEnablePulse(bool enable)
 {
     static constexpr char ENABLE[] {"se1"};
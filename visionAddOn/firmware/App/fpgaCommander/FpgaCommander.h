@@ -2,8 +2,10 @@
 #define VISIONADDON_APP_FPGACOMMANDER_FPGACOMMANDER_H
 
 #include "FpgaCommanderTypes.h"
+#include "camera/CameraTypes.h"
 
 #include "stm32f7xx_hal.h"
+#include "utils/mutex/Mutex.h"
 
 class FpgaCommander final
 {
@@ -30,6 +32,8 @@ public:
      */
     bool pipelineOutput(PipelineOutput output);
 
+    static constexpr uint8_t INIT_BINARIZATION_THRESHOLD {128U}; //!< threshold set by the fpga program on boot
+
     /**
      * @brief Set the pipeline image binarization threshold.
      *
@@ -38,6 +42,28 @@ public:
      */
     bool pipelineBinarizationThreshold(uint8_t threshold);
 
+    /**
+     * @brief Set the pipeline image geometry.
+     *
+     * The blob detection processes width x height pixels per frame, the mode is reported back in the blob packet header.
+     * The fpga applies the geometry on the next frame start.
+     *
+     * @param info of the sensor mode the camera was initialized with
+     * @return true if command was sent successfully, false otherwise
+     */
+    bool pipelineGeometry(const SensorModeInfo& info);
+
+    /**
+     * @brief Enable/disable streaming of the features.
+     *
+     * While streaming the fpga sends the features in chunks as they are detected instead of one packet per frame.
+     * The fpga switches on the next frame start.
+     *
+     * @param enable true to stream, false for one packet per frame
+     * @return true if command was sent successfully, false otherwise
+     */
+    bool pipelineStreaming(bool enable);
+
     /**
      * @brief Enable/disable pulsed strobe pin.
      *
@@ -77,6 +103,7 @@ public:
 private:
     bool sendCommand(const char* buffer, size_t size);
     UART_HandleTypeDef *_uartHandle;
+    Mutex _mutex; //!< the command and the auto exposure task both send commands
     static constexpr uint32_t UART_TIMEOUT_MS {10U};
     static constexpr size_t NULL_TERMINATION_SIZE {1};
 };
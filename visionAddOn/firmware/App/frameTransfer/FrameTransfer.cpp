@@ -20,9 +20,8 @@ FrameTransfer::TransferStatus FrameTransfer::sendFrameSegment(int32_t& socket) {
   } else {
     segmentSize = _bytesRemaining;
   }
-  // FIXME: frame buffer address and size should be managed by Camera class
-  const uint8_t* frameBufferBase {(const uint8_t*)EXTERNAL_SDRAM_BASE_ADDRESS};
-  const uint8_t* segmentBase {frameBufferBase + (_MAX_SEGMENT_SIZE * _segmentIndex++)};
+  // FIXME: frame size should be managed by Camera class
+  const uint8_t* segmentBase {_frame + (_MAX_SEGMENT_SIZE * _segmentIndex++)};
   Log::debug("[FrameTransfer] segment %u/%u, segmentBase: %#x", _segmentIndex, _REQUIRED_SEGMENTS, segmentBase);
   auto ret = lwip_write(socket, (void*)segmentBase, segmentSize); // blocking!
   if(ret != static_cast<int32_t>(segmentSize)) {
@@ -49,6 +48,12 @@ void FrameTransfer::endTransfer(int32_t& socket){
 }
 
 bool FrameTransfer::sendFrame(in_addr_t address, uint32_t port) { //!< blocking!
+    return sendFrame(address, port, reinterpret_cast<const uint8_t*>(EXTERNAL_SDRAM_BASE_ADDRESS));
+}
+
+bool FrameTransfer::sendFrame(in_addr_t address, uint32_t port, const uint8_t* frame) { //!< blocking!
+    ASSERT(frame != nullptr);
+    _frame = frame;
     int32_t clientSocket = lwip_socket(AF_INET, SOCK_STREAM, 0);
     struct sockaddr_in addr = {};
     addr.sin_len = sizeof(addr);
@@ -78,3 +83,18 @@ bool FrameTransfer::sendFrame(in_addr_t address, uint32_t port) { //!< blocking!
     }
     return true;
 }
+
+bool FrameTransfer::publishFrame(in_addr_t requester, uint32_t port) { //!< blocking!
+    const bool sent = sendFrame(requester, port);
+    Subscriptions::Destinations destinations {};
+    const size_t count = _subscriptions.next(SubscriberStream::STREAM_FRAMES, destinations);
+    for(size_t i = 0; i < count; i++) {
+      if((destinations[i].address == requester) && (destinations[i].port == port)) {
+        continue; // already sent
+      }
+      if(!sendFrame(destinations[i].address, destinations[i].port)) {
+        Log::warning("[FrameTransfer] sending frame to subscriber %u failed", i);
+      }
+    }
+    return sent;
+}
@@ -5,16 +5,25 @@
 #include "lwip/api.h"
 #include "lwip/sockets.h"
 #undef bind // to avoid conflicts with std functional bind
+#include "network/Subscriptions.h"
 
 class FrameTransfer final {
 public:
-    FrameTransfer() = default;
+    explicit FrameTransfer(Subscriptions& subscriptions) : _subscriptions{subscriptions} {};
     FrameTransfer (const FrameTransfer&) = delete;
     FrameTransfer& operator=(const FrameTransfer&) = delete;
     FrameTransfer (const FrameTransfer&&) = delete;
     FrameTransfer& operator=(const FrameTransfer&&) = delete;
 
-    bool sendFrame(in_addr_t address, uint32_t port); //!< blocking!
+    bool sendFrame(in_addr_t address, uint32_t port); //!< sends the frame buffer at the SDRAM base, blocking!
+    bool sendFrame(in_addr_t address, uint32_t port, const uint8_t* frame); //!< sends a 1280x800 frame, blocking!
+
+    /**
+     * @brief Send the frame to the requester, then one tcp stream per due frame subscriber. Blocking!
+     *
+     * @return true if the requester received the frame, subscriber failures are only logged
+     */
+    bool publishFrame(in_addr_t requester, uint32_t port);
 private:
     bool initTransfer(int32_t& socket);
     enum TransferStatus : uint8_t {
@@ -24,6 +33,8 @@ private:
     };
     TransferStatus sendFrameSegment(int32_t& socket);
     void endTransfer(int32_t& socket); 
+    Subscriptions& _subscriptions;
+    const uint8_t* _frame {nullptr}; //!< of the running transfer
     osSemaphoreId_t _transferRequestSemaphore;
     size_t _segmentIndex = 0;
     size_t _bytesRemaining = 0;
@@ -0,0 +1,31 @@
+#include "BootTimeline.h"
+
+#include "stm32f7xx_hal.h"
+#include "utils/Log.h"
+
+std::array<uint32_t, NUMBER_OF_BOOT_PHASES> BootTimeline::_ms {};
+std::array<std::atomic<bool>, NUMBER_OF_BOOT_PHASES> BootTimeline::_reached {};
+
+void BootTimeline::reached(BootPhase phase)
+{
+    if((phase >= NUMBER_OF_BOOT_PHASES) || _reached[phase].load(std::memory_order_acquire)) {
+        return;
+    }
+    _ms[phase] = HAL_GetTick();
+    _reached[phase].store(true, std::memory_order_release);
+    Log::info("[BootTimeline] phase %u reached after %lu ms", phase, _ms[phase]);
+}
+
+BootTimes BootTimeline::times()
+{
+    BootTimes times {};
+    for(size_t phase = 0; phase < NUMBER_OF_BOOT_PHASES; phase++) {
+        times.ms[phase] = _reached[phase].load(std::memory_order_acquire) ? _ms[phase] : BootTimes::NOT_REACHED;
+    }
+    return times;
+}
+
+void boot_timeline_reached(BootPhase phase)
+{
+    BootTimeline::reached(phase);
+}
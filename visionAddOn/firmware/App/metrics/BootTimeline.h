@@ -0,0 +1,46 @@
+#ifndef VISIONADDON_APP_METRICS_BOOTTIMELINE_H
+#define VISIONADDON_APP_METRICS_BOOTTIMELINE_H
+
+#include "c_boot_timeline.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class BootTimes {
+public:
+    std::array<uint32_t, NUMBER_OF_BOOT_PHASES> ms {}; //!< since reset, indexed by BootPhase
+
+    static constexpr uint32_t NOT_REACHED {0xffffffffU};
+    static constexpr size_t SIZE {NUMBER_OF_BOOT_PHASES * sizeof(uint32_t)};
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer, ms.data(), SIZE);
+        return true;
+    }
+};
+
+// Time since reset each boot phase was first reached at, in ms of the HAL tick which runs before the scheduler starts.
+//
+// Every phase is reached from one place only, the first call counts and later calls return after an atomic load.
+class BootTimeline final {
+public:
+    BootTimeline() = delete;
+    BootTimeline (const BootTimeline&) = delete;
+    BootTimeline& operator=(const BootTimeline&) = delete;
+    BootTimeline (const BootTimeline&&) = delete;
+    BootTimeline& operator=(const BootTimeline&&) = delete;
+
+    static void reached(BootPhase phase);
+    static BootTimes times(); //!< BootTimes::NOT_REACHED for the phases not reached yet
+private:
+    static std::array<uint32_t, NUMBER_OF_BOOT_PHASES> _ms;
+    static std::array<std::atomic<bool>, NUMBER_OF_BOOT_PHASES> _reached;
+};
+
+#endif // VISIONADDON_APP_METRICS_BOOTTIMELINE_H
@@ -0,0 +1,123 @@
+#include "ImageKernelBenchmark.h"
+
+#include "stm32f7xx_hal.h"
+#include "utils/assert.h"
+#include "utils/Cache.h"
+#include "utils/CycleCounter.h"
+#include "utils/image/ImageKernels.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+constexpr size_t HISTOGRAM_BINS {256};
+}
+
+ImageKernelBenchmark::ImageKernelBenchmark(uint8_t* frame, uint8_t* scratch) :
+_frame{frame},
+_scratch{scratch},
+_referenceScratch{scratch + PIXELS}
+{
+    ASSERT(frame != nullptr);
+    ASSERT(scratch != nullptr);
+}
+
+ImageKernelBenchmarkResult ImageKernelBenchmark::measure(uint8_t threshold)
+{
+    ImageKernelBenchmarkResult result {};
+    result.pixels = PIXELS;
+    result.threshold = threshold;
+
+    result.kernels[IMAGE_KERNEL_THRESHOLD] = time(PIXELS, PIXELS,
+        [&](uint8_t* out) {ImageKernels::threshold(_frame, out, PIXELS, threshold);},
+        [&](uint8_t* out) {ImageKernels::Reference::threshold(_frame, out, PIXELS, threshold);});
+
+    result.kernels[IMAGE_KERNEL_PACK_BITS] = time(PIXELS, PIXELS / CHAR_BIT,
+        [&](uint8_t* out) {ImageKernels::packBits(_frame, out, PIXELS, threshold);},
+        [&](uint8_t* out) {ImageKernels::Reference::packBits(_frame, out, PIXELS, threshold);});
+
+    result.kernels[IMAGE_KERNEL_HISTOGRAM] = time(PIXELS, HISTOGRAM_BINS * sizeof(uint32_t),
+        [&](uint8_t* out) {ImageKernels::histogram(_frame, PIXELS, reinterpret_cast<uint32_t*>(out));},
+        [&](uint8_t* out) {ImageKernels::Reference::histogram(_frame, PIXELS, reinterpret_cast<uint32_t*>(out));});
+
+    static constexpr size_t BOX_WIDTH {WIDTH / BOX_FACTOR};
+    result.kernels[IMAGE_KERNEL_BOX_DOWN] = time(PIXELS, PIXELS / (BOX_FACTOR * BOX_FACTOR),
+        [&](uint8_t* out) {
+            for(size_t row = 0; row < (ROWS / BOX_FACTOR); row++) {
+                ImageKernels::boxDown(_frame + (row * BOX_FACTOR * WIDTH), WIDTH, WIDTH, BOX_FACTOR, _sums.data(), out + (row * BOX_WIDTH));
+            }
+        },
+        [&](uint8_t* out) {
+            for(size_t row = 0; row < (ROWS / BOX_FACTOR); row++) {
+                ImageKernels::Reference::boxDown(_frame + (row * BOX_FACTOR * WIDTH), WIDTH, WIDTH, BOX_FACTOR, _sums.data(), out + (row * BOX_WIDTH));
+            }
+        });
+
+    // centered, half the width and half the rows
+    const uint8_t* region = _frame + ((ROWS / 4) * WIDTH) + (WIDTH / 4);
+    result.kernels[IMAGE_KERNEL_CROP] = time(PIXELS / 4, PIXELS / 4,
+        [&](uint8_t* out) {ImageKernels::crop(region, WIDTH, WIDTH / 2, ROWS / 2, out);},
+        [&](uint8_t* out) {ImageKernels::Reference::crop(region, WIDTH, WIDTH / 2, ROWS / 2, out);});
+
+    result.kernels[IMAGE_KERNEL_RUN_LENGTHS] = time(PIXELS, ROWS * RUN_LENGTHS_ROW_SIZE,
+        [&](uint8_t* out) {
+            for(size_t row = 0; row < ROWS; row++) {
+                uint16_t* runs = reinterpret_cast<uint16_t*>(out + (row * RUN_LENGTHS_ROW_SIZE));
+                runs[0] = static_cast<uint16_t>(ImageKernels::runLengths(_frame + (row * WIDTH), WIDTH, threshold, runs + 1, RUNS_PER_ROW));
+            }
+        },
+        [&](uint8_t* out) {
+            for(size_t row = 0; row < ROWS; row++) {
+                uint16_t* runs = reinterpret_cast<uint16_t*>(out + (row * RUN_LENGTHS_ROW_SIZE));
+                runs[0] = static_cast<uint16_t>(ImageKernels::Reference::runLengths(_frame + (row * WIDTH), WIDTH, threshold, runs + 1, RUNS_PER_ROW));
+            }
+        });
+
+    for(uint8_t id = 0; id < NUMBER_OF_IMAGE_KERNELS; id++) {
+        const ImageKernelTiming& timing = result.kernels[id];
+        Log::info("[ImageKernelBenchmark] kernel %u: %lu cycles (reference %lu), %lu kB/s, %s",
+            id, timing.cycles, timing.referenceCycles, timing.kBps, timing.match ? "match" : "MISMATCH");
+    }
+    return result;
+}
+
+template<typename Kernel, typename Reference>
+ImageKernelTiming ImageKernelBenchmark::time(size_t pixels, size_t outputSize, Kernel kernel, Reference reference)
+{
+    // outputs are compared as a whole, unused parts must be equal as well
+    std::fill_n(_scratch, outputSize, 0U);
+    std::fill_n(_referenceScratch, outputSize, 0U);
+
+    ImageKernelTiming timing {};
+    evict();
+    uint32_t start = CycleCounter::now();
+    kernel(_scratch);
+    timing.cycles = CycleCounter::now() - start;
+
+    evict();
+    start = CycleCounter::now();
+    reference(_referenceScratch);
+    timing.referenceCycles = CycleCounter::now() - start;
+
+    timing.kBps = kBps(pixels, timing.cycles);
+    timing.match = std::memcmp(_scratch, _referenceScratch, outputSize) == 0;
+    return timing;
+}
+
+void ImageKernelBenchmark::evict()
+{
+    // clean and invalidate, nothing of the previous run stays in the data cache
+    Cache::beforeDmaWrite(_frame, PIXELS);
+    Cache::beforeDmaWrite(_scratch, SCRATCH_SIZE);
+}
+
+uint32_t ImageKernelBenchmark::kBps(size_t pixels, uint32_t cycles) const
+{
+    if(cycles == 0U) {
+        return 0;
+    }
+    static constexpr uint64_t BYTES_PER_KILOBYTE {1000};
+    return static_cast<uint32_t>((static_cast<uint64_t>(pixels) * SystemCoreClock) / (static_cast<uint64_t>(cycles) * BYTES_PER_KILOBYTE));
+}
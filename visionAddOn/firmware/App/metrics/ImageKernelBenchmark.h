@@ -0,0 +1,51 @@
+#ifndef VISIONADDON_APP_METRICS_IMAGEKERNELBENCHMARK_H
+#define VISIONADDON_APP_METRICS_IMAGEKERNELBENCHMARK_H
+
+#include "MetricsTypes.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Cycles of the SIMD image kernels (utils/image/ImageKernels) against their byte loop references on the camera frame.
+//
+// Runs over the upper half of the frame, the SIMD and the reference results go to the two halves of the scratch and
+// are compared afterwards. Every run starts cold, the frame and the scratch are evicted from the data cache first.
+// The last captured frame is used as is, its content only matters for the run length kernel. Executed by the calling
+// task, some 100 ms.
+class ImageKernelBenchmark final {
+public:
+    /**
+     * @param frame 1280x800 px, line aligned, e.g. the camera frame buffer
+     * @param scratch SCRATCH_SIZE bytes, line aligned, the content is overwritten
+     */
+    ImageKernelBenchmark(uint8_t* frame, uint8_t* scratch);
+    ImageKernelBenchmark (const ImageKernelBenchmark&) = delete;
+    ImageKernelBenchmark& operator=(const ImageKernelBenchmark&) = delete;
+    ImageKernelBenchmark (const ImageKernelBenchmark&&) = delete;
+    ImageKernelBenchmark& operator=(const ImageKernelBenchmark&&) = delete;
+
+    ImageKernelBenchmarkResult measure(uint8_t threshold); //!< blocking!
+
+    static constexpr size_t WIDTH {1280};
+    static constexpr size_t ROWS {400}; //!< upper half of the frame
+    static constexpr size_t PIXELS {WIDTH * ROWS};
+    static constexpr size_t SCRATCH_SIZE {2 * PIXELS};
+
+private:
+    template<typename Kernel, typename Reference>
+    ImageKernelTiming time(size_t pixels, size_t outputSize, Kernel kernel, Reference reference);
+    void evict();
+    uint32_t kBps(size_t pixels, uint32_t cycles) const;
+
+    uint8_t* _frame;
+    uint8_t* _scratch;
+    uint8_t* _referenceScratch; //!< upper half of the scratch
+
+    static constexpr size_t BOX_FACTOR {4};
+    static constexpr size_t RUNS_PER_ROW {64}; //!< toggle positions kept per row, a few markers per row at most
+    static constexpr size_t RUN_LENGTHS_ROW_SIZE {(1 + RUNS_PER_ROW) * sizeof(uint16_t)}; //!< count, positions
+    std::array<uint32_t, WIDTH / BOX_FACTOR> _sums {};
+};
+
+#endif // VISIONADDON_APP_METRICS_IMAGEKERNELBENCHMARK_H
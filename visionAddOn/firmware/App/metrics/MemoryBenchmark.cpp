@@ -0,0 +1,71 @@
+#include "MemoryBenchmark.h"
+
+#include "stm32f7xx_hal.h"
+#include "utils/assert.h"
+#include "utils/Cache.h"
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <cstring>
+
+MemoryBenchmark::MemoryBenchmark(uint8_t* frame, uint8_t* scratch, size_t size) :
+_frame{frame},
+_scratch{scratch},
+_size{size}
+{
+    ASSERT(frame != nullptr);
+    ASSERT(scratch != nullptr);
+    ASSERT((size % Cache::LINE_SIZE) == 0U);
+}
+
+MemoryBenchmarkResult MemoryBenchmark::measure()
+{
+    MemoryBenchmarkResult result {};
+    result.dataCacheEnabled = Cache::dataEnabled();
+    result.frameSize = _size;
+
+    Cache::dataEnable(true);
+    const uint32_t start = CycleCounter::now();
+    Cache::afterDmaWrite(_frame, _size);
+    result.invalidateCycles = CycleCounter::now() - start;
+    result.cached = pass();
+
+    Cache::dataEnable(false);
+    result.uncached = pass();
+    Cache::dataEnable(result.dataCacheEnabled);
+
+    Log::info("[MemoryBenchmark] %lu bytes, scan %lu / %lu kB/s, copy %lu / %lu kB/s (cached / uncached), invalidate %lu cycles",
+        result.frameSize, result.cached.scanKBps, result.uncached.scanKBps, result.cached.copyKBps, result.uncached.copyKBps, result.invalidateCycles);
+    return result;
+}
+
+MemoryBenchmarkPass MemoryBenchmark::pass()
+{
+    MemoryBenchmarkPass pass {};
+    const uint32_t* frame32 = reinterpret_cast<const uint32_t*>(_frame);
+    const size_t words = _size / sizeof(uint32_t);
+    uint32_t sum = 0;
+    uint32_t start = CycleCounter::now();
+    for(size_t i = 0; i < words; i++) {
+        sum += frame32[i];
+    }
+    pass.scanCycles = CycleCounter::now() - start;
+    _sum = sum;
+
+    start = CycleCounter::now();
+    std::memcpy(_scratch, _frame, _size);
+    pass.copyCycles = CycleCounter::now() - start;
+
+    pass.scanKBps = kBps(pass.scanCycles);
+    pass.copyKBps = kBps(pass.copyCycles);
+    return pass;
+}
+
+uint32_t MemoryBenchmark::kBps(uint32_t cycles) const
+{
+    if(cycles == 0U) {
+        return 0;
+    }
+    static constexpr uint64_t BYTES_PER_KILOBYTE {1000};
+    return static_cast<uint32_t>((static_cast<uint64_t>(_size) * SystemCoreClock) / (static_cast<uint64_t>(cycles) * BYTES_PER_KILOBYTE));
+}
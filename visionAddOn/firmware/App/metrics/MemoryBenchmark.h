@@ -0,0 +1,39 @@
+#ifndef VISIONADDON_APP_METRICS_MEMORYBENCHMARK_H
+#define VISIONADDON_APP_METRICS_MEMORYBENCHMARK_H
+
+#include "MetricsTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Scan and copy throughput over a frame in the external SDRAM, with the data cache on and off.
+//
+// The cached pass starts cold, the frame is invalidated first as after a DCMI capture. The data cache is switched
+// off for the uncached pass, the whole system runs uncached for its duration (some 10 ms), the setting outside of the
+// benchmark is restored afterwards. Executed by the calling task.
+class MemoryBenchmark final {
+public:
+    /**
+     * @param frame read by the passes, line aligned, e.g. the camera frame buffer
+     * @param scratch copy destination, line aligned, the content is overwritten
+     * @param size of frame and scratch in bytes, whole cache lines
+     */
+    MemoryBenchmark(uint8_t* frame, uint8_t* scratch, size_t size);
+    MemoryBenchmark (const MemoryBenchmark&) = delete;
+    MemoryBenchmark& operator=(const MemoryBenchmark&) = delete;
+    MemoryBenchmark (const MemoryBenchmark&&) = delete;
+    MemoryBenchmark& operator=(const MemoryBenchmark&&) = delete;
+
+    MemoryBenchmarkResult measure(); //!< blocking!
+
+private:
+    MemoryBenchmarkPass pass();
+    uint32_t kBps(uint32_t cycles) const;
+
+    uint8_t* _frame;
+    uint8_t* _scratch;
+    size_t _size;
+    volatile uint32_t _sum {0}; //!< keeps the scan loop
+};
+
+#endif // VISIONADDON_APP_METRICS_MEMORYBENCHMARK_H
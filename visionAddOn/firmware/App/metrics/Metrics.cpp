@@ -0,0 +1,100 @@
+#include "Metrics.h"
+#include "PeripheralErrors.h"
+
+#include "lwip/memp.h"
+#include "lwip/stats.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/interrupt/InterruptProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(LINK_STATS && UDP_STATS && TCP_STATS && MEM_STATS && MEMP_STATS, "metrics require LWIP_STATS, see lwipopts.h");
+
+// indexed by MetricsTask, names as passed to the thread creation (freertos.c, lwip)
+static constexpr const char* TASK_NAMES[NUMBER_OF_METRICS_TASKS] {
+    "networkTask",
+    "blobDetectorTas",
+    "controlTask",
+    "statsTask",
+    "tcpip_thread",
+    "EthIf",
+    "EthLink",
+    "IDLE",
+    "Tmr Svc",
+    "profilerTask",
+};
+
+Metrics::Metrics(BlobReceiver& blobReceiver, TaskProfiler& taskProfiler, osMessageQueueId_t spiRxQueue, osMessageQueueId_t frameStatisticsQueue) :
+_blobReceiver{blobReceiver},
+_taskProfiler{taskProfiler},
+_spiRxQueue{spiRxQueue},
+_frameStatisticsQueue{frameStatisticsQueue}
+{
+    ASSERT(_spiRxQueue != nullptr);
+    ASSERT(_frameStatisticsQueue != nullptr);
+}
+
+RuntimeMetrics Metrics::collect() {
+    RuntimeMetrics metrics {};
+    metrics.uptimeMs = osKernelGetTickCount() / TICKS_PER_MILLISECOND;
+    collectLwip(metrics);
+
+    const BufferPoolStats pool {_blobReceiver.poolStats()};
+    metrics.values[METRIC_BLOB_POOL_USED_MAX] = pool.blocksInUseMax;
+    metrics.values[METRIC_BLOB_POOL_ERRORS] = pool.acquireFailures + pool.invalidReleases;
+    const FeatureStreamStats stream {_blobReceiver.stats()};
+    metrics.values[METRIC_BLOB_PACKETS_RECEIVED] = stream.packetsReceived;
+    metrics.values[METRIC_BLOB_PACKETS_CORRUPT] = stream.packetsCorrupt;
+    metrics.values[METRIC_BLOB_PACKETS_SENT] = stream.packetsSent;
+    metrics.values[METRIC_BLOB_SEND_FAILURES] = stream.sendFailures;
+    metrics.values[METRIC_BLOB_OVERRUNS] = stream.overruns;
+
+    metrics.values[METRIC_EXTI_INTERRUPTS] = InterruptProfiler::stats(INTERRUPT_SOURCE_EXTI).count;
+    metrics.values[METRIC_UART_RX_INTERRUPTS] = InterruptProfiler::stats(INTERRUPT_SOURCE_UART_RX).count;
+    metrics.values[METRIC_SPI_RX_QUEUE_DEPTH] = osMessageQueueGetCount(_spiRxQueue);
+    metrics.values[METRIC_FRAME_STATISTICS_QUEUE_DEPTH] = osMessageQueueGetCount(_frameStatisticsQueue);
+
+    for(size_t i = 0; i < NUMBER_OF_PERIPHERALS; i++) {
+        metrics.peripheralErrors[i] = PeripheralErrors::get(static_cast<MetricsPeripheral>(i));
+    }
+    collectTasks(metrics);
+    return metrics;
+}
+
+void Metrics::collectLwip(RuntimeMetrics& metrics) const {
+    // lwip counters are single words, reading them without the core lock may only miss concurrent increments
+    metrics.values[METRIC_LINK_XMIT] = lwip_stats.link.xmit;
+    metrics.values[METRIC_LINK_RECV] = lwip_stats.link.recv;
+    metrics.values[METRIC_LINK_DROP] = lwip_stats.link.drop;
+    metrics.values[METRIC_LINK_ERR] = lwip_stats.link.err;
+    metrics.values[METRIC_UDP_XMIT] = lwip_stats.udp.xmit;
+    metrics.values[METRIC_UDP_RECV] = lwip_stats.udp.recv;
+    metrics.values[METRIC_UDP_DROP] = lwip_stats.udp.drop;
+    metrics.values[METRIC_TCP_XMIT] = lwip_stats.tcp.xmit;
+    metrics.values[METRIC_TCP_RECV] = lwip_stats.tcp.recv;
+    metrics.values[METRIC_TCP_DROP] = lwip_stats.tcp.drop;
+    metrics.values[METRIC_MEM_USED] = lwip_stats.mem.used;
+    metrics.values[METRIC_MEM_USED_MAX] = lwip_stats.mem.max;
+    metrics.values[METRIC_MEM_ERRORS] = lwip_stats.mem.err;
+    const struct stats_mem* pbufPool = lwip_stats.memp[MEMP_PBUF_POOL];
+    metrics.values[METRIC_PBUF_POOL_USED] = pbufPool->used;
+    metrics.values[METRIC_PBUF_POOL_USED_MAX] = pbufPool->max;
+    metrics.values[METRIC_PBUF_POOL_ERRORS] = pbufPool->err;
+}
+
+void Metrics::collectTasks(RuntimeMetrics& metrics) {
+    const TaskProfile profile {_taskProfiler.profile()};
+    for(size_t i = 0; i < profile.taskCount; i++) {
+        const TaskProfileEntry& entry = profile.tasks[i];
+        for(size_t task = 0; task < NUMBER_OF_METRICS_TASKS; task++) {
+            if(std::strncmp(entry.name.data(), TASK_NAMES[task], TaskProfileEntry::NAME_SIZE) != 0) {
+                continue;
+            }
+            metrics.tasks[task].stackFreeMin = std::min(entry.stackFreeMin, static_cast<uint16_t>(TaskMetrics::STACK_UNKNOWN - 1U));
+            metrics.tasks[task].cpuPermille = entry.cpuPermille;
+            break;
+        }
+    }
+}
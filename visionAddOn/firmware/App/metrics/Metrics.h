@@ -0,0 +1,34 @@
+#ifndef VISIONADDON_APP_METRICS_METRICS_H
+#define VISIONADDON_APP_METRICS_METRICS_H
+
+#include "MetricsTypes.h"
+#include "TaskProfiler.h"
+#include "blob/BlobReceiver.h"
+#include "cmsis_os2.h"
+
+#include <cstdint>
+
+// Collects the runtime metrics on request, replaces the periodic lwip stats_display text dumps.
+//
+// All sources are counters updated in place by their owners, collecting only reads them.
+// Cheap enough to be polled by a host dashboard at 1 Hz.
+class Metrics final {
+public:
+    Metrics(BlobReceiver& blobReceiver, TaskProfiler& taskProfiler, osMessageQueueId_t spiRxQueue, osMessageQueueId_t frameStatisticsQueue);
+    Metrics (const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+    Metrics (const Metrics&&) = delete;
+    Metrics& operator=(const Metrics&&) = delete;
+
+    RuntimeMetrics collect();
+private:
+    void collectLwip(RuntimeMetrics& metrics) const;
+    void collectTasks(RuntimeMetrics& metrics);
+
+    BlobReceiver& _blobReceiver;
+    TaskProfiler& _taskProfiler;
+    osMessageQueueId_t _spiRxQueue;
+    osMessageQueueId_t _frameStatisticsQueue;
+};
+
+#endif // VISIONADDON_APP_METRICS_METRICS_H
@@ -0,0 +1,377 @@
+#ifndef VISIONADDON_APP_METRICS_METRICSTYPES_H
+#define VISIONADDON_APP_METRICS_METRICSTYPES_H
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// ids are indices into RuntimeMetrics::values, new ids are appended, host tables must match
+enum MetricId : uint8_t {
+    METRIC_LINK_XMIT = 0, //!< lwip link layer counters
+    METRIC_LINK_RECV = 1,
+    METRIC_LINK_DROP = 2,
+    METRIC_LINK_ERR = 3,
+    METRIC_UDP_XMIT = 4, //!< lwip udp counters
+    METRIC_UDP_RECV = 5,
+    METRIC_UDP_DROP = 6,
+    METRIC_TCP_XMIT = 7, //!< lwip tcp counters
+    METRIC_TCP_RECV = 8,
+    METRIC_TCP_DROP = 9,
+    METRIC_MEM_USED = 10, //!< lwip heap in bytes
+    METRIC_MEM_USED_MAX = 11,
+    METRIC_MEM_ERRORS = 12,
+    METRIC_PBUF_POOL_USED = 13, //!< lwip receive pbuf pool in pbufs
+    METRIC_PBUF_POOL_USED_MAX = 14,
+    METRIC_PBUF_POOL_ERRORS = 15,
+    METRIC_BLOB_POOL_USED_MAX = 16, //!< feature packet buffer pool in blocks
+    METRIC_BLOB_POOL_ERRORS = 17,
+    METRIC_BLOB_PACKETS_RECEIVED = 18, //!< feature stream, see FeatureStreamStats
+    METRIC_BLOB_PACKETS_CORRUPT = 19,
+    METRIC_BLOB_PACKETS_SENT = 20,
+    METRIC_BLOB_SEND_FAILURES = 21,
+    METRIC_BLOB_OVERRUNS = 22,
+    METRIC_EXTI_INTERRUPTS = 23,
+    METRIC_UART_RX_INTERRUPTS = 24,
+    METRIC_SPI_RX_QUEUE_DEPTH = 25, //!< messages pending at the time of the request
+    METRIC_FRAME_STATISTICS_QUEUE_DEPTH = 26,
+    NUMBER_OF_METRICS = 27,
+};
+
+enum MetricsPeripheral : uint8_t {
+    PERIPHERAL_SPI = 0, //!< feature receive spi and its dma
+    PERIPHERAL_DCMI = 1, //!< camera interface and its dma
+    PERIPHERAL_UART = 2, //!< fpga command uart and its dma
+    NUMBER_OF_PERIPHERALS = 3,
+};
+
+// tasks are looked up by name, entries stay empty for tasks not (yet) created
+enum MetricsTask : uint8_t {
+    TASK_NETWORK = 0,
+    TASK_BLOB_DETECTOR = 1,
+    TASK_CONTROL = 2,
+    TASK_STATS = 3,
+    TASK_TCPIP = 4,
+    TASK_ETHERNET_INPUT = 5,
+    TASK_ETHERNET_LINK = 6,
+    TASK_IDLE = 7,
+    TASK_TIMER = 8,
+    TASK_PROFILER = 9,
+    NUMBER_OF_METRICS_TASKS = 10,
+};
+
+// kernels of utils/image/ImageKernels in the order of ImageKernelBenchmarkResult::kernels
+enum ImageKernelId : uint8_t {
+    IMAGE_KERNEL_THRESHOLD = 0,
+    IMAGE_KERNEL_PACK_BITS = 1,
+    IMAGE_KERNEL_HISTOGRAM = 2,
+    IMAGE_KERNEL_BOX_DOWN = 3, //!< factor 4
+    IMAGE_KERNEL_CROP = 4,
+    IMAGE_KERNEL_RUN_LENGTHS = 5,
+    NUMBER_OF_IMAGE_KERNELS = 6,
+};
+
+// regions of the external sdram the pattern test of metrics/SdramTest runs on
+enum SdramRegion : uint8_t {
+    SDRAM_REGION_FRAME_HISTORY = 0, //!< 13 MB, tested in the background at boot
+    SDRAM_REGION_RECORDER = 1, //!< 16 MB, the recorder must be disabled, its records are dropped
+    NUMBER_OF_SDRAM_REGIONS = 2,
+};
+
+class PeripheralErrorMetrics {
+public:
+    uint32_t flags = {}; //!< HAL ErrorCode bits, or-ed since boot
+    uint32_t count = {}; //!< error callbacks since boot
+
+    static constexpr size_t SIZE {8};
+    static constexpr size_t OFFSET_FLAGS {0};
+    static constexpr size_t OFFSET_COUNT {OFFSET_FLAGS + sizeof(flags)};
+    static_assert(OFFSET_COUNT + sizeof(count) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_FLAGS, &flags, sizeof(flags));
+        std::memcpy(buffer + OFFSET_COUNT, &count, sizeof(count));
+        return true;
+    }
+};
+
+class TaskMetrics {
+public:
+    static constexpr uint16_t STACK_UNKNOWN {UINT16_MAX};
+    uint16_t stackFreeMin = {STACK_UNKNOWN}; //!< stack high water mark, least free bytes since task start
+    uint16_t cpuPermille = {}; //!< share of the cpu time during the latest TaskProfiler period
+
+    static constexpr size_t SIZE {4};
+    static constexpr size_t OFFSET_STACK_FREE_MIN {0};
+    static constexpr size_t OFFSET_CPU_PERMILLE {OFFSET_STACK_FREE_MIN + sizeof(stackFreeMin)};
+    static_assert(OFFSET_CPU_PERMILLE + sizeof(cpuPermille) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_STACK_FREE_MIN, &stackFreeMin, sizeof(stackFreeMin));
+        std::memcpy(buffer + OFFSET_CPU_PERMILLE, &cpuPermille, sizeof(cpuPermille));
+        return true;
+    }
+};
+
+class TaskProfileEntry {
+public:
+    static constexpr size_t NAME_SIZE {16}; //!< configMAX_TASK_NAME_LEN, including the null terminator
+    std::array<char, NAME_SIZE> name {}; //!< null terminated
+    uint8_t priority = {}; //!< current priority, same scale as osPriority_t
+    uint8_t state = {}; //!< eTaskState, 0 running, 1 ready, 2 blocked, 3 suspended, 4 deleted
+    uint16_t stackFreeMin = {}; //!< stack high water mark, least free bytes since task start
+    uint16_t cpuPermille = {}; //!< share of the cpu time during the latest period
+    uint16_t cpuPermilleMax = {}; //!< highest share of any period since boot
+
+    static constexpr size_t SIZE {24};
+    static constexpr size_t OFFSET_NAME {0};
+    static constexpr size_t OFFSET_PRIORITY {OFFSET_NAME + NAME_SIZE};
+    static constexpr size_t OFFSET_STATE {OFFSET_PRIORITY + sizeof(priority)};
+    static constexpr size_t OFFSET_STACK_FREE_MIN {OFFSET_STATE + sizeof(state)};
+    static constexpr size_t OFFSET_CPU_PERMILLE {OFFSET_STACK_FREE_MIN + sizeof(stackFreeMin)};
+    static constexpr size_t OFFSET_CPU_PERMILLE_MAX {OFFSET_CPU_PERMILLE + sizeof(cpuPermille)};
+    static_assert(OFFSET_CPU_PERMILLE_MAX + sizeof(cpuPermilleMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_NAME, name.data(), NAME_SIZE);
+        buffer[OFFSET_PRIORITY] = priority;
+        buffer[OFFSET_STATE] = state;
+        std::memcpy(buffer + OFFSET_STACK_FREE_MIN, &stackFreeMin, sizeof(stackFreeMin));
+        std::memcpy(buffer + OFFSET_CPU_PERMILLE, &cpuPermille, sizeof(cpuPermille));
+        std::memcpy(buffer + OFFSET_CPU_PERMILLE_MAX, &cpuPermilleMax, sizeof(cpuPermilleMax));
+        return true;
+    }
+};
+
+// Latest TaskProfiler sample, all tasks of the system including the kernel and lwip ones.
+// All entries don't fit into a single command response, the serialized form holds the summary and a single entry.
+class TaskProfile {
+public:
+    static constexpr size_t TASKS_MAX {16};
+    uint16_t periodMs = {}; //!< length of the sampled period
+    uint16_t busyPermille = {}; //!< cpu time not spent in the idle task during the period
+    uint16_t busyPermilleMax = {}; //!< highest busy share of any period since boot
+    uint8_t taskCount = {}; //!< valid entries in tasks
+    std::array<TaskProfileEntry, TASKS_MAX> tasks {};
+
+    static constexpr size_t SIZE {8 + TaskProfileEntry::SIZE};
+    static constexpr size_t OFFSET_PERIOD_MS {0};
+    static constexpr size_t OFFSET_BUSY_PERMILLE {OFFSET_PERIOD_MS + sizeof(periodMs)};
+    static constexpr size_t OFFSET_BUSY_PERMILLE_MAX {OFFSET_BUSY_PERMILLE + sizeof(busyPermille)};
+    static constexpr size_t OFFSET_TASK_COUNT {OFFSET_BUSY_PERMILLE_MAX + sizeof(busyPermilleMax)};
+    static constexpr size_t OFFSET_INDEX {OFFSET_TASK_COUNT + sizeof(taskCount)};
+    static constexpr size_t OFFSET_ENTRY {OFFSET_INDEX + sizeof(uint8_t)};
+    static_assert(OFFSET_ENTRY + TaskProfileEntry::SIZE == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size, uint8_t index) const {
+        if((SIZE > size) || (index >= taskCount)) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_PERIOD_MS, &periodMs, sizeof(periodMs));
+        std::memcpy(buffer + OFFSET_BUSY_PERMILLE, &busyPermille, sizeof(busyPermille));
+        std::memcpy(buffer + OFFSET_BUSY_PERMILLE_MAX, &busyPermilleMax, sizeof(busyPermilleMax));
+        buffer[OFFSET_TASK_COUNT] = taskCount;
+        buffer[OFFSET_INDEX] = index;
+        return tasks[index].toBytes(buffer + OFFSET_ENTRY, TaskProfileEntry::SIZE);
+    }
+};
+
+// Versioned snapshot of the runtime metrics. The counts allow hosts to parse snapshots of newer firmware,
+// the version is only increased if existing fields change their meaning or position.
+class RuntimeMetrics {
+public:
+    static constexpr uint8_t VERSION {1};
+    uint32_t uptimeMs = {};
+    std::array<uint32_t, NUMBER_OF_METRICS> values {}; //!< indexed by MetricId
+    std::array<PeripheralErrorMetrics, NUMBER_OF_PERIPHERALS> peripheralErrors {}; //!< indexed by MetricsPeripheral
+    std::array<TaskMetrics, NUMBER_OF_METRICS_TASKS> tasks {}; //!< indexed by MetricsTask
+
+    static constexpr size_t SIZE {8 + (NUMBER_OF_METRICS * sizeof(uint32_t)) + (NUMBER_OF_PERIPHERALS * PeripheralErrorMetrics::SIZE) + (NUMBER_OF_METRICS_TASKS * TaskMetrics::SIZE)};
+    static constexpr size_t OFFSET_VERSION {0};
+    static constexpr size_t OFFSET_VALUE_COUNT {OFFSET_VERSION + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_PERIPHERAL_COUNT {OFFSET_VALUE_COUNT + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_TASK_COUNT {OFFSET_PERIPHERAL_COUNT + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_UPTIME_MS {OFFSET_TASK_COUNT + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_VALUES {OFFSET_UPTIME_MS + sizeof(uptimeMs)};
+    static constexpr size_t OFFSET_PERIPHERAL_ERRORS {OFFSET_VALUES + (NUMBER_OF_METRICS * sizeof(uint32_t))};
+    static constexpr size_t OFFSET_TASKS {OFFSET_PERIPHERAL_ERRORS + (NUMBER_OF_PERIPHERALS * PeripheralErrorMetrics::SIZE)};
+    static_assert(OFFSET_TASKS + (NUMBER_OF_METRICS_TASKS * TaskMetrics::SIZE) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_VERSION] = VERSION;
+        buffer[OFFSET_VALUE_COUNT] = NUMBER_OF_METRICS;
+        buffer[OFFSET_PERIPHERAL_COUNT] = NUMBER_OF_PERIPHERALS;
+        buffer[OFFSET_TASK_COUNT] = NUMBER_OF_METRICS_TASKS;
+        std::memcpy(buffer + OFFSET_UPTIME_MS, &uptimeMs, sizeof(uptimeMs));
+        std::memcpy(buffer + OFFSET_VALUES, values.data(), NUMBER_OF_METRICS * sizeof(uint32_t));
+        for(size_t i = 0; i < NUMBER_OF_PERIPHERALS; i++) {
+            peripheralErrors[i].toBytes(buffer + OFFSET_PERIPHERAL_ERRORS + (i * PeripheralErrorMetrics::SIZE), PeripheralErrorMetrics::SIZE);
+        }
+        for(size_t i = 0; i < NUMBER_OF_METRICS_TASKS; i++) {
+            tasks[i].toBytes(buffer + OFFSET_TASKS + (i * TaskMetrics::SIZE), TaskMetrics::SIZE);
+        }
+        return true;
+    }
+};
+
+// One pass of the memory benchmark over a full frame in the external SDRAM.
+class MemoryBenchmarkPass {
+public:
+    uint32_t scanCycles = {}; //!< core clock cycles to sum the frame word by word
+    uint32_t copyCycles = {}; //!< core clock cycles to copy the frame to another SDRAM buffer
+    uint32_t scanKBps = {}; //!< kB/s, 1000 bytes
+    uint32_t copyKBps = {}; //!< kB/s copied, read and written once each
+
+    static constexpr size_t SIZE {16};
+    static constexpr size_t OFFSET_SCAN_CYCLES {0};
+    static constexpr size_t OFFSET_COPY_CYCLES {OFFSET_SCAN_CYCLES + sizeof(scanCycles)};
+    static constexpr size_t OFFSET_SCAN_KBPS {OFFSET_COPY_CYCLES + sizeof(copyCycles)};
+    static constexpr size_t OFFSET_COPY_KBPS {OFFSET_SCAN_KBPS + sizeof(scanKBps)};
+    static_assert(OFFSET_COPY_KBPS + sizeof(copyKBps) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_SCAN_CYCLES, &scanCycles, sizeof(scanCycles));
+        std::memcpy(buffer + OFFSET_COPY_CYCLES, &copyCycles, sizeof(copyCycles));
+        std::memcpy(buffer + OFFSET_SCAN_KBPS, &scanKBps, sizeof(scanKBps));
+        std::memcpy(buffer + OFFSET_COPY_KBPS, &copyKBps, sizeof(copyKBps));
+        return true;
+    }
+};
+
+// Frame scan and copy throughput with the data cache on and off, and the cost of handing a frame from the DCMI to the CPU.
+class MemoryBenchmarkResult {
+public:
+    bool dataCacheEnabled = {}; //!< data cache setting outside of the benchmark
+    uint32_t frameSize = {}; //!< bytes per pass
+    uint32_t invalidateCycles = {}; //!< core clock cycles to invalidate the frame after a DCMI capture
+    MemoryBenchmarkPass cached {};
+    MemoryBenchmarkPass uncached {};
+
+    static constexpr size_t SIZE {9 + (2 * MemoryBenchmarkPass::SIZE)};
+    static constexpr size_t OFFSET_DATA_CACHE_ENABLED {0};
+    static constexpr size_t OFFSET_FRAME_SIZE {OFFSET_DATA_CACHE_ENABLED + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_INVALIDATE_CYCLES {OFFSET_FRAME_SIZE + sizeof(frameSize)};
+    static constexpr size_t OFFSET_CACHED {OFFSET_INVALIDATE_CYCLES + sizeof(invalidateCycles)};
+    static constexpr size_t OFFSET_UNCACHED {OFFSET_CACHED + MemoryBenchmarkPass::SIZE};
+    static_assert(OFFSET_UNCACHED + MemoryBenchmarkPass::SIZE == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_DATA_CACHE_ENABLED] = dataCacheEnabled ? 1U : 0U;
+        std::memcpy(buffer + OFFSET_FRAME_SIZE, &frameSize, sizeof(frameSize));
+        std::memcpy(buffer + OFFSET_INVALIDATE_CYCLES, &invalidateCycles, sizeof(invalidateCycles));
+        return cached.toBytes(buffer + OFFSET_CACHED, MemoryBenchmarkPass::SIZE)
+            && uncached.toBytes(buffer + OFFSET_UNCACHED, MemoryBenchmarkPass::SIZE);
+    }
+};
+
+// One image kernel over the benchmark frame, SIMD and byte loop reference.
+class ImageKernelTiming {
+public:
+    uint32_t cycles = {}; //!< core clock cycles of the SIMD kernel
+    uint32_t referenceCycles = {}; //!< core clock cycles of the byte loop reference
+    uint32_t kBps = {}; //!< input kB/s of the SIMD kernel, 1000 bytes
+    bool match = {}; //!< SIMD and reference results are identical
+
+    static constexpr size_t SIZE {13};
+    static constexpr size_t OFFSET_CYCLES {0};
+    static constexpr size_t OFFSET_REFERENCE_CYCLES {OFFSET_CYCLES + sizeof(cycles)};
+    static constexpr size_t OFFSET_KBPS {OFFSET_REFERENCE_CYCLES + sizeof(referenceCycles)};
+    static constexpr size_t OFFSET_MATCH {OFFSET_KBPS + sizeof(kBps)};
+    static_assert(OFFSET_MATCH + sizeof(uint8_t) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_CYCLES, &cycles, sizeof(cycles));
+        std::memcpy(buffer + OFFSET_REFERENCE_CYCLES, &referenceCycles, sizeof(referenceCycles));
+        std::memcpy(buffer + OFFSET_KBPS, &kBps, sizeof(kBps));
+        buffer[OFFSET_MATCH] = match ? 1U : 0U;
+        return true;
+    }
+};
+
+// Cycles of the image kernels over the upper half of the camera frame, indexed by ImageKernelId.
+class ImageKernelBenchmarkResult {
+public:
+    uint32_t pixels = {}; //!< px of the benchmark frame, the crop copies a quarter of it
+    uint8_t threshold = {}; //!< of the threshold, bit packing and run length kernels
+    std::array<ImageKernelTiming, NUMBER_OF_IMAGE_KERNELS> kernels {};
+
+    static constexpr size_t SIZE {5 + (NUMBER_OF_IMAGE_KERNELS * ImageKernelTiming::SIZE)};
+    static constexpr size_t OFFSET_PIXELS {0};
+    static constexpr size_t OFFSET_THRESHOLD {OFFSET_PIXELS + sizeof(pixels)};
+    static constexpr size_t OFFSET_KERNELS {OFFSET_THRESHOLD + sizeof(threshold)};
+    static_assert(OFFSET_KERNELS + (NUMBER_OF_IMAGE_KERNELS * ImageKernelTiming::SIZE) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_PIXELS, &pixels, sizeof(pixels));
+        buffer[OFFSET_THRESHOLD] = threshold;
+        for(size_t i = 0; i < NUMBER_OF_IMAGE_KERNELS; i++) {
+            if(!kernels[i].toBytes(buffer + OFFSET_KERNELS + (i * ImageKernelTiming::SIZE), ImageKernelTiming::SIZE)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Progress and result of the latest sdram pattern test, live while running.
+class SdramTestState {
+public:
+    bool running = {}; //!< pending or in progress
+    SdramRegion region = {SdramRegion::SDRAM_REGION_FRAME_HISTORY};
+    uint32_t bytesVerified = {}; //!< read back so far, every pattern counts
+    uint32_t errors = {}; //!< words read back wrong, a failed DMA transfer counts as one
+    uint32_t firstErrorAddress = {}; //!< 0 without errors
+    uint32_t durationMs = {};
+    uint32_t runs = {}; //!< completed since boot, including the boot test
+
+    static constexpr size_t SIZE {22};
+    static constexpr size_t OFFSET_RUNNING {0};
+    static constexpr size_t OFFSET_REGION {OFFSET_RUNNING + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_BYTES_VERIFIED {OFFSET_REGION + sizeof(region)};
+    static constexpr size_t OFFSET_ERRORS {OFFSET_BYTES_VERIFIED + sizeof(bytesVerified)};
+    static constexpr size_t OFFSET_FIRST_ERROR_ADDRESS {OFFSET_ERRORS + sizeof(errors)};
+    static constexpr size_t OFFSET_DURATION_MS {OFFSET_FIRST_ERROR_ADDRESS + sizeof(firstErrorAddress)};
+    static constexpr size_t OFFSET_RUNS {OFFSET_DURATION_MS + sizeof(durationMs)};
+    static_assert(OFFSET_RUNS + sizeof(runs) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        buffer[OFFSET_RUNNING] = running ? 1U : 0U;
+        buffer[OFFSET_REGION] = region;
+        std::memcpy(buffer + OFFSET_BYTES_VERIFIED, &bytesVerified, sizeof(bytesVerified));
+        std::memcpy(buffer + OFFSET_ERRORS, &errors, sizeof(errors));
+        std::memcpy(buffer + OFFSET_FIRST_ERROR_ADDRESS, &firstErrorAddress, sizeof(firstErrorAddress));
+        std::memcpy(buffer + OFFSET_DURATION_MS, &durationMs, sizeof(durationMs));
+        std::memcpy(buffer + OFFSET_RUNS, &runs, sizeof(runs));
+        return true;
+    }
+};
+
+#endif // VISIONADDON_APP_METRICS_METRICSTYPES_H
@@ -0,0 +1,24 @@
+#include "PeripheralErrors.h"
+
+std::array<std::atomic<uint32_t>, NUMBER_OF_PERIPHERALS> PeripheralErrors::_flags {};
+std::array<std::atomic<uint32_t>, NUMBER_OF_PERIPHERALS> PeripheralErrors::_counts {};
+
+void PeripheralErrors::record(MetricsPeripheral peripheral, uint32_t errorCode)
+{
+    if(peripheral >= NUMBER_OF_PERIPHERALS) {
+        return;
+    }
+    _flags[peripheral].fetch_or(errorCode, std::memory_order_relaxed);
+    _counts[peripheral].fetch_add(1U, std::memory_order_relaxed);
+}
+
+PeripheralErrorMetrics PeripheralErrors::get(MetricsPeripheral peripheral)
+{
+    PeripheralErrorMetrics metrics {};
+    if(peripheral >= NUMBER_OF_PERIPHERALS) {
+        return metrics;
+    }
+    metrics.flags = _flags[peripheral].load(std::memory_order_relaxed);
+    metrics.count = _counts[peripheral].load(std::memory_order_relaxed);
+    return metrics;
+}
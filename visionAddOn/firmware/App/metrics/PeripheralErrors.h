@@ -0,0 +1,28 @@
+#ifndef VISIONADDON_APP_METRICS_PERIPHERALERRORS_H
+#define VISIONADDON_APP_METRICS_PERIPHERALERRORS_H
+
+#include "MetricsTypes.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Sticky HAL error flags of the streaming peripherals, recorded by the HAL error callbacks.
+//
+// Lock-free, record is safe to call from interrupt context and neither blocks nor logs.
+class PeripheralErrors final {
+public:
+    PeripheralErrors() = delete;
+    PeripheralErrors (const PeripheralErrors&) = delete;
+    PeripheralErrors& operator=(const PeripheralErrors&) = delete;
+    PeripheralErrors (const PeripheralErrors&&) = delete;
+    PeripheralErrors& operator=(const PeripheralErrors&&) = delete;
+
+    static void record(MetricsPeripheral peripheral, uint32_t errorCode); //!< interrupt context
+    static PeripheralErrorMetrics get(MetricsPeripheral peripheral); //!< all zero if peripheral is invalid
+private:
+    static std::array<std::atomic<uint32_t>, NUMBER_OF_PERIPHERALS> _flags;
+    static std::array<std::atomic<uint32_t>, NUMBER_OF_PERIPHERALS> _counts;
+};
+
+#endif // VISIONADDON_APP_METRICS_PERIPHERALERRORS_H
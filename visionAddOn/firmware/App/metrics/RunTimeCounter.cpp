@@ -0,0 +1,44 @@
+#include "utils/CycleCounter.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstdint>
+
+// FreeRTOS run time stats clock (configGENERATE_RUN_TIME_STATS), overrides the weak stubs in freertos.c.
+//
+// The kernel keeps 32 bit run time counters, the raw cycle counter would wrap every 20 s at 216 MHz.
+// The cycles are therefore accumulated and handed out in us, which wraps after 71 min.
+// Every reading must be less than 2^32 cycles after the previous one, given by the context switches
+// and the periodic TaskProfiler sample.
+
+static uint32_t lastCycles {0};
+static uint32_t pendingCycles {0}; //!< cycles not yet accounted as a full us
+static uint32_t runTimeUs {0};
+static uint32_t cyclesPerUs {1};
+
+extern "C" {
+
+void configureTimerForRunTimeStats(void)
+{
+    CycleCounter::init();
+    cyclesPerUs = SystemCoreClock / 1000000U;
+    lastCycles = CycleCounter::now();
+}
+
+unsigned long getRunTimeCounterValue(void)
+{
+    // called by the scheduler on every context switch (PendSV) and by uxTaskGetSystemState
+    const UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    const uint32_t now = CycleCounter::now();
+    pendingCycles += now - lastCycles;
+    lastCycles = now;
+    const uint32_t elapsedUs = pendingCycles / cyclesPerUs;
+    pendingCycles -= elapsedUs * cyclesPerUs;
+    runTimeUs += elapsedUs;
+    const uint32_t value = runTimeUs;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return value;
+}
+
+}
@@ -0,0 +1,156 @@
+#include "SdramTest.h"
+
+#include "BootTimeline.h"
+#include "utils/assert.h"
+#include "utils/Cache.h"
+#include "utils/constants.h"
+#include "utils/Log.h"
+
+const std::array<SdramTest::Region, NUMBER_OF_SDRAM_REGIONS> SdramTest::_REGIONS {{
+    {EXTERNAL_SDRAM_FRAME_HISTORY_ADDRESS, EXTERNAL_SDRAM_FRAME_HISTORY_SIZE_BYTES},
+    {EXTERNAL_SDRAM_RECORDER_ADDRESS, EXTERNAL_SDRAM_RECORDER_SIZE_BYTES},
+}};
+uint32_t SdramTest::_source DMA_BUFFER;
+
+SdramTest::SdramTest(DMA_HandleTypeDef* dma) :
+_requests{osMessageQueueNew(1, sizeof(SdramRegion), NULL)},
+_dma{dma}
+{
+    ASSERT(_requests != nullptr);
+    ASSERT(dma != nullptr);
+    for(const Region& region : _REGIONS) {
+        ASSERT((region.size % _CHUNK_SIZE) == 0U);
+    }
+    // the frame history is unused until the host configures it, tested while the rest of the system boots
+    const SdramRegion boot {SdramRegion::SDRAM_REGION_FRAME_HISTORY};
+    const bool booted = osMessageQueuePut(_requests, &boot, 0U, 0U) == osOK;
+    ASSERT(booted);
+    _state.running = true;
+    _state.region = boot;
+}
+
+bool SdramTest::start(SdramRegion region)
+{
+    if(region >= NUMBER_OF_SDRAM_REGIONS) {
+        Log::warning("[SdramTest] invalid region %u", region);
+        return false;
+    }
+    _mutex.lock();
+    if(_state.running || (osMessageQueuePut(_requests, &region, 0U, 0U) != osOK)) {
+        _mutex.unlock();
+        Log::warning("[SdramTest] run already in progress");
+        return false;
+    }
+    const uint32_t runs = _state.runs;
+    _state = SdramTestState{};
+    _state.running = true;
+    _state.region = region;
+    _state.runs = runs;
+    _mutex.unlock();
+    return true;
+}
+
+SdramTestState SdramTest::state()
+{
+    _mutex.lock();
+    SdramTestState state = _state;
+    _mutex.unlock();
+    return state;
+}
+
+bool SdramTest::busy(SdramRegion region)
+{
+    _mutex.lock();
+    const bool busy = _state.running && (_state.region == region);
+    _mutex.unlock();
+    return busy;
+}
+
+void SdramTest::run()
+{
+    SdramRegion region {};
+    auto qStatus = osMessageQueueGet(_requests, &region, NULL, osWaitForever);
+    if(qStatus != osOK) {
+        Log::error("[SdramTest] osMessageQueueGet returned with status %d", qStatus);
+        return;
+    }
+    execute(region);
+}
+
+void SdramTest::execute(SdramRegion region)
+{
+    const Region& memory = _REGIONS[region];
+    uint32_t* const words = reinterpret_cast<uint32_t*>(memory.address);
+    const size_t chunks = memory.size / _CHUNK_SIZE;
+    Log::info("[SdramTest] region %u: %lu bytes @ %#lx", region, memory.size, memory.address);
+    const uint32_t startTick = osKernelGetTickCount();
+
+    for(const uint32_t pattern : _PATTERNS) {
+        // no dirty line of the previous users may be evicted over the DMA data
+        Cache::beforeDmaWrite(words, memory.size);
+        for(size_t chunk = 0; chunk < chunks; chunk++) {
+            if(!fill(words + (chunk * _CHUNK_WORDS), chunkPattern(pattern, chunk))) {
+                account(1U, memory.address + (chunk * _CHUNK_SIZE), 0U);
+            }
+        }
+        Cache::afterDmaWrite(words, memory.size);
+
+        for(size_t chunk = 0; chunk < chunks; chunk++) {
+            const uint32_t expected = chunkPattern(pattern, chunk);
+            const uint32_t* read = words + (chunk * _CHUNK_WORDS);
+            uint32_t errors {0};
+            size_t firstError {0};
+            for(size_t i = 0; i < _CHUNK_WORDS; i++) {
+                if(read[i] != expected) {
+                    firstError = (errors == 0U) ? i : firstError;
+                    errors++;
+                }
+            }
+            account(errors, memory.address + (chunk * _CHUNK_SIZE) + (firstError * sizeof(uint32_t)), _CHUNK_SIZE);
+        }
+    }
+
+    _mutex.lock();
+    _state.running = false;
+    _state.durationMs = (osKernelGetTickCount() - startTick) / TICKS_PER_MILLISECOND;
+    _state.runs++;
+    const SdramTestState state = _state;
+    _mutex.unlock();
+    if(state.errors == 0U) {
+        Log::info("[SdramTest] region %u ok, %lu ms", region, state.durationMs);
+    } else {
+        Log::error("[SdramTest] region %u: %lu errors, first @ %#lx", region, state.errors, state.firstErrorAddress);
+    }
+    BootTimeline::reached(BOOT_PHASE_SDRAM_TEST); // the first run is the boot test
+}
+
+bool SdramTest::fill(uint32_t* chunk, uint32_t value)
+{
+    _source = value;
+    if(HAL_DMA_Start_IT(_dma, reinterpret_cast<uint32_t>(&_source), reinterpret_cast<uint32_t>(chunk), _CHUNK_WORDS) != HAL_OK) {
+        Log::error("[SdramTest] dma start failed, error code %lu", _dma->ErrorCode);
+        return false;
+    }
+    // polled like the DCMI capture, the transfer complete interrupt only updates the handle state
+    uint32_t waitedTicks {0};
+    while(HAL_DMA_GetState(_dma) == HAL_DMA_STATE_BUSY) {
+        if(waitedTicks++ >= _FILL_TIMEOUT_TICKS) {
+            HAL_DMA_Abort(_dma);
+            Log::error("[SdramTest] dma timeout");
+            return false;
+        }
+        osDelay(1);
+    }
+    return HAL_DMA_GetError(_dma) == HAL_DMA_ERROR_NONE;
+}
+
+void SdramTest::account(uint32_t errors, uint32_t firstErrorAddress, size_t bytesVerified)
+{
+    _mutex.lock();
+    if((_state.errors == 0U) && (errors > 0U)) {
+        _state.firstErrorAddress = firstErrorAddress;
+    }
+    _state.errors += errors;
+    _state.bytesVerified += bytesVerified;
+    _mutex.unlock();
+}
@@ -0,0 +1,68 @@
+#ifndef VISIONADDON_APP_METRICS_SDRAMTEST_H
+#define VISIONADDON_APP_METRICS_SDRAMTEST_H
+
+#include "MetricsTypes.h"
+#include "cmsis_os2.h"
+#include "stm32f7xx_hal.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Pattern test of the external sdram cells, replaces the word by word test that used to delay the boot by seconds.
+//
+// The memory to memory DMA fills a region chunk by chunk from a single pattern word, the CPU reads it back afterwards.
+// The whole region is filled before the first chunk is verified and every chunk gets its own pattern, a chunk aliasing
+// another one shows up as errors. Aliasing within a chunk is left to the bus test in main (as4c16m16msa/sdram.h).
+// Two complementary patterns, every bit of every cell is written as 0 and as 1. The content of the region is lost.
+// The frame history region is tested once at boot. Runs in its own low priority task, some 1 s per region.
+class SdramTest final : public IRunnable {
+public:
+    /**
+     * @param dma memory to memory stream, word aligned, peripheral (source) address fixed
+     */
+    explicit SdramTest(DMA_HandleTypeDef* dma);
+    SdramTest (const SdramTest&) = delete;
+    SdramTest& operator=(const SdramTest&) = delete;
+    SdramTest (const SdramTest&&) = delete;
+    SdramTest& operator=(const SdramTest&&) = delete;
+
+    void run() override; //!< blocking!
+
+    /**
+     * @brief Request a run, returns immediately. The users of the region must be stopped by the caller.
+     *
+     * @return false if the region is invalid or a run is already pending / in progress
+     */
+    bool start(SdramRegion region);
+
+    SdramTestState state(); //!< live while running, final afterwards
+    bool busy(SdramRegion region); //!< a run on region is pending or in progress
+
+private:
+    void execute(SdramRegion region);
+    bool fill(uint32_t* chunk, uint32_t value); //!< @return false if the DMA transfer failed or timed out
+    void account(uint32_t errors, uint32_t firstErrorAddress, size_t bytesVerified); //!< once per chunk
+    static uint32_t chunkPattern(uint32_t pattern, size_t chunk) {return pattern ^ (static_cast<uint32_t>(chunk) * 0x01010101U);};
+
+    class Region {
+    public:
+        uint32_t address;
+        uint32_t size;
+    };
+    static const std::array<Region, NUMBER_OF_SDRAM_REGIONS> _REGIONS;
+    static constexpr std::array<uint32_t, 2> _PATTERNS {0x55555555U, 0xaaaaaaaaU};
+    static constexpr size_t _CHUNK_WORDS {0x8000}; //!< 128 KB, below the 65535 items of a DMA transfer
+    static constexpr size_t _CHUNK_SIZE {_CHUNK_WORDS * sizeof(uint32_t)};
+    static constexpr uint32_t _FILL_TIMEOUT_TICKS {100}; //!< some 2 ms per chunk
+
+    osMessageQueueId_t _requests;
+    DMA_HandleTypeDef* _dma;
+    Mutex _mutex;
+    SdramTestState _state {};
+    static uint32_t _source; //!< pattern word read by the DMA, non cacheable
+};
+
+#endif // VISIONADDON_APP_METRICS_SDRAMTEST_H
@@ -0,0 +1,119 @@
+#include "TaskProfiler.h"
+
+#include "utils/constants.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY, "task profiler requires run time stats, see FreeRTOSConfig.h");
+static_assert(configMAX_TASK_NAME_LEN == TaskProfileEntry::NAME_SIZE);
+
+static constexpr const char IDLE_TASK_NAME[] {"IDLE"}; // configIDLE_TASK_NAME
+
+static uint16_t toPermille(uint32_t part, uint32_t total) {
+    if(total == 0U) {
+        return 0U;
+    }
+    return static_cast<uint16_t>(std::min<uint64_t>((static_cast<uint64_t>(part) * 1000U) / total, 1000U));
+}
+
+TaskProfiler::TaskProfiler() :
+_nextSampleTick{osKernelGetTickCount()},
+_lastSampleTick{_nextSampleTick}
+{
+    _profile.periodMs = _PERIOD_MS;
+}
+
+void TaskProfiler::run() {
+    _nextSampleTick += _PERIOD_MS * TICKS_PER_MILLISECOND;
+    if(osDelayUntil(_nextSampleTick) != osOK) {
+        // fell behind by more than a period, start over instead of catching up
+        _nextSampleTick = osKernelGetTickCount();
+    }
+    sample();
+}
+
+TaskProfile TaskProfiler::profile() {
+    _mutex.lock();
+    TaskProfile profile = _profile;
+    _mutex.unlock();
+    return profile;
+}
+
+void TaskProfiler::sample() {
+    uint32_t totalRunTime {0};
+    const UBaseType_t taskCount = uxTaskGetSystemState(_status.data(), _status.size(), &totalRunTime);
+    if(taskCount == 0U) {
+        Log::error("[TaskProfiler] more than %u tasks, increase TaskProfile::TASKS_MAX", TaskProfile::TASKS_MAX);
+        return;
+    }
+    const uint32_t totalDelta = totalRunTime - _lastTotalRunTime;
+    _lastTotalRunTime = totalRunTime;
+    const uint32_t tick = osKernelGetTickCount();
+    const uint32_t periodMs = (tick - _lastSampleTick) / TICKS_PER_MILLISECOND;
+    _lastSampleTick = tick;
+
+    TaskProfile profile {};
+    std::array<History, TaskProfile::TASKS_MAX> history {};
+    profile.periodMs = static_cast<uint16_t>(std::min<uint32_t>(periodMs, UINT16_MAX));
+    profile.taskCount = static_cast<uint8_t>(taskCount);
+    uint16_t idlePermille {0};
+    for(UBaseType_t i = 0; i < taskCount; i++) {
+        const TaskStatus_t& status = _status[i];
+        // kernel order is not stable, look the task up by its number
+        const auto previous = std::find_if(_history.cbegin(), _history.cend(), [&status](const History& entry) {
+            return entry.taskNumber == status.xTaskNumber;
+        });
+        History& current = history[i];
+        if(previous != _history.cend()) {
+            current = *previous;
+        }
+        current.taskNumber = status.xTaskNumber;
+
+        TaskProfileEntry& entry = profile.tasks[i];
+        std::strncpy(entry.name.data(), status.pcTaskName, TaskProfileEntry::NAME_SIZE - 1U);
+        entry.priority = static_cast<uint8_t>(status.uxCurrentPriority);
+        entry.state = static_cast<uint8_t>(status.eCurrentState);
+        const uint32_t stackFreeBytes = static_cast<uint32_t>(status.usStackHighWaterMark) * sizeof(StackType_t);
+        entry.stackFreeMin = static_cast<uint16_t>(std::min<uint32_t>(stackFreeBytes, UINT16_MAX));
+        entry.cpuPermille = toPermille(status.ulRunTimeCounter - current.runTime, totalDelta);
+        current.runTime = status.ulRunTimeCounter;
+        current.cpuPermilleMax = std::max(current.cpuPermilleMax, entry.cpuPermille);
+        entry.cpuPermilleMax = current.cpuPermilleMax;
+
+        if(std::strncmp(status.pcTaskName, IDLE_TASK_NAME, configMAX_TASK_NAME_LEN) == 0) {
+            idlePermille = entry.cpuPermille;
+        }
+        if((stackFreeBytes < _STACK_FREE_WARNING_BYTES) && !current.stackWarned) {
+            Log::warning("[TaskProfiler] task %s has only %lu bytes of stack left", status.pcTaskName, stackFreeBytes);
+            current.stackWarned = true;
+        }
+    }
+    _history = history;
+
+    profile.busyPermille = 1000U - idlePermille;
+    _mutex.lock();
+    profile.busyPermilleMax = std::max(_profile.busyPermilleMax, profile.busyPermille);
+    _profile = profile;
+    _mutex.unlock();
+
+    const bool saturated = profile.busyPermille >= _SATURATION_PERMILLE;
+    if(saturated && !_saturated) {
+        Log::warning("[TaskProfiler] cpu saturated, busy %u permille", profile.busyPermille);
+    }
+    _saturated = saturated;
+    trace(profile);
+}
+
+void TaskProfiler::trace(const TaskProfile& profile) const {
+    if(Log::level() > Log::LOG_TRACE) {
+        return;
+    }
+    Log::trace("[TaskProfiler] period %u ms, busy %u permille (max %u)", profile.periodMs, profile.busyPermille, profile.busyPermilleMax);
+    for(size_t i = 0; i < profile.taskCount; i++) {
+        const TaskProfileEntry& entry = profile.tasks[i];
+        Log::trace("[TaskProfiler] %-16s cpu %4u permille (max %4u), stack free %5u bytes",
+            entry.name.data(), entry.cpuPermille, entry.cpuPermilleMax, entry.stackFreeMin);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef VISIONADDON_APP_METRICS_TASKPROFILER_H
+#define VISIONADDON_APP_METRICS_TASKPROFILER_H
+
+#include "MetricsTypes.h"
+#include "cmsis_os2.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <array>
+#include <cstdint>
+
+// Samples cpu share and stack high water mark of every task once per period.
+//
+// The cpu share is derived from the FreeRTOS run time stats (us resolution, see RunTimeCounter.cpp),
+// the busy share is everything but the idle task. A warning is logged once the busy share reaches
+// the saturation threshold or a stack is about to overflow, every sample is traced.
+// Runs in its own task above normal priority, so saturation is still reported while the
+// application tasks eat all the cpu time.
+class TaskProfiler final : public IRunnable {
+public:
+    TaskProfiler();
+    TaskProfiler (const TaskProfiler&) = delete;
+    TaskProfiler& operator=(const TaskProfiler&) = delete;
+    TaskProfiler (const TaskProfiler&&) = delete;
+    TaskProfiler& operator=(const TaskProfiler&&) = delete;
+
+    void run() override; //!< blocking! waits for the end of the period, then samples
+
+    TaskProfile profile(); //!< latest sample
+
+private:
+    class History {
+    public:
+        UBaseType_t taskNumber {0}; //!< unique per task, 0 marks an empty entry
+        uint32_t runTime {0};
+        uint16_t cpuPermilleMax {0};
+        bool stackWarned {false};
+    };
+    void sample();
+    void trace(const TaskProfile& profile) const;
+
+    Mutex _mutex;
+    TaskProfile _profile {};
+    uint32_t _nextSampleTick {0};
+    uint32_t _lastSampleTick {0};
+    uint32_t _lastTotalRunTime {0};
+    bool _saturated {false};
+    std::array<TaskStatus_t, TaskProfile::TASKS_MAX> _status {};
+    std::array<History, TaskProfile::TASKS_MAX> _history {}; //!< same order as the entries of _profile
+    static constexpr uint32_t _PERIOD_MS {1000};
+    static constexpr uint16_t _SATURATION_PERMILLE {900}; //!< less than 10% idle leaves no headroom for a busy frame
+    static constexpr uint32_t _STACK_FREE_WARNING_BYTES {64};
+};
+
+#endif // VISIONADDON_APP_METRICS_TASKPROFILER_H
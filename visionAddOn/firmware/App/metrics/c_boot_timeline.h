@@ -0,0 +1,28 @@
+#ifndef VISIONADDON_APP_METRICS_CBOOTTIMELINE_H
+#define VISIONADDON_APP_METRICS_CBOOTTIMELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// boot phases in the order they are usually reached, the value is the index in the BOOT_TIMELINE_GET response
+typedef enum {
+    BOOT_PHASE_PERIPHERALS = 0, //!< clock and CubeMX peripherals initialized, main
+    BOOT_PHASE_SDRAM = 1, //!< external sdram initialized and its bus tested, main
+    BOOT_PHASE_SCHEDULER = 2, //!< application built and tasks created, the scheduler starts next
+    BOOT_PHASE_NETWORK = 3, //!< lwip and the ethernet interface up, networkTask
+    BOOT_PHASE_NETWORK_CONFIG = 4, //!< persisted ip config applied and calibration loaded, networkTask
+    BOOT_PHASE_COMMAND_HANDLER = 5, //!< command socket listening, networkTask
+    BOOT_PHASE_CAMERA = 6, //!< sensor and pipeline geometry initialized, blobDetectorTask
+    BOOT_PHASE_FIRST_BLOB = 7, //!< first intact feature packet received from the fpga
+    BOOT_PHASE_SDRAM_TEST = 8, //!< background pattern test of the frame history done, memTestTask
+    NUMBER_OF_BOOT_PHASES
+} BootPhase;
+
+void boot_timeline_reached(BootPhase phase); //!< timestamps the phase on its first call, any task
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VISIONADDON_APP_METRICS_CBOOTTIMELINE_H
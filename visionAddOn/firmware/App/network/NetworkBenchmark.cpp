@@ -0,0 +1,192 @@
+#include "NetworkBenchmark.h"
+
+#include "lwip.h"
+#include "lwip/memp.h"
+#include "lwip/sockets.h"
+#include "lwip/stats.h"
+#include "lwip/sys.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/CycleCounter.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+static_assert(MEM_STATS && MEMP_STATS, "network benchmark requires LWIP_STATS, see lwipopts.h");
+
+NetworkBenchmark::NetworkBenchmark() :
+_requests{osMessageQueueNew(1, sizeof(NetworkBenchmarkConfig), NULL)},
+_udpSender{inet_addr(HOST_IP), PORT_NETWORK_BENCHMARK}
+{
+    ASSERT(_requests != nullptr);
+}
+
+bool NetworkBenchmark::start(const NetworkBenchmarkConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[NetworkBenchmark] invalid config rejected");
+        return false;
+    }
+    _mutex.lock();
+    if(_result.running || (osMessageQueuePut(_requests, &config, 0U, 0U) != osOK)) {
+        _mutex.unlock();
+        Log::warning("[NetworkBenchmark] run already in progress");
+        return false;
+    }
+    _result = NetworkBenchmarkResult{};
+    _result.running = true;
+    _result.protocol = config.protocol;
+    _result.payloadSize = config.payloadSize;
+    _mutex.unlock();
+    return true;
+}
+
+NetworkBenchmarkResult NetworkBenchmark::result() {
+    _mutex.lock();
+    NetworkBenchmarkResult result = _result;
+    _mutex.unlock();
+    return result;
+}
+
+void NetworkBenchmark::run() {
+    NetworkBenchmarkConfig config {};
+    auto qStatus = osMessageQueueGet(_requests, &config, NULL, osWaitForever);
+    if(qStatus != osOK) {
+        Log::error("[NetworkBenchmark] osMessageQueueGet returned with status %d", qStatus);
+        return;
+    }
+    // compete with the blob receiver and the command handler, not only for idle time
+    const osThreadId_t thread = osThreadGetId();
+    const osPriority_t priority = osThreadGetPriority(thread);
+    osThreadSetPriority(thread, osPriorityNormal);
+    execute(config);
+    osThreadSetPriority(thread, priority);
+}
+
+void NetworkBenchmark::execute(const NetworkBenchmarkConfig& config) {
+    Log::info("[NetworkBenchmark] start, protocol %u, payload %u bytes, rate %lu/s, duration %u s",
+        config.protocol, config.payloadSize, config.packetRate, config.durationS);
+    int32_t socket {-1};
+    if(config.protocol == BenchmarkProtocol::PROTOCOL_TCP) {
+        socket = connectTcp();
+        if(socket < 0) {
+            publish(Counters{}, 0U, false);
+            return;
+        }
+    }
+    resetPoolStats();
+
+    Counters counters {};
+    const uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+    const uint32_t durationTicks = config.durationS * TICKS_PER_SECOND;
+    const uint32_t startTick = osKernelGetTickCount();
+    uint32_t publishedTick {startTick};
+    uint32_t lastCycles {CycleCounter::now()};
+    uint64_t elapsedCycles {0}; // the cycle counter wraps after 20 s at 216 MHz
+    uint32_t sequence {0}; // successful sends only, the host counts everything else as lost on the way
+    uint32_t attempts {0};
+    uint32_t elapsedTicks {0};
+    while((elapsedTicks = osKernelGetTickCount() - startTick) < durationTicks) {
+        if(config.packetRate > 0) {
+            // paced per tick, the packets of a tick are sent as a burst at its start
+            const uint64_t packetsDue = ((static_cast<uint64_t>(elapsedTicks) + 1U) * config.packetRate) / TICKS_PER_SECOND;
+            if(attempts >= packetsDue) {
+                osDelay(1);
+                continue;
+            }
+        }
+        attempts++;
+        const uint32_t begin = CycleCounter::now();
+        elapsedCycles += begin - lastCycles;
+        lastCycles = begin;
+        const uint32_t timestampUs = static_cast<uint32_t>(elapsedCycles / cyclesPerUs);
+        std::memcpy(_payload + _OFFSET_SEQUENCE, &sequence, sizeof(sequence));
+        std::memcpy(_payload + _OFFSET_TIMESTAMP_US, &timestampUs, sizeof(timestampUs));
+        const bool sent = sendPacket(config.protocol, socket, config.payloadSize);
+        const uint32_t cycles = CycleCounter::now() - begin;
+        if(sent) {
+            sequence++;
+            counters.packetsSent++;
+            counters.bytesSent += config.payloadSize;
+            counters.sendCyclesSum += cycles;
+            counters.sendCyclesMax = std::max(counters.sendCyclesMax, cycles);
+        } else {
+            counters.sendFailures++;
+            if(config.protocol == BenchmarkProtocol::PROTOCOL_TCP) {
+                Log::warning("[NetworkBenchmark] tcp write failed, errno %d", errno);
+                break;
+            }
+            osThreadYield(); // let the stack drain its queues
+        }
+        const uint32_t now = osKernelGetTickCount();
+        if(now != publishedTick) {
+            publish(counters, (now - startTick) / TICKS_PER_MILLISECOND, true);
+            publishedTick = now;
+        }
+    }
+    const uint32_t elapsedMs = std::min(elapsedTicks, durationTicks) / TICKS_PER_MILLISECOND;
+
+    if((socket >= 0) && (lwip_close(socket) != 0)) {
+        Log::warning("[NetworkBenchmark] closing socket failed");
+    }
+    publish(counters, elapsedMs, false);
+    const NetworkBenchmarkResult summary {result()};
+    Log::info("[NetworkBenchmark] done, %lu packets, %lu failures, %lu kbit/s, %lu cycles/send, mem max %lu bytes, pbuf pool max %lu",
+        summary.packetsSent, summary.sendFailures, summary.throughputKbps, summary.sendCyclesMean, summary.memUsedMax, summary.pbufPoolUsedMax);
+}
+
+bool NetworkBenchmark::sendPacket(BenchmarkProtocol protocol, int32_t socket, uint16_t size) {
+    if(protocol == BenchmarkProtocol::PROTOCOL_TCP) {
+        return lwip_write(socket, _payload, size) == static_cast<int32_t>(size); // blocking!
+    }
+    return _udpSender.send(_payload, size);
+}
+
+int32_t NetworkBenchmark::connectTcp() {
+    int32_t clientSocket = lwip_socket(AF_INET, SOCK_STREAM, 0);
+    if(clientSocket < 0) {
+        Log::error("[NetworkBenchmark] creating socket failed");
+        return -1;
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_len = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT_NETWORK_BENCHMARK);
+    addr.sin_addr.s_addr = inet_addr(HOST_IP);
+    if(lwip_connect(clientSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        Log::warning("[NetworkBenchmark] connecting to host failed, errno %d", errno);
+        lwip_close(clientSocket);
+        return -1;
+    }
+    return clientSocket;
+}
+
+void NetworkBenchmark::resetPoolStats() {
+    SYS_ARCH_DECL_PROTECT(lev);
+    SYS_ARCH_PROTECT(lev);
+    lwip_stats.mem.max = lwip_stats.mem.used;
+    _memErrorsStart = lwip_stats.mem.err;
+    struct stats_mem* pbufPool = lwip_stats.memp[MEMP_PBUF_POOL];
+    pbufPool->max = pbufPool->used;
+    _pbufPoolErrorsStart = pbufPool->err;
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+void NetworkBenchmark::publish(const Counters& counters, uint32_t elapsedMs, bool running) {
+    const struct stats_mem* pbufPool = lwip_stats.memp[MEMP_PBUF_POOL];
+    _mutex.lock();
+    _result.running = running;
+    _result.packetsSent = counters.packetsSent;
+    _result.sendFailures = counters.sendFailures;
+    _result.bytesSent = counters.bytesSent;
+    _result.elapsedMs = elapsedMs;
+    _result.throughputKbps = (elapsedMs > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(counters.bytesSent) * 8U) / elapsedMs) : 0U;
+    _result.sendCyclesMean = (counters.packetsSent > 0) ? static_cast<uint32_t>(counters.sendCyclesSum / counters.packetsSent) : 0U;
+    _result.sendCyclesMax = counters.sendCyclesMax;
+    _result.memUsedMax = static_cast<uint32_t>(lwip_stats.mem.max);
+    _result.memErrors = static_cast<uint32_t>(lwip_stats.mem.err) - _memErrorsStart;
+    _result.pbufPoolUsedMax = static_cast<uint32_t>(pbufPool->max);
+    _result.pbufPoolErrors = static_cast<uint32_t>(pbufPool->err) - _pbufPoolErrorsStart;
+    _mutex.unlock();
+}
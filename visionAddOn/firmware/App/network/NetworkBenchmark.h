@@ -0,0 +1,63 @@
+#ifndef VISIONADDON_APP_NETWORK_NETWORKBENCHMARK_H
+#define VISIONADDON_APP_NETWORK_NETWORKBENCHMARK_H
+
+#include "NetworkTypes.h"
+#include "UdpSender.h"
+#include "cmsis_os2.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <cstdint>
+
+// Throughput benchmark of the network stack, sends packets of configurable size and rate to the host for a fixed duration.
+//
+// Every payload starts with a sequence number (U32) and the send time in us since the start of the run (U32),
+// the host receiver derives loss, reordering and jitter from these. The remaining payload is zero.
+// Pool high water marks are taken from the lwip statistics, the maxima are reset at the start of a run.
+// The run is executed by the task calling run(), with normal priority for the duration of the run.
+class NetworkBenchmark final : public IRunnable {
+public:
+    NetworkBenchmark();
+    NetworkBenchmark (const NetworkBenchmark&) = delete;
+    NetworkBenchmark& operator=(const NetworkBenchmark&) = delete;
+    NetworkBenchmark (const NetworkBenchmark&&) = delete;
+    NetworkBenchmark& operator=(const NetworkBenchmark&&) = delete;
+
+    void run() override; //!< blocking!
+
+    /**
+     * @brief Request a run, returns immediately.
+     *
+     * @return false if config is invalid or a run is already pending / in progress
+     */
+    bool start(const NetworkBenchmarkConfig& config);
+
+    NetworkBenchmarkResult result(); //!< live while running, final afterwards
+
+private:
+    class Counters {
+    public:
+        uint32_t packetsSent {0};
+        uint32_t sendFailures {0};
+        uint32_t bytesSent {0};
+        uint64_t sendCyclesSum {0};
+        uint32_t sendCyclesMax {0};
+    };
+    void execute(const NetworkBenchmarkConfig& config);
+    bool sendPacket(BenchmarkProtocol protocol, int32_t socket, uint16_t size);
+    int32_t connectTcp();
+    void resetPoolStats();
+    void publish(const Counters& counters, uint32_t elapsedMs, bool running);
+
+    osMessageQueueId_t _requests;
+    UdpSender _udpSender;
+    Mutex _mutex;
+    NetworkBenchmarkResult _result {};
+    uint32_t _memErrorsStart {0};
+    uint32_t _pbufPoolErrorsStart {0};
+    uint8_t _payload[NetworkBenchmarkConfig::PAYLOAD_SIZE_MAX] {};
+    static constexpr size_t _OFFSET_SEQUENCE {0};
+    static constexpr size_t _OFFSET_TIMESTAMP_US {4};
+};
+
+#endif // VISIONADDON_APP_NETWORK_NETWORKBENCHMARK_H
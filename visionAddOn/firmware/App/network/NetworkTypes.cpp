@@ -1,5 +1,7 @@
 #include "NetworkTypes.h"
 
+#include <cstring>
+
 bool IpV4Address::toBytes(uint8_t* buffer, size_t size) {
     if(SIZE > size) {
         return false;
@@ -95,3 +97,130 @@ void MacAddress::fromU64(uint64_t src)
     octet4 = static_cast<uint8_t>((src >>  8) & 0xff);
     octet5 = static_cast<uint8_t>((src >>  0) & 0xff);
 }
+
+bool NetworkBenchmarkConfig::valid() const {
+    return ((protocol == BenchmarkProtocol::PROTOCOL_UDP) || (protocol == BenchmarkProtocol::PROTOCOL_TCP))
+        && (payloadSize >= PAYLOAD_SIZE_MIN) && (payloadSize <= PAYLOAD_SIZE_MAX)
+        && (durationS > 0) && (durationS <= DURATION_MAX_S);
+}
+
+bool NetworkBenchmarkConfig::fromBytes(const uint8_t* buffer, size_t size) {
+    if(SIZE > size) {
+        return false;
+    }
+    protocol = static_cast<BenchmarkProtocol>(buffer[OFFSET_PROTOCOL]);
+    std::memcpy(&payloadSize, buffer + OFFSET_PAYLOAD_SIZE, sizeof(payloadSize));
+    std::memcpy(&packetRate, buffer + OFFSET_PACKET_RATE, sizeof(packetRate));
+    std::memcpy(&durationS, buffer + OFFSET_DURATION, sizeof(durationS));
+    return true;
+}
+
+bool NetworkBenchmarkResult::toBytes(uint8_t* buffer, size_t size) const {
+    if(SIZE > size) {
+        return false;
+    }
+    buffer[OFFSET_RUNNING] = running ? 1U : 0U;
+    buffer[OFFSET_PROTOCOL] = static_cast<uint8_t>(protocol);
+    std::memcpy(buffer + OFFSET_PAYLOAD_SIZE, &payloadSize, sizeof(payloadSize));
+    std::memcpy(buffer + OFFSET_PACKETS_SENT, &packetsSent, sizeof(packetsSent));
+    std::memcpy(buffer + OFFSET_SEND_FAILURES, &sendFailures, sizeof(sendFailures));
+    std::memcpy(buffer + OFFSET_BYTES_SENT, &bytesSent, sizeof(bytesSent));
+    std::memcpy(buffer + OFFSET_ELAPSED_MS, &elapsedMs, sizeof(elapsedMs));
+    std::memcpy(buffer + OFFSET_THROUGHPUT_KBPS, &throughputKbps, sizeof(throughputKbps));
+    std::memcpy(buffer + OFFSET_SEND_CYCLES_MEAN, &sendCyclesMean, sizeof(sendCyclesMean));
+    std::memcpy(buffer + OFFSET_SEND_CYCLES_MAX, &sendCyclesMax, sizeof(sendCyclesMax));
+    std::memcpy(buffer + OFFSET_MEM_USED_MAX, &memUsedMax, sizeof(memUsedMax));
+    std::memcpy(buffer + OFFSET_MEM_ERRORS, &memErrors, sizeof(memErrors));
+    std::memcpy(buffer + OFFSET_PBUF_POOL_USED_MAX, &pbufPoolUsedMax, sizeof(pbufPoolUsedMax));
+    std::memcpy(buffer + OFFSET_PBUF_POOL_ERRORS, &pbufPoolErrors, sizeof(pbufPoolErrors));
+    return true;
+}
+
+bool Subscriber::valid() const {
+    const bool unspecified = (address.octet0 == 0U) && (address.octet1 == 0U) && (address.octet2 == 0U) && (address.octet3 == 0U);
+    return !unspecified && (port != 0U) && (stream < SubscriberStream::NUMBER_OF_STREAMS) && (decimation > 0U)
+        && !((stream == SubscriberStream::STREAM_FRAMES) && multicast()); // frames are sent over tcp
+}
+
+bool Subscriber::multicast() const {
+    return (address.octet0 & 0xf0) == 0xe0; // 224.0.0.0/4
+}
+
+bool Subscriber::sameDestination(const Subscriber& other) const {
+    return (address.octet0 == other.address.octet0) && (address.octet1 == other.address.octet1)
+        && (address.octet2 == other.address.octet2) && (address.octet3 == other.address.octet3)
+        && (port == other.port) && (stream == other.stream);
+}
+
+bool Subscriber::fromBytes(const uint8_t* buffer, size_t size) {
+    if(SIZE > size) {
+        return false;
+    }
+    address.fromBytes(buffer + OFFSET_ADDRESS, IpV4Address::SIZE);
+    std::memcpy(&port, buffer + OFFSET_PORT, sizeof(port));
+    stream = static_cast<SubscriberStream>(buffer[OFFSET_STREAM]);
+    decimation = buffer[OFFSET_DECIMATION];
+    return true;
+}
+
+bool Subscriber::toBytes(uint8_t* buffer, size_t size) const {
+    if(SIZE > size) {
+        return false;
+    }
+    buffer[OFFSET_ADDRESS + 0] = address.octet0;
+    buffer[OFFSET_ADDRESS + 1] = address.octet1;
+    buffer[OFFSET_ADDRESS + 2] = address.octet2;
+    buffer[OFFSET_ADDRESS + 3] = address.octet3;
+    std::memcpy(buffer + OFFSET_PORT, &port, sizeof(port));
+    buffer[OFFSET_STREAM] = static_cast<uint8_t>(stream);
+    buffer[OFFSET_DECIMATION] = decimation;
+    return true;
+}
+
+bool TimeSyncConfig::valid() const {
+    return (periodMs >= PERIOD_MIN_MS) && (periodMs <= PERIOD_MAX_MS);
+}
+
+bool TimeSyncConfig::fromBytes(const uint8_t* buffer, size_t size) {
+    if(SIZE > size) {
+        return false;
+    }
+    enabled = buffer[OFFSET_ENABLED] != 0U;
+    master.fromBytes(buffer + OFFSET_MASTER, IpV4Address::SIZE);
+    std::memcpy(&port, buffer + OFFSET_PORT, sizeof(port));
+    std::memcpy(&periodMs, buffer + OFFSET_PERIOD_MS, sizeof(periodMs));
+    stampPackets = buffer[OFFSET_STAMP_PACKETS] != 0U;
+    return true;
+}
+
+bool TimeSyncConfig::toBytes(uint8_t* buffer, size_t size) const {
+    if(SIZE > size) {
+        return false;
+    }
+    buffer[OFFSET_ENABLED] = enabled ? 1U : 0U;
+    buffer[OFFSET_MASTER + 0] = master.octet0;
+    buffer[OFFSET_MASTER + 1] = master.octet1;
+    buffer[OFFSET_MASTER + 2] = master.octet2;
+    buffer[OFFSET_MASTER + 3] = master.octet3;
+    std::memcpy(buffer + OFFSET_PORT, &port, sizeof(port));
+    std::memcpy(buffer + OFFSET_PERIOD_MS, &periodMs, sizeof(periodMs));
+    buffer[OFFSET_STAMP_PACKETS] = stampPackets ? 1U : 0U;
+    return true;
+}
+
+bool TimeSyncState::toBytes(uint8_t* buffer, size_t size) const {
+    if(SIZE > size) {
+        return false;
+    }
+    config.toBytes(buffer + OFFSET_CONFIG, TimeSyncConfig::SIZE);
+    buffer[OFFSET_SYNCHRONIZED] = synchronized ? 1U : 0U;
+    std::memcpy(buffer + OFFSET_OFFSET_US, &offsetUs, sizeof(offsetUs));
+    std::memcpy(buffer + OFFSET_JITTER_US, &jitterUs, sizeof(jitterUs));
+    std::memcpy(buffer + OFFSET_DELAY_US, &delayUs, sizeof(delayUs));
+    std::memcpy(buffer + OFFSET_DRIFT_PPB, &driftPpb, sizeof(driftPpb));
+    std::memcpy(buffer + OFFSET_ROUNDS, &rounds, sizeof(rounds));
+    std::memcpy(buffer + OFFSET_FAILED_ROUNDS, &failedRounds, sizeof(failedRounds));
+    std::memcpy(buffer + OFFSET_STEPS, &steps, sizeof(steps));
+    std::memcpy(buffer + OFFSET_TIME_US, &timeUs, sizeof(timeUs));
+    return true;
+}
@@ -3,6 +3,8 @@
 
 #include "ip4_addr.h"
 
+#include <climits>
+#include <cstddef>
 #include <cstdint>
 
 class IpV4Address {
@@ -44,4 +46,158 @@ public:
     void fromU64(uint64_t src);
 };
 
+enum BenchmarkProtocol : uint8_t {
+    PROTOCOL_UDP = 0, //!< raw api datagrams, payload copied into the lwip heap
+    PROTOCOL_TCP = 1, //!< socket stream
+    PROTOCOL_UNDEFINED = UINT8_MAX
+};
+
+class NetworkBenchmarkConfig {
+public:
+    BenchmarkProtocol protocol = {BenchmarkProtocol::PROTOCOL_UDP};
+    uint16_t payloadSize = {1024}; //!< bytes per datagram / write
+    uint32_t packetRate = {0}; //!< packets per second, 0 sends as fast as possible
+    uint16_t durationS = {10};
+
+    static constexpr uint16_t PAYLOAD_SIZE_MIN {8}; //!< sequence number and timestamp
+    static constexpr uint16_t PAYLOAD_SIZE_MAX {1472}; //!< largest unfragmented udp payload
+    static constexpr uint16_t DURATION_MAX_S {60};
+
+    static constexpr size_t SIZE {9};
+    static constexpr size_t OFFSET_PROTOCOL {0};
+    static constexpr size_t OFFSET_PAYLOAD_SIZE {OFFSET_PROTOCOL + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_PACKET_RATE {OFFSET_PAYLOAD_SIZE + sizeof(payloadSize)};
+    static constexpr size_t OFFSET_DURATION {OFFSET_PACKET_RATE + sizeof(packetRate)};
+    static_assert(OFFSET_DURATION + sizeof(durationS) == SIZE);
+
+    bool valid() const;
+    bool fromBytes(const uint8_t* buffer, size_t size);
+};
+
+class NetworkBenchmarkResult {
+public:
+    bool running = {false};
+    BenchmarkProtocol protocol = {BenchmarkProtocol::PROTOCOL_UNDEFINED};
+    uint16_t payloadSize = {};
+    uint32_t packetsSent = {};
+    uint32_t sendFailures = {}; //!< dropped sends, no memory, no tx descriptor or connection lost
+    uint32_t bytesSent = {};
+    uint32_t elapsedMs = {};
+    uint32_t throughputKbps = {}; //!< payload bits per ms, without protocol overhead
+    uint32_t sendCyclesMean = {}; //!< cpu cycles per send call, includes blocking for tcp
+    uint32_t sendCyclesMax = {};
+    uint32_t memUsedMax = {}; //!< lwip heap high water mark in bytes (MEM_SIZE)
+    uint32_t memErrors = {}; //!< failed lwip heap allocations
+    uint32_t pbufPoolUsedMax = {}; //!< receive pbuf pool high water mark in pbufs (PBUF_POOL_SIZE)
+    uint32_t pbufPoolErrors = {}; //!< failed receive pbuf allocations
+
+    static constexpr size_t SIZE {48};
+    static constexpr size_t OFFSET_RUNNING {0};
+    static constexpr size_t OFFSET_PROTOCOL {OFFSET_RUNNING + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_PAYLOAD_SIZE {OFFSET_PROTOCOL + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_PACKETS_SENT {OFFSET_PAYLOAD_SIZE + sizeof(payloadSize)};
+    static constexpr size_t OFFSET_SEND_FAILURES {OFFSET_PACKETS_SENT + sizeof(packetsSent)};
+    static constexpr size_t OFFSET_BYTES_SENT {OFFSET_SEND_FAILURES + sizeof(sendFailures)};
+    static constexpr size_t OFFSET_ELAPSED_MS {OFFSET_BYTES_SENT + sizeof(bytesSent)};
+    static constexpr size_t OFFSET_THROUGHPUT_KBPS {OFFSET_ELAPSED_MS + sizeof(elapsedMs)};
+    static constexpr size_t OFFSET_SEND_CYCLES_MEAN {OFFSET_THROUGHPUT_KBPS + sizeof(throughputKbps)};
+    static constexpr size_t OFFSET_SEND_CYCLES_MAX {OFFSET_SEND_CYCLES_MEAN + sizeof(sendCyclesMean)};
+    static constexpr size_t OFFSET_MEM_USED_MAX {OFFSET_SEND_CYCLES_MAX + sizeof(sendCyclesMax)};
+    static constexpr size_t OFFSET_MEM_ERRORS {OFFSET_MEM_USED_MAX + sizeof(memUsedMax)};
+    static constexpr size_t OFFSET_PBUF_POOL_USED_MAX {OFFSET_MEM_ERRORS + sizeof(memErrors)};
+    static constexpr size_t OFFSET_PBUF_POOL_ERRORS {OFFSET_PBUF_POOL_USED_MAX + sizeof(pbufPoolUsedMax)};
+    static_assert(OFFSET_PBUF_POOL_ERRORS + sizeof(pbufPoolErrors) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const;
+};
+
+enum SubscriberStream : uint8_t {
+    STREAM_BLOBS = 0, //!< blob packets, udp
+    STREAM_LOG = 1, //!< log lines, udp
+    STREAM_FRAMES = 2, //!< requested frames, tcp, unicast only
+    STREAM_PREVIEW = 3, //!< decimated preview frames, udp
+    NUMBER_OF_STREAMS,
+    STREAM_UNDEFINED = UINT8_MAX
+};
+
+class UdpDestination {
+public:
+    uint32_t address = {}; //!< network byte order
+    uint16_t port = {};
+};
+
+class Subscriber {
+public:
+    IpV4Address address = {}; //!< unicast, broadcast or multicast (224.0.0.0/4) for udp streams
+    uint16_t port = {};
+    SubscriberStream stream = {SubscriberStream::STREAM_UNDEFINED};
+    uint8_t decimation = {1}; //!< every n-th packet, line or frame is sent
+
+    static constexpr size_t SIZE {8};
+    static constexpr size_t OFFSET_ADDRESS {0};
+    static constexpr size_t OFFSET_PORT {OFFSET_ADDRESS + IpV4Address::SIZE};
+    static constexpr size_t OFFSET_STREAM {OFFSET_PORT + sizeof(port)};
+    static constexpr size_t OFFSET_DECIMATION {OFFSET_STREAM + sizeof(uint8_t)};
+    static_assert(OFFSET_DECIMATION + sizeof(decimation) == SIZE);
+
+    bool valid() const;
+    bool multicast() const;
+    bool sameDestination(const Subscriber& other) const; //!< address, port and stream match
+    bool fromBytes(const uint8_t* buffer, size_t size);
+    bool toBytes(uint8_t* buffer, size_t size) const;
+};
+
+class TimeSyncConfig {
+public:
+    bool enabled = {false};
+    IpV4Address master = {}; //!< 0.0.0.0 is HOST_IP
+    uint16_t port = {}; //!< 0 is PORT_TIME_SYNC
+    uint16_t periodMs = {1000}; //!< between rounds
+    bool stampPackets = {false}; //!< append the synchronised receive time to the forwarded feature packets
+
+    static constexpr uint16_t PERIOD_MIN_MS {100};
+    static constexpr uint16_t PERIOD_MAX_MS {10000};
+
+    static constexpr size_t SIZE {10};
+    static constexpr size_t OFFSET_ENABLED {0};
+    static constexpr size_t OFFSET_MASTER {OFFSET_ENABLED + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_PORT {OFFSET_MASTER + IpV4Address::SIZE};
+    static constexpr size_t OFFSET_PERIOD_MS {OFFSET_PORT + sizeof(port)};
+    static constexpr size_t OFFSET_STAMP_PACKETS {OFFSET_PERIOD_MS + sizeof(periodMs)};
+    static_assert(OFFSET_STAMP_PACKETS + sizeof(uint8_t) == SIZE);
+
+    bool valid() const;
+    bool fromBytes(const uint8_t* buffer, size_t size);
+    bool toBytes(uint8_t* buffer, size_t size) const;
+};
+
+class TimeSyncState {
+public:
+    TimeSyncConfig config = {};
+    bool synchronized = {false}; //!< a round succeeded within the last TimeSync::LOST_ROUNDS periods
+    int32_t offsetUs = {}; //!< of the last round, master minus synchronised time before the correction
+    uint32_t jitterUs = {}; //!< smoothed absolute offset
+    uint32_t delayUs = {}; //!< round trip of the last round, the shortest of its burst
+    int32_t driftPpb = {}; //!< frequency correction of the local clock
+    uint32_t rounds = {}; //!< successful
+    uint32_t failedRounds = {}; //!< no valid reply in the whole burst
+    uint32_t steps = {}; //!< the clock was set instead of slewed
+    uint64_t timeUs = {}; //!< synchronised time the state was taken at
+
+    static constexpr size_t SIZE {TimeSyncConfig::SIZE + 37};
+    static constexpr size_t OFFSET_CONFIG {0};
+    static constexpr size_t OFFSET_SYNCHRONIZED {OFFSET_CONFIG + TimeSyncConfig::SIZE};
+    static constexpr size_t OFFSET_OFFSET_US {OFFSET_SYNCHRONIZED + sizeof(uint8_t)};
+    static constexpr size_t OFFSET_JITTER_US {OFFSET_OFFSET_US + sizeof(offsetUs)};
+    static constexpr size_t OFFSET_DELAY_US {OFFSET_JITTER_US + sizeof(jitterUs)};
+    static constexpr size_t OFFSET_DRIFT_PPB {OFFSET_DELAY_US + sizeof(delayUs)};
+    static constexpr size_t OFFSET_ROUNDS {OFFSET_DRIFT_PPB + sizeof(driftPpb)};
+    static constexpr size_t OFFSET_FAILED_ROUNDS {OFFSET_ROUNDS + sizeof(rounds)};
+    static constexpr size_t OFFSET_STEPS {OFFSET_FAILED_ROUNDS + sizeof(failedRounds)};
+    static constexpr size_t OFFSET_TIME_US {OFFSET_STEPS + sizeof(steps)};
+    static_assert(OFFSET_TIME_US + sizeof(timeUs) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const;
+};
+
 #endif // VISIONADDON_APP_NETWORK_NETWORKTYPES_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Subscriptions.h"
+
+#include "lwip.h"
+#include "lwip/sockets.h"
+#undef bind // to avoid conflicts with std functional bind
+#include "utils/constants.h"
+#include "utils/Log.h"
+
+Subscriptions::Subscriptions()
+{
+    Subscriber host {};
+    host.address.fromU32(PP_NTOHL(inet_addr(HOST_IP)));
+    host.port = PORT_BLOB_RECEIVER;
+    host.stream = SubscriberStream::STREAM_BLOBS;
+    _subscribers[_count++] = host;
+    host.port = PORT_LOG;
+    host.stream = SubscriberStream::STREAM_LOG;
+    _subscribers[_count++] = host;
+}
+
+bool Subscriptions::subscribe(const Subscriber& subscriber)
+{
+    if(!subscriber.valid()) {
+        Log::warning("[Subscriptions] invalid subscriber %u.%u.%u.%u:%u, stream %u, decimation %u",
+            subscriber.address.octet0, subscriber.address.octet1, subscriber.address.octet2, subscriber.address.octet3,
+            subscriber.port, subscriber.stream, subscriber.decimation);
+        return false;
+    }
+    bool added = false;
+    bool full = false;
+    _mutex.lock();
+    size_t index = 0;
+    while((index < _count) && !_subscribers[index].sameDestination(subscriber)) {
+        index++;
+    }
+    if(index < _count) {
+        _subscribers[index].decimation = subscriber.decimation;
+        _phase[index] = 0U;
+    } else if(_count < MAX_SUBSCRIBERS) {
+        _subscribers[_count] = subscriber;
+        _phase[_count] = 0U;
+        _count++;
+        added = true;
+    } else {
+        full = true;
+    }
+    _mutex.unlock();
+    if(full) {
+        Log::warning("[Subscriptions] registry full, %u subscribers", MAX_SUBSCRIBERS);
+        return false;
+    }
+    Log::info("[Subscriptions] %s %u.%u.%u.%u:%u, stream %u, decimation %u", added ? "subscribed" : "updated",
+        subscriber.address.octet0, subscriber.address.octet1, subscriber.address.octet2, subscriber.address.octet3,
+        subscriber.port, subscriber.stream, subscriber.decimation);
+    return true;
+}
+
+bool Subscriptions::unsubscribe(const Subscriber& subscriber)
+{
+    bool removed = false;
+    _mutex.lock();
+    for(size_t i = 0; i < _count; i++) {
+        if(_subscribers[i].sameDestination(subscriber)) {
+            // keep the order, the senders serve the subscribers in registration order
+            for(size_t j = i + 1; j < _count; j++) {
+                _subscribers[j - 1] = _subscribers[j];
+                _phase[j - 1] = _phase[j];
+            }
+            _count--;
+            removed = true;
+            break;
+        }
+    }
+    _mutex.unlock();
+    if(!removed) {
+        Log::warning("[Subscriptions] %u.%u.%u.%u:%u, stream %u not subscribed",
+            subscriber.address.octet0, subscriber.address.octet1, subscriber.address.octet2, subscriber.address.octet3,
+            subscriber.port, subscriber.stream);
+        return false;
+    }
+    Log::info("[Subscriptions] unsubscribed %u.%u.%u.%u:%u, stream %u",
+        subscriber.address.octet0, subscriber.address.octet1, subscriber.address.octet2, subscriber.address.octet3,
+        subscriber.port, subscriber.stream);
+    return true;
+}
+
+size_t Subscriptions::subscribers(std::array<Subscriber, MAX_SUBSCRIBERS>& subscribers)
+{
+    _mutex.lock();
+    const size_t count = _count;
+    for(size_t i = 0; i < count; i++) {
+        subscribers[i] = _subscribers[i];
+    }
+    _mutex.unlock();
+    return count;
+}
+
+size_t Subscriptions::next(SubscriberStream stream, Destinations& destinations)
+{
+    size_t count = 0;
+    _mutex.lock();
+    for(size_t i = 0; i < _count; i++) {
+        Subscriber& subscriber = _subscribers[i];
+        if(subscriber.stream != stream) {
+            continue;
+        }
+        if(_phase[i] == 0U) {
+            destinations[count].address = PP_HTONL(subscriber.address.toU32());
+            destinations[count].port = subscriber.port;
+            count++;
+        }
+        _phase[i] = static_cast<uint8_t>((_phase[i] + 1U) % subscriber.decimation);
+    }
+    _mutex.unlock();
+    return count;
+}
@@ -0,0 +1,57 @@
+#ifndef VISIONADDON_APP_NETWORK_SUBSCRIPTIONS_H
+#define VISIONADDON_APP_NETWORK_SUBSCRIPTIONS_H
+
+#include "NetworkTypes.h"
+#include "utils/mutex/Mutex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Runtime registry of the stream destinations, held in RAM and lost on reset.
+//
+// Starts with the host (HOST_IP) subscribed to the blobs and the log on their default ports.
+// The senders fetch the destinations of every packet, log line or frame with next(), which advances the decimation.
+// Do not log while holding the mutex, the log itself fetches its destinations here.
+class Subscriptions final {
+public:
+    Subscriptions();
+    Subscriptions (const Subscriptions&) = delete;
+    Subscriptions& operator=(const Subscriptions&) = delete;
+    Subscriptions (const Subscriptions&&) = delete;
+    Subscriptions& operator=(const Subscriptions&&) = delete;
+
+    static constexpr size_t MAX_SUBSCRIBERS {8};
+    using Destinations = std::array<UdpDestination, MAX_SUBSCRIBERS>;
+
+    /**
+     * @brief Add a subscriber, an existing one with the same address, port and stream gets the new decimation.
+     *
+     * @return false if the subscriber is invalid or the registry is full
+     */
+    bool subscribe(const Subscriber& subscriber);
+
+    /**
+     * @brief Remove the subscriber with the same address, port and stream, the decimation is ignored.
+     *
+     * @return false if there is no such subscriber
+     */
+    bool unsubscribe(const Subscriber& subscriber);
+
+    size_t subscribers(std::array<Subscriber, MAX_SUBSCRIBERS>& subscribers); //!< @return number of subscribers
+
+    /**
+     * @brief Destinations of the next packet of a stream, subscribers skipped by their decimation are left out.
+     *
+     * @return number of destinations
+     */
+    size_t next(SubscriberStream stream, Destinations& destinations);
+
+private:
+    Mutex _mutex;
+    std::array<Subscriber, MAX_SUBSCRIBERS> _subscribers {};
+    std::array<uint8_t, MAX_SUBSCRIBERS> _phase {}; //!< packets since the last one sent to the subscriber
+    size_t _count {0};
+};
+
+#endif // VISIONADDON_APP_NETWORK_SUBSCRIPTIONS_H
@@ -0,0 +1,218 @@
+#include "TimeSync.h"
+
+#include "lwip.h"
+#include "lwip/sockets.h"
+#include "utils/assert.h"
+#include "utils/constants.h"
+#include "utils/Log.h"
+#include "utils/SyncClock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+constexpr int64_t PPB {1000000000};
+constexpr int64_t PHASE_GAIN_DIVIDER {2};
+constexpr int64_t FREQUENCY_GAIN_DIVIDER {4};
+constexpr int64_t JITTER_SMOOTHING {8};
+
+int32_t clampToI32(int64_t value) {
+    return static_cast<int32_t>(std::clamp<int64_t>(value, INT32_MIN, INT32_MAX));
+}
+}
+
+TimeSync::TimeSync() :
+_configChanged{osSemaphoreNew(1, 0, NULL)}
+{
+    ASSERT(_configChanged != nullptr);
+    _state.config = _config;
+}
+
+bool TimeSync::config(const TimeSyncConfig& config) {
+    if(!config.valid()) {
+        Log::warning("[TimeSync] invalid config rejected, period %u ms", config.periodMs);
+        return false;
+    }
+    _mutex.lock();
+    _config = config;
+    _state.config = config;
+    _mutex.unlock();
+    osSemaphoreRelease(_configChanged);
+    Log::info("[TimeSync] %s, master %u.%u.%u.%u:%u, period %u ms", config.enabled ? "enabled" : "disabled",
+        config.master.octet0, config.master.octet1, config.master.octet2, config.master.octet3, config.port, config.periodMs);
+    return true;
+}
+
+TimeSyncState TimeSync::state() {
+    _mutex.lock();
+    TimeSyncState state = _state;
+    _mutex.unlock();
+    state.timeUs = SyncClock::nowUs();
+    return state;
+}
+
+void TimeSync::run() {
+    _mutex.lock();
+    const TimeSyncConfig config = _config;
+    _mutex.unlock();
+    if(!config.enabled) {
+        close();
+        osSemaphoreAcquire(_configChanged, osWaitForever);
+        return;
+    }
+    const uint32_t periodTicks = config.periodMs * TICKS_PER_MILLISECOND;
+    if(!open()) {
+        osSemaphoreAcquire(_configChanged, periodTicks);
+        return;
+    }
+
+    Sample best {};
+    bool replied {false};
+    for(size_t i = 0; i < BURST_SIZE; i++) {
+        if(i > 0) {
+            osDelay(BURST_SPACING_MS * TICKS_PER_MILLISECOND);
+        }
+        Sample sample {};
+        if(exchange(config, sample) && (sample.delayUs < best.delayUs)) {
+            best = sample;
+            replied = true;
+        }
+    }
+    const uint32_t nowMs = osKernelGetTickCount() / TICKS_PER_MILLISECOND;
+    if(replied) {
+        discipline(best);
+        _lastSuccessMs = nowMs;
+    } else {
+        _mutex.lock();
+        _state.failedRounds++;
+        const bool lost = _state.synchronized && ((nowMs - _lastSuccessMs) > (LOST_ROUNDS * config.periodMs));
+        if(lost) {
+            _state.synchronized = false;
+        }
+        _mutex.unlock();
+        if(lost) {
+            Log::warning("[TimeSync] sync lost, the clock keeps running with the last drift correction");
+        }
+    }
+    osSemaphoreAcquire(_configChanged, periodTicks); // a new config starts the next round early
+}
+
+bool TimeSync::open() {
+    if(_socket >= 0) {
+        return true;
+    }
+    _socket = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+    if(_socket < 0) {
+        Log::error("[TimeSync] creating socket failed, errno %d", errno);
+        return false;
+    }
+    return true;
+}
+
+void TimeSync::close() {
+    if(_socket < 0) {
+        return;
+    }
+    if(lwip_close(_socket) != 0) {
+        Log::warning("[TimeSync] closing socket failed");
+    }
+    _socket = -1;
+}
+
+bool TimeSync::exchange(const TimeSyncConfig& config, Sample& sample) {
+    IpV4Address masterAddress = config.master;
+    struct sockaddr_in master = {};
+    master.sin_len = sizeof(master);
+    master.sin_family = AF_INET;
+    master.sin_port = htons((config.port != 0U) ? config.port : PORT_TIME_SYNC);
+    master.sin_addr.s_addr = (masterAddress.toU32() != 0U) ? PP_HTONL(masterAddress.toU32()) : inet_addr(HOST_IP);
+
+    const uint8_t sequence = ++_sequence;
+    uint8_t request[REQUEST_SIZE] {};
+    request[OFFSET_TYPE] = TYPE_REQUEST;
+    request[OFFSET_SEQUENCE] = sequence;
+    const uint64_t t1 = SyncClock::localUs();
+    std::memcpy(request + OFFSET_T1, &t1, sizeof(t1));
+    if(lwip_sendto(_socket, request, REQUEST_SIZE, 0, (struct sockaddr*)&master, sizeof(master)) != static_cast<int32_t>(REQUEST_SIZE)) {
+        Log::debug("[TimeSync] request failed, errno %d", errno);
+        return false;
+    }
+
+    // late replies to earlier requests are skipped by their sequence
+    const uint32_t startMs = osKernelGetTickCount() / TICKS_PER_MILLISECOND;
+    uint32_t elapsedMs {0};
+    while((elapsedMs = (osKernelGetTickCount() / TICKS_PER_MILLISECOND) - startMs) < REPLY_TIMEOUT_MS) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(_socket, &readSet);
+        struct timeval timeout = {};
+        timeout.tv_usec = static_cast<long>((REPLY_TIMEOUT_MS - elapsedMs) * 1000U);
+        if(lwip_select(_socket + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+            return false; // timeout
+        }
+        uint8_t reply[REPLY_SIZE + 1] {}; // longer datagrams are detected by their size
+        const int32_t received = lwip_recvfrom(_socket, reply, sizeof(reply), 0, nullptr, nullptr);
+        const uint64_t t4 = SyncClock::localUs();
+        if((received != static_cast<int32_t>(REPLY_SIZE)) || (reply[OFFSET_TYPE] != TYPE_REPLY) || (reply[OFFSET_SEQUENCE] != sequence)) {
+            continue;
+        }
+        uint64_t t1Echo {};
+        uint64_t t2 {};
+        uint64_t t3 {};
+        std::memcpy(&t1Echo, reply + OFFSET_T1, sizeof(t1Echo));
+        std::memcpy(&t2, reply + OFFSET_T2, sizeof(t2));
+        std::memcpy(&t3, reply + OFFSET_T3, sizeof(t3));
+        if(t1Echo != t1) {
+            continue;
+        }
+        sample.offsetUs = (static_cast<int64_t>(t2 - t1) + static_cast<int64_t>(t3 - t4)) / 2;
+        sample.delayUs = std::max<int64_t>(static_cast<int64_t>(t4 - t1) - static_cast<int64_t>(t3 - t2), 0);
+        sample.localUs = t4;
+        return true;
+    }
+    return false;
+}
+
+void TimeSync::discipline(const Sample& sample) {
+    const int64_t predictedUs = SyncClock::offsetUs(sample.localUs);
+    const int64_t errorUs = sample.offsetUs - predictedUs;
+    const bool first = !SyncClock::synchronized();
+    const bool step = first || (std::abs(errorUs) > static_cast<int64_t>(STEP_THRESHOLD_US));
+    int32_t ratePpb = SyncClock::ratePpb();
+    if(step) {
+        SyncClock::discipline(sample.offsetUs, ratePpb, sample.localUs);
+    } else {
+        const int64_t elapsedUs = static_cast<int64_t>(sample.localUs - _lastSampleUs);
+        if(elapsedUs > 0) {
+            const int64_t correctionPpb = ((errorUs * PPB) / elapsedUs) / FREQUENCY_GAIN_DIVIDER;
+            ratePpb = static_cast<int32_t>(std::clamp<int64_t>(ratePpb + correctionPpb, -RATE_MAX_PPB, RATE_MAX_PPB));
+        }
+        SyncClock::discipline(predictedUs + (errorUs / PHASE_GAIN_DIVIDER), ratePpb, sample.localUs);
+    }
+    _lastSampleUs = sample.localUs;
+
+    _mutex.lock();
+    const bool regained = !_state.synchronized;
+    _state.synchronized = true;
+    _state.offsetUs = clampToI32(errorUs);
+    if(step) {
+        _state.steps++;
+        _state.jitterUs = 0U; // restarts from the next slewed round
+    } else {
+        const int64_t jitterUs = static_cast<int64_t>(_state.jitterUs);
+        _state.jitterUs = static_cast<uint32_t>(jitterUs + ((std::abs(errorUs) - jitterUs) / JITTER_SMOOTHING));
+    }
+    _state.delayUs = static_cast<uint32_t>(std::min<int64_t>(sample.delayUs, UINT32_MAX));
+    _state.driftPpb = ratePpb;
+    _state.rounds++;
+    _mutex.unlock();
+
+    if(first) {
+        Log::info("[TimeSync] clock set, round trip %lu us", static_cast<uint32_t>(std::min<int64_t>(sample.delayUs, UINT32_MAX)));
+    } else if(step) {
+        Log::warning("[TimeSync] clock stepped by %ld us", clampToI32(errorUs));
+    } else if(regained) {
+        Log::info("[TimeSync] sync regained, offset %ld us", clampToI32(errorUs));
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef VISIONADDON_APP_NETWORK_TIMESYNC_H
+#define VISIONADDON_APP_NETWORK_TIMESYNC_H
+
+#include "NetworkTypes.h"
+#include "cmsis_os2.h"
+#include "utils/IRunnable.h"
+#include "utils/mutex/Mutex.h"
+
+#include <cstdint>
+
+// NTP style two way time sync client, disciplines the SyncClock to the time of a master (host/timeSyncMaster.py).
+//
+// Every period a burst of requests is sent to the master over udp, t1/t4 are the local send and receive times, t2/t3
+// the receive and send times of the master:
+//     offset = ((t2 - t1) + (t3 - t4)) / 2, delay = (t4 - t1) - (t3 - t2)
+// The reply with the shortest delay of the burst is the least disturbed by queueing and is the only one used.
+// The clock is stepped on the first round and on offsets beyond STEP_THRESHOLD_US, otherwise slewed: half of the
+// offset is corrected per round and a quarter of the offset per elapsed time goes into the frequency correction.
+// Datagrams (little endian): request U8 type (1), U8 sequence, U16 reserved, U64 t1;
+// reply U8 type (2), U8 sequence, U16 reserved, U64 t1 (echoed), U64 t2, U64 t3.
+class TimeSync final : public IRunnable {
+public:
+    TimeSync();
+    TimeSync (const TimeSync&) = delete;
+    TimeSync& operator=(const TimeSync&) = delete;
+    TimeSync (const TimeSync&&) = delete;
+    TimeSync& operator=(const TimeSync&&) = delete;
+
+    void run() override; //!< one round per period, blocking!
+
+    bool config(const TimeSyncConfig& config); //!< false if invalid, a new config starts a round right away
+    TimeSyncState state();
+
+    static constexpr uint32_t LOST_ROUNDS {10}; //!< periods without a successful round until the sync is lost
+    static constexpr uint32_t STEP_THRESHOLD_US {10000};
+
+private:
+    class Sample {
+    public:
+        int64_t offsetUs {}; //!< master minus local time
+        int64_t delayUs {INT64_MAX};
+        uint64_t localUs {}; //!< t4
+    };
+    bool open();
+    void close();
+    bool exchange(const TimeSyncConfig& config, Sample& sample); //!< one request and its reply
+    void discipline(const Sample& sample);
+
+    osSemaphoreId_t _configChanged;
+    Mutex _mutex;
+    TimeSyncConfig _config {};
+    TimeSyncState _state {};
+    int32_t _socket {-1};
+    uint8_t _sequence {0};
+    uint64_t _lastSampleUs {0}; //!< local time of the last sample used
+    uint32_t _lastSuccessMs {0};
+
+    static constexpr size_t BURST_SIZE {4};
+    static constexpr uint32_t BURST_SPACING_MS {10};
+    static constexpr uint32_t REPLY_TIMEOUT_MS {50};
+    static constexpr int32_t RATE_MAX_PPB {500000}; //!< crystal tolerance and then some
+    static constexpr uint8_t TYPE_REQUEST {1};
+    static constexpr uint8_t TYPE_REPLY {2};
+    static constexpr size_t REQUEST_SIZE {12};
+    static constexpr size_t REPLY_SIZE {28};
+    static constexpr size_t OFFSET_TYPE {0};
+    static constexpr size_t OFFSET_SEQUENCE {1};
+    static constexpr size_t OFFSET_T1 {4};
+    static constexpr size_t OFFSET_T2 {12};
+    static constexpr size_t OFFSET_T3 {20};
+};
+
+#endif // VISIONADDON_APP_NETWORK_TIMESYNC_H
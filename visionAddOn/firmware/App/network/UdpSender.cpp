@@ -0,0 +1,144 @@
+#include "UdpSender.h"
+
+#include "utils/Log.h"
+
+#include <cstring>
+
+UdpSender::UdpSender(uint32_t targetAddress, uint16_t targetPort) :
+_targetPort{targetPort}
+{
+    ip_addr_set_ip4_u32(&_targetAddress, targetAddress);
+}
+
+bool UdpSender::send(struct pbuf* p)
+{
+    if(p == nullptr) {
+        return false;
+    }
+    if((_pcb == nullptr) && !open()) {
+        pbuf_free(p);
+        return false;
+    }
+#if LWIP_TCPIP_CORE_LOCKING
+    LOCK_TCPIP_CORE();
+    const err_t result = udp_send(_pcb, p);
+    UNLOCK_TCPIP_CORE();
+    pbuf_free(p); // udp_send never takes ownership
+    return result == ERR_OK;
+#else
+    SendMessage& message = _messages[_nextMessage];
+    _nextMessage = (_nextMessage + 1) % _messages.size();
+    message.pcb = _pcb;
+    message.p = p;
+    message.port = 0U;
+    if(tcpip_try_callback(&UdpSender::sendInTcpipThread, &message) != ERR_OK) {
+        pbuf_free(p); // tcpip mailbox full
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool UdpSender::send(const uint8_t* data, size_t size)
+{
+    if(size > UINT16_MAX) {
+        return false;
+    }
+    struct pbuf* p = pbuf_alloc(PBUF_TRANSPORT, static_cast<uint16_t>(size), PBUF_RAM);
+    if(p == nullptr) {
+        return false;
+    }
+    std::memcpy(p->payload, data, size);
+    return send(p);
+}
+
+size_t UdpSender::sendTo(struct pbuf* p, const UdpDestination* destinations, size_t count)
+{
+    if(p == nullptr) {
+        return 0;
+    }
+    if((count == 0) || ((_pcb == nullptr) && !open())) {
+        pbuf_free(p);
+        return 0;
+    }
+    size_t sent = 0;
+    for(size_t i = 0; i < count; i++) {
+        // udp_sendto writes the header into the first pbuf if it has room, an empty header pbuf keeps p untouched
+        struct pbuf* header = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_RAM);
+        if(header == nullptr) {
+            break; // lwip heap exhausted, the remaining destinations would fail as well
+        }
+        pbuf_chain(header, p); // references p
+        ip_addr_t address {};
+        ip_addr_set_ip4_u32(&address, destinations[i].address);
+#if LWIP_TCPIP_CORE_LOCKING
+        LOCK_TCPIP_CORE();
+        const err_t result = udp_sendto(_pcb, header, &address, destinations[i].port);
+        UNLOCK_TCPIP_CORE();
+        pbuf_free(header);
+        if(result == ERR_OK) {
+            sent++;
+        }
+#else
+        SendMessage& message = _messages[_nextMessage];
+        _nextMessage = (_nextMessage + 1) % _messages.size();
+        message.pcb = _pcb;
+        message.p = header;
+        message.address = address;
+        message.port = destinations[i].port;
+        if(tcpip_try_callback(&UdpSender::sendInTcpipThread, &message) != ERR_OK) {
+            pbuf_free(header); // tcpip mailbox full
+            continue;
+        }
+        sent++;
+#endif
+    }
+    pbuf_free(p); // the header pbufs hold their own references until the ethernet dma is done
+    return sent;
+}
+
+bool UdpSender::open()
+{
+    OpenCall call {};
+    call.sender = this;
+    const err_t result = tcpip_api_call(&UdpSender::openInTcpipThread, &call.base);
+    if(result != ERR_OK) {
+        Log::error("[UdpSender] opening pcb for port %u failed, err %d", _targetPort, result);
+        return false;
+    }
+    return true;
+}
+
+err_t UdpSender::openInTcpipThread(struct tcpip_api_call_data* call)
+{
+    UdpSender* sender = reinterpret_cast<OpenCall*>(call)->sender;
+    if(sender->_pcb != nullptr) {
+        return ERR_OK; // opened by a concurrent first send
+    }
+    struct udp_pcb* pcb = udp_new();
+    if(pcb == nullptr) {
+        return ERR_MEM; // MEMP_NUM_UDP_PCB exhausted
+    }
+    if(sender->_targetPort == 0U) {
+        sender->_pcb = pcb;
+        return ERR_OK;
+    }
+    const err_t result = udp_connect(pcb, &sender->_targetAddress, sender->_targetPort);
+    if(result != ERR_OK) {
+        udp_remove(pcb);
+        return result;
+    }
+    sender->_pcb = pcb;
+    return ERR_OK;
+}
+
+void UdpSender::sendInTcpipThread(void* context)
+{
+    SendMessage* message = static_cast<SendMessage*>(context);
+    if(message->port == 0U) {
+        udp_send(message->pcb, message->p);
+    } else {
+        udp_sendto(message->pcb, message->p, &message->address, message->port);
+    }
+    pbuf_free(message->p);
+}
@@ -0,0 +1,80 @@
+#ifndef VISIONADDON_APP_NETWORK_UDPSENDER_H
+#define VISIONADDON_APP_NETWORK_UDPSENDER_H
+
+#include "lwip/ip_addr.h"
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcpip.h"
+#include "lwip/udp.h"
+#include "NetworkTypes.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Datagram sender on the lwip raw api with a pcb that stays connected, bypasses the socket layer.
+//
+// With LWIP_TCPIP_CORE_LOCKING (lwipopts.h) the datagram is sent from the calling task under the core lock,
+// otherwise it is posted to the tcpip thread without waiting for the result.
+// The pcb is created by open() or on the first send, after the network stack is up. Not thread safe, one sending task
+// only, or the senders serialize their calls (Log).
+class UdpSender final {
+public:
+    UdpSender() = default; //!< without a target, sendTo only
+    UdpSender(uint32_t targetAddress, uint16_t targetPort); //!< targetAddress in network byte order
+    UdpSender (const UdpSender&) = delete;
+    UdpSender& operator=(const UdpSender&) = delete;
+    UdpSender (const UdpSender&&) = delete;
+    UdpSender& operator=(const UdpSender&&) = delete;
+
+    /**
+     * @brief Send a datagram, the payload is referenced (zero copy).
+     *
+     * @param p payload, ownership is taken in any case
+     * @return true if the datagram was handed to the network interface (core locking) or queued for the tcpip thread
+     */
+    bool send(struct pbuf* p);
+
+    /**
+     * @brief Send a datagram, the payload is copied into a pbuf from the lwip heap.
+     */
+    bool send(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Send the same datagram to several destinations, the payload is shared (zero copy).
+     *
+     * Each destination gets its own header pbuf chained in front of the payload, the payload itself is never modified.
+     * Multicast destinations need no group membership for sending.
+     *
+     * @param p payload, ownership is taken in any case
+     * @return number of destinations the datagram was handed to the network interface or queued for
+     */
+    size_t sendTo(struct pbuf* p, const UdpDestination* destinations, size_t count);
+
+    bool open(); //!< creates the pcb, true if it exists
+
+private:
+    struct OpenCall {
+        struct tcpip_api_call_data base; //!< must be first
+        UdpSender* sender;
+    };
+    struct SendMessage {
+        struct udp_pcb* pcb;
+        struct pbuf* p;
+        ip_addr_t address;
+        uint16_t port; //!< 0 sends to the connected target
+    };
+    static err_t openInTcpipThread(struct tcpip_api_call_data* call);
+    static void sendInTcpipThread(void* context);
+
+    ip_addr_t _targetAddress {};
+    uint16_t _targetPort {0}; //!< 0 leaves the pcb unconnected
+    struct udp_pcb* _pcb {nullptr};
+#if !LWIP_TCPIP_CORE_LOCKING
+    // the tcpip mailbox processes messages in order, at most TCPIP_MBOX_SIZE are queued and one is executed
+    std::array<SendMessage, TCPIP_MBOX_SIZE + 2> _messages {};
+    size_t _nextMessage {0};
+#endif
+};
+
+#endif // VISIONADDON_APP_NETWORK_UDPSENDER_H
@@ -1,5 +1,6 @@
 #include "At24c02d.h"
 
+#include "cmsis_os2.h"
 #include "utils/assert.h"
 #include "utils/constants.h"
 #include "utils/Log.h"
@@ -56,12 +57,11 @@ bool At24c02d::writeData(uint8_t address, const uint8_t* data, size_t size, uint
             }
             Log::trace("[At24c02d] I2C busy, waiting");
             static constexpr uint32_t WAIT_MS {1U};
-            HAL_Delay(WAIT_MS); //intentionally blocking
+            wait(WAIT_MS);
         }
 
-        size_t PAGE_SIZE {8};
-        uint8_t pageOffset = address % PAGE_SIZE;
-        size_t bytesInCurrenPage = PAGE_SIZE - pageOffset;
+        uint8_t pageOffset = writeAddress % EEPROM_PAGE_SIZE_BYTES;
+        size_t bytesInCurrenPage = EEPROM_PAGE_SIZE_BYTES - pageOffset;
         size_t bytesToWrite = (bytesRemaining < bytesInCurrenPage) ? bytesRemaining : bytesInCurrenPage;
         const uint32_t timeoutTicks {timeRemainingMs * TICKS_PER_MILLISECOND};
         auto status = HAL_I2C_Mem_Write(_i2c, _i2cSlaveAddressWrite, uint16_t(writeAddress), uint16_t(sizeof(writeAddress)), const_cast<uint8_t*>(writePointer), bytesToWrite, timeoutTicks);
@@ -107,7 +107,7 @@ bool At24c02d::readData(uint8_t address, uint8_t* data, size_t size, uint32_t ti
         }
         Log::trace("[At24c02d] I2C busy, waiting");
         static constexpr uint32_t WAIT_MS {1U};
-        HAL_Delay(WAIT_MS); //intentionally blocking
+        wait(WAIT_MS);
     }
 
     const uint32_t timeRemainingMs = timeoutMs - (currentTimeMs() - startTimeMs);
@@ -121,6 +121,15 @@ bool At24c02d::readData(uint8_t address, uint8_t* data, size_t size, uint32_t ti
     return true;
 }
 
+void At24c02d::wait(uint32_t ms){
+    // the write cycle of a page takes up to 5 ms, other tasks run meanwhile. The mac address is read before the kernel starts
+    if(osKernelGetState() == osKernelRunning){
+        osDelay(ms * TICKS_PER_MILLISECOND);
+    } else {
+        HAL_Delay(ms);
+    }
+}
+
 bool At24c02d::isBusy(uint32_t timeoutMs){
     return !i2cSlaveReady(timeoutMs);
 }
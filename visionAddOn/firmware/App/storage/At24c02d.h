@@ -28,6 +28,7 @@ public:
     bool isBusy( uint32_t timeoutMs) override;
 private:
 
+    static void wait(uint32_t ms);
     bool i2cMasterReady();
     bool i2cSlaveReady(uint32_t retires = 1, uint32_t timeoutMs = 1);
 
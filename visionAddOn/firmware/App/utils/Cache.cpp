@@ -0,0 +1,45 @@
+#include "Cache.h"
+
+#include "utils/assert.h"
+
+namespace {
+bool lineAligned(const void* buffer, size_t size) {
+    return ((reinterpret_cast<uintptr_t>(buffer) % Cache::LINE_SIZE) == 0U) && ((size % Cache::LINE_SIZE) == 0U);
+}
+}
+
+void Cache::beforeDmaRead(const void* buffer, size_t size)
+{
+    // cleaning the lines next to the buffer is harmless, round out to whole lines
+    const uintptr_t start = reinterpret_cast<uintptr_t>(buffer) & ~(LINE_SIZE - 1U);
+    const size_t length = size + (reinterpret_cast<uintptr_t>(buffer) - start);
+    SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t*>(start), static_cast<int32_t>(length));
+}
+
+void Cache::beforeDmaWrite(void* buffer, size_t size)
+{
+    ASSERT(lineAligned(buffer, size));
+    SCB_CleanInvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(buffer), static_cast<int32_t>(size));
+}
+
+void Cache::afterDmaWrite(void* buffer, size_t size)
+{
+    ASSERT(lineAligned(buffer, size));
+    SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(buffer), static_cast<int32_t>(size));
+}
+
+void Cache::dataEnable(bool enable)
+{
+    if(enable == dataEnabled()) {
+        return;
+    }
+    // a store between switching the cache off and the write back of its line would be overwritten by the stale line
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(enable) {
+        SCB_EnableDCache();
+    } else {
+        SCB_DisableDCache();
+    }
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,36 @@
+#ifndef VISIONADDON_APP_UTILS_CACHE_H
+#define VISIONADDON_APP_UTILS_CACHE_H
+
+#include "stm32f7xx_hal.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// places a buffer in the non cacheable DMA region (SRAM2, MPU_Config in main.cpp), no maintenance needed
+#define DMA_BUFFER __attribute__((section(".dma_buffers"), aligned(32)))
+
+// Data cache maintenance for buffers shared with a DMA master (DCMI, ETH) in cached memory.
+//
+// Called whenever a buffer changes hands: the CPU wrote it and a DMA reads it next (clean), a DMA writes it next
+// (clean and invalidate, no dirty line may be evicted over the DMA data) or a DMA wrote it and the CPU reads it
+// next (invalidate). Invalidated buffers must start on a cache line and cover whole lines, otherwise data next to
+// the buffer is lost. The ETH driver does the same for the lwip buffers, see ethernetif.c.
+class Cache final {
+public:
+    Cache() = delete;
+    Cache (const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+    Cache (const Cache&&) = delete;
+    Cache& operator=(const Cache&&) = delete;
+
+    static void beforeDmaRead(const void* buffer, size_t size); //!< any alignment
+    static void beforeDmaWrite(void* buffer, size_t size); //!< line aligned
+    static void afterDmaWrite(void* buffer, size_t size); //!< line aligned
+
+    static bool dataEnabled() {return (SCB->CCR & SCB_CCR_DC_Msk) != 0U;};
+    static void dataEnable(bool enable); //!< the whole data cache, dirty lines are written back before disabling
+
+    static constexpr size_t LINE_SIZE {32};
+};
+
+#endif // VISIONADDON_APP_UTILS_CACHE_H
@@ -0,0 +1,13 @@
+#include "CycleCounter.h"
+
+void CycleCounter::init()
+{
+    if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U) {
+        return; // already running, a reset would break differences of readings taken before
+    }
+    static constexpr uint32_t DWT_UNLOCK {0xC5ACCE55}; // cortex-m7 locks the DWT registers after reset
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = DWT_UNLOCK;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
@@ -0,0 +1,21 @@
+#ifndef VISIONADDON_APP_UTILS_CYCLECOUNTER_H
+#define VISIONADDON_APP_UTILS_CYCLECOUNTER_H
+
+#include "stm32f7xx_hal.h"
+
+#include <cstdint>
+
+// DWT cycle counter, core clock cycles. Differences of two readings are wrap safe for up to 2^32 cycles.
+class CycleCounter final {
+public:
+    CycleCounter() = delete;
+    CycleCounter (const CycleCounter&) = delete;
+    CycleCounter& operator=(const CycleCounter&) = delete;
+    CycleCounter (const CycleCounter&&) = delete;
+    CycleCounter& operator=(const CycleCounter&&) = delete;
+
+    static void init(); //!< start the counter, no-op if already running
+    static uint32_t now() {return DWT->CYCCNT;};
+};
+
+#endif // VISIONADDON_APP_UTILS_CYCLECOUNTER_H
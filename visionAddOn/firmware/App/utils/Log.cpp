@@ -1,19 +1,22 @@
 #include "Log.h"
+#include "cmsis_os2.h"
 #include "lwip.h"
-#include "lwip/sockets.h"
 #include "stm32f7xx_hal.h"
 #include "utils/assert.h"
 #include "utils/constants.h"
 
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <utility>
 
-Log::TickKeeper Log::_getTicks = [](void) -> uint32_t {return 0U;};
-uint32_t Log::_ticksPerMs {0U};
+Log::Clock Log::_getTimeUs = [](void) -> uint64_t {return 0U;};
 char Log::_timestampBuffer[Log::_TIMESTAMP_BUFFER_SIZE];
 Log::Level Log::_level {Log::Level::LOG_DEBUG};
-struct sockaddr_in Log::_socketAddr {sizeof(Log::_socketAddr), AF_INET,  htons(PORT_LOG), inet_addr(HOST_IP), 0};
+Subscriptions* Log::_subscriptions {nullptr};
+UdpSender Log::_udpSender {};
+osMutexId_t Log::_mutex {nullptr};
+osThreadId_t Log::_publishingThread {nullptr};
 char Log::_buffer[_BUFFER_SIZE] {};
 
 Log::Level Log::toLevel(uint8_t level){
@@ -38,9 +41,10 @@ void Log::level(Log::Level level){
 }
 
 const char* Log::getTime(){
-    uint64_t totalMs = static_cast<uint64_t>(Log::_getTicks()) * Log::_ticksPerMs; // Ensure correct precision
-    std::time_t timestampS = totalMs / MILLISECONDS_PER_SECOND;
-    uint32_t timestampMs = totalMs % MILLISECONDS_PER_SECOND;
+    static constexpr uint64_t MICROSECONDS_PER_SECOND {1000000U};
+    const uint64_t totalUs = Log::_getTimeUs();
+    std::time_t timestampS = totalUs / MICROSECONDS_PER_SECOND;
+    uint32_t timestampUs = totalUs % MICROSECONDS_PER_SECOND;
 
     // Convert to struct tm (UTC time)
     std::tm timeInfo{};
@@ -49,29 +53,50 @@ const char* Log::getTime(){
     // Format time as "YYYY-MM-DD HH:MM:SS"
     std::strftime(_timestampBuffer, _TIMESTAMP_BUFFER_SIZE, "%Y-%m-%d %H:%M:%S", &timeInfo);
 
-    // Print result with milliseconds
-    std::snprintf(_timestampBuffer + 19, 5, ".%03lu", timestampMs);
+    // Print result with microseconds
+    std::snprintf(_timestampBuffer + 19, 8, ".%06lu", timestampUs);
 
     return _timestampBuffer;
 }
 
 void Log::log(const char* logPrefix, const char* format, va_list arglist) {
+    // interrupts must not block, lines logged while publishing come from the sender itself and the lock is held already
+    const bool interrupt = (__get_IPSR() != 0U);
+    const bool nested = !interrupt && (_publishingThread != nullptr) && (osThreadGetId() == _publishingThread);
+    const bool locking = !interrupt && !nested && (_mutex != nullptr) && (osKernelGetState() == osKernelRunning);
+    if(locking) {
+        osMutexAcquire(_mutex, osWaitForever);
+    }
+    const int32_t length = Log::format(logPrefix, format, arglist);
+    if(length > 0) {
+        publishSwo(_buffer, length);
+        if(locking) {
+            _publishingThread = osThreadGetId();
+            publishUdp(_buffer, length);
+            _publishingThread = nullptr;
+        }
+    }
+    if(locking) {
+        osMutexRelease(_mutex);
+    }
+}
+
+int32_t Log::format(const char* logPrefix, const char* format, va_list arglist) {
     int32_t writePointer {0};
 
     int32_t writeLength = std::snprintf(_buffer, _BUFFER_SIZE, "%s ", getTime());
-    if(writeLength <= 0) { return; } // abort
+    if(writeLength <= 0) { return 0; } // abort
     writePointer += writeLength;
     writeLength = std::snprintf(_buffer + writePointer, _BUFFER_SIZE, logPrefix);
-    if(writeLength <= 0) { return; } // abort
+    if(writeLength <= 0) { return 0; } // abort
     writePointer += writeLength;
     writeLength = vsnprintf(_buffer + writePointer, _BUFFER_SIZE - writePointer, format, arglist);
-    if(writeLength <= 0) { return; } // abort
+    if(writeLength <= 0) { return 0; } // abort
     writePointer += writeLength;
     writeLength = std::snprintf(_buffer + writePointer, _BUFFER_SIZE - writePointer, "\n");
-    if(writeLength <= 0) { return; } // abort
+    if(writeLength <= 0) { return 0; } // abort
     writePointer += writeLength;
-    publishSwo(_buffer, writePointer);
-    publishUdp(_buffer, writePointer);
+    return writePointer;
 }
 
 void Log::_vaListTrace(const char* format, va_list arglist) {
@@ -110,12 +135,23 @@ void Log::_vaListError(const char* format, va_list arglist) {
     log("\x1B[1;31mERR\x1B[2;0m ",format, arglist);
 }
 
-void Log::registerTickKeeper(Log::TickKeeper tickKeeper){
-   _getTicks = std::move(tickKeeper);
+void Log::registerClock(Log::Clock clock){
+   _getTimeUs = std::move(clock);
 }
 
-void Log::setTickrate(uint32_t ticksPerMs){
-    _ticksPerMs = ticksPerMs;
+void Log::registerSubscriptions(Subscriptions& subscriptions){
+    ASSERT(osKernelGetState() != osKernelRunning); // no task logs yet
+    _mutex = osMutexNew(nullptr);
+    ASSERT(_mutex != nullptr);
+    _subscriptions = &subscriptions;
+}
+
+void Log::openUdp(){
+    osMutexAcquire(_mutex, osWaitForever);
+    _publishingThread = osThreadGetId(); // a failure is logged to SWO only
+    _udpSender.open();
+    _publishingThread = nullptr;
+    osMutexRelease(_mutex);
 }
 
 void Log::trace(const char* format, ...) {
@@ -160,14 +196,19 @@ void Log::publishSwo(const char* p, int len) {
 }
 
 void Log::publishUdp(const char* p, int len) {
-    int32_t udpSocket = lwip_socket(AF_INET, SOCK_DGRAM, 0);
-
-    auto ret = lwip_connect(udpSocket, (struct sockaddr*)&_socketAddr, sizeof(_socketAddr));
-    if(ret == 0) {
-        auto r = lwip_write(udpSocket, (void*)p, len); // blocking!
-        (void) r;
+    if(_subscriptions == nullptr) {
+        return;
+    }
+    Subscriptions::Destinations destinations {};
+    const size_t count = _subscriptions->next(SubscriberStream::STREAM_LOG, destinations);
+    if(count > 0) {
+        // the line is copied once, all subscribers share the pbuf
+        struct pbuf* line = pbuf_alloc(PBUF_RAW, static_cast<uint16_t>(len), PBUF_RAM);
+        if(line != nullptr) {
+            std::memcpy(line->payload, p, len);
+            _udpSender.sendTo(line, destinations.data(), count);
+        }
     }
-    lwip_close(udpSocket);
 }
 // C interface
 
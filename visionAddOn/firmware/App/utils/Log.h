@@ -4,6 +4,8 @@
 #include "c_log.h"
 
 #include "lwip/api.h"
+#include "network/Subscriptions.h"
+#include "network/UdpSender.h"
 #include "utils/mutex/Mutex.h"
 #include "utils/pool/CyclicPool.h"
 
@@ -13,8 +15,9 @@
 #include <stdio.h>
 
 
-// DISCLAIMER: this class is not thread safe ... log output might get mangled
-// TODO: set system time
+// Tasks take turns once the kernel runs. Lines logged from interrupts (fault handlers included) never block, they only
+// go to SWO and might get mangled.
+// Lines are stamped with the registered clock, utils/SyncClock: the time of the sync master once synchronised.
 
 class Log final {
 public:
@@ -25,9 +28,10 @@ public:
     Log& operator=(const Log&&) = delete;
 
     // avoid functional header because of conflict with lwip bind macro
-    using TickKeeper = uint32_t (*)(void);
-    static void registerTickKeeper(TickKeeper tickKeeper); //!< TickKeeper returns system ticks
-    static void setTickrate(uint32_t ticksPerMs);
+    using Clock = uint64_t (*)(void);
+    static void registerClock(Clock clock); //!< Clock returns us since the epoch (since boot until it is set)
+    static void registerSubscriptions(Subscriptions& subscriptions); //!< lines are sent to the log subscribers from then on, before the kernel starts
+    static void openUdp(); //!< creates the udp pcb, call once the network stack is up
     enum Level : uint8_t {
         LOG_TRACE = 0,
         LOG_DEBUG = 1,
@@ -53,15 +57,18 @@ public:
     static void _vaListError(const char* format, va_list arglist);  //!< Do not use as entry point! Used by C-interface
 private:
     static void log(const char* logPrefix, const char* format, va_list arglist);
+    static int32_t format(const char* logPrefix, const char* format, va_list arglist); //!< into _buffer, 0 on failure
     static void publishSwo(const char* p, int len);
     static void publishUdp(const char* p, int len);
     static const char* getTime();
-    static TickKeeper _getTicks;
-    static uint32_t _ticksPerMs;
-    static constexpr size_t _TIMESTAMP_BUFFER_SIZE {sizeof("YYYY-MM-DD HH:MM:SS.mmm") + 1}; // + null terminator
+    static Clock _getTimeUs;
+    static constexpr size_t _TIMESTAMP_BUFFER_SIZE {sizeof("YYYY-MM-DD HH:MM:SS.uuuuuu") + 1}; // + null terminator
     static char _timestampBuffer[_TIMESTAMP_BUFFER_SIZE];
     static Level _level;
-    static struct sockaddr_in _socketAddr;
+    static Subscriptions* _subscriptions;
+    static UdpSender _udpSender;
+    static osMutexId_t _mutex; //!< held by the task formatting and publishing a line
+    static osThreadId_t _publishingThread; //!< the sender logs its own errors, those lines are not published
     static constexpr size_t _BUFFER_SIZE {512};
     static char _buffer[_BUFFER_SIZE];
 };
@@ -0,0 +1,79 @@
+#include "SyncClock.h"
+
+#include "cmsis_os2.h"
+#include "stm32f7xx_hal.h"
+#include "utils/constants.h"
+
+uint32_t SyncClock::_lastTicks {0U};
+uint32_t SyncClock::_tickWraps {0U};
+int64_t SyncClock::_offsetUs {0};
+int32_t SyncClock::_ratePpb {0};
+uint64_t SyncClock::_anchorUs {0U};
+bool SyncClock::_synchronized {false};
+
+namespace {
+constexpr uint32_t MICROSECONDS_PER_TICK {1000U / TICKS_PER_MILLISECOND};
+constexpr int64_t PPB {1000000000};
+}
+
+uint64_t SyncClock::localUs()
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t ticks = osKernelGetTickCount();
+    uint32_t counter = SysTick->VAL;
+    if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U) {
+        // the counter reloaded but the tick interrupt is masked, count the tick and take the reloaded counter
+        ticks++;
+        counter = SysTick->VAL;
+    }
+    const uint32_t reload = SysTick->LOAD;
+    if(ticks < _lastTicks) {
+        _tickWraps++;
+    }
+    _lastTicks = ticks;
+    const uint64_t totalTicks = (static_cast<uint64_t>(_tickWraps) << 32) | ticks;
+    __set_PRIMASK(primask);
+
+    // SysTick counts down from reload to 0 once per tick, it is not running before the scheduler starts
+    const uint32_t subTickUs = (reload > 0U) ? (((reload - counter) * MICROSECONDS_PER_TICK) / (reload + 1U)) : 0U;
+    return (totalTicks * MICROSECONDS_PER_TICK) + subTickUs;
+}
+
+uint64_t SyncClock::toSynchronized(uint64_t localUs)
+{
+    return static_cast<uint64_t>(static_cast<int64_t>(localUs) + offsetUs(localUs));
+}
+
+int64_t SyncClock::offsetUs(uint64_t localUs)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const int64_t offsetUs = _offsetUs;
+    const int32_t ratePpb = _ratePpb;
+    const uint64_t anchorUs = _anchorUs;
+    __set_PRIMASK(primask);
+    const int64_t sinceAnchorUs = static_cast<int64_t>(localUs - anchorUs);
+    return offsetUs + ((sinceAnchorUs * ratePpb) / PPB);
+}
+
+int32_t SyncClock::ratePpb()
+{
+    return _ratePpb;
+}
+
+bool SyncClock::synchronized()
+{
+    return _synchronized;
+}
+
+void SyncClock::discipline(int64_t offsetUs, int32_t ratePpb, uint64_t anchorUs)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    _offsetUs = offsetUs;
+    _ratePpb = ratePpb;
+    _anchorUs = anchorUs;
+    _synchronized = true;
+    __set_PRIMASK(primask);
+}
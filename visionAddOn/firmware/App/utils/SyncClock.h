@@ -0,0 +1,45 @@
+#ifndef VISIONADDON_APP_UTILS_SYNCCLOCK_H
+#define VISIONADDON_APP_UTILS_SYNCCLOCK_H
+
+#include <cstdint>
+
+// Microsecond clock, local time since boot and the time of the sync master derived from it.
+//
+// The local time is the kernel tick interpolated with the SysTick counter, 64 bit and callable from tasks and
+// interrupts (the tick count wraps after 49 days, the wrap is caught by any call in between).
+// The synchronised time is modelled as local + offset + rate * (local - anchor), the model is disciplined by the
+// network/TimeSync client. Until the first sync the synchronised time is the local time.
+class SyncClock final {
+public:
+    SyncClock() = delete;
+    SyncClock (const SyncClock&) = delete;
+    SyncClock& operator=(const SyncClock&) = delete;
+    SyncClock (const SyncClock&&) = delete;
+    SyncClock& operator=(const SyncClock&&) = delete;
+
+    static uint64_t localUs();
+    static uint64_t nowUs() {return toSynchronized(localUs());}; //!< us since the epoch of the master once synchronised
+    static uint64_t toSynchronized(uint64_t localUs); //!< also for local times taken earlier, e.g. in an interrupt
+    static int64_t offsetUs(uint64_t localUs); //!< synchronised minus local time predicted by the model
+    static int32_t ratePpb(); //!< frequency correction of the local time
+    static bool synchronized(); //!< the model was set at least once
+
+    /**
+     * @brief Replace the model, TimeSync only.
+     *
+     * @param offsetUs synchronised minus local time at anchorUs
+     * @param ratePpb synchronised time runs faster than the local time by this, parts per billion
+     * @param anchorUs local time
+     */
+    static void discipline(int64_t offsetUs, int32_t ratePpb, uint64_t anchorUs);
+
+private:
+    static uint32_t _lastTicks;
+    static uint32_t _tickWraps;
+    static int64_t _offsetUs;
+    static int32_t _ratePpb;
+    static uint64_t _anchorUs;
+    static bool _synchronized;
+};
+
+#endif // VISIONADDON_APP_UTILS_SYNCCLOCK_H
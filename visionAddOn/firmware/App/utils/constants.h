@@ -14,6 +14,10 @@ static const uint16_t PORT_COMMAND_HANDLER = 80;
 static const uint16_t PORT_FRAME_TRANSFER = 1055;
 static const uint16_t PORT_BLOB_RECEIVER = 1056;
 static const uint16_t PORT_LOG = 1057;
+static const uint16_t PORT_NETWORK_BENCHMARK = 1058;
+static const uint16_t PORT_RECORDER = 1059;
+static const uint16_t PORT_COMMAND_BROADCAST = 1061; // udp, 1060 is taken by host/previewReceiver.py
+static const uint16_t PORT_TIME_SYNC = 1062; // udp, of the master (host/timeSyncMaster.py)
 
 static const uint32_t TICKS_PER_SECOND = 1000U; // based on FreeROTSConfig.h configTICK_RATE_HZ
 static const uint32_t MILLISECONDS_PER_SECOND = 1000U;
@@ -24,19 +28,28 @@ static const uint32_t EXTERNAL_SDRAM_END_ADDRESS = 0xc2000000U;
 static const uint32_t EXTERNAL_SDRAM_SIZE_BYTES = (16U * 1024U * 1024U * 16U) / 8U;
 static const uint32_t EXTERNAL_SDRAM_SIZE_MEAGABYTES = EXTERNAL_SDRAM_SIZE_BYTES / 1024U / 1024U;
 static const uint32_t EXTERNAL_SDRAM_SIZE_WORDS = EXTERNAL_SDRAM_SIZE_BYTES / sizeof(uint32_t);
+// the camera frame buffer starts at the base, followed by the frame history, the memory benchmark scratch frame
+// and the preview frame buffer, the flight recorder takes the upper half.
+// The whole SDRAM is cached write-back (MPU_Config in main.cpp), frames written by a DMA go through utils/Cache.h
+static const uint32_t EXTERNAL_SDRAM_FRAME_HISTORY_ADDRESS = 0xc0100000U;
+static const uint32_t EXTERNAL_SDRAM_FRAME_HISTORY_SIZE_BYTES = 0x00d00000U;
+static const uint32_t EXTERNAL_SDRAM_SCRATCH_ADDRESS = 0xc0e00000U;
+static const uint32_t EXTERNAL_SDRAM_SCRATCH_SIZE_BYTES = 0x00100000U;
+static const uint32_t EXTERNAL_SDRAM_PREVIEW_ADDRESS = 0xc0f00000U;
+static const uint32_t EXTERNAL_SDRAM_PREVIEW_SIZE_BYTES = 0x00100000U;
+static const uint32_t EXTERNAL_SDRAM_RECORDER_ADDRESS = 0xc1000000U;
+static const uint32_t EXTERNAL_SDRAM_RECORDER_SIZE_BYTES = 0x01000000U;
 
 static const uint32_t EEPROM_SIZE_BYTES = 256U;
 static const uint32_t EEPROM_SIZE_BIT = EEPROM_SIZE_BYTES * 8U;
 static const uint32_t EEPROM_SIZE_KILOBIT = EEPROM_SIZE_BIT / 1024U;
+static const uint32_t EEPROM_PAGE_SIZE_BYTES = 8U; // a write must not cross a page
 
 static const uint8_t EEPROM_ADDRESS_MAC = 0x10; // 6 byte (0x06)
 static const uint8_t EEPROM_ADDRESS_IP = 0x18; // 4 byte (0x04)
 static const uint8_t EEPROM_ADDRESS_NETMASK = 0x20; // 4 byte (0x04)
 static const uint8_t EEPROM_ADDRESS_GATEWAY = 0x28; // 4 byte (0x04)
-static const uint8_t EEPROM_ADDRESS_CAMERA_MATRIX = 0x40; // 36 byte (0x24)
-static const uint8_t EEPROM_ADDRESS_DISTORTION_COEFFICIENTS = 0x70; // 20 byte (0x14)
-static const uint8_t EEPROM_ADDRESS_ROTATION_MATRIX = 0x90; // 36 byte (0x24)
-static const uint8_t EEPROM_ADDRESS_TRANSLATION_VECTOR = 0xc0; // 12 byte (0x0c)
+static const uint8_t EEPROM_ADDRESS_CALIBRATION = 0x40; // 110 byte (0x6e), blob of calibration/CalibrationManager
 
 #ifndef GIT_COMMIT_HASH
 #define GIT_COMMIT_HASH "?"
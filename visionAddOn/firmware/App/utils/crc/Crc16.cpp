@@ -0,0 +1,44 @@
+#include "Crc16.h"
+
+#include "stm32f7xx_hal.h"
+
+#include <cstring>
+
+Crc16::Crc16()
+{
+    static constexpr uint32_t POLYNOMIAL {0x1021};
+    static constexpr uint32_t INIT {0xffff};
+    __HAL_RCC_CRC_CLK_ENABLE();
+    CRC->POL = POLYNOMIAL;
+    CRC->INIT = INIT;
+    CRC->CR = CRC_CR_POLYSIZE_0; // 16 bit polynomial, no input / output reversal
+}
+
+uint16_t Crc16::compute(const uint8_t* data, size_t size)
+{
+    CRC->CR |= CRC_CR_RESET;
+    // the unit processes words most significant byte first, swap to keep the byte order of the buffer
+    size_t i = 0;
+    for(; (i + sizeof(uint32_t)) <= size; i += sizeof(uint32_t)) {
+        uint32_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        CRC->DR = __REV(word);
+    }
+    for(; i < size; i++) {
+        *reinterpret_cast<volatile uint8_t*>(&CRC->DR) = data[i];
+    }
+    return static_cast<uint16_t>(CRC->DR);
+}
+
+uint16_t Crc16::computeSoftware(const uint8_t* data, size_t size)
+{
+    static constexpr uint16_t POLYNOMIAL {0x1021};
+    uint16_t crc {0xffff};
+    for(size_t i = 0; i < size; i++) {
+        crc = static_cast<uint16_t>(crc ^ (data[i] << 8));
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000U) ? static_cast<uint16_t>((crc << 1) ^ POLYNOMIAL) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,30 @@
+#ifndef VISIONADDON_APP_UTILS_CRC_CRC16_H
+#define VISIONADDON_APP_UTILS_CRC_CRC16_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, init 0xffff, no reflection, no final xor) computed by the CRC calculation unit.
+// The unit is shared, compute() is not thread safe and there must only be one instance.
+class Crc16 final {
+public:
+    Crc16();
+    Crc16 (const Crc16&) = delete;
+    Crc16& operator=(const Crc16&) = delete;
+    Crc16 (const Crc16&&) = delete;
+    Crc16& operator=(const Crc16&&) = delete;
+
+    /**
+     * @brief Compute the crc over a buffer.
+     *
+     * @return crc, 0 if the buffer ends with its own crc (most significant byte first) and is intact
+     */
+    uint16_t compute(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Same crc as compute(), bit by bit without the unit. For small buffers outside the owner of the unit.
+     */
+    static uint16_t computeSoftware(const uint8_t* data, size_t size);
+};
+
+#endif // VISIONADDON_APP_UTILS_CRC_CRC16_H
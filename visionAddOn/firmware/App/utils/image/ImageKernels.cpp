@@ -0,0 +1,241 @@
+#include "ImageKernels.h"
+
+#include "cmsis_gcc.h"
+#include "utils/assert.h"
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+
+namespace {
+constexpr size_t PX_PER_WORD {sizeof(uint32_t)};
+constexpr size_t WORDS_PER_BLOCK {ImageKernels::BLOCK_SIZE / PX_PER_WORD};
+constexpr uint32_t ALL_LANES {0xffffffffU};
+constexpr uint32_t LANE_BITS {0x08040201U}; //!< bit i in byte lane i
+
+bool wordAligned(const void* buffer) {
+    return (reinterpret_cast<uintptr_t>(buffer) % sizeof(uint32_t)) == 0U;
+}
+
+bool streamable(const uint8_t* in, size_t size) {
+    return wordAligned(in) && ((size % ImageKernels::BLOCK_SIZE) == 0U);
+}
+
+// threshold in every byte lane
+inline uint32_t lanes(uint8_t value) {
+    return value * 0x01010101U;
+}
+
+// set in the byte lanes of the px at or above the limit, 0 in the others
+inline uint32_t atOrAbove(uint32_t px, uint32_t limit, uint32_t set) {
+    (void)__USUB8(px, limit); // only the GE flags are used, one per byte lane without borrow
+    return __SEL(set, 0U);
+}
+
+inline uint32_t meanShift(uint8_t factor) {
+    return (factor == 4U) ? 4U : 6U; // mean of 16 or 64 px
+}
+}
+
+void ImageKernels::threshold(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold)
+{
+    ASSERT(streamable(in, size));
+    ASSERT(wordAligned(out));
+    const uint32_t* in32 = reinterpret_cast<const uint32_t*>(in);
+    uint32_t* out32 = reinterpret_cast<uint32_t*>(out);
+    const uint32_t limit = lanes(threshold);
+    for(size_t i = 0; i < (size / PX_PER_WORD); i += WORDS_PER_BLOCK) {
+        for(size_t k = 0; k < WORDS_PER_BLOCK; k++) {
+            out32[i + k] = atOrAbove(in32[i + k], limit, ALL_LANES);
+        }
+    }
+}
+
+void ImageKernels::packBits(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold)
+{
+    static_assert(BLOCK_SIZE == (sizeof(uint32_t) * CHAR_BIT), "one output word per block");
+    ASSERT(streamable(in, size));
+    ASSERT(wordAligned(out));
+    const uint32_t* in32 = reinterpret_cast<const uint32_t*>(in);
+    uint32_t* out32 = reinterpret_cast<uint32_t*>(out);
+    const uint32_t limit = lanes(threshold);
+    for(size_t block = 0; block < (size / BLOCK_SIZE); block++) {
+        uint32_t bits = 0;
+        for(size_t k = 0; k < WORDS_PER_BLOCK; k++) {
+            // the lane bits don't overlap, their byte sum is the nibble of the word
+            const uint32_t nibble = __USAD8(atOrAbove(in32[(block * WORDS_PER_BLOCK) + k], limit, LANE_BITS), 0U);
+            bits |= nibble << (k * PX_PER_WORD);
+        }
+        out32[block] = bits;
+    }
+}
+
+void ImageKernels::histogram(const uint8_t* in, size_t size, uint32_t* bins)
+{
+    // bound by the read-modify-write of the bins, the frame is still read in words
+    ASSERT(streamable(in, size));
+    ASSERT(bins != nullptr);
+    const uint32_t* in32 = reinterpret_cast<const uint32_t*>(in);
+    for(size_t i = 0; i < (size / PX_PER_WORD); i++) {
+        const uint32_t px = in32[i];
+        bins[px & 0xffU]++;
+        bins[(px >> 8) & 0xffU]++;
+        bins[(px >> 16) & 0xffU]++;
+        bins[px >> 24]++;
+    }
+}
+
+void ImageKernels::boxDown(const uint8_t* in, size_t stride, size_t width, uint8_t factor, uint32_t* sums, uint8_t* out)
+{
+    ASSERT((factor == 4U) || (factor == 8U));
+    ASSERT(streamable(in, width));
+    ASSERT((stride % sizeof(uint32_t)) == 0U);
+    const size_t outWidth = width / factor;
+    std::fill_n(sums, outWidth, 0U);
+    // row by row, every row is streamed once
+    for(size_t y = 0; y < factor; y++) {
+        const uint32_t* line = reinterpret_cast<const uint32_t*>(in + (y * stride));
+        if(factor == 4U) {
+            for(size_t x = 0; x < outWidth; x++) {
+                sums[x] = __USADA8(line[x], 0U, sums[x]);
+            }
+        } else {
+            for(size_t x = 0; x < outWidth; x++) {
+                sums[x] = __USADA8(line[(2 * x) + 1], 0U, __USADA8(line[2 * x], 0U, sums[x]));
+            }
+        }
+    }
+    const uint32_t shift = meanShift(factor);
+    for(size_t x = 0; x < outWidth; x++) {
+        out[x] = static_cast<uint8_t>(sums[x] >> shift);
+    }
+}
+
+void ImageKernels::decimate(const uint8_t* in, size_t width, uint8_t factor, uint8_t* out)
+{
+    // nothing to compute, one word read per output px
+    ASSERT((factor == 4U) || (factor == 8U));
+    ASSERT(streamable(in, width));
+    const uint32_t* in32 = reinterpret_cast<const uint32_t*>(in);
+    const size_t wordsPerPx = factor / PX_PER_WORD;
+    for(size_t x = 0; x < (width / factor); x++) {
+        out[x] = static_cast<uint8_t>(in32[x * wordsPerPx]);
+    }
+}
+
+void ImageKernels::crop(const uint8_t* in, size_t stride, size_t width, size_t height, uint8_t* out)
+{
+    // newlib nano copies byte by byte, the region is copied in words instead
+    ASSERT(wordAligned(in));
+    ASSERT(wordAligned(out));
+    ASSERT((stride % sizeof(uint32_t)) == 0U);
+    ASSERT((width % sizeof(uint32_t)) == 0U);
+    const size_t words = width / PX_PER_WORD;
+    uint32_t* out32 = reinterpret_cast<uint32_t*>(out);
+    for(size_t y = 0; y < height; y++) {
+        const uint32_t* line = reinterpret_cast<const uint32_t*>(in + (y * stride));
+        std::copy_n(line, words, out32);
+        out32 += words;
+    }
+}
+
+size_t ImageKernels::runLengths(const uint8_t* in, size_t size, uint8_t threshold, uint16_t* positions, size_t capacity)
+{
+    ASSERT(streamable(in, size));
+    ASSERT(size <= std::numeric_limits<uint16_t>::max());
+    const uint32_t* in32 = reinterpret_cast<const uint32_t*>(in);
+    const uint32_t limit = lanes(threshold);
+    uint32_t state = 0; // all lanes below or all lanes at or above the threshold
+    size_t count = 0;
+    for(size_t i = 0; i < (size / PX_PER_WORD); i++) {
+        const uint32_t mask = atOrAbove(in32[i], limit, ALL_LANES);
+        if(mask == state) {
+            continue; // the common case, 4 px without a toggle
+        }
+        for(size_t lane = 0; lane < PX_PER_WORD; lane++) {
+            const uint32_t shift = lane * CHAR_BIT;
+            if(((mask ^ state) >> shift) & 0xffU) {
+                if(count == capacity) {
+                    return count;
+                }
+                positions[count++] = static_cast<uint16_t>((i * PX_PER_WORD) + lane);
+                state = ~state;
+            }
+        }
+    }
+    return count;
+}
+
+void ImageKernels::Reference::threshold(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold)
+{
+    for(size_t i = 0; i < size; i++) {
+        out[i] = (in[i] >= threshold) ? 0xffU : 0U;
+    }
+}
+
+void ImageKernels::Reference::packBits(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold)
+{
+    for(size_t i = 0; i < size; i += CHAR_BIT) {
+        uint8_t bits = 0;
+        for(size_t bit = 0; bit < CHAR_BIT; bit++) {
+            if(in[i + bit] >= threshold) {
+                bits = static_cast<uint8_t>(bits | (1U << bit));
+            }
+        }
+        out[i / CHAR_BIT] = bits;
+    }
+}
+
+void ImageKernels::Reference::histogram(const uint8_t* in, size_t size, uint32_t* bins)
+{
+    for(size_t i = 0; i < size; i++) {
+        bins[in[i]]++;
+    }
+}
+
+void ImageKernels::Reference::boxDown(const uint8_t* in, size_t stride, size_t width, uint8_t factor, uint32_t* sums, uint8_t* out)
+{
+    const size_t outWidth = width / factor;
+    std::fill_n(sums, outWidth, 0U);
+    for(size_t y = 0; y < factor; y++) {
+        for(size_t x = 0; x < width; x++) {
+            sums[x / factor] += in[(y * stride) + x];
+        }
+    }
+    const uint32_t shift = meanShift(factor);
+    for(size_t x = 0; x < outWidth; x++) {
+        out[x] = static_cast<uint8_t>(sums[x] >> shift);
+    }
+}
+
+void ImageKernels::Reference::decimate(const uint8_t* in, size_t width, uint8_t factor, uint8_t* out)
+{
+    for(size_t x = 0; x < (width / factor); x++) {
+        out[x] = in[x * factor];
+    }
+}
+
+void ImageKernels::Reference::crop(const uint8_t* in, size_t stride, size_t width, size_t height, uint8_t* out)
+{
+    for(size_t y = 0; y < height; y++) {
+        for(size_t x = 0; x < width; x++) {
+            out[(y * width) + x] = in[(y * stride) + x];
+        }
+    }
+}
+
+size_t ImageKernels::Reference::runLengths(const uint8_t* in, size_t size, uint8_t threshold, uint16_t* positions, size_t capacity)
+{
+    bool above = false;
+    size_t count = 0;
+    for(size_t i = 0; i < size; i++) {
+        if((in[i] >= threshold) != above) {
+            if(count == capacity) {
+                return count;
+            }
+            positions[count++] = static_cast<uint16_t>(i);
+            above = !above;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,98 @@
+#ifndef VISIONADDON_APP_UTILS_IMAGE_IMAGEKERNELS_H
+#define VISIONADDON_APP_UTILS_IMAGE_IMAGEKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels on 8 bit grayscale frames (Ov9281 Y8), e.g. in the external SDRAM.
+//
+// The frame is read word by word, 4 px per access, and the px of a word are processed together with the ARMv7E-M
+// SIMD instructions (__USUB8 / __SEL compare, __USAD8 / __USADA8 byte sums), which keeps the kernels close to the
+// SDRAM bandwidth. Little endian, the first px of a word is its low byte. Unless stated otherwise buffers are word
+// aligned and rows are whole blocks of BLOCK_SIZE px. Reference holds plain byte loop versions with identical
+// results, see metrics/ImageKernelBenchmark.
+class ImageKernels final {
+public:
+    ImageKernels() = delete;
+    ImageKernels (const ImageKernels&) = delete;
+    ImageKernels& operator=(const ImageKernels&) = delete;
+    ImageKernels (const ImageKernels&&) = delete;
+    ImageKernels& operator=(const ImageKernels&&) = delete;
+
+    /**
+     * @brief Binarize px, 0xff at or above the threshold, 0 below.
+     *
+     * @param out size bytes, may be in
+     */
+    static void threshold(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold);
+
+    /**
+     * @brief Binarize px into bits, 1 at or above the threshold. The first px is bit 0 of the first byte.
+     *
+     * @param out size / 8 bytes
+     */
+    static void packBits(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold);
+
+    /**
+     * @brief Count px per value, adds to the bins.
+     *
+     * @param bins 256 counters
+     */
+    static void histogram(const uint8_t* in, size_t size, uint32_t* bins);
+
+    /**
+     * @brief Scale one row down by the mean of factor x factor px.
+     *
+     * @param in first of factor rows, stride bytes apart
+     * @param width in px
+     * @param factor 4 or 8
+     * @param sums width / factor scratch counters
+     * @param out width / factor bytes, any alignment
+     */
+    static void boxDown(const uint8_t* in, size_t stride, size_t width, uint8_t factor, uint32_t* sums, uint8_t* out);
+
+    /**
+     * @brief Scale one row down by picking every factor-th px.
+     *
+     * @param factor 4 or 8
+     * @param out width / factor bytes, any alignment
+     */
+    static void decimate(const uint8_t* in, size_t width, uint8_t factor, uint8_t* out);
+
+    /**
+     * @brief Copy a region of interest into a dense buffer.
+     *
+     * @param in first px of the region, word aligned
+     * @param stride bytes from one row of in to the next, whole words
+     * @param width in px, whole words, no block alignment needed
+     * @param out width * height bytes
+     */
+    static void crop(const uint8_t* in, size_t stride, size_t width, size_t height, uint8_t* out);
+
+    /**
+     * @brief Run length encode a binarized row as the px positions where it toggles, starting below the threshold.
+     *
+     * Run i spans from position i - 1 (or 0) to position i, the last run ends at size.
+     * @param positions at most capacity positions, further toggles are dropped
+     * @return number of positions written
+     */
+    static size_t runLengths(const uint8_t* in, size_t size, uint8_t threshold, uint16_t* positions, size_t capacity);
+
+    // byte loop versions of the kernels above, same contracts and results
+    class Reference final {
+    public:
+        Reference() = delete;
+
+        static void threshold(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold);
+        static void packBits(const uint8_t* in, uint8_t* out, size_t size, uint8_t threshold);
+        static void histogram(const uint8_t* in, size_t size, uint32_t* bins);
+        static void boxDown(const uint8_t* in, size_t stride, size_t width, uint8_t factor, uint32_t* sums, uint8_t* out);
+        static void decimate(const uint8_t* in, size_t width, uint8_t factor, uint8_t* out);
+        static void crop(const uint8_t* in, size_t stride, size_t width, size_t height, uint8_t* out);
+        static size_t runLengths(const uint8_t* in, size_t size, uint8_t threshold, uint16_t* positions, size_t capacity);
+    };
+
+    static constexpr size_t BLOCK_SIZE {32}; //!< px per iteration of the streaming kernels
+};
+
+#endif // VISIONADDON_APP_UTILS_IMAGE_IMAGEKERNELS_H
@@ -0,0 +1,39 @@
+#include "InterruptProfiler.h"
+
+#include <algorithm>
+
+InterruptStats InterruptProfiler::_stats[NUMBER_OF_INTERRUPT_SOURCES] {};
+uint32_t InterruptProfiler::_entryCycles[NUMBER_OF_INTERRUPT_SOURCES] {};
+bool InterruptProfiler::_entryValid[NUMBER_OF_INTERRUPT_SOURCES] {};
+
+void InterruptProfiler::record(InterruptSource source, uint32_t handlerStart)
+{
+    const uint32_t handlerCycles = CycleCounter::now() - handlerStart; // unsigned difference is wrap safe
+    InterruptStats& stats = _stats[source];
+    stats.count++;
+    stats.handlerCyclesLast = handlerCycles;
+    stats.handlerCyclesMax = std::max(stats.handlerCyclesMax, handlerCycles);
+    if(_entryValid[source]) {
+        const uint32_t dispatchCycles = handlerStart - _entryCycles[source];
+        stats.dispatchCyclesLast = dispatchCycles;
+        stats.dispatchCyclesMax = std::max(stats.dispatchCyclesMax, dispatchCycles);
+        _entryValid[source] = false;
+    }
+}
+
+InterruptStats InterruptProfiler::stats(InterruptSource source)
+{
+    if(source >= NUMBER_OF_INTERRUPT_SOURCES) {
+        return InterruptStats{};
+    }
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    InterruptStats stats = _stats[source];
+    __set_PRIMASK(primask);
+    return stats;
+}
+
+void interrupt_profiler_enter(InterruptSource source)
+{
+    InterruptProfiler::enter(source);
+}
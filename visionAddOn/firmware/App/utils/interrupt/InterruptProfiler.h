@@ -0,0 +1,74 @@
+#ifndef VISIONADDON_APP_UTILS_INTERRUPT_INTERRUPTPROFILER_H
+#define VISIONADDON_APP_UTILS_INTERRUPT_INTERRUPTPROFILER_H
+
+#include "c_interrupt_profiler.h"
+#include "utils/CycleCounter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class InterruptStats {
+public:
+    uint32_t count = {};
+    uint32_t dispatchCyclesLast = {}; //!< IRQ handler entry to application handler call, in core clock cycles
+    uint32_t dispatchCyclesMax = {};
+    uint32_t handlerCyclesLast = {}; //!< application handler duration, in core clock cycles
+    uint32_t handlerCyclesMax = {};
+
+    static constexpr size_t SIZE {20};
+    static constexpr size_t OFFSET_COUNT {0};
+    static constexpr size_t OFFSET_DISPATCH_CYCLES_LAST {OFFSET_COUNT + sizeof(count)};
+    static constexpr size_t OFFSET_DISPATCH_CYCLES_MAX {OFFSET_DISPATCH_CYCLES_LAST + sizeof(dispatchCyclesLast)};
+    static constexpr size_t OFFSET_HANDLER_CYCLES_LAST {OFFSET_DISPATCH_CYCLES_MAX + sizeof(dispatchCyclesMax)};
+    static constexpr size_t OFFSET_HANDLER_CYCLES_MAX {OFFSET_HANDLER_CYCLES_LAST + sizeof(handlerCyclesLast)};
+    static_assert(OFFSET_HANDLER_CYCLES_MAX + sizeof(handlerCyclesMax) == SIZE);
+
+    bool toBytes(uint8_t* buffer, size_t size) const {
+        if(SIZE > size) {
+            return false;
+        }
+        std::memcpy(buffer + OFFSET_COUNT, &count, sizeof(count));
+        std::memcpy(buffer + OFFSET_DISPATCH_CYCLES_LAST, &dispatchCyclesLast, sizeof(dispatchCyclesLast));
+        std::memcpy(buffer + OFFSET_DISPATCH_CYCLES_MAX, &dispatchCyclesMax, sizeof(dispatchCyclesMax));
+        std::memcpy(buffer + OFFSET_HANDLER_CYCLES_LAST, &handlerCyclesLast, sizeof(handlerCyclesLast));
+        std::memcpy(buffer + OFFSET_HANDLER_CYCLES_MAX, &handlerCyclesMax, sizeof(handlerCyclesMax));
+        return true;
+    }
+};
+
+// Cycle accurate timing of the interrupt dispatch, CycleCounter must be initialized before the first profiled interrupt.
+//
+// Every source is written from its own interrupt only, readers take a snapshot with interrupts masked.
+class InterruptProfiler final {
+public:
+    InterruptProfiler() = delete;
+    InterruptProfiler (const InterruptProfiler&) = delete;
+    InterruptProfiler& operator=(const InterruptProfiler&) = delete;
+    InterruptProfiler (const InterruptProfiler&&) = delete;
+    InterruptProfiler& operator=(const InterruptProfiler&&) = delete;
+
+    static void enter(InterruptSource source) {
+        _entryCycles[source] = CycleCounter::now();
+        _entryValid[source] = true;
+    };
+
+    /**
+     * @brief Account one handled interrupt, call after the application handler returned.
+     *
+     * @param source profiled interrupt
+     * @param handlerStart CycleCounter::now() taken right before the application handler was called
+     */
+    static void record(InterruptSource source, uint32_t handlerStart);
+
+    /**
+     * @return snapshot of the statistics, all zero if source is invalid
+     */
+    static InterruptStats stats(InterruptSource source);
+private:
+    static InterruptStats _stats[NUMBER_OF_INTERRUPT_SOURCES];
+    static uint32_t _entryCycles[NUMBER_OF_INTERRUPT_SOURCES];
+    static bool _entryValid[NUMBER_OF_INTERRUPT_SOURCES]; //!< the dispatch time is only known if the IRQ handler called enter
+};
+
+#endif // VISIONADDON_APP_UTILS_INTERRUPT_INTERRUPTPROFILER_H
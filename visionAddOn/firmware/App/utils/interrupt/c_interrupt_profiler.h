@@ -0,0 +1,21 @@
+#ifndef VISIONADDON_APP_UTILS_INTERRUPT_CINTERRUPTPROFILER_H
+#define VISIONADDON_APP_UTILS_INTERRUPT_CINTERRUPTPROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// profiled interrupts, the value is the index in the INTERRUPT_GET_STATS command
+typedef enum {
+    INTERRUPT_SOURCE_EXTI = 0, //!< external interrupt lines, spi new data
+    INTERRUPT_SOURCE_UART_RX = 1, //!< uart receive to idle events
+    NUMBER_OF_INTERRUPT_SOURCES
+} InterruptSource;
+
+void interrupt_profiler_enter(InterruptSource source); //!< call first thing in the IRQ handler, timestamps the entry
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VISIONADDON_APP_UTILS_INTERRUPT_CINTERRUPTPROFILER_H
@@ -1,50 +1,204 @@
 #include "BufferPool.h"
 
 #include "utils/assert.h"
-#include "utils/Log.h"
 
 #include <algorithm>
-#include <stdlib.h>
-#include <mutex>
-BufferPool::BufferPool(size_t depth, IMutex& mutex) :
-_mutex{mutex}
+#include <new>
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept :
+_pool{other._pool},
+_data{other._data}
+{
+    other._pool = nullptr;
+    other._data = nullptr;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept
+{
+    if(this != &other) {
+        reset();
+        _pool = other._pool;
+        _data = other._data;
+        other._pool = nullptr;
+        other._data = nullptr;
+    }
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer()
 {
-    for(size_t i = 0; i < depth; i++){
-        uint8_t* p = (uint8_t*)malloc(_BUFFER_SIZE);
-        ASSERT(p != nullptr);
-        Log::debug("[BufferPool] *p: %#x", p);
-        _pool.push_back(p);
-        _validBases.push_back(p);
+    reset();
+}
+
+size_t BufferPool::Buffer::capacity() const
+{
+    return (_data != nullptr) ? _pool->_blockSize : 0U;
+}
+
+void BufferPool::Buffer::reset()
+{
+    if(_data != nullptr) {
+        _pool->release(_data, BLOCK_ACQUIRED);
     }
+    _pool = nullptr;
+    _data = nullptr;
 }
 
-uint8_t* BufferPool::acquire(size_t size)
+uint8_t* BufferPool::Buffer::detach()
 {
-    Log::trace("[BufferPool] acquire: pool size: %u", _pool.size());
-    if(size > _BUFFER_SIZE){
-        Log::warning("[BufferPool] acquire: size exeeds buffer");
+    if(_data == nullptr) {
         return nullptr;
     }
-    uint8_t* p {nullptr};
-    {
-        std::scoped_lock lock(_mutex);
-        if(_pool.empty()){
-            Log::warning("[BufferPool] acquire: pool exhausted");
+    _pool->headerOf(_data)->state.store(BLOCK_DETACHED, std::memory_order_release);
+    uint8_t* p = _data;
+    _pool = nullptr;
+    _data = nullptr;
+    return p;
+}
+
+struct pbuf* BufferPool::Buffer::toPbuf(size_t length)
+{
+    if((_data == nullptr) || (length > capacity()) || (length > UINT16_MAX)) {
+        return nullptr;
+    }
+    BlockHeader* header = _pool->headerOf(_data);
+    header->pbuf.custom_free_function = &BufferPool::freePbuf;
+    header->state.store(BLOCK_PBUF, std::memory_order_release);
+    const uint16_t payloadMemLength = static_cast<uint16_t>(std::min<size_t>(capacity(), UINT16_MAX));
+    struct pbuf* p = pbuf_alloced_custom(PBUF_RAW, static_cast<uint16_t>(length), PBUF_REF, &header->pbuf, _data, payloadMemLength);
+    if(p == nullptr) {
+        header->state.store(BLOCK_ACQUIRED, std::memory_order_release);
+        return nullptr;
+    }
+    _pool = nullptr;
+    _data = nullptr;
+    return p;
+}
+
+BufferPool::BufferPool(uint8_t* storage, size_t blockSize, size_t blockCount) :
+_storage{storage},
+_blockSize{blockSize},
+_blockCount{blockCount},
+_stride{stride(blockSize)},
+_freeHead{0U}
+{
+    ASSERT(_storage != nullptr);
+    ASSERT((reinterpret_cast<uintptr_t>(_storage) % ALIGNMENT) == 0);
+    ASSERT((_blockCount > 0) && (_blockCount < _INDEX_NONE));
+    for(size_t i = 0; i < _blockCount; i++) {
+        BlockHeader* block = new (_storage + (i * _stride)) BlockHeader{};
+        block->pool = this;
+        block->index = static_cast<uint16_t>(i);
+        block->next.store(((i + 1) < _blockCount) ? static_cast<uint16_t>(i + 1) : _INDEX_NONE, std::memory_order_relaxed);
+        block->state.store(BLOCK_FREE, std::memory_order_relaxed);
+    }
+}
+
+BufferPool::Buffer BufferPool::acquire(size_t size)
+{
+    if(size > _blockSize) {
+        _acquireFailures.fetch_add(1U, std::memory_order_relaxed);
+        return Buffer{};
+    }
+    BlockHeader* block = pop();
+    if(block == nullptr) {
+        _acquireFailures.fetch_add(1U, std::memory_order_relaxed);
+        return Buffer{};
+    }
+    block->state.store(BLOCK_ACQUIRED, std::memory_order_release);
+    const uint32_t inUse = _blocksInUse.fetch_add(1U, std::memory_order_relaxed) + 1U;
+    uint32_t inUseMax = _blocksInUseMax.load(std::memory_order_relaxed);
+    while((inUse > inUseMax) && !_blocksInUseMax.compare_exchange_weak(inUseMax, inUse, std::memory_order_relaxed)) {
+    }
+    return Buffer{this, dataOf(block)};
+}
+
+BufferPool::Buffer BufferPool::adopt(uint8_t* p)
+{
+    BlockHeader* block = headerOf(p);
+    uint8_t expected {BLOCK_DETACHED};
+    if((block == nullptr) || !block->state.compare_exchange_strong(expected, BLOCK_ACQUIRED, std::memory_order_acq_rel)) {
+        _invalidReleases.fetch_add(1U, std::memory_order_relaxed);
+        return Buffer{};
+    }
+    return Buffer{this, p};
+}
+
+BufferPoolStats BufferPool::stats() const
+{
+    BufferPoolStats stats {};
+    stats.blockCount = static_cast<uint32_t>(_blockCount);
+    stats.blocksInUse = _blocksInUse.load(std::memory_order_relaxed);
+    stats.blocksInUseMax = _blocksInUseMax.load(std::memory_order_relaxed);
+    stats.acquireFailures = _acquireFailures.load(std::memory_order_relaxed);
+    stats.invalidReleases = _invalidReleases.load(std::memory_order_relaxed);
+    return stats;
+}
+
+BufferPool::BlockHeader* BufferPool::header(uint16_t index) const
+{
+    return reinterpret_cast<BlockHeader*>(_storage + (index * _stride));
+}
+
+BufferPool::BlockHeader* BufferPool::headerOf(const uint8_t* data) const
+{
+    const uint8_t* firstData = _storage + headerSize();
+    if((data == nullptr) || (data < firstData)) {
+        return nullptr;
+    }
+    const size_t offset = static_cast<size_t>(data - firstData);
+    if(((offset % _stride) != 0) || ((offset / _stride) >= _blockCount)) {
+        return nullptr;
+    }
+    return header(static_cast<uint16_t>(offset / _stride));
+}
+
+// Treiber stack, the tag is incremented on every change of the head so a pop that read a stale next link fails its
+// compare exchange even if the same block is on top again (ABA).
+// On the cortex-m7 the compare exchange maps to ldrex / strex, an exception entry clears the exclusive monitor.
+void BufferPool::push(BlockHeader* block)
+{
+    static constexpr uint32_t TAG_INCREMENT {0x10000U};
+    uint32_t head = _freeHead.load(std::memory_order_relaxed);
+    uint32_t newHead {0U};
+    do {
+        block->next.store(static_cast<uint16_t>(head & _INDEX_NONE), std::memory_order_relaxed);
+        newHead = ((head & ~static_cast<uint32_t>(_INDEX_NONE)) + TAG_INCREMENT) | block->index;
+    } while(!_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+BufferPool::BlockHeader* BufferPool::pop()
+{
+    static constexpr uint32_t TAG_INCREMENT {0x10000U};
+    uint32_t head = _freeHead.load(std::memory_order_acquire);
+    while(true) {
+        const uint16_t index = static_cast<uint16_t>(head & _INDEX_NONE);
+        if(index == _INDEX_NONE) {
             return nullptr;
         }
-        p = _pool.back();
-        _pool.pop_back();
+        BlockHeader* block = header(index);
+        const uint32_t newHead = ((head & ~static_cast<uint32_t>(_INDEX_NONE)) + TAG_INCREMENT) | block->next.load(std::memory_order_relaxed);
+        if(_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            return block;
+        }
     }
-    Log::trace("[BufferPool] acquire: *p: %#x", p);
-    return p;
 }
 
-void BufferPool::release(uint8_t* p)
+void BufferPool::release(uint8_t* data, BlockState owner)
 {
-    ASSERT(std::find(_validBases.begin(), _validBases.end(), p) != _validBases.end());
-    {
-        std::scoped_lock lock(_mutex);
-        _pool.push_back(p);
+    BlockHeader* block = headerOf(data);
+    uint8_t expected {owner};
+    if((block == nullptr) || !block->state.compare_exchange_strong(expected, BLOCK_FREE, std::memory_order_acq_rel)) {
+        _invalidReleases.fetch_add(1U, std::memory_order_relaxed);
+        return;
     }
-    Log::trace("[BufferPool] released: *p: %#x, pool size: %u", p, _pool.size());
+    _blocksInUse.fetch_sub(1U, std::memory_order_relaxed);
+    push(block);
+}
+
+void BufferPool::freePbuf(struct pbuf* p)
+{
+    // pbuf_custom is the first member of the block header
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(p);
+    block->pool->release(dataOf(block), BLOCK_PBUF);
 }
@@ -1,45 +1,149 @@
 #ifndef VISIONADDON_APP_UTILS_POOL_BUFFERPOOL_H
 #define VISIONADDON_APP_UTILS_POOL_BUFFERPOOL_H
 
-#include "utils/mutex/IMutex.h"
+#include "lwip/pbuf.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <vector>
 
+class BufferPoolStats {
+public:
+    uint32_t blockCount = {};
+    uint32_t blocksInUse = {};
+    uint32_t blocksInUseMax = {}; //!< high water mark, reaching blockCount means the pool is too small or leaks
+    uint32_t acquireFailures = {}; //!< pool exhausted or requested size exceeds the block size
+    uint32_t invalidReleases = {}; //!< pointer not owned by the pool or block released twice
+};
+
+// Fixed size blocks in caller provided (static) storage, kept in a lock-free free list.
+//
+// acquire and release are O(1) and safe to call from interrupt context, they neither block nor log.
+// Every block carries a lwip custom pbuf header, a Buffer handed to the network stack returns
+// to the pool when the stack frees the pbuf.
 class BufferPool final {
 public:
-    BufferPool(size_t depth, IMutex& mutex);
+    static constexpr size_t ALIGNMENT {32}; //!< cache line size, blocks never share a line
+
+    /**
+     * @brief Move only ownership of a block, the block is returned to the pool on destruction.
+     */
+    class Buffer final {
+    public:
+        Buffer() = default;
+        Buffer (const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+        ~Buffer();
+
+        explicit operator bool() const {return _data != nullptr;};
+        uint8_t* data() const {return _data;};
+        size_t capacity() const;
+        void reset(); //!< return the block to the pool now
+
+        /**
+         * @brief Give up ownership without returning the block, e.g. to pass it through a message queue.
+         *
+         * @return block base, must be turned into a Buffer again by BufferPool::adopt
+         */
+        uint8_t* detach();
+
+        /**
+         * @brief Hand the block over to lwip as a PBUF_REF custom pbuf.
+         *
+         * The block returns to the pool once the last reference to the pbuf is freed.
+         *
+         * @param length payload length in bytes, at most capacity()
+         * @return pbuf, nullptr on failure (ownership is kept in that case)
+         */
+        struct pbuf* toPbuf(size_t length);
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool* pool, uint8_t* data) : _pool{pool}, _data{data} {};
+        BufferPool* _pool {nullptr};
+        uint8_t* _data {nullptr};
+    };
+
+    /**
+     * @brief Required storage for a pool.
+     *
+     * @param blockSize usable bytes per block
+     * @param blockCount number of blocks
+     * @return storage size in bytes
+     */
+    static constexpr size_t storageSize(size_t blockSize, size_t blockCount) {
+        return stride(blockSize) * blockCount;
+    }
+
+    /**
+     * @param storage at least storageSize(blockSize, blockCount) bytes, aligned to ALIGNMENT
+     * @param blockSize usable bytes per block
+     * @param blockCount number of blocks, less than 0xffff
+     */
+    BufferPool(uint8_t* storage, size_t blockSize, size_t blockCount);
     BufferPool (const BufferPool&) = delete;
     BufferPool& operator=(const BufferPool&) = delete;
     BufferPool (const BufferPool&&) = delete;
     BufferPool& operator=(const BufferPool&&) = delete;
 
     /**
-     * @brief Request a buffer from the pool.
-     * 
-     * This function attempts to acquire a buffer of the specified size from the buffer pool.
-     * 
-     * @param size The size of the buffer to request.
-     * @return pointer to base of buffer, nullptr if allocation failed
+     * @brief Request a block from the pool.
+     *
+     * @param size required bytes, at most blockSize()
+     * @return buffer, empty if the pool is exhausted or size exceeds the block size
      */
-    uint8_t* acquire(size_t size);
+    Buffer acquire(size_t size);
 
     /**
-     * @brief Returns a buffer back to the pool.
-     * 
-     * This function is used to return a previously allocated buffer back to the pool,
-     * making it available for future use.
-     * 
-     * @param b The buffer to be returned to the pool.
+     * @brief Take back ownership of a block previously given up by Buffer::detach.
+     *
+     * @return buffer, empty if p is not a detached block of this pool
      */
-    void release(uint8_t* p);
+    Buffer adopt(uint8_t* p);
+
+    size_t blockSize() const {return _blockSize;};
+    BufferPoolStats stats() const;
+
 private:
-    static constexpr size_t _BUFFER_SIZE {1024};
-    IMutex& _mutex;
-    std::deque<uint8_t*> _pool;
-    std::vector<uint8_t*> _validBases;
+    struct BlockHeader {
+        struct pbuf_custom pbuf; //!< must be first, lwip hands back the pbuf pointer on free
+        BufferPool* pool;
+        uint16_t index;
+        std::atomic<uint16_t> next; //!< free list link, only valid while the block is free
+        std::atomic<uint8_t> state;
+    };
+    enum BlockState : uint8_t {
+        BLOCK_FREE = 0,
+        BLOCK_ACQUIRED = 1, //!< owned by a Buffer
+        BLOCK_DETACHED = 2, //!< owned by a raw pointer in transit
+        BLOCK_PBUF = 3, //!< owned by lwip
+    };
+    static constexpr size_t headerSize() {
+        return (sizeof(BlockHeader) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+    static constexpr size_t stride(size_t blockSize) {
+        return headerSize() + ((blockSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+    }
+    static constexpr uint16_t _INDEX_NONE {0xffff};
+
+    BlockHeader* header(uint16_t index) const;
+    BlockHeader* headerOf(const uint8_t* data) const; //!< nullptr if data is not a block base of this pool
+    static uint8_t* dataOf(BlockHeader* header) {return reinterpret_cast<uint8_t*>(header) + headerSize();};
+    void push(BlockHeader* header);
+    BlockHeader* pop();
+    void release(uint8_t* data, BlockState owner);
+    static void freePbuf(struct pbuf* p);
+
+    uint8_t* _storage;
+    const size_t _blockSize;
+    const size_t _blockCount;
+    const size_t _stride;
+    std::atomic<uint32_t> _freeHead; //!< [31:16] tag against ABA, [15:0] index of the first free block
+    std::atomic<uint32_t> _blocksInUse {0};
+    std::atomic<uint32_t> _blocksInUseMax {0};
+    std::atomic<uint32_t> _acquireFailures {0};
+    std::atomic<uint32_t> _invalidReleases {0};
 };
 
-#endif // VISIONADDON_APP_UTILS_POOL_BUFFERPOOL_H
\ No newline at end of file
+#endif // VISIONADDON_APP_UTILS_POOL_BUFFERPOOL_H
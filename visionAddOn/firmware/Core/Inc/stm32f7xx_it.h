@@ -58,6 +58,7 @@ void USART2_IRQHandler(void);
 void EXTI15_10_IRQHandler(void);
 void DMA2_Stream0_IRQHandler(void);
 void DMA2_Stream1_IRQHandler(void);
+void DMA2_Stream2_IRQHandler(void);
 void ETH_IRQHandler(void);
 void DCMI_IRQHandler(void);
 /* USER CODE BEGIN EFP */
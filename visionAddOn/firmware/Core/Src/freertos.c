@@ -26,6 +26,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "c_app_builder.h"
+#include "metrics/c_boot_timeline.h"
 #include "lwip.h"
 #include "utils/c_log.h"
 #include "utils/allocator.h"
@@ -78,9 +79,21 @@ const osThreadAttr_t blobDetectorTas_attributes = {
   .stack_size = sizeof(blobDetectorBuffer),
   .priority = (osPriority_t) osPriorityNormal,
 };
+/* Definitions for controlTask */
+osThreadId_t controlTaskHandle;
+uint32_t controlTaskBuffer[ 512 ];
+osStaticThreadDef_t controlTaskControlBlock;
+const osThreadAttr_t controlTask_attributes = {
+  .name = "controlTask",
+  .cb_mem = &controlTaskControlBlock,
+  .cb_size = sizeof(controlTaskControlBlock),
+  .stack_mem = &controlTaskBuffer[0],
+  .stack_size = sizeof(controlTaskBuffer),
+  .priority = (osPriority_t) osPriorityBelowNormal,
+};
 /* Definitions for statsTask */
 osThreadId_t statsTaskHandle;
-uint32_t statsTaskBuffer[ 256 ];
+uint32_t statsTaskBuffer[ 512 ];
 osStaticThreadDef_t statsTaskControlBlock;
 const osThreadAttr_t statsTask_attributes = {
   .name = "statsTask",
@@ -90,6 +103,66 @@ const osThreadAttr_t statsTask_attributes = {
   .stack_size = sizeof(statsTaskBuffer),
   .priority = (osPriority_t) osPriorityLow,
 };
+/* Definitions for profilerTask */
+osThreadId_t profilerTaskHandle;
+uint32_t profilerTaskBuffer[ 256 ];
+osStaticThreadDef_t profilerTaskControlBlock;
+const osThreadAttr_t profilerTask_attributes = {
+  .name = "profilerTask",
+  .cb_mem = &profilerTaskControlBlock,
+  .cb_size = sizeof(profilerTaskControlBlock),
+  .stack_mem = &profilerTaskBuffer[0],
+  .stack_size = sizeof(profilerTaskBuffer),
+  .priority = (osPriority_t) osPriorityAboveNormal,
+};
+/* Definitions for historyTask */
+osThreadId_t historyTaskHandle;
+uint32_t historyTaskBuffer[ 256 ];
+osStaticThreadDef_t historyTaskControlBlock;
+const osThreadAttr_t historyTask_attributes = {
+  .name = "historyTask",
+  .cb_mem = &historyTaskControlBlock,
+  .cb_size = sizeof(historyTaskControlBlock),
+  .stack_mem = &historyTaskBuffer[0],
+  .stack_size = sizeof(historyTaskBuffer),
+  .priority = (osPriority_t) osPriorityBelowNormal,
+};
+/* Definitions for previewTask */
+osThreadId_t previewTaskHandle;
+uint32_t previewTaskBuffer[ 256 ];
+osStaticThreadDef_t previewTaskControlBlock;
+const osThreadAttr_t previewTask_attributes = {
+  .name = "previewTask",
+  .cb_mem = &previewTaskControlBlock,
+  .cb_size = sizeof(previewTaskControlBlock),
+  .stack_mem = &previewTaskBuffer[0],
+  .stack_size = sizeof(previewTaskBuffer),
+  .priority = (osPriority_t) osPriorityLow,
+};
+/* Definitions for memTestTask */
+osThreadId_t memTestTaskHandle;
+uint32_t memTestTaskBuffer[ 256 ];
+osStaticThreadDef_t memTestTaskControlBlock;
+const osThreadAttr_t memTestTask_attributes = {
+  .name = "memTestTask",
+  .cb_mem = &memTestTaskControlBlock,
+  .cb_size = sizeof(memTestTaskControlBlock),
+  .stack_mem = &memTestTaskBuffer[0],
+  .stack_size = sizeof(memTestTaskBuffer),
+  .priority = (osPriority_t) osPriorityLow,
+};
+/* Definitions for timeSyncTask */
+osThreadId_t timeSyncTaskHandle;
+uint32_t timeSyncTaskBuffer[ 512 ];
+osStaticThreadDef_t timeSyncTaskControlBlock;
+const osThreadAttr_t timeSyncTask_attributes = {
+  .name = "timeSyncTask",
+  .cb_mem = &timeSyncTaskControlBlock,
+  .cb_size = sizeof(timeSyncTaskControlBlock),
+  .stack_mem = &timeSyncTaskBuffer[0],
+  .stack_size = sizeof(timeSyncTaskBuffer),
+  .priority = (osPriority_t) osPriorityNormal,
+};
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN FunctionPrototypes */
@@ -98,7 +171,13 @@ const osThreadAttr_t statsTask_attributes = {
 
 void StartNetworkTask(void *argument);
 void StartBlobDetectorTask(void *argument);
+void StartControlTask(void *argument);
 void StartStatsTask(void *argument);
+void StartProfilerTask(void *argument);
+void StartHistoryTask(void *argument);
+void StartPreviewTask(void *argument);
+void StartMemTestTask(void *argument);
+void StartTimeSyncTask(void *argument);
 
 extern void MX_LWIP_Init(void);
 void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
@@ -172,7 +251,9 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_TIMERS */
   app_build();
+  // needed by the generated MX_LWIP_Init, the rest of the network config is applied by the networkTask
   persisted_mac = app_fetch_mac_address_from_storage();
+  boot_timeline_reached(BOOT_PHASE_SCHEDULER);
 
   /* USER CODE END RTOS_TIMERS */
 
@@ -187,9 +268,27 @@ void MX_FREERTOS_Init(void) {
   /* creation of blobDetectorTas */
   blobDetectorTasHandle = osThreadNew(StartBlobDetectorTask, NULL, &blobDetectorTas_attributes);
 
+  /* creation of controlTask */
+  controlTaskHandle = osThreadNew(StartControlTask, NULL, &controlTask_attributes);
+
   /* creation of statsTask */
   statsTaskHandle = osThreadNew(StartStatsTask, NULL, &statsTask_attributes);
 
+  /* creation of profilerTask */
+  profilerTaskHandle = osThreadNew(StartProfilerTask, NULL, &profilerTask_attributes);
+
+  /* creation of historyTask */
+  historyTaskHandle = osThreadNew(StartHistoryTask, NULL, &historyTask_attributes);
+
+  /* creation of previewTask */
+  previewTaskHandle = osThreadNew(StartPreviewTask, NULL, &previewTask_attributes);
+
+  /* creation of memTestTask */
+  memTestTaskHandle = osThreadNew(StartMemTestTask, NULL, &memTestTask_attributes);
+
+  /* creation of timeSyncTask */
+  timeSyncTaskHandle = osThreadNew(StartTimeSyncTask, NULL, &timeSyncTask_attributes);
+
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
 
@@ -214,10 +313,16 @@ void StartNetworkTask(void *argument)
   MX_LWIP_Init();
   /* USER CODE BEGIN StartNetworkTask */
   (void)argument;
+  boot_timeline_reached(BOOT_PHASE_NETWORK);
+  // eeprom on i2c4, runs while the blobDetectorTask initializes the camera on i2c1
+  app_init_network_config();
+  app_init_calibration();
+  boot_timeline_reached(BOOT_PHASE_NETWORK_CONFIG);
   log_info("[StartNetworkTask] locking heap");
   lock_heap();
   log_info("[StartNetworkTask] init command handler");
   app_init_command_handler();
+  boot_timeline_reached(BOOT_PHASE_COMMAND_HANDLER);
   for(;;)
   {
     app_run_command_handler(); // blocking!
@@ -239,7 +344,6 @@ void StartBlobDetectorTask(void *argument)
   (void)argument;
   log_info("[StartBlobDetectorTask] init camera");
   app_init_camera();
-  app_init_network_config();
   /* Infinite loop */
   for(;;)
   {
@@ -249,6 +353,25 @@ void StartBlobDetectorTask(void *argument)
   /* USER CODE END StartBlobDetectorTask */
 }
 
+/* USER CODE BEGIN Header_StartControlTask */
+/**
+* @brief Function implementing the controlTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartControlTask */
+void StartControlTask(void *argument)
+{
+  /* USER CODE BEGIN StartControlTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_auto_exposure(); // blocking!
+  }
+  /* USER CODE END StartControlTask */
+}
+
 /* USER CODE BEGIN Header_StartStatsTask */
 /**
 * @brief Function implementing the statsTask thread.
@@ -263,12 +386,106 @@ void StartStatsTask(void *argument)
   /* Infinite loop */
   for(;;)
   {
-    //app_run_network_stats();
-    osDelay(100);
+    app_run_network_benchmark(); // blocking!
   }
   /* USER CODE END StartStatsTask */
 }
 
+/* USER CODE BEGIN Header_StartProfilerTask */
+/**
+* @brief Function implementing the profilerTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartProfilerTask */
+void StartProfilerTask(void *argument)
+{
+  /* USER CODE BEGIN StartProfilerTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_task_profiler(); // blocking!
+  }
+  /* USER CODE END StartProfilerTask */
+}
+
+/* USER CODE BEGIN Header_StartHistoryTask */
+/**
+* @brief Function implementing the historyTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartHistoryTask */
+void StartHistoryTask(void *argument)
+{
+  /* USER CODE BEGIN StartHistoryTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_frame_history(); // blocking!
+  }
+  /* USER CODE END StartHistoryTask */
+}
+
+/* USER CODE BEGIN Header_StartPreviewTask */
+/**
+* @brief Function implementing the previewTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartPreviewTask */
+void StartPreviewTask(void *argument)
+{
+  /* USER CODE BEGIN StartPreviewTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_preview_stream(); // blocking!
+  }
+  /* USER CODE END StartPreviewTask */
+}
+
+/* USER CODE BEGIN Header_StartMemTestTask */
+/**
+* @brief Function implementing the memTestTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartMemTestTask */
+void StartMemTestTask(void *argument)
+{
+  /* USER CODE BEGIN StartMemTestTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_sdram_test(); // blocking!
+  }
+  /* USER CODE END StartMemTestTask */
+}
+
+/* USER CODE BEGIN Header_StartTimeSyncTask */
+/**
+* @brief Function implementing the timeSyncTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartTimeSyncTask */
+void StartTimeSyncTask(void *argument)
+{
+  /* USER CODE BEGIN StartTimeSyncTask */
+  (void)argument;
+  /* Infinite loop */
+  for(;;)
+  {
+    app_run_time_sync(); // blocking!
+  }
+  /* USER CODE END StartTimeSyncTask */
+}
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
 
@@ -68,6 +68,7 @@ extern "C" {
 void SystemClock_Config(void);
 void MX_FREERTOS_Init(void);
 /* USER CODE BEGIN PFP */
+static void configureMpu(void);
 
 /* USER CODE END PFP */
 
@@ -77,8 +78,10 @@ void MX_FREERTOS_Init(void);
 #include "AppBuilder.h"
 #include "utils/swo.h"
 #include "utils/Log.h"
+#include "utils/SyncClock.h"
 #include "utils/constants.h"
 #include "as4c16m16msa/sdram.h"
+#include "metrics/BootTimeline.h"
 /* USER CODE END 0 */
 
 /**
@@ -89,9 +92,17 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  configureMpu(); // before the caches are enabled below
   /* USER CODE END 1 */
 
+  /* Enable the CPU Cache */
+
+  /* Enable I-Cache---------------------------------------------------------*/
+  SCB_EnableICache();
+
+  /* Enable D-Cache---------------------------------------------------------*/
+  SCB_EnableDCache();
+
   /* MCU Configuration--------------------------------------------------------*/
 
   /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
@@ -122,29 +133,22 @@ int main(void)
   MX_UART5_Init();
   MX_USB_OTG_HS_PCD_Init();
   /* USER CODE BEGIN 2 */
-  Log::registerTickKeeper([](void) -> uint32_t {return osKernelGetTickCount();});
-  Log::setTickrate(TICKS_PER_MILLISECOND);
+  BootTimeline::reached(BOOT_PHASE_PERIPHERALS);
+  Log::registerClock(SyncClock::nowUs);
   Log::level(Log::Level::LOG_INFO);
   Log::info("[main] visionAddOn, commit %s", GIT_COMMIT_HASH);
 
   initSdram(&hsdram1);
 #ifdef TEST_EXTERNAL_SDRAM
-  Log::info("[main] testing sdram");
-  uint32_t* externalSdramBase = (uint32_t*) EXTERNAL_SDRAM_BASE_ADDRESS;
-  for(uint32_t offset = 0; offset < EXTERNAL_SDRAM_SIZE_WORDS; offset++) {
-    if((EXTERNAL_SDRAM_BASE_ADDRESS + offset) > EXTERNAL_SDRAM_END_ADDRESS) {
-      Log::error("[main] @ offset %#x: EXTERNAL_SDRAM_BASE_ADDRESS + offset = %#x, which is greater than EXTERNAL_SDRAM_END_ADDRESS (%#x)", offset, EXTERNAL_SDRAM_BASE_ADDRESS + offset, EXTERNAL_SDRAM_END_ADDRESS);
-      Error_Handler();
-    }
-    externalSdramBase[offset] = offset;
-    uint32_t offsetReadBack = externalSdramBase[offset];
-    if(offset != offsetReadBack) {
-      Log::error("[main] offset: %#x, offsetReadBack: %#x", offset, offsetReadBack);
-      Error_Handler();
-    }
+  // data and address lines only, the cells are pattern tested in the background by metrics/SdramTest
+  uint32_t failedAddress = 0;
+  if(!testSdramBus(EXTERNAL_SDRAM_BASE_ADDRESS, EXTERNAL_SDRAM_SIZE_BYTES, &failedAddress)) {
+    Log::error("[main] sdram bus test failed @ %#lx", failedAddress);
+    Error_Handler();
   }
-  Log::info("[main] sdram ok");
+  Log::info("[main] sdram bus ok");
 #endif // TEST_EXTERNAL_SDRAM
+  BootTimeline::reached(BOOT_PHASE_SDRAM);
 
   /* USER CODE END 2 */
 
@@ -234,6 +238,32 @@ void SystemClock_Config(void)
 
 /* USER CODE BEGIN 4 */
 #pragma GCC diagnostic pop // "-Wmissing-field-initializers"
+
+// Not generated from the ioc, CubeMX only zero initializes MPU_Region_InitTypeDef.
+// The regions are listed with all fields, in the order of MPU_Region_InitTypeDef:
+// Enable, Number, BaseAddress, Size, SubRegionDisable, TypeExtField, AccessPermission, DisableExec, IsShareable, IsCacheable, IsBufferable
+static void configureMpu(void)
+{
+  MPU_Region_InitTypeDef regions[] = {
+    // FMC bank 1 is not populated, no access (the default map allows speculative reads)
+    {MPU_REGION_ENABLE, MPU_REGION_NUMBER0, 0x60000000, MPU_REGION_SIZE_256MB, 0x0, MPU_TEX_LEVEL0, MPU_REGION_NO_ACCESS,
+     MPU_INSTRUCTION_ACCESS_DISABLE, MPU_ACCESS_SHAREABLE, MPU_ACCESS_NOT_CACHEABLE, MPU_ACCESS_NOT_BUFFERABLE},
+    // external SDRAM, normal write-back memory instead of device memory
+    {MPU_REGION_ENABLE, MPU_REGION_NUMBER1, 0xC0000000, MPU_REGION_SIZE_32MB, 0x0, MPU_TEX_LEVEL1, MPU_REGION_FULL_ACCESS,
+     MPU_INSTRUCTION_ACCESS_DISABLE, MPU_ACCESS_NOT_SHAREABLE, MPU_ACCESS_CACHEABLE, MPU_ACCESS_BUFFERABLE},
+    // DMA buffers at the end of SRAM2, normal non-cacheable memory
+    {MPU_REGION_ENABLE, MPU_REGION_NUMBER2, 0x2007C000, MPU_REGION_SIZE_16KB, 0x0, MPU_TEX_LEVEL1, MPU_REGION_FULL_ACCESS,
+     MPU_INSTRUCTION_ACCESS_DISABLE, MPU_ACCESS_SHAREABLE, MPU_ACCESS_NOT_CACHEABLE, MPU_ACCESS_NOT_BUFFERABLE},
+    // ETH DMA descriptors, shared device memory
+    {MPU_REGION_ENABLE, MPU_REGION_NUMBER3, 0x2007C000, MPU_REGION_SIZE_512B, 0x0, MPU_TEX_LEVEL0, MPU_REGION_FULL_ACCESS,
+     MPU_INSTRUCTION_ACCESS_DISABLE, MPU_ACCESS_SHAREABLE, MPU_ACCESS_NOT_CACHEABLE, MPU_ACCESS_BUFFERABLE},
+  };
+  HAL_MPU_Disable();
+  for(MPU_Region_InitTypeDef& region : regions) {
+    HAL_MPU_ConfigRegion(&region);
+  }
+  HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
 /* USER CODE END 4 */
 
 /**
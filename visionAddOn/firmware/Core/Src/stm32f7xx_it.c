@@ -23,6 +23,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "utils/c_log.h"
+#include "utils/interrupt/c_interrupt_profiler.h"
 #include <stdlib.h>
 /* USER CODE END Includes */
 
@@ -59,6 +60,7 @@ uint8_t spiRxBuffer[SPI_RX_BUFFER_SIZE];
 
 /* External variables --------------------------------------------------------*/
 extern ETH_HandleTypeDef heth;
+extern DMA_HandleTypeDef hdma_memtomem_dma2_stream2;
 extern DMA_HandleTypeDef hdma_dcmi;
 extern DCMI_HandleTypeDef hdcmi;
 extern DMA_HandleTypeDef hdma_spi1_rx;
@@ -182,7 +184,7 @@ void DebugMon_Handler(void)
 void DMA1_Stream5_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
-  log_debug("[DMA1_Stream5_IRQHandler]");
+  interrupt_profiler_enter(INTERRUPT_SOURCE_UART_RX);
   /* USER CODE END DMA1_Stream5_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart2_rx);
   /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
@@ -210,6 +212,7 @@ void TIM1_UP_TIM10_IRQHandler(void)
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
+  interrupt_profiler_enter(INTERRUPT_SOURCE_UART_RX);
   //log_trace("[USART2_IRQHandler] UART_IT_CM: %d",__HAL_UART_GET_IT(&huart2, UART_IT_CM));
   //log_trace("[USART2_IRQHandler] UART_IT_CTS: %d",__HAL_UART_GET_IT(&huart2, UART_IT_CTS));
   //log_trace("[USART2_IRQHandler] UART_IT_LBD: %d",__HAL_UART_GET_IT(&huart2, UART_IT_LBD));
@@ -232,7 +235,7 @@ void USART2_IRQHandler(void)
 void EXTI15_10_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_10_IRQn 0 */
-
+  interrupt_profiler_enter(INTERRUPT_SOURCE_EXTI);
   /* USER CODE END EXTI15_10_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(EXTI10_SPI_NEW_DATA_Pin);
   /* USER CODE BEGIN EXTI15_10_IRQn 1 */
@@ -273,6 +276,20 @@ void DMA2_Stream1_IRQHandler(void)
   /* USER CODE END DMA2_Stream1_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA2 stream2 global interrupt.
+  */
+void DMA2_Stream2_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream2_IRQn 0 */
+
+  /* USER CODE END DMA2_Stream2_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_memtomem_dma2_stream2);
+  /* USER CODE BEGIN DMA2_Stream2_IRQn 1 */
+
+  /* USER CODE END DMA2_Stream2_IRQn 1 */
+}
+
 /**
   * @brief This function handles Ethernet global interrupt.
   */
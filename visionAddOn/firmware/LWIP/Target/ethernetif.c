@@ -122,6 +122,9 @@ ETH_DMADescTypeDef DMATxDscrTab[ETH_TX_DESC_CNT] __attribute__((section(".TxDecr
 
 /* USER CODE BEGIN 2 */
 #pragma GCC diagnostic pop // "-Wpedantic"
+/* LWIP_MEMPOOL_DECLARE only aligns the pool to MEM_ALIGNMENT, the buffers must start on a cache line so that their
+ * invalidation cannot drop the pbuf header or the previous element. sizeof(RxBuff_t) is a multiple of 32. */
+extern u8_t memp_memory_RX_POOL_base[] __ALIGNED(32);
 uint8_t* persisted_mac = NULL; // MAC address loaded from eeprom will be stored here
 /* USER CODE END 2 */
 
@@ -395,6 +398,10 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     Txbuffer[i].buffer = q->payload;
     Txbuffer[i].len = q->len;
 
+    /* The payload may be cached (lwip heap, SDRAM), write it back before the Tx DMA reads it.
+       Cleaning the partial lines next to the payload is harmless. */
+    SCB_CleanDCache_by_Addr((uint32_t *)((uint32_t)q->payload & ~31U), q->len + ((uint32_t)q->payload & 31U));
+
     if(i>0)
     {
       Txbuffer[i-1].next = &Txbuffer[i];
@@ -861,6 +868,9 @@ void HAL_ETH_RxAllocateCallback(uint8_t **buff)
   {
     /* Get the buff from the struct pbuf address. */
     *buff = (uint8_t *)p + offsetof(RxBuff_t, buff);
+    /* The recycled buffer may hold dirty lines (lwip replies in place), drop them before the Rx DMA writes.
+     * Whole cache lines of the payload only, before the pbuf header is written. */
+    SCB_InvalidateDCache_by_Addr((uint32_t *)*buff, sizeof(((RxBuff_t *)0)->buff));
     p->custom_free_function = pbuf_free_custom;
     /* Initialize the struct pbuf.
     * This must be performed whenever a buffer's allocated because it may be
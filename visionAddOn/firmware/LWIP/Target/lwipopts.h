@@ -50,7 +50,7 @@
 /* LwIP Stack Parameters (modified compared to initialization value in opt.h) -*/
 /* Parameters set in STM32CubeMX LwIP Configuration GUI -*/
 /*----- Default Value for MEMP_NUM_UDP_PCB: 4 ---*/
-#define MEMP_NUM_UDP_PCB 2
+#define MEMP_NUM_UDP_PCB 7
 /*----- Default Value for MEMP_NUM_TCP_PCB: 5 ---*/
 #define MEMP_NUM_TCP_PCB 2
 /*----- Value in opt.h for MEM_ALIGNMENT: 1 -----*/
@@ -127,7 +127,13 @@
 /* USER CODE BEGIN 1 */
 #undef LWIP_SUPPORT_CUSTOM_PBUF
 #undef LWIP_RAM_HEAP_POINTER
-#define LWIP_STATS_DISPLAY 1
+/* raw api senders lock the core instead of posting to the tcpip thread,
+   set to 0 to benchmark the tcpip_callback path (see host/transportBenchmark.py) */
+#undef LWIP_TCPIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING 1
+/* command listener, accepted command connection, broadcast commands, time sync and the short lived
+   frame transfer / recorder / benchmark / socket transport connections */
+#define MEMP_NUM_NETCONN 7
 /* USER CODE END 1 */
 
 #ifdef __cplusplus